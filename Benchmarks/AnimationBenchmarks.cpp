@@ -0,0 +1,70 @@
+#include <random>
+
+#include "Benchmark.h"
+#include "Game/Animation.h"
+
+static const uint ANIMATION_KEY_COUNT = 256;
+static const uint ANIMATION_EVALUATION_COUNT = 1024;
+static const float ANIMATION_DURATION = 10.f;
+
+template < typename T, typename Generator >
+static AnimationCurve< T > GenerateCurve( Generator oGenerateValue )
+{
+	AnimationCurve< T > oCurve;
+	for( uint u = 0; u < ANIMATION_KEY_COUNT; ++u )
+	{
+		oCurve.m_aTimes.PushBack( u * ANIMATION_DURATION / ( ANIMATION_KEY_COUNT - 1 ) );
+		oCurve.m_aValues.PushBack( oGenerateValue() );
+	}
+
+	return oCurve;
+}
+
+// Random times, as evaluated by many animators each playing at its own time
+static Array< float > GenerateTimes()
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oDistribution( 0.f, ANIMATION_DURATION );
+
+	Array< float > aTimes( ANIMATION_EVALUATION_COUNT );
+	for( float& fTime : aTimes )
+		fTime = oDistribution( oGenerator );
+
+	return aTimes;
+}
+
+BENCHMARK( AnimationCurveEvaluatePosition )
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oDistribution( -10.f, 10.f );
+
+	const AnimationCurve< glm::vec3 > oCurve = GenerateCurve< glm::vec3 >( [ & ]() { return glm::vec3( oDistribution( oGenerator ), oDistribution( oGenerator ), oDistribution( oGenerator ) ); } );
+	const Array< float > aTimes = GenerateTimes();
+
+	oState.SetItemsPerIteration( ANIMATION_EVALUATION_COUNT );
+	oState.Measure( [ & ]() {
+		glm::vec3 vSum( 0.f );
+		for( const float fTime : aTimes )
+			vSum += oCurve.Evaluate( fTime );
+
+		DoNotOptimize( vSum );
+	} );
+}
+
+BENCHMARK( AnimationCurveEvaluateRotation )
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oDistribution( -1.f, 1.f );
+
+	const AnimationCurve< glm::quat > oCurve = GenerateCurve< glm::quat >( [ & ]() { return glm::normalize( glm::quat( oDistribution( oGenerator ), oDistribution( oGenerator ), oDistribution( oGenerator ), oDistribution( oGenerator ) ) ); } );
+	const Array< float > aTimes = GenerateTimes();
+
+	oState.SetItemsPerIteration( ANIMATION_EVALUATION_COUNT );
+	oState.Measure( [ & ]() {
+		glm::quat qSum( 0.f, 0.f, 0.f, 0.f );
+		for( const float fTime : aTimes )
+			qSum += oCurve.Evaluate( fTime );
+
+		DoNotOptimize( qSum );
+	} );
+}
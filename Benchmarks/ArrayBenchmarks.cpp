@@ -0,0 +1,113 @@
+#include <random>
+#include <string>
+
+#include "Benchmark.h"
+#include "Core/ArrayUtils.h"
+
+BENCHMARK( ArrayPushBack )
+{
+	const uint uCount = 4096;
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		Array< uint > aValues;
+		for( uint u = 0; u < uCount; ++u )
+			aValues.PushBack( u );
+
+		DoNotOptimize( aValues.Back() );
+	} );
+}
+
+BENCHMARK( ArrayPushBackReserved )
+{
+	const uint uCount = 4096;
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		Array< uint > aValues;
+		aValues.Reserve( uCount );
+		for( uint u = 0; u < uCount; ++u )
+			aValues.PushBack( u );
+
+		DoNotOptimize( aValues.Back() );
+	} );
+}
+
+BENCHMARK( ArrayPushBackStrings )
+{
+	const uint uCount = 1024;
+	const std::string sValue( "Data/Scene/synthetic_entity_name" );
+
+	// Strings are not trivially copyable, growing the array copies them one by one
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		Array< std::string > aValues;
+		for( uint u = 0; u < uCount; ++u )
+			aValues.PushBack( sValue );
+
+		DoNotOptimize( aValues.Back().length() );
+	} );
+}
+
+BENCHMARK( ArrayCopy )
+{
+	const uint uCount = 65536;
+	const Array< float > aSource( uCount, 1.f );
+
+	oState.SetBytesPerIteration( uCount * sizeof( float ) );
+	oState.Measure( [ & ]() {
+		const Array< float > aCopy( aSource );
+		DoNotOptimize( aCopy.Back() );
+	} );
+}
+
+BENCHMARK( ArrayRemoveFront )
+{
+	const uint uCount = 1024;
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		Array< uint > aValues( uCount, 0 );
+		while( aValues.Empty() == false )
+			aValues.Remove( 0 );
+
+		DoNotOptimize( aValues.Count() );
+	} );
+}
+
+BENCHMARK( ArraySort )
+{
+	const uint uCount = 4096;
+
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oDistribution( 0.f, 1000.f );
+
+	Array< float > aSource( uCount );
+	for( float& fValue : aSource )
+		fValue = oDistribution( oGenerator );
+
+	Array< float > aValues;
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		aValues = aSource;
+		Sort( aValues, []( const float fA, const float fB ) { return fA < fB; } );
+
+		DoNotOptimize( aValues.Front() );
+	} );
+}
+
+BENCHMARK( ArrayIterate )
+{
+	const uint uCount = 65536;
+	const Array< uint > aValues( uCount, 3 );
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		uint uSum = 0;
+		for( const uint uValue : aValues )
+			uSum += uValue;
+
+		DoNotOptimize( uSum );
+	} );
+}
@@ -0,0 +1,157 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Benchmark.h"
+#include "Core/AsyncFileReader.h"
+
+static const uint ASYNC_READ_FILE_COUNT = 512;
+
+// Medium sized assets, like the textures and models of a level
+struct AsyncReadBenchmarkData
+{
+	AsyncReadBenchmarkData()
+		: m_oDirectory( std::filesystem::temp_directory_path() / "GameEngineAsyncReadBenchmarks" )
+		, m_uTotalSize( 0 )
+	{
+		std::mt19937 oGenerator( 42 );
+		std::uniform_int_distribution< uint > oSizeDistribution( 16 * 1024, 256 * 1024 );
+
+		std::filesystem::remove_all( m_oDirectory );
+		std::filesystem::create_directories( m_oDirectory );
+
+		for( uint u = 0; u < ASYNC_READ_FILE_COUNT; ++u )
+		{
+			const std::filesystem::path oFilePath = m_oDirectory / ( "Asset" + std::to_string( u ) + ".bin" );
+
+			const std::string sContent( oSizeDistribution( oGenerator ), ( char )u );
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream.write( sContent.data(), sContent.length() );
+
+			m_aFilePaths.PushBack( oFilePath );
+			m_uTotalSize += sContent.length();
+		}
+	}
+
+	~AsyncReadBenchmarkData()
+	{
+		std::filesystem::remove_all( m_oDirectory );
+	}
+
+	std::filesystem::path				m_oDirectory;
+	Array< std::filesystem::path >		m_aFilePaths;
+	uint64								m_uTotalSize;
+};
+
+static const AsyncReadBenchmarkData& GetAsyncReadBenchmarkData()
+{
+	static const AsyncReadBenchmarkData s_oData;
+	return s_oData;
+}
+
+// Drops the files from the system cache so that they are read from the disk, files stay in the cache where this is not supported
+static void EvictFromCache( const AsyncReadBenchmarkData& oData )
+{
+#ifdef __linux__
+	for( const std::filesystem::path& oFilePath : oData.m_aFilePaths )
+	{
+		const int iFile = open( oFilePath.c_str(), O_RDONLY );
+		posix_fadvise( iFile, 0, 0, POSIX_FADV_DONTNEED );
+		close( iFile );
+	}
+#else
+	( void )oData;
+#endif
+}
+
+static void ReadAll( BenchmarkState& oState, AsyncFileReader& oReader, const bool bCold )
+{
+	const AsyncReadBenchmarkData& oData = GetAsyncReadBenchmarkData();
+
+	oState.SetItemsPerIteration( oData.m_aFilePaths.Count() );
+	oState.SetBytesPerIteration( oData.m_uTotalSize );
+	oState.Measure( [ & ]() {
+		if( bCold )
+			EvictFromCache( oData );
+
+		for( const std::filesystem::path& oFilePath : oData.m_aFilePaths )
+			oReader.Read( oFilePath, 0, 0, 0 );
+
+		uint64 uSum = 0;
+		while( AsyncRead* pRead = oReader.PopDelivered( true ) )
+		{
+			uSum += pRead->m_aData.Back();
+			delete pRead;
+		}
+
+		DoNotOptimize( uSum );
+	} );
+}
+
+// One file after the other, as the IO thread used to
+static void ReadAllBlocking( BenchmarkState& oState, const bool bCold )
+{
+	const AsyncReadBenchmarkData& oData = GetAsyncReadBenchmarkData();
+
+	oState.SetItemsPerIteration( oData.m_aFilePaths.Count() );
+	oState.SetBytesPerIteration( oData.m_uTotalSize );
+	oState.Measure( [ & ]() {
+		if( bCold )
+			EvictFromCache( oData );
+
+		uint64 uSum = 0;
+		for( const std::filesystem::path& oFilePath : oData.m_aFilePaths )
+		{
+			// Each file gets its own buffer, which is then handed to its decoder
+			Array< uint8 > aData;
+			std::ifstream oFileStream( oFilePath, std::ios::binary | std::ios::ate );
+			aData.Resize( ( uint )oFileStream.tellg() );
+			oFileStream.seekg( 0 );
+			oFileStream.read( ( char* )aData.Data(), aData.Count() );
+			uSum += aData.Back();
+		}
+
+		DoNotOptimize( uSum );
+	} );
+}
+
+BENCHMARK( AsyncReadBlocking )
+{
+	ReadAllBlocking( oState, false );
+}
+
+BENCHMARK( AsyncReadThreadPool )
+{
+	AsyncFileReader oReader( ASYNC_READ_DEFAULT_THREAD_COUNT, false );
+	ReadAll( oState, oReader, false );
+}
+
+// Same as the thread pool where io_uring is not available
+BENCHMARK( AsyncReadIOUring )
+{
+	AsyncFileReader oReader( ASYNC_READ_DEFAULT_THREAD_COUNT, true );
+	ReadAll( oState, oReader, false );
+}
+
+BENCHMARK( AsyncReadColdBlocking )
+{
+	ReadAllBlocking( oState, true );
+}
+
+BENCHMARK( AsyncReadColdThreadPool )
+{
+	AsyncFileReader oReader( ASYNC_READ_DEFAULT_THREAD_COUNT, false );
+	ReadAll( oState, oReader, true );
+}
+
+BENCHMARK( AsyncReadColdIOUring )
+{
+	AsyncFileReader oReader( ASYNC_READ_DEFAULT_THREAD_COUNT, true );
+	ReadAll( oState, oReader, true );
+}
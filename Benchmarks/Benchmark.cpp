@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+const void* volatile g_pBenchmarkSink = nullptr;
+#endif
+
+static Array< BenchmarkEntry >& GetMutableBenchmarks()
+{
+	// Benchmarks register during static initialization, the array has to exist before the first of them
+	static Array< BenchmarkEntry > s_aBenchmarks;
+	return s_aBenchmarks;
+}
+
+bool RegisterBenchmark( const char* sName, const BenchmarkFunction pFunction )
+{
+	GetMutableBenchmarks().PushBack( BenchmarkEntry{ sName, pFunction } );
+	return true;
+}
+
+const Array< BenchmarkEntry >& GetBenchmarks()
+{
+	return GetMutableBenchmarks();
+}
+
+BenchmarkResult::BenchmarkResult()
+	: m_uIterations( 0 )
+	, m_uSampleCount( 0 )
+	, m_fMinNs( 0.0 )
+	, m_fMedianNs( 0.0 )
+	, m_fMeanNs( 0.0 )
+	, m_fMaxNs( 0.0 )
+	, m_uItemsPerIteration( 0 )
+	, m_uBytesPerIteration( 0 )
+{
+}
+
+BenchmarkState::BenchmarkState( const char* sName, const uint uSampleCount, const std::chrono::nanoseconds oSampleTime )
+	: m_oSampleTime( oSampleTime )
+{
+	m_oResult.m_sName = sName;
+	m_oResult.m_uSampleCount = std::max( uSampleCount, 1u );
+}
+
+void BenchmarkState::SetItemsPerIteration( const uint64 uItems )
+{
+	m_oResult.m_uItemsPerIteration = uItems;
+}
+
+void BenchmarkState::SetBytesPerIteration( const uint64 uBytes )
+{
+	m_oResult.m_uBytesPerIteration = uBytes;
+}
+
+const BenchmarkResult& BenchmarkState::GetResult() const
+{
+	return m_oResult;
+}
+
+void BenchmarkState::ComputeResult( Array< std::chrono::nanoseconds >& aSamples, const uint64 uIterations )
+{
+	std::sort( aSamples.begin(), aSamples.end() );
+
+	const double fIterations = ( double )uIterations;
+	auto ToNs = [ fIterations ]( const std::chrono::nanoseconds oDuration ) {
+		return oDuration.count() / fIterations;
+	};
+
+	double fTotalNs = 0.0;
+	for( const std::chrono::nanoseconds oSample : aSamples )
+		fTotalNs += ToNs( oSample );
+
+	const uint uCount = aSamples.Count();
+
+	m_oResult.m_uIterations = uIterations;
+	m_oResult.m_fMinNs = ToNs( aSamples.Front() );
+	m_oResult.m_fMedianNs = uCount % 2 != 0 ? ToNs( aSamples[ uCount / 2 ] ) : 0.5 * ( ToNs( aSamples[ uCount / 2 - 1 ] ) + ToNs( aSamples[ uCount / 2 ] ) );
+	m_oResult.m_fMeanNs = fTotalNs / uCount;
+	m_oResult.m_fMaxNs = ToNs( aSamples.Back() );
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#include <intrin.h>
+#endif
+
+#include "Core/Array.h"
+
+inline constexpr uint BENCHMARK_DEFAULT_SAMPLE_COUNT = 10;
+inline constexpr std::chrono::milliseconds BENCHMARK_DEFAULT_SAMPLE_TIME( 20 );
+inline constexpr uint64 BENCHMARK_MAX_ITERATIONS = 1ull << 30;
+
+class BenchmarkState;
+
+using BenchmarkFunction = void ( * )( BenchmarkState& oState );
+
+bool RegisterBenchmark( const char* sName, const BenchmarkFunction pFunction );
+
+#define BENCHMARK( NAME )												\
+static void NAME( BenchmarkState& oState );								\
+static bool b##NAME##Registered = RegisterBenchmark( #NAME, &NAME );	\
+static void NAME( BenchmarkState& oState )
+
+// Durations are per iteration, items and bytes let results be compared as throughputs
+struct BenchmarkResult
+{
+	BenchmarkResult();
+
+	std::string	m_sName;
+	uint64		m_uIterations;
+	uint		m_uSampleCount;
+	double		m_fMinNs;
+	double		m_fMedianNs;
+	double		m_fMeanNs;
+	double		m_fMaxNs;
+	uint64		m_uItemsPerIteration;
+	uint64		m_uBytesPerIteration;
+};
+
+struct BenchmarkEntry
+{
+	const char*			m_sName;
+	BenchmarkFunction	m_pFunction;
+};
+
+const Array< BenchmarkEntry >& GetBenchmarks();
+
+// Keeps the compiler from removing the computation of a value nothing reads
+// The whole value is assumed read through its address and memory is clobbered, without copying it
+#if defined( _MSC_VER ) && !defined( __clang__ )
+extern const void* volatile g_pBenchmarkSink;
+
+template < typename T >
+inline void DoNotOptimize( const T& oValue )
+{
+	g_pBenchmarkSink = &oValue;
+	_ReadWriteBarrier();
+}
+#else
+template < typename T >
+inline void DoNotOptimize( const T& oValue )
+{
+	asm volatile( "" : : "g"( &oValue ) : "memory" );
+}
+#endif
+
+class BenchmarkState
+{
+public:
+	BenchmarkState( const char* sName, const uint uSampleCount, const std::chrono::nanoseconds oSampleTime );
+
+	// Setup done before calling Measure is not timed, the function is one iteration
+	// Iterations are scaled until a sample lasts the sample time, which also warms the caches up, then the samples are taken
+	template < typename Function >
+	void Measure( Function&& oFunction )
+	{
+		uint64 uIterations = 1;
+		std::chrono::nanoseconds oDuration = RunIterations( oFunction, uIterations );
+		while( oDuration < m_oSampleTime && uIterations < BENCHMARK_MAX_ITERATIONS )
+		{
+			const double fScale = oDuration.count() > 0 ? 1.2 * m_oSampleTime.count() / oDuration.count() : 10.0;
+			uIterations = std::min( BENCHMARK_MAX_ITERATIONS, ( uint64 )( uIterations * std::clamp( fScale, 2.0, 10.0 ) ) );
+			oDuration = RunIterations( oFunction, uIterations );
+		}
+
+		Array< std::chrono::nanoseconds > aSamples( m_oResult.m_uSampleCount );
+		for( std::chrono::nanoseconds& oSample : aSamples )
+			oSample = RunIterations( oFunction, uIterations );
+
+		ComputeResult( aSamples, uIterations );
+	}
+
+	void					SetItemsPerIteration( const uint64 uItems );
+	void					SetBytesPerIteration( const uint64 uBytes );
+
+	const BenchmarkResult&	GetResult() const;
+
+private:
+	template < typename Function >
+	static std::chrono::nanoseconds RunIterations( Function& oFunction, const uint64 uIterations )
+	{
+		const std::chrono::steady_clock::time_point oStart = std::chrono::steady_clock::now();
+		for( uint64 u = 0; u < uIterations; ++u )
+			oFunction();
+
+		return std::chrono::steady_clock::now() - oStart;
+	}
+
+	void					ComputeResult( Array< std::chrono::nanoseconds >& aSamples, const uint64 uIterations );
+
+	BenchmarkResult				m_oResult;
+	std::chrono::nanoseconds	m_oSampleTime;
+};
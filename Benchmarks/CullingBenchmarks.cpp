@@ -0,0 +1,71 @@
+#include <random>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Benchmark.h"
+#include "Graphics/BoundingVolume.h"
+
+// Boxes spread around a camera looking down the Z axis, about a third of them in its frustum
+static Array< AxisAlignedBox > GenerateBoxes( const uint uCount )
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oPositionDistribution( -200.f, 200.f );
+	std::uniform_real_distribution< float > oSizeDistribution( 0.5f, 5.f );
+
+	Array< AxisAlignedBox > aBoxes( uCount );
+	for( AxisAlignedBox& oBox : aBoxes )
+	{
+		const glm::vec3 vCenter( oPositionDistribution( oGenerator ), oPositionDistribution( oGenerator ) * 0.1f, oPositionDistribution( oGenerator ) );
+		const glm::vec3 vExtends( oSizeDistribution( oGenerator ) );
+
+		oBox.m_vMin = vCenter - vExtends;
+		oBox.m_vMax = vCenter + vExtends;
+	}
+
+	return aBoxes;
+}
+
+static Frustum GenerateFrustum()
+{
+	const glm::mat4 mProjection = glm::perspective( glm::radians( 60.f ), 16.f / 9.f, 0.1f, 500.f );
+	const glm::mat4 mView = glm::lookAt( glm::vec3( 0.f, 10.f, -250.f ), glm::vec3( 0.f, 0.f, 0.f ), glm::vec3( 0.f, 1.f, 0.f ) );
+
+	return Frustum::FromViewProjection( mProjection * mView );
+}
+
+BENCHMARK( FrustumIsVisible )
+{
+	const uint uCount = 4096;
+	const Array< AxisAlignedBox > aBoxes = GenerateBoxes( uCount );
+	const Frustum oFrustum = GenerateFrustum();
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		uint uVisibleCount = 0;
+		for( const AxisAlignedBox& oBox : aBoxes )
+			uVisibleCount += oFrustum.IsVisible( oBox ) ? 1 : 0;
+
+		DoNotOptimize( uVisibleCount );
+	} );
+}
+
+BENCHMARK( FrustumAreVisible )
+{
+	const uint uCount = 4096;
+	const Array< AxisAlignedBox > aBoxes = GenerateBoxes( uCount );
+	const Frustum oFrustum = GenerateFrustum();
+
+	oState.SetItemsPerIteration( uCount );
+	oState.Measure( [ & ]() {
+		uint uVisibleCount = 0;
+		for( uint u = 0; u < uCount; u += 4 )
+		{
+			bool bVisibleA, bVisibleB, bVisibleC, bVisibleD;
+			oFrustum.AreVisible( bVisibleA, bVisibleB, bVisibleC, bVisibleD, aBoxes[ u ], aBoxes[ u + 1 ], aBoxes[ u + 2 ], aBoxes[ u + 3 ] );
+			uVisibleCount += ( bVisibleA ? 1 : 0 ) + ( bVisibleB ? 1 : 0 ) + ( bVisibleC ? 1 : 0 ) + ( bVisibleD ? 1 : 0 );
+		}
+
+		DoNotOptimize( uVisibleCount );
+	} );
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+#include "Benchmark.h"
+
+// Headless benchmarks of engine subsystems on synthetic data, results are written as JSON to track them over time
+// Usage : Benchmarks [--filter <text>] [--samples <count>] [--sample-time <ms>] [--output <file>] [--list]
+int main( int iArgumentCount, char** aArguments )
+{
+	const char* sFilter = nullptr;
+	const char* sOutput = nullptr;
+	uint uSampleCount = BENCHMARK_DEFAULT_SAMPLE_COUNT;
+	std::chrono::nanoseconds oSampleTime = BENCHMARK_DEFAULT_SAMPLE_TIME;
+	bool bList = false;
+
+	for( int i = 1; i < iArgumentCount; ++i )
+	{
+		const bool bHasValue = i + 1 < iArgumentCount;
+
+		if( strcmp( aArguments[ i ], "--filter" ) == 0 && bHasValue )
+			sFilter = aArguments[ ++i ];
+		else if( strcmp( aArguments[ i ], "--output" ) == 0 && bHasValue )
+			sOutput = aArguments[ ++i ];
+		else if( strcmp( aArguments[ i ], "--samples" ) == 0 && bHasValue )
+			uSampleCount = ( uint )atoi( aArguments[ ++i ] );
+		else if( strcmp( aArguments[ i ], "--sample-time" ) == 0 && bHasValue )
+			oSampleTime = std::chrono::milliseconds( atoi( aArguments[ ++i ] ) );
+		else if( strcmp( aArguments[ i ], "--list" ) == 0 )
+			bList = true;
+		else
+		{
+			fprintf( stderr, "Unknown argument %s\n", aArguments[ i ] );
+			return -1;
+		}
+	}
+
+	nlohmann::json oBenchmarks = nlohmann::json::array();
+
+	for( const BenchmarkEntry& oEntry : GetBenchmarks() )
+	{
+		if( sFilter != nullptr && strstr( oEntry.m_sName, sFilter ) == nullptr )
+			continue;
+
+		if( bList )
+		{
+			printf( "%s\n", oEntry.m_sName );
+			continue;
+		}
+
+		BenchmarkState oState( oEntry.m_sName, uSampleCount, oSampleTime );
+		oEntry.m_pFunction( oState );
+
+		const BenchmarkResult& oResult = oState.GetResult();
+
+		nlohmann::json oBenchmark;
+		oBenchmark[ "name" ] = oResult.m_sName;
+		oBenchmark[ "iterations" ] = oResult.m_uIterations;
+		oBenchmark[ "samples" ] = oResult.m_uSampleCount;
+		oBenchmark[ "min_ns" ] = oResult.m_fMinNs;
+		oBenchmark[ "median_ns" ] = oResult.m_fMedianNs;
+		oBenchmark[ "mean_ns" ] = oResult.m_fMeanNs;
+		oBenchmark[ "max_ns" ] = oResult.m_fMaxNs;
+
+		std::string sThroughput;
+		if( oResult.m_uItemsPerIteration != 0 )
+		{
+			oBenchmark[ "items_per_iteration" ] = oResult.m_uItemsPerIteration;
+			oBenchmark[ "items_per_second" ] = oResult.m_uItemsPerIteration * 1e9 / oResult.m_fMedianNs;
+			sThroughput += std::format( " {:>14.0f} items/s", oResult.m_uItemsPerIteration * 1e9 / oResult.m_fMedianNs );
+		}
+
+		if( oResult.m_uBytesPerIteration != 0 )
+		{
+			oBenchmark[ "bytes_per_iteration" ] = oResult.m_uBytesPerIteration;
+			oBenchmark[ "bytes_per_second" ] = oResult.m_uBytesPerIteration * 1e9 / oResult.m_fMedianNs;
+			sThroughput += std::format( " {:>10.1f} MB/s", oResult.m_uBytesPerIteration * 1e3 / oResult.m_fMedianNs );
+		}
+
+		oBenchmarks.push_back( oBenchmark );
+
+		// Progress goes to the error output so the results alone can be redirected
+		fprintf( stderr, "%s\n", std::format( "{:<40} {:>14.1f} ns (min {:.1f}, max {:.1f}){}", oResult.m_sName, oResult.m_fMedianNs, oResult.m_fMinNs, oResult.m_fMaxNs, sThroughput ).c_str() );
+	}
+
+	if( bList )
+		return 0;
+
+	nlohmann::json oResults;
+	oResults[ "date" ] = std::format( "{:%Y-%m-%d %H:%M:%S}", std::chrono::floor< std::chrono::seconds >( std::chrono::system_clock::now() ) );
+#if defined( _MSC_VER )
+	oResults[ "compiler" ] = std::format( "msvc {}", _MSC_VER );
+#elif defined( __clang__ )
+	oResults[ "compiler" ] = std::format( "clang {}.{}", __clang_major__, __clang_minor__ );
+#elif defined( __GNUC__ )
+	oResults[ "compiler" ] = std::format( "gcc {}.{}", __GNUC__, __GNUC_MINOR__ );
+#endif
+#ifdef NDEBUG
+	oResults[ "configuration" ] = "release";
+#else
+	oResults[ "configuration" ] = "debug";
+#endif
+	oResults[ "benchmarks" ] = oBenchmarks;
+
+	if( sOutput == nullptr )
+	{
+		std::cout << oResults.dump( 4 ) << std::endl;
+		return 0;
+	}
+
+	std::ofstream oOutputStream( sOutput );
+	if( oOutputStream.is_open() == false )
+	{
+		fprintf( stderr, "Cannot write %s\n", sOutput );
+		return -1;
+	}
+
+	oOutputStream << oResults.dump( 4 ) << std::endl;
+	return 0;
+}
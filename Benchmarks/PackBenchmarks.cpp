@@ -0,0 +1,110 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+// Implemented by ResourceLoader.cpp in the engine, packs only need its zlib decoder
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "Benchmark.h"
+#include "Core/PackFile.h"
+#include "Core/stb_image.h"
+#include "Core/VirtualFileSystem.h"
+
+static const uint PACK_FILE_COUNT = 2048;
+
+// Many small assets spread in a few directories, text like so that they can be compressed
+struct PackBenchmarkData
+{
+	PackBenchmarkData()
+		: m_oDirectory( std::filesystem::temp_directory_path() / "GameEngineBenchmarks" / "Data" )
+		, m_uTotalSize( 0 )
+	{
+		std::mt19937 oGenerator( 42 );
+		std::uniform_int_distribution< uint > oSizeDistribution( 512, 16 * 1024 );
+		std::uniform_int_distribution< int > oCharacterDistribution( 'a', 'h' );
+
+		std::filesystem::remove_all( m_oDirectory );
+
+		for( uint u = 0; u < PACK_FILE_COUNT; ++u )
+		{
+			const std::string sPath = "Data/Folder" + std::to_string( u % 16 ) + "/Asset" + std::to_string( u ) + ".json";
+			const std::filesystem::path oFilePath = m_oDirectory.parent_path() / sPath;
+			std::filesystem::create_directories( oFilePath.parent_path() );
+
+			std::string sContent( oSizeDistribution( oGenerator ), ' ' );
+			for( char& cCharacter : sContent )
+				cCharacter = ( char )oCharacterDistribution( oGenerator );
+
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream.write( sContent.data(), sContent.length() );
+
+			m_aPaths.PushBack( oFilePath.generic_string() );
+			m_uTotalSize += sContent.length();
+		}
+
+		m_oPackPath = m_oDirectory.parent_path() / "Data.pack";
+		m_oCompressedPackPath = m_oDirectory.parent_path() / "DataCompressed.pack";
+		WritePackFile( m_oDirectory, m_oPackPath, false );
+		WritePackFile( m_oDirectory, m_oCompressedPackPath, true );
+	}
+
+	~PackBenchmarkData()
+	{
+		std::filesystem::remove_all( m_oDirectory.parent_path() );
+	}
+
+	std::filesystem::path	m_oDirectory;
+	std::filesystem::path	m_oPackPath;
+	std::filesystem::path	m_oCompressedPackPath;
+	Array< std::string >	m_aPaths;
+	uint64					m_uTotalSize;
+};
+
+static const PackBenchmarkData& GetPackBenchmarkData()
+{
+	static const PackBenchmarkData s_oData;
+	return s_oData;
+}
+
+// Checks then reads every file the way load commands do, files stay in the system cache so this is a warm load
+static void LoadAll( BenchmarkState& oState, const VirtualFileSystem& oVirtualFileSystem )
+{
+	const PackBenchmarkData& oData = GetPackBenchmarkData();
+
+	oState.SetItemsPerIteration( oData.m_aPaths.Count() );
+	oState.SetBytesPerIteration( oData.m_uTotalSize );
+	oState.Measure( [ & ]() {
+		uint64 uSum = 0;
+		for( const std::string& sPath : oData.m_aPaths )
+		{
+			if( oVirtualFileSystem.Exists( sPath ) == false )
+				continue;
+
+			const VirtualFile oVirtualFile = oVirtualFileSystem.Open( sPath );
+			uSum += oVirtualFile.GetData().Back();
+		}
+
+		DoNotOptimize( uSum );
+	} );
+}
+
+BENCHMARK( PackLooseFiles )
+{
+	const VirtualFileSystem oVirtualFileSystem;
+	LoadAll( oState, oVirtualFileSystem );
+}
+
+BENCHMARK( PackMounted )
+{
+	VirtualFileSystem oVirtualFileSystem;
+	oVirtualFileSystem.Mount( GetPackBenchmarkData().m_oPackPath, GetPackBenchmarkData().m_oDirectory.generic_string() );
+	LoadAll( oState, oVirtualFileSystem );
+}
+
+BENCHMARK( PackMountedCompressed )
+{
+	VirtualFileSystem oVirtualFileSystem;
+	oVirtualFileSystem.Mount( GetPackBenchmarkData().m_oCompressedPackPath, GetPackBenchmarkData().m_oDirectory.generic_string() );
+	LoadAll( oState, oVirtualFileSystem );
+}
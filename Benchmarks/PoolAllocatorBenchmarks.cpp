@@ -0,0 +1,152 @@
+#include <thread>
+
+#include "Benchmark.h"
+#include "Core/PoolAllocator.h"
+
+static const uint CHURN_SLOT_COUNT = 10000;
+static const uint CHURN_OPERATION_COUNT = 100000;
+static const uint CHURN_THREAD_COUNT = 4;
+
+struct SmallPooledElement
+{
+	DECLARE_POOL_ALLOCATOR()
+
+	uint64	m_aPayload[ 2 ];
+};
+
+struct PooledElement
+{
+	DECLARE_POOL_ALLOCATOR()
+
+	virtual ~PooledElement()
+	{
+	}
+
+	uint64	m_uValue;
+	float	m_aPayload[ 12 ];
+};
+
+struct LargePooledElement
+{
+	DECLARE_POOL_ALLOCATOR()
+
+	float	m_aPayload[ 64 ];
+};
+
+DEFINE_POOL_ALLOCATOR( SmallPooledElement, 256 )
+DEFINE_POOL_ALLOCATOR( PooledElement, 64 )
+DEFINE_POOL_ALLOCATOR( LargePooledElement, 32 )
+
+struct SmallHeapElement
+{
+	uint64	m_aPayload[ 2 ];
+};
+
+struct HeapElement
+{
+	virtual ~HeapElement()
+	{
+	}
+
+	uint64	m_uValue;
+	float	m_aPayload[ 12 ];
+};
+
+struct LargeHeapElement
+{
+	float	m_aPayload[ 64 ];
+};
+
+template < typename T >
+static void Churn( Array< T* >& aElements, const uint uSlot )
+{
+	if( aElements[ uSlot ] != nullptr )
+	{
+		delete aElements[ uSlot ];
+		aElements[ uSlot ] = nullptr;
+	}
+	else
+	{
+		aElements[ uSlot ] = new T;
+	}
+}
+
+// Elements of three sizes are created and destroyed in a random order, like entities, components and visual nodes spawning during gameplay
+// Same sequence on every call, so that the pools and the heap go through the same operations
+template < typename SmallType, typename MediumType, typename LargeType >
+static void ChurnElements( const uint uSeed )
+{
+	Array< SmallType* > aSmallElements( CHURN_SLOT_COUNT, nullptr );
+	Array< MediumType* > aMediumElements( CHURN_SLOT_COUNT, nullptr );
+	Array< LargeType* > aLargeElements( CHURN_SLOT_COUNT, nullptr );
+
+	uint uRandom = uSeed;
+	for( uint u = 0; u < CHURN_OPERATION_COUNT; ++u )
+	{
+		uRandom = uRandom * 1664525u + 1013904223u;
+		const uint uSlot = ( uRandom >> 8 ) % CHURN_SLOT_COUNT;
+
+		// Half of the operations are on the medium size
+		switch( uRandom >> 30 )
+		{
+		case 0:
+			Churn( aSmallElements, uSlot );
+			break;
+		case 3:
+			Churn( aLargeElements, uSlot );
+			break;
+		default:
+			Churn( aMediumElements, uSlot );
+			break;
+		}
+	}
+
+	for( SmallType* pElement : aSmallElements )
+		delete pElement;
+	for( MediumType* pElement : aMediumElements )
+		delete pElement;
+	for( LargeType* pElement : aLargeElements )
+		delete pElement;
+
+	DoNotOptimize( uRandom );
+}
+
+// Several threads churn at once, as the jobs spawning entities do
+template < typename SmallType, typename MediumType, typename LargeType >
+static void ChurnElementsThreaded()
+{
+	Array< std::thread* > aThreads;
+	for( uint uThread = 0; uThread < CHURN_THREAD_COUNT; ++uThread )
+		aThreads.PushBack( new std::thread( &ChurnElements< SmallType, MediumType, LargeType >, 12345 + uThread ) );
+
+	for( std::thread* pThread : aThreads )
+	{
+		pThread->join();
+		delete pThread;
+	}
+}
+
+BENCHMARK( PoolAllocatorChurn )
+{
+	oState.SetItemsPerIteration( CHURN_OPERATION_COUNT );
+	oState.Measure( []() { ChurnElements< SmallPooledElement, PooledElement, LargePooledElement >( 12345 ); } );
+}
+
+BENCHMARK( HeapChurn )
+{
+	oState.SetItemsPerIteration( CHURN_OPERATION_COUNT );
+	oState.Measure( []() { ChurnElements< SmallHeapElement, HeapElement, LargeHeapElement >( 12345 ); } );
+}
+
+// Threads take their elements from their own free lists, the shared one is only locked once per batch
+BENCHMARK( PoolAllocatorChurnThreaded )
+{
+	oState.SetItemsPerIteration( CHURN_OPERATION_COUNT * CHURN_THREAD_COUNT );
+	oState.Measure( []() { ChurnElementsThreaded< SmallPooledElement, PooledElement, LargePooledElement >(); } );
+}
+
+BENCHMARK( HeapChurnThreaded )
+{
+	oState.SetItemsPerIteration( CHURN_OPERATION_COUNT * CHURN_THREAD_COUNT );
+	oState.Measure( []() { ChurnElementsThreaded< SmallHeapElement, HeapElement, LargeHeapElement >(); } );
+}
@@ -0,0 +1,114 @@
+#include <random>
+#include <string>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <nlohmann/json.hpp>
+
+#include "Benchmark.h"
+#include "Core/GLMSerialization.h"
+
+static const uint SCENE_ENTITY_COUNT = 2048;
+
+// A scene in the format written by Scene::Save, with a hierarchy of entities holding visual and terrain components
+static std::string GenerateScene()
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oPositionDistribution( -500.f, 500.f );
+	std::uniform_int_distribution< int > oResolutionDistribution( 6, 10 );
+
+	nlohmann::json aEntities = nlohmann::json::array();
+	for( uint u = 0; u < SCENE_ENTITY_COUNT; ++u )
+	{
+		nlohmann::json oEntity;
+		oEntity[ "id" ] = 1000 + u;
+		oEntity[ "name" ] = "Entity_" + std::to_string( u );
+		if( u % 8 != 0 )
+			oEntity[ "parentId" ] = 1000 + u - u % 8;
+
+		oEntity[ "position" ] = glm::vec3( oPositionDistribution( oGenerator ), oPositionDistribution( oGenerator ), oPositionDistribution( oGenerator ) );
+		oEntity[ "rotation" ] = glm::quat( 1.f, 0.f, 0.f, 0.f );
+		oEntity[ "scale" ] = glm::vec3( 1.f );
+
+		nlohmann::json aComponents = nlohmann::json::array();
+		if( u % 4 == 0 )
+		{
+			nlohmann::json oComponent;
+			oComponent[ "name" ] = "TerrainChunkComponent";
+			oComponent[ "properties" ] = nlohmann::json::array( { { { "Width resolution", 1 << oResolutionDistribution( oGenerator ) } }, { { "Height resolution", 1 << oResolutionDistribution( oGenerator ) } },
+				{ { "Has collisions", u % 8 == 0 } }, { { "Chunk index", u / 4 } } } );
+			aComponents.push_back( oComponent );
+		}
+		else
+		{
+			nlohmann::json oComponent;
+			oComponent[ "name" ] = "VisualComponent";
+			oComponent[ "properties" ] = nlohmann::json::array( { { { "Model", "Sphere.obj" } } } );
+			aComponents.push_back( oComponent );
+		}
+		oEntity[ "components" ] = aComponents;
+
+		aEntities.push_back( oEntity );
+	}
+
+	nlohmann::json oScene;
+	oScene[ "scene" ] = aEntities;
+
+	return oScene.dump( 4 );
+}
+
+BENCHMARK( SceneParse )
+{
+	const std::string sScene = GenerateScene();
+
+	oState.SetBytesPerIteration( sScene.length() );
+	oState.Measure( [ & ]() {
+		const nlohmann::json oJsonContent = nlohmann::json::parse( sScene );
+		DoNotOptimize( oJsonContent.size() );
+	} );
+}
+
+// Reads entities and components the way Scene::Load does, without creating them
+BENCHMARK( SceneLoad )
+{
+	const std::string sScene = GenerateScene();
+
+	oState.SetItemsPerIteration( SCENE_ENTITY_COUNT );
+	oState.Measure( [ & ]() {
+		const nlohmann::json oJsonContent = nlohmann::json::parse( sScene );
+
+		glm::vec3 vSum( 0.f );
+		uint64 uIDSum = 0;
+		uint uPropertyCount = 0;
+		for( const auto& oEntityIt : oJsonContent[ "scene" ].items() )
+		{
+			const nlohmann::json& oEntity = oEntityIt.value();
+
+			const uint64 uEntityID = oEntity[ "id" ];
+			const std::string& sName = oEntity[ "name" ];
+			const glm::vec3 vPosition = oEntity[ "position" ];
+			const glm::quat qRotation = oEntity[ "rotation" ];
+			const glm::vec3 vScale = oEntity[ "scale" ];
+
+			uIDSum += uEntityID + sName.length();
+			if( oEntity.contains( "parentId" ) )
+				uIDSum += oEntity[ "parentId" ].get< uint64 >();
+
+			vSum += vPosition * vScale + glm::vec3( qRotation.x, qRotation.y, qRotation.z );
+
+			for( const auto& oComponentIt : oEntity[ "components" ].items() )
+			{
+				const nlohmann::json& oComponent = oComponentIt.value();
+
+				const std::string& sComponentName = oComponent[ "name" ];
+				uIDSum += sComponentName.length();
+
+				for( const auto& oPropertyIt : oComponent[ "properties" ].items() )
+					uPropertyCount += ( uint )oPropertyIt.value().size();
+			}
+		}
+
+		DoNotOptimize( vSum );
+		DoNotOptimize( uIDSum + uPropertyCount );
+	} );
+}
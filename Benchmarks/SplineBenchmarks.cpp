@@ -0,0 +1,77 @@
+#include <random>
+
+#include "Benchmark.h"
+#include "Math/Spline.h"
+
+// A road like path, moving forward with random turns and slopes
+static Spline GenerateSpline( const uint uControlPointCount )
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oTurnDistribution( -0.5f, 0.5f );
+	std::uniform_real_distribution< float > oSlopeDistribution( -2.f, 2.f );
+
+	Array< glm::vec3 > aControlPoints( uControlPointCount );
+
+	glm::vec3 vPosition( 0.f );
+	float fAngle = 0.f;
+	for( glm::vec3& vControlPoint : aControlPoints )
+	{
+		vControlPoint = vPosition;
+
+		fAngle += oTurnDistribution( oGenerator );
+		vPosition += glm::vec3( 20.f * glm::cos( fAngle ), oSlopeDistribution( oGenerator ), 20.f * glm::sin( fAngle ) );
+	}
+
+	return Spline( aControlPoints );
+}
+
+BENCHMARK( SplineRebuildDistances )
+{
+	const uint uControlPointCount = 64;
+	Spline oSpline = GenerateSpline( uControlPointCount );
+
+	oState.SetItemsPerIteration( uControlPointCount - 1 );
+	oState.Measure( [ & ]() {
+		oSpline.RebuildDistances();
+		DoNotOptimize( oSpline.GetLength() );
+	} );
+}
+
+BENCHMARK( SplineComputeDistance )
+{
+	const uint uQueryCount = 256;
+	const Spline oSpline = GenerateSpline( 64 );
+
+	std::mt19937 oGenerator( 42 );
+	std::uniform_real_distribution< float > oDistribution( 0.f, 1.f );
+
+	Array< float > aRatios( 2 * uQueryCount );
+	for( float& fRatio : aRatios )
+		fRatio = oDistribution( oGenerator );
+
+	oState.SetItemsPerIteration( uQueryCount );
+	oState.Measure( [ & ]() {
+		float fSum = 0.f;
+		for( uint u = 0; u < uQueryCount; ++u )
+			fSum += oSpline.ComputeDistance( glm::min( aRatios[ 2 * u ], aRatios[ 2 * u + 1 ] ), glm::max( aRatios[ 2 * u ], aRatios[ 2 * u + 1 ] ) );
+
+		DoNotOptimize( fSum );
+	} );
+}
+
+BENCHMARK( SplineIteratorMoveForward )
+{
+	const Spline oSpline = GenerateSpline( 64 );
+	const float fStepDistance = 1.f;
+
+	oState.SetItemsPerIteration( ( uint64 )( oSpline.GetLength() / fStepDistance ) );
+	oState.Measure( [ & ]() {
+		SplineIterator oIterator( oSpline );
+
+		glm::vec3 vSum( 0.f );
+		while( oIterator.MoveForward( fStepDistance ) )
+			vSum += oIterator.ComputePosition();
+
+		DoNotOptimize( vSum );
+	} );
+}
@@ -0,0 +1,44 @@
+#include <random>
+
+#include "Benchmark.h"
+#include "Math/MathUtils.h"
+
+// Smooth hills made of a few sine waves plus some noise, stored like the 16 bits height maps of terrains
+static Array< uint16 > GenerateHeightMap( const int iWidth, const int iHeight )
+{
+	std::mt19937 oGenerator( 42 );
+	std::uniform_int_distribution< int > oNoiseDistribution( -256, 256 );
+
+	Array< uint16 > aHeightMap( iWidth * iHeight );
+	for( int iY = 0; iY < iHeight; ++iY )
+	{
+		for( int iX = 0; iX < iWidth; ++iX )
+		{
+			const float fHeight = 0.5f + 0.25f * glm::sin( iX * 0.02f ) * glm::cos( iY * 0.03f ) + 0.1f * glm::sin( ( iX + iY ) * 0.1f );
+			aHeightMap[ iY * iWidth + iX ] = ( uint16 )glm::clamp( ( int )( fHeight * 65535.f ) + oNoiseDistribution( oGenerator ), 0, 65535 );
+		}
+	}
+
+	return aHeightMap;
+}
+
+BENCHMARK( TerrainSampleHeightMap )
+{
+	const int iWidth = 1024;
+	const int iHeight = 1024;
+	const uint uResolution = 256;
+	const Array< uint16 > aHeightMap = GenerateHeightMap( iWidth, iHeight );
+
+	// One sample per vertex of a chunk covering the whole height map, as when generating its mesh
+	oState.SetItemsPerIteration( ( uResolution + 1 ) * ( uResolution + 1 ) );
+	oState.Measure( [ & ]() {
+		float fSum = 0.f;
+		for( uint uY = 0; uY <= uResolution; ++uY )
+		{
+			for( uint uX = 0; uX <= uResolution; ++uX )
+				fSum += SampleHeightMap( glm::vec2( ( float )uX / uResolution, ( float )uY / uResolution ), aHeightMap.Data(), iWidth, iHeight );
+		}
+
+		DoNotOptimize( fSum );
+	} );
+}
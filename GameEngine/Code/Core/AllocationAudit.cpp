@@ -0,0 +1,305 @@
+#include "AllocationAudit.h"
+
+#include <cstdlib>
+#include <format>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_set>
+
+#include "Common.h"
+#include "Logger.h"
+
+static constexpr uint MAX_SCOPE_DEPTH = 64;
+// Allocations made while evaluating the arguments of a constructor come between the object and its constructor
+static constexpr uint ALLOCATED_OBJECT_HISTORY = 8;
+
+struct AllocatedObject
+{
+	const uint8*	m_pPtr;
+	uint64			m_uBytes;
+	const void*		m_pCallSite;
+};
+
+struct AllocationAuditThreadState
+{
+	AllocationCounters	m_oCounters;
+	const char*			m_aScopes[ MAX_SCOPE_DEPTH ];
+	uint				m_uScopeDepth;
+	AllocatedObject		m_aAllocatedObjects[ ALLOCATED_OBJECT_HISTORY ];
+	uint				m_uAllocatedObjectCount;
+	bool				m_bSteadyState;
+	bool				m_bReporting;
+};
+
+static thread_local AllocationAuditThreadState s_oThreadState = {};
+
+AllocationCounters::AllocationCounters()
+	: m_uAllocationCount( 0 )
+	, m_uAllocatedBytes( 0 )
+	, m_uFreeCount( 0 )
+	, m_uFreedBytes( 0 )
+	, m_uIntrusiveCount( 0 )
+{
+}
+
+AllocationCounters AllocationCounters::operator-( const AllocationCounters& oOther ) const
+{
+	AllocationCounters oCounters;
+	oCounters.m_uAllocationCount = m_uAllocationCount - oOther.m_uAllocationCount;
+	oCounters.m_uAllocatedBytes = m_uAllocatedBytes - oOther.m_uAllocatedBytes;
+	oCounters.m_uFreeCount = m_uFreeCount - oOther.m_uFreeCount;
+	oCounters.m_uFreedBytes = m_uFreedBytes - oOther.m_uFreedBytes;
+	oCounters.m_uIntrusiveCount = m_uIntrusiveCount - oOther.m_uIntrusiveCount;
+
+	return oCounters;
+}
+
+const AllocationCounters& AllocationAudit::GetThreadCounters()
+{
+	return s_oThreadState.m_oCounters;
+}
+
+void AllocationAudit::OnAllocation( const uint64 uBytes, const void* pCallSite )
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	++oState.m_oCounters.m_uAllocationCount;
+	oState.m_oCounters.m_uAllocatedBytes += uBytes;
+
+	if( oState.m_bSteadyState && oState.m_bReporting == false )
+	{
+		oState.m_bReporting = true;
+		ReportSteadyStateAllocation( "Allocation", uBytes, std::format( "{}", pCallSite ) );
+		oState.m_bReporting = false;
+	}
+}
+
+void AllocationAudit::OnAllocation( const uint64 uBytes, const std::source_location& oCallSite )
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	++oState.m_oCounters.m_uAllocationCount;
+	oState.m_oCounters.m_uAllocatedBytes += uBytes;
+
+	if( oState.m_bSteadyState && oState.m_bReporting == false )
+	{
+		oState.m_bReporting = true;
+		ReportSteadyStateAllocation( "Allocation", uBytes, std::format( "{}({})", oCallSite.file_name(), oCallSite.line() ) );
+		oState.m_bReporting = false;
+	}
+}
+
+void AllocationAudit::OnFree( const uint64 uBytes )
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	++oState.m_oCounters.m_uFreeCount;
+	oState.m_oCounters.m_uFreedBytes += uBytes;
+}
+
+void AllocationAudit::OnObjectAllocated( const void* pPtr, const uint64 uBytes, const void* pCallSite )
+{
+	// What reporting allocates would push the objects being built out of the history
+	AllocationAuditThreadState& oState = s_oThreadState;
+	if( oState.m_bReporting )
+		return;
+
+	oState.m_aAllocatedObjects[ oState.m_uAllocatedObjectCount++ % ALLOCATED_OBJECT_HISTORY ] = AllocatedObject { ( const uint8* )pPtr, uBytes, pCallSite };
+}
+
+void AllocationAudit::OnIntrusiveCreated( const void* pObject, const void* pCallSite )
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	++oState.m_oCounters.m_uIntrusiveCount;
+
+	// Newest first, the base of an object with several bases may not be at its start
+	const uint uCount = oState.m_uAllocatedObjectCount < ALLOCATED_OBJECT_HISTORY ? oState.m_uAllocatedObjectCount : ALLOCATED_OBJECT_HISTORY;
+	for( uint u = 1; u <= uCount; ++u )
+	{
+		AllocatedObject& oObject = oState.m_aAllocatedObjects[ ( oState.m_uAllocatedObjectCount - u ) % ALLOCATED_OBJECT_HISTORY ];
+		if( pObject >= oObject.m_pPtr && pObject < oObject.m_pPtr + oObject.m_uBytes )
+		{
+			pCallSite = oObject.m_pCallSite;
+			oObject.m_pPtr = nullptr;
+			oObject.m_uBytes = 0;
+			break;
+		}
+	}
+
+	if( oState.m_bSteadyState && oState.m_bReporting == false )
+	{
+		oState.m_bReporting = true;
+		ReportSteadyStateAllocation( "Intrusive creation", 0, std::format( "{}", pCallSite ) );
+		oState.m_bReporting = false;
+	}
+}
+
+void AllocationAudit::SetSteadyState( const bool bSteadyState )
+{
+	s_oThreadState.m_bSteadyState = bSteadyState;
+}
+
+bool AllocationAudit::IsSteadyState()
+{
+	return s_oThreadState.m_bSteadyState;
+}
+
+void AllocationAudit::PushScope( const char* sName )
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	if( oState.m_uScopeDepth < MAX_SCOPE_DEPTH )
+		oState.m_aScopes[ oState.m_uScopeDepth ] = sName;
+
+	++oState.m_uScopeDepth;
+}
+
+void AllocationAudit::PopScope()
+{
+	AllocationAuditThreadState& oState = s_oThreadState;
+	ASSERT( oState.m_uScopeDepth > 0 );
+	--oState.m_uScopeDepth;
+}
+
+// Anything allocated while reporting would be reported in turn, callers flag the thread as reporting first
+void AllocationAudit::ReportSteadyStateAllocation( const char* sKind, const uint64 uBytes, const std::string& sCallSite )
+{
+	static std::mutex s_oMutex;
+	static std::unordered_set< std::string > s_sReportedCallSites;
+
+	const AllocationAuditThreadState& oState = s_oThreadState;
+
+	std::unique_lock oLock( s_oMutex );
+	if( s_sReportedCallSites.insert( sCallSite ).second == false )
+		return;
+
+	std::string sScopes;
+	const uint uDepth = oState.m_uScopeDepth < MAX_SCOPE_DEPTH ? oState.m_uScopeDepth : MAX_SCOPE_DEPTH;
+	for( uint u = 0; u < uDepth; ++u )
+	{
+		if( u != 0 )
+			sScopes += " > ";
+		sScopes += oState.m_aScopes[ u ];
+	}
+
+	LOG_WARN( "{} of {} bytes during steady state from {} in [{}]", sKind, uBytes, sCallSite, sScopes.empty() ? "no profiler block" : sScopes );
+}
+
+AllocationAuditIgnore::AllocationAuditIgnore()
+	: m_bPreviousSteadyState( AllocationAudit::IsSteadyState() )
+{
+	AllocationAudit::SetSteadyState( false );
+}
+
+AllocationAuditIgnore::~AllocationAuditIgnore()
+{
+	AllocationAudit::SetSteadyState( m_bPreviousSteadyState );
+}
+
+#ifdef AUDIT_ALLOCATIONS
+
+// The size of each block is stored right before it, unsized deletes could not report the freed bytes otherwise
+// The header takes a whole alignment so that the block keeps the alignment it was asked for
+static std::size_t GetHeaderSize( const std::size_t uAlignment )
+{
+	return uAlignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? uAlignment : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+static void* AllocateBlock( const std::size_t uSize, const std::size_t uAlignment, const void* pCallSite )
+{
+	const std::size_t uHeaderSize = GetHeaderSize( uAlignment );
+	if( uSize > SIZE_MAX - uHeaderSize - uAlignment )
+		throw std::bad_alloc();
+
+#ifdef _MSC_VER
+	uint8* pBlock = ( uint8* )_aligned_malloc( uHeaderSize + uSize, uHeaderSize );
+#else
+	uint8* pBlock = ( uint8* )aligned_alloc( uHeaderSize, ( uHeaderSize + uSize + uHeaderSize - 1 ) & ~( uHeaderSize - 1 ) );
+#endif
+	if( pBlock == nullptr )
+		throw std::bad_alloc();
+
+	uint8* pPtr = pBlock + uHeaderSize;
+	memcpy( pPtr - sizeof( std::size_t ), &uSize, sizeof( std::size_t ) );
+
+	AllocationAudit::OnAllocation( uSize, pCallSite );
+	AllocationAudit::OnObjectAllocated( pPtr, uSize, pCallSite );
+	return pPtr;
+}
+
+static void FreeBlock( void* pPtr, const std::size_t uAlignment )
+{
+	if( pPtr == nullptr )
+		return;
+
+	uint8* pBlock = ( uint8* )pPtr - GetHeaderSize( uAlignment );
+
+	std::size_t uSize = 0;
+	memcpy( &uSize, ( uint8* )pPtr - sizeof( std::size_t ), sizeof( std::size_t ) );
+	AllocationAudit::OnFree( uSize );
+
+#ifdef _MSC_VER
+	_aligned_free( pBlock );
+#else
+	free( pBlock );
+#endif
+}
+
+void* operator new( const std::size_t uSize )
+{
+	return AllocateBlock( uSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__, ALLOCATION_CALL_SITE() );
+}
+
+void* operator new[]( const std::size_t uSize )
+{
+	return AllocateBlock( uSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__, ALLOCATION_CALL_SITE() );
+}
+
+void* operator new( const std::size_t uSize, const std::align_val_t eAlignment )
+{
+	return AllocateBlock( uSize, ( std::size_t )eAlignment, ALLOCATION_CALL_SITE() );
+}
+
+void* operator new[]( const std::size_t uSize, const std::align_val_t eAlignment )
+{
+	return AllocateBlock( uSize, ( std::size_t )eAlignment, ALLOCATION_CALL_SITE() );
+}
+
+void operator delete( void* pPtr ) noexcept
+{
+	FreeBlock( pPtr, __STDCPP_DEFAULT_NEW_ALIGNMENT__ );
+}
+
+void operator delete[]( void* pPtr ) noexcept
+{
+	FreeBlock( pPtr, __STDCPP_DEFAULT_NEW_ALIGNMENT__ );
+}
+
+void operator delete( void* pPtr, const std::size_t /*uSize*/ ) noexcept
+{
+	FreeBlock( pPtr, __STDCPP_DEFAULT_NEW_ALIGNMENT__ );
+}
+
+void operator delete[]( void* pPtr, const std::size_t /*uSize*/ ) noexcept
+{
+	FreeBlock( pPtr, __STDCPP_DEFAULT_NEW_ALIGNMENT__ );
+}
+
+void operator delete( void* pPtr, const std::align_val_t eAlignment ) noexcept
+{
+	FreeBlock( pPtr, ( std::size_t )eAlignment );
+}
+
+void operator delete[]( void* pPtr, const std::align_val_t eAlignment ) noexcept
+{
+	FreeBlock( pPtr, ( std::size_t )eAlignment );
+}
+
+void operator delete( void* pPtr, const std::size_t /*uSize*/, const std::align_val_t eAlignment ) noexcept
+{
+	FreeBlock( pPtr, ( std::size_t )eAlignment );
+}
+
+void operator delete[]( void* pPtr, const std::size_t /*uSize*/, const std::align_val_t eAlignment ) noexcept
+{
+	FreeBlock( pPtr, ( std::size_t )eAlignment );
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <source_location>
+#include <string>
+
+#include "Types.h"
+
+struct AllocationCounters
+{
+	AllocationCounters();
+
+	AllocationCounters operator-( const AllocationCounters& oOther ) const;
+
+	uint64	m_uAllocationCount;
+	uint64	m_uAllocatedBytes;
+	uint64	m_uFreeCount;
+	uint64	m_uFreedBytes;
+	uint64	m_uIntrusiveCount;
+};
+
+// Counts heap allocations made by the calling thread, fed by Array, the global operator new / delete and Intrusive construction
+// Hooks are only compiled with AUDIT_ALLOCATIONS defined, counters stay at zero otherwise
+// A thread flagged as steady state logs the call site of any allocation it makes, once per call site
+// Array reports the source location of the call that allocated, operator new reports a return address
+// Intrusive objects report the new expression which created them, looked up among the last objects allocated by the thread
+class AllocationAudit
+{
+public:
+	static const AllocationCounters&	GetThreadCounters();
+
+	static void							OnAllocation( const uint64 uBytes, const void* pCallSite );
+	static void							OnAllocation( const uint64 uBytes, const std::source_location& oCallSite );
+	static void							OnFree( const uint64 uBytes );
+	// Called by operator new and the pool allocators, pooled objects are not counted as allocations
+	static void							OnObjectAllocated( const void* pPtr, const uint64 uBytes, const void* pCallSite );
+	// Objects not found among the last ones allocated, such as the ones on the stack, report the call site given
+	static void							OnIntrusiveCreated( const void* pObject, const void* pCallSite );
+
+	static void							SetSteadyState( const bool bSteadyState );
+	static bool							IsSteadyState();
+
+	static void							PushScope( const char* sName );
+	static void							PopScope();
+
+private:
+	static void							ReportSteadyStateAllocation( const char* sKind, const uint64 uBytes, const std::string& sCallSite );
+};
+
+// Allocations made by debug tools during steady state frames are expected, they are not reported while one of these is alive
+class AllocationAuditIgnore
+{
+public:
+	AllocationAuditIgnore();
+	~AllocationAuditIgnore();
+
+private:
+	bool m_bPreviousSteadyState;
+};
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ALLOCATION_CALL_SITE() _ReturnAddress()
+#else
+#define ALLOCATION_CALL_SITE() __builtin_return_address( 0 )
+#endif
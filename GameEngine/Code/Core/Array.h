@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <source_location>
 #include <type_traits>
 
 #include "Common.h"
@@ -11,6 +12,10 @@
 #include "MemoryTracker.h"
 #endif
 
+#ifdef AUDIT_ALLOCATIONS
+#include "AllocationAudit.h"
+#endif
+
 class ArrayBase
 {
 public:
@@ -40,9 +45,9 @@ public:
 		TrackMemory();
 	}
 
-	explicit Array( const uint uCount )
+	explicit Array( const uint uCount, const std::source_location& oCallSite = std::source_location::current() )
 		: ArrayBase( uCount, uCount )
-		, m_pData( ( T* )malloc( uCount * sizeof( T ) ) )
+		, m_pData( Allocate( uCount, oCallSite ) )
 	{
 		if constexpr( std::is_trivially_default_constructible_v< T > == false )
 		{
@@ -53,9 +58,9 @@ public:
 		TrackMemory();
 	}
 
-	Array( const uint uCount, const T& oValue )
+	Array( const uint uCount, const T& oValue, const std::source_location& oCallSite = std::source_location::current() )
 		: ArrayBase( uCount, uCount )
-		, m_pData( ( T* )malloc( uCount * sizeof( T ) ) )
+		, m_pData( Allocate( uCount, oCallSite ) )
 	{
 		if constexpr( std::is_trivially_copy_constructible_v< T > )
 		{
@@ -80,9 +85,9 @@ public:
 		TrackMemory();
 	}
 
-	Array( const Array& aArray )
+	Array( const Array& aArray, const std::source_location& oCallSite = std::source_location::current() )
 		: ArrayBase( aArray.m_uCount, aArray.m_uCapacity )
-		, m_pData( ( T* )malloc( aArray.m_uCount * sizeof( T ) ) )
+		, m_pData( Allocate( aArray.m_uCapacity, oCallSite ) )
 	{
 		if constexpr( std::is_trivially_copy_constructible_v< T > )
 		{
@@ -102,9 +107,12 @@ public:
 		if( &aArray == this )
 			return *this;
 
+		UnTrackMemory();
+
 		Destroy();
 
-		m_pData = ( T* )malloc( aArray.m_uCount * sizeof( T ) );
+		// Operators can't take the call site as a default argument, their allocations are reported from here
+		m_pData = Allocate( aArray.m_uCapacity, std::source_location::current() );
 		m_uCount = aArray.m_uCount;
 		m_uCapacity = aArray.m_uCapacity;
 
@@ -120,6 +128,8 @@ public:
 				::new( &m_pData[ u ] ) T( aArray[ u ] );
 		}
 
+		TrackMemory();
+
 		return *this;
 	}
 
@@ -127,11 +137,10 @@ public:
 		: ArrayBase( aArray.m_uCount, aArray.m_uCapacity )
 		, m_pData( aArray.m_pData )
 	{
+		// Memory is handed over from one array to the other, tracked amounts are unchanged
 		aArray.m_pData = nullptr;
 		aArray.m_uCount = 0;
 		aArray.m_uCapacity = 0;
-
-		TrackMemory();
 	}
 
 	Array& operator=( Array&& aArray ) noexcept
@@ -139,6 +148,8 @@ public:
 		if( &aArray == this )
 			return *this;
 
+		UnTrackMemory();
+
 		Destroy();
 
 		m_pData = aArray.m_pData;
@@ -165,9 +176,9 @@ public:
 		m_uCapacity = 0;
 	}
 
-	void PushBack()
+	void PushBack( const std::source_location& oCallSite = std::source_location::current() )
 	{
-		Expand();
+		Expand( 1, oCallSite );
 
 		ASSERT( m_pData != nullptr );
 		ASSERT( m_uCount < m_uCapacity );
@@ -176,11 +187,13 @@ public:
 			::new( &m_pData[ m_uCount ] ) T();
 
 		++m_uCount;
+
+		TrackMemory( m_uCount - 1, m_uCapacity );
 	}
 
-	void PushBack( const T& oElement )
+	void PushBack( const T& oElement, const std::source_location& oCallSite = std::source_location::current() )
 	{
-		Expand();
+		Expand( 1, oCallSite );
 
 		ASSERT( m_pData != nullptr );
 		ASSERT( m_uCount < m_uCapacity );
@@ -191,30 +204,33 @@ public:
 			::new( &m_pData[ m_uCount ] ) T( oElement );
 
 		++m_uCount;
+
+		TrackMemory( m_uCount - 1, m_uCapacity );
 	}
 
-	void PushFront( const T& oElement )
+	void PushFront( const T& oElement, const std::source_location& oCallSite = std::source_location::current() )
 	{
 		Array< T > aPush;
 		if( m_uCapacity < m_uCount + 1 )
-			aPush.Reserve( m_uCount + 1 );
+			aPush.Reserve( m_uCount + 1, oCallSite );
 		else
-			aPush.Reserve( m_uCapacity );
+			aPush.Reserve( m_uCapacity, oCallSite );
 
-		aPush.PushBack( oElement );
+		aPush.PushBack( oElement, oCallSite );
 
 		if constexpr( std::is_trivially_copy_constructible_v< T > )
 		{
 			memcpy( &aPush.m_pData[ 1 ], m_pData, m_uCount * sizeof( T ) );
 			aPush.m_uCount = m_uCount + 1;
+			aPush.TrackMemory( 1, aPush.m_uCapacity );
 		}
 		else
 		{
 			for( uint u = 0; u < m_uCount; ++u )
-				aPush.PushBack( m_pData[ u ] );
+				aPush.PushBack( m_pData[ u ], oCallSite );
 		}
 
-		*this = aPush;
+		Swap( aPush );
 	}
 
 	void PopBack()
@@ -225,6 +241,8 @@ public:
 		--m_uCount;
 		if( std::is_trivially_destructible_v< T > == false )
 			m_pData[ m_uCount ].~T();
+
+		TrackMemory( m_uCount + 1, m_uCapacity );
 	}
 
 	void PopFront()
@@ -257,6 +275,8 @@ public:
 		}
 
 		--m_uCount;
+
+		TrackMemory( m_uCount + 1, m_uCapacity );
 	}
 
 	void Clear()
@@ -267,7 +287,10 @@ public:
 				m_pData[ u ].~T();
 		}
 
+		const uint uPreviousCount = m_uCount;
 		m_uCount = 0;
+
+		TrackMemory( uPreviousCount, m_uCapacity );
 	}
 
 	void Swap( Array& aArray )
@@ -291,21 +314,24 @@ public:
 		aArray.Clear();
 	}
 
-	void Resize( const uint uCount )
+	void Resize( const uint uCount, const std::source_location& oCallSite = std::source_location::current() )
 	{
 		if( m_uCount < uCount )
 		{
 			const uint uExpansion = uCount - m_uCount;
-			Reserve( uCount );
+			Reserve( uCount, oCallSite );
 
 			if constexpr( std::is_trivially_default_constructible_v< T > )
 			{
+				const uint uPreviousCount = m_uCount;
 				m_uCount = uCount;
+
+				TrackMemory( uPreviousCount, m_uCapacity );
 			}
 			else
 			{
 				for( uint u = 0; u < uExpansion; ++u )
-					PushBack();
+					PushBack( oCallSite );
 			}
 		}
 		else if( m_uCount > uCount )
@@ -314,7 +340,10 @@ public:
 
 			if constexpr( std::is_trivially_destructible_v< T > )
 			{
+				const uint uPreviousCount = m_uCount;
 				m_uCount = uCount;
+
+				TrackMemory( uPreviousCount, m_uCapacity );
 			}
 			else
 			{
@@ -324,12 +353,12 @@ public:
 		}
 	}
 
-	void Resize( const uint uCount, const T& oValue )
+	void Resize( const uint uCount, const T& oValue, const std::source_location& oCallSite = std::source_location::current() )
 	{
 		if( m_uCount < uCount )
 		{
 			const uint uExpansion = uCount - m_uCount;
-			Reserve( uCount );
+			Reserve( uCount, oCallSite );
 
 			if constexpr( std::is_trivially_copy_constructible_v< T > )
 			{
@@ -345,12 +374,15 @@ public:
 						memcpy( &m_pData[ m_uCount + u ], &oValue, sizeof( T ) );
 				}
 
+				const uint uPreviousCount = m_uCount;
 				m_uCount = uCount;
+
+				TrackMemory( uPreviousCount, m_uCapacity );
 			}
 			else
 			{
 				for( uint u = 0; u < uExpansion; ++u )
-					PushBack( oValue );
+					PushBack( oValue, oCallSite );
 			}
 		}
 		else if( m_uCount > uCount )
@@ -359,7 +391,10 @@ public:
 
 			if constexpr( std::is_trivially_destructible_v< T > )
 			{
+				const uint uPreviousCount = m_uCount;
 				m_uCount = uCount;
+
+				TrackMemory( uPreviousCount, m_uCapacity );
 			}
 			else
 			{
@@ -369,11 +404,11 @@ public:
 		}
 	}
 
-	void Reserve( const uint uCount )
+	void Reserve( const uint uCount, const std::source_location& oCallSite = std::source_location::current() )
 	{
 		if( m_uCapacity < uCount )
 		{
-			T* pData = ( T* )malloc( uCount * sizeof( T ) );
+			T* pData = Allocate( uCount, oCallSite );
 
 			if constexpr( std::is_trivially_copy_constructible_v< T > )
 			{
@@ -387,29 +422,41 @@ public:
 
 			Destroy();
 
+			const uint uPreviousCapacity = m_uCapacity;
 			m_pData = pData;
 			m_uCapacity = uCount;
 
 			ASSERT( m_uCount <= m_uCapacity );
+
+			TrackMemory( m_uCount, uPreviousCapacity );
 		}
 	}
 
-	void Expand( uint uBy = 1 )
+	void Expand( uint uBy = 1, const std::source_location& oCallSite = std::source_location::current() )
 	{
 		if( m_uCapacity >= m_uCount + uBy )
 			return;
 
-		Reserve( m_uCount + uBy );
+		Reserve( m_uCount + uBy, oCallSite );
 	}
 
-	void ShrinkToFit()
+	void ShrinkToFit( const std::source_location& oCallSite = std::source_location::current() )
 	{
 		if( m_uCapacity == m_uCount )
 			return;
 
+#ifdef AUDIT_ALLOCATIONS
+		AllocationAudit::OnFree( m_uCapacity * sizeof( T ) );
+		if( m_uCount != 0 )
+			AllocationAudit::OnAllocation( m_uCount * sizeof( T ), oCallSite );
+#endif
+
 		m_pData = ( T* )realloc( m_pData, m_uCount * sizeof( T ) );
 
+		const uint uPreviousCapacity = m_uCapacity;
 		m_uCapacity = m_uCount;
+
+		TrackMemory( m_uCount, uPreviousCapacity );
 	}
 
 	T& Back()
@@ -491,34 +538,44 @@ public:
 	}
 
 private:
+	// The call site is captured by the public function the allocation comes from, rather than pointing inside Array
+	static T* Allocate( const uint uCount, const std::source_location& oCallSite )
+	{
+#ifdef AUDIT_ALLOCATIONS
+		if( uCount != 0 )
+			AllocationAudit::OnAllocation( uCount * sizeof( T ), oCallSite );
+#endif
+
+		return ( T* )malloc( uCount * sizeof( T ) );
+	}
+
 	void Destroy()
 	{
-		if constexpr( std::is_trivially_destructible_v< T > )
-		{
-			free( m_pData );
-		}
-		else
+		if constexpr( std::is_trivially_destructible_v< T > == false )
 		{
 			for( uint u = 0; u < m_uCount; ++u )
 				m_pData[ u ].~T();
-
-			free( m_pData );
 		}
+
+#ifdef AUDIT_ALLOCATIONS
+		if( m_uCapacity != 0 )
+			AllocationAudit::OnFree( m_uCapacity * sizeof( T ) );
+#endif
+
+		free( m_pData );
 	}
 
-	void TrackMemory()
+	void TrackMemory( const uint uPreviousCount = 0, const uint uPreviousCapacity = 0 )
 	{
 #ifdef TRACK_MEMORY
-		if( g_pMemoryTracker != nullptr )
-			g_pMemoryTracker->RegisterArray< T >( this );
+		MemoryTracker::GetArrayMemory< T >().Track( uPreviousCount, uPreviousCapacity, m_uCount, m_uCapacity );
 #endif
 	}
 
 	void UnTrackMemory()
 	{
 #ifdef TRACK_MEMORY
-		if( g_pMemoryTracker != nullptr )
-			g_pMemoryTracker->UnRegisterArray( this );
+		MemoryTracker::GetArrayMemory< T >().Track( m_uCount, m_uCapacity, 0, 0 );
 #endif
 	}
 
@@ -542,6 +599,12 @@ public:
 	{
 	}
 
+	ArrayView( T* pData, const uint uCount )
+		: m_pData( pData )
+		, m_uCount( uCount )
+	{
+	}
+
 	T& Back()
 	{
 		ASSERT( m_pData != nullptr );
@@ -0,0 +1,649 @@
+#include "AsyncFileReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+// Reads are split in chunks the size of which fits in a submission
+static constexpr uint64 ASYNC_READ_MAX_CHUNK_SIZE = 1ull << 30;
+// Read data is stored in an Array, the count of which is a uint
+static constexpr uint64 ASYNC_READ_MAX_SIZE = std::numeric_limits< uint >::max();
+
+AsyncRead::AsyncRead()
+	: m_uOffset( 0 )
+	, m_uSize( 0 )
+	, m_iPriority( 0 )
+	, m_pUserData( nullptr )
+	, m_eStatus( AsyncReadStatus::PENDING )
+	, m_bCancelled( false )
+	, m_iFile( -1 )
+	, m_uReadSize( 0 )
+	, m_uSequence( 0 )
+{
+}
+
+static bool ReadFileRange( AsyncRead& oRead )
+{
+	std::ifstream oFileStream( oRead.m_oFilePath, std::ios::binary );
+	if( oFileStream.is_open() == false )
+		return false;
+
+	uint64 uSize = oRead.m_uSize;
+	if( uSize == 0 )
+	{
+		oFileStream.seekg( 0, std::ios_base::end );
+		const uint64 uFileSize = ( uint64 )oFileStream.tellg();
+		if( uFileSize < oRead.m_uOffset )
+			return false;
+
+		uSize = uFileSize - oRead.m_uOffset;
+	}
+
+	if( uSize > ASYNC_READ_MAX_SIZE )
+		return false;
+
+	oRead.m_aData.Resize( ( uint )uSize );
+
+	oFileStream.seekg( oRead.m_uOffset, std::ios_base::beg );
+	oFileStream.read( ( char* )oRead.m_aData.Data(), uSize );
+
+	return ( uint64 )oFileStream.gcount() == uSize;
+}
+
+#ifdef __linux__
+
+struct AsyncFileReader::IOUring
+{
+	io_uring_sqe&	PushSubmission();
+	void			SubmitRead( AsyncRead* pRead, const int iFile, uint8* pBuffer, const uint64 uOffset, const uint64 uSize );
+
+	int				m_iRingFile;
+	int				m_iWakeUpFile;
+	bool			m_bWakeUpArmed;
+	uint			m_uToSubmit;
+
+	void*			m_pSubmissionRing;
+	uint64			m_uSubmissionRingSize;
+	void*			m_pCompletionRing;
+	uint64			m_uCompletionRingSize;
+	io_uring_sqe*	m_pEntries;
+	uint64			m_uEntriesSize;
+
+	uint32*			m_pSubmissionTail;
+	uint32			m_uSubmissionMask;
+	uint32*			m_pSubmissionArray;
+
+	uint32*			m_pCompletionHead;
+	uint32*			m_pCompletionTail;
+	uint32			m_uCompletionMask;
+	io_uring_cqe*	m_pCompletions;
+};
+
+// The user data of the wake up poll, reads use their address
+static constexpr uint64 IO_URING_WAKE_UP = 0;
+
+io_uring_sqe& AsyncFileReader::IOUring::PushSubmission()
+{
+	// Only the ring thread submits, and never more than the queue depth, so the submission ring cannot be full
+	const uint32 uTail = *m_pSubmissionTail;
+	const uint32 uIndex = uTail & m_uSubmissionMask;
+
+	io_uring_sqe& oEntry = m_pEntries[ uIndex ];
+	memset( &oEntry, 0, sizeof( io_uring_sqe ) );
+	m_pSubmissionArray[ uIndex ] = uIndex;
+
+	std::atomic_ref< uint32 >( *m_pSubmissionTail ).store( uTail + 1, std::memory_order_release );
+	++m_uToSubmit;
+
+	return oEntry;
+}
+
+void AsyncFileReader::IOUring::SubmitRead( AsyncRead* pRead, const int iFile, uint8* pBuffer, const uint64 uOffset, const uint64 uSize )
+{
+	io_uring_sqe& oEntry = PushSubmission();
+	oEntry.opcode = IORING_OP_READ;
+	oEntry.fd = iFile;
+	oEntry.addr = ( uint64 )pBuffer;
+	oEntry.len = ( uint32 )std::min( uSize, ASYNC_READ_MAX_CHUNK_SIZE );
+	oEntry.off = uOffset;
+	oEntry.user_data = ( uint64 )pRead;
+}
+
+bool AsyncFileReader::CreateIOUring()
+{
+	io_uring_params oParams = {};
+
+	// Completions may outnumber submissions with the wake up poll, the completion ring is twice as large anyway
+	const int iRingFile = ( int )syscall( __NR_io_uring_setup, ASYNC_READ_QUEUE_DEPTH + 1, &oParams );
+	if( iRingFile < 0 )
+		return false;
+
+	IOUring* pRing = new IOUring {};
+	pRing->m_iRingFile = iRingFile;
+	pRing->m_iWakeUpFile = eventfd( 0, EFD_CLOEXEC );
+
+	pRing->m_uSubmissionRingSize = oParams.sq_off.array + oParams.sq_entries * sizeof( uint32 );
+	pRing->m_uCompletionRingSize = oParams.cq_off.cqes + oParams.cq_entries * sizeof( io_uring_cqe );
+	if( oParams.features & IORING_FEAT_SINGLE_MMAP )
+		pRing->m_uSubmissionRingSize = pRing->m_uCompletionRingSize = std::max( pRing->m_uSubmissionRingSize, pRing->m_uCompletionRingSize );
+
+	pRing->m_pSubmissionRing = mmap( nullptr, pRing->m_uSubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iRingFile, IORING_OFF_SQ_RING );
+	pRing->m_pCompletionRing = ( oParams.features & IORING_FEAT_SINGLE_MMAP ) ? pRing->m_pSubmissionRing : mmap( nullptr, pRing->m_uCompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iRingFile, IORING_OFF_CQ_RING );
+	pRing->m_uEntriesSize = oParams.sq_entries * sizeof( io_uring_sqe );
+	pRing->m_pEntries = ( io_uring_sqe* )mmap( nullptr, pRing->m_uEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iRingFile, IORING_OFF_SQES );
+
+	if( pRing->m_iWakeUpFile < 0 || pRing->m_pSubmissionRing == MAP_FAILED || pRing->m_pCompletionRing == MAP_FAILED || pRing->m_pEntries == MAP_FAILED )
+	{
+		m_pIOUring = pRing;
+		DestroyIOUring();
+		return false;
+	}
+
+	uint8* pSubmissionRing = ( uint8* )pRing->m_pSubmissionRing;
+	pRing->m_pSubmissionTail = ( uint32* )( pSubmissionRing + oParams.sq_off.tail );
+	pRing->m_uSubmissionMask = *( uint32* )( pSubmissionRing + oParams.sq_off.ring_mask );
+	pRing->m_pSubmissionArray = ( uint32* )( pSubmissionRing + oParams.sq_off.array );
+
+	uint8* pCompletionRing = ( uint8* )pRing->m_pCompletionRing;
+	pRing->m_pCompletionHead = ( uint32* )( pCompletionRing + oParams.cq_off.head );
+	pRing->m_pCompletionTail = ( uint32* )( pCompletionRing + oParams.cq_off.tail );
+	pRing->m_uCompletionMask = *( uint32* )( pCompletionRing + oParams.cq_off.ring_mask );
+	pRing->m_pCompletions = ( io_uring_cqe* )( pCompletionRing + oParams.cq_off.cqes );
+
+	m_pIOUring = pRing;
+	return true;
+}
+
+void AsyncFileReader::DestroyIOUring()
+{
+	if( m_pIOUring == nullptr )
+		return;
+
+	IOUring& oRing = *m_pIOUring;
+
+	if( oRing.m_pEntries != nullptr && oRing.m_pEntries != MAP_FAILED )
+		munmap( oRing.m_pEntries, oRing.m_uEntriesSize );
+
+	if( oRing.m_pCompletionRing != nullptr && oRing.m_pCompletionRing != MAP_FAILED && oRing.m_pCompletionRing != oRing.m_pSubmissionRing )
+		munmap( oRing.m_pCompletionRing, oRing.m_uCompletionRingSize );
+
+	if( oRing.m_pSubmissionRing != nullptr && oRing.m_pSubmissionRing != MAP_FAILED )
+		munmap( oRing.m_pSubmissionRing, oRing.m_uSubmissionRingSize );
+
+	if( oRing.m_iWakeUpFile >= 0 )
+		close( oRing.m_iWakeUpFile );
+
+	close( oRing.m_iRingFile );
+
+	delete m_pIOUring;
+	m_pIOUring = nullptr;
+}
+
+void AsyncFileReader::WakeUpIOUring()
+{
+	if( m_pIOUring == nullptr )
+		return;
+
+	const uint64 uValue = 1;
+	const ssize_t iWritten = write( m_pIOUring->m_iWakeUpFile, &uValue, sizeof( uValue ) );
+	( void )iWritten;
+}
+
+void AsyncFileReader::FinishReads( Array< AsyncRead* >& aReads, Array< AsyncReadStatus >& aStatus )
+{
+	if( aReads.Empty() )
+		return;
+
+	for( AsyncRead* pRead : aReads )
+	{
+		if( pRead->m_iFile >= 0 )
+			close( pRead->m_iFile );
+
+		pRead->m_iFile = -1;
+	}
+
+	std::unique_lock oLock( m_oMutex );
+	for( uint u = 0; u < aReads.Count(); ++u )
+		Finish( aReads[ u ], aStatus[ u ] );
+
+	aReads.Clear();
+	aStatus.Clear();
+}
+
+void AsyncFileReader::RunIOUring()
+{
+	IOUring& oRing = *m_pIOUring;
+
+	Array< AsyncRead* > aStartedReads;
+	Array< AsyncRead* > aFinishedReads;
+	Array< AsyncReadStatus > aFinishedStatus;
+
+	while( true )
+	{
+		{
+			std::unique_lock oLock( m_oMutex );
+
+			// In flight reads write into their buffers, they are waited for before stopping
+			if( m_bRunning == false && m_aInFlightReads.Empty() )
+				break;
+
+			while( m_bRunning && m_aInFlightReads.Count() < ASYNC_READ_QUEUE_DEPTH )
+			{
+				AsyncRead* pRead = PopPending();
+				if( pRead == nullptr )
+					break;
+
+				pRead->m_eStatus = AsyncReadStatus::IN_FLIGHT;
+				m_aInFlightReads.PushBack( pRead );
+				aStartedReads.PushBack( pRead );
+			}
+		}
+
+		// Files are opened out of the lock, opening may block on a cold directory
+		for( AsyncRead* pRead : aStartedReads )
+		{
+			pRead->m_iFile = open( pRead->m_oFilePath.c_str(), O_RDONLY | O_CLOEXEC );
+
+			struct stat oStat;
+			if( pRead->m_iFile < 0 || fstat( pRead->m_iFile, &oStat ) != 0 || ( uint64 )oStat.st_size < pRead->m_uOffset + pRead->m_uSize )
+			{
+				aFinishedReads.PushBack( pRead );
+				aFinishedStatus.PushBack( AsyncReadStatus::FAILED );
+				continue;
+			}
+
+			const uint64 uSize = pRead->m_uSize != 0 ? pRead->m_uSize : ( uint64 )oStat.st_size - pRead->m_uOffset;
+			if( uSize > ASYNC_READ_MAX_SIZE )
+			{
+				aFinishedReads.PushBack( pRead );
+				aFinishedStatus.PushBack( AsyncReadStatus::FAILED );
+				continue;
+			}
+
+			pRead->m_aData.Resize( ( uint )uSize );
+
+			if( uSize == 0 )
+			{
+				aFinishedReads.PushBack( pRead );
+				aFinishedStatus.PushBack( AsyncReadStatus::COMPLETED );
+				continue;
+			}
+
+			oRing.SubmitRead( pRead, pRead->m_iFile, pRead->m_aData.Data(), pRead->m_uOffset, uSize );
+		}
+
+		aStartedReads.Clear();
+
+		FinishReads( aFinishedReads, aFinishedStatus );
+
+		// New pending reads and stops write to the wake up file, which completes this poll
+		if( oRing.m_bWakeUpArmed == false )
+		{
+			io_uring_sqe& oEntry = oRing.PushSubmission();
+			oEntry.opcode = IORING_OP_POLL_ADD;
+			oEntry.fd = oRing.m_iWakeUpFile;
+			oEntry.poll32_events = POLLIN;
+			oEntry.user_data = IO_URING_WAKE_UP;
+
+			oRing.m_bWakeUpArmed = true;
+		}
+
+		const int iSubmitted = ( int )syscall( __NR_io_uring_enter, oRing.m_iRingFile, oRing.m_uToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0 );
+		if( iSubmitted < 0 )
+		{
+			if( errno != EINTR && errno != EAGAIN && errno != EBUSY )
+			{
+				LOG_ERROR( "io_uring_enter failed with error {}, reading with threads instead", errno );
+
+				// None of the reads given to the ring will complete, the pending ones are read by the worker threads
+				{
+					std::unique_lock oLock( m_oMutex );
+					for( AsyncRead* pRead : m_aInFlightReads )
+					{
+						aFinishedReads.PushBack( pRead );
+						aFinishedStatus.PushBack( AsyncReadStatus::FAILED );
+					}
+				}
+
+				FinishReads( aFinishedReads, aFinishedStatus );
+				StartWorkers( true );
+				return;
+			}
+		}
+		else
+		{
+			oRing.m_uToSubmit -= std::min( oRing.m_uToSubmit, ( uint )iSubmitted );
+		}
+
+		uint32 uHead = *oRing.m_pCompletionHead;
+		const uint32 uTail = std::atomic_ref< uint32 >( *oRing.m_pCompletionTail ).load( std::memory_order_acquire );
+		for( ; uHead != uTail; ++uHead )
+		{
+			const io_uring_cqe& oCompletion = oRing.m_pCompletions[ uHead & oRing.m_uCompletionMask ];
+			if( oCompletion.user_data == IO_URING_WAKE_UP )
+			{
+				uint64 uValue = 0;
+				const ssize_t iRead = read( oRing.m_iWakeUpFile, &uValue, sizeof( uValue ) );
+				( void )iRead;
+
+				oRing.m_bWakeUpArmed = false;
+				continue;
+			}
+
+			AsyncRead* pRead = ( AsyncRead* )oCompletion.user_data;
+			if( oCompletion.res <= 0 )
+			{
+				aFinishedReads.PushBack( pRead );
+				aFinishedStatus.PushBack( AsyncReadStatus::FAILED );
+				continue;
+			}
+
+			// Reads may be short, the rest of the range is read again
+			pRead->m_uReadSize += ( uint64 )oCompletion.res;
+			if( pRead->m_uReadSize < pRead->m_aData.Count() )
+			{
+				oRing.SubmitRead( pRead, pRead->m_iFile, pRead->m_aData.Data() + pRead->m_uReadSize, pRead->m_uOffset + pRead->m_uReadSize, pRead->m_aData.Count() - pRead->m_uReadSize );
+				continue;
+			}
+
+			aFinishedReads.PushBack( pRead );
+			aFinishedStatus.PushBack( AsyncReadStatus::COMPLETED );
+		}
+
+		std::atomic_ref< uint32 >( *oRing.m_pCompletionHead ).store( uHead, std::memory_order_release );
+
+		FinishReads( aFinishedReads, aFinishedStatus );
+	}
+}
+
+#else
+
+bool AsyncFileReader::CreateIOUring()
+{
+	return false;
+}
+
+void AsyncFileReader::DestroyIOUring()
+{
+}
+
+void AsyncFileReader::WakeUpIOUring()
+{
+}
+
+void AsyncFileReader::FinishReads( Array< AsyncRead* >& /*aReads*/, Array< AsyncReadStatus >& /*aStatus*/ )
+{
+}
+
+void AsyncFileReader::RunIOUring()
+{
+}
+
+#endif
+
+AsyncFileReader::AsyncFileReader( const uint uThreadCount /*= ASYNC_READ_DEFAULT_THREAD_COUNT*/, const bool bAllowIOUring /*= true*/ )
+	: m_uNextSequence( 0 )
+	, m_bRunning( true )
+	, m_bInterrupted( false )
+	, m_bIOUringFailed( false )
+	, m_uThreadCount( uThreadCount )
+	, m_pIOUring( nullptr )
+{
+	if( bAllowIOUring && CreateIOUring() )
+	{
+		m_aThreads.PushBack( new std::thread( &AsyncFileReader::RunIOUring, this ) );
+		return;
+	}
+
+	StartWorkers( false );
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+	{
+		std::unique_lock oLock( m_oMutex );
+		m_bRunning = false;
+	}
+
+	m_oPendingCondition.notify_all();
+	m_oDeliveredCondition.notify_all();
+	WakeUpIOUring();
+
+	for( std::thread* pThread : m_aThreads )
+	{
+		pThread->join();
+		delete pThread;
+	}
+
+	DestroyIOUring();
+
+	for( AsyncRead* pRead : m_aPendingReads )
+		delete pRead;
+
+	for( AsyncRead* pRead : m_aDeliveredReads )
+		delete pRead;
+}
+
+AsyncRead* AsyncFileReader::Read( const std::filesystem::path& oFilePath, const uint64 uOffset, const uint64 uSize, const int iPriority, void* pUserData /*= nullptr*/ )
+{
+	AsyncRead* pRead = new AsyncRead;
+	pRead->m_oFilePath = oFilePath;
+	pRead->m_uOffset = uOffset;
+	pRead->m_uSize = uSize;
+	pRead->m_iPriority = iPriority;
+	pRead->m_pUserData = pUserData;
+
+	bool bUseIOUring = false;
+	{
+		std::unique_lock oLock( m_oMutex );
+		pRead->m_uSequence = m_uNextSequence++;
+		m_aPendingReads.PushBack( pRead );
+
+		bUseIOUring = m_pIOUring != nullptr && m_bIOUringFailed == false;
+	}
+
+	if( bUseIOUring )
+		WakeUpIOUring();
+	else
+		m_oPendingCondition.notify_one();
+
+	return pRead;
+}
+
+void AsyncFileReader::Cancel( AsyncRead* pRead )
+{
+	std::unique_lock oLock( m_oMutex );
+
+	switch( pRead->m_eStatus )
+	{
+	case AsyncReadStatus::PENDING:
+		for( uint u = 0; u < m_aPendingReads.Count(); ++u )
+		{
+			if( m_aPendingReads[ u ] == pRead )
+			{
+				m_aPendingReads.Remove( u );
+				break;
+			}
+		}
+
+		pRead->m_eStatus = AsyncReadStatus::CANCELLED;
+		Deliver( pRead );
+		break;
+	case AsyncReadStatus::IN_FLIGHT:
+		pRead->m_bCancelled = true;
+		break;
+	default:
+		break;
+	}
+}
+
+void AsyncFileReader::CancelAll()
+{
+	std::unique_lock oLock( m_oMutex );
+
+	for( AsyncRead* pRead : m_aPendingReads )
+	{
+		pRead->m_eStatus = AsyncReadStatus::CANCELLED;
+		Deliver( pRead );
+	}
+	m_aPendingReads.Clear();
+
+	for( AsyncRead* pRead : m_aInFlightReads )
+		pRead->m_bCancelled = true;
+}
+
+void AsyncFileReader::SetPriority( AsyncRead* pRead, const int iPriority )
+{
+	std::unique_lock oLock( m_oMutex );
+
+	if( pRead->m_eStatus == AsyncReadStatus::PENDING )
+		pRead->m_iPriority = iPriority;
+}
+
+AsyncRead* AsyncFileReader::PopDelivered( const bool bWait )
+{
+	std::unique_lock oLock( m_oMutex );
+
+	if( bWait )
+		m_oDeliveredCondition.wait( oLock, [ this ]() { return m_aDeliveredReads.Empty() == false || ( m_aPendingReads.Empty() && m_aInFlightReads.Empty() ) || m_bInterrupted || m_bRunning == false; } );
+
+	if( m_aDeliveredReads.Empty() )
+	{
+		if( bWait )
+			m_bInterrupted = false;
+
+		return nullptr;
+	}
+
+	AsyncRead* pRead = m_aDeliveredReads.Front();
+	m_aDeliveredReads.PopFront();
+
+	return pRead;
+}
+
+void AsyncFileReader::Interrupt()
+{
+	{
+		std::unique_lock oLock( m_oMutex );
+		m_bInterrupted = true;
+	}
+
+	m_oDeliveredCondition.notify_all();
+}
+
+uint AsyncFileReader::GetPendingCount() const
+{
+	std::unique_lock oLock( m_oMutex );
+	return m_aPendingReads.Count();
+}
+
+uint AsyncFileReader::GetInFlightCount() const
+{
+	std::unique_lock oLock( m_oMutex );
+	return m_aInFlightReads.Count();
+}
+
+bool AsyncFileReader::IsUsingIOUring() const
+{
+	std::unique_lock oLock( m_oMutex );
+	return m_pIOUring != nullptr && m_bIOUringFailed == false;
+}
+
+AsyncRead* AsyncFileReader::PopPending()
+{
+	if( m_aPendingReads.Empty() )
+		return nullptr;
+
+	// Highest priority first, then in request order
+	uint uBestIndex = 0;
+	for( uint u = 1; u < m_aPendingReads.Count(); ++u )
+	{
+		const AsyncRead* pRead = m_aPendingReads[ u ];
+		const AsyncRead* pBestRead = m_aPendingReads[ uBestIndex ];
+		if( pRead->m_iPriority > pBestRead->m_iPriority || ( pRead->m_iPriority == pBestRead->m_iPriority && pRead->m_uSequence < pBestRead->m_uSequence ) )
+			uBestIndex = u;
+	}
+
+	AsyncRead* pRead = m_aPendingReads[ uBestIndex ];
+	m_aPendingReads.Remove( uBestIndex );
+
+	return pRead;
+}
+
+void AsyncFileReader::Finish( AsyncRead* pRead, const AsyncReadStatus eStatus )
+{
+	pRead->m_eStatus = pRead->m_bCancelled ? AsyncReadStatus::CANCELLED : eStatus;
+
+	for( uint u = 0; u < m_aInFlightReads.Count(); ++u )
+	{
+		if( m_aInFlightReads[ u ] == pRead )
+		{
+			m_aInFlightReads.Remove( u );
+			break;
+		}
+	}
+
+	Deliver( pRead );
+}
+
+void AsyncFileReader::Deliver( AsyncRead* pRead )
+{
+	if( pRead->m_eStatus != AsyncReadStatus::COMPLETED )
+		pRead->m_aData.Clear();
+
+	m_aDeliveredReads.PushBack( pRead );
+	m_oDeliveredCondition.notify_all();
+}
+
+void AsyncFileReader::StartWorkers( const bool bIOUringFailed )
+{
+	std::unique_lock oLock( m_oMutex );
+	m_bIOUringFailed = bIOUringFailed;
+
+	// The destructor joins the threads once it stopped the reader, none can be added after that
+	if( m_bRunning == false )
+		return;
+
+	for( uint u = 0; u < m_uThreadCount; ++u )
+		m_aThreads.PushBack( new std::thread( &AsyncFileReader::RunWorker, this ) );
+}
+
+void AsyncFileReader::RunWorker()
+{
+	while( true )
+	{
+		AsyncRead* pRead = nullptr;
+
+		{
+			std::unique_lock oLock( m_oMutex );
+			m_oPendingCondition.wait( oLock, [ this ]() { return m_aPendingReads.Empty() == false || m_bRunning == false; } );
+
+			if( m_bRunning == false )
+				return;
+
+			pRead = PopPending();
+			pRead->m_eStatus = AsyncReadStatus::IN_FLIGHT;
+			m_aInFlightReads.PushBack( pRead );
+		}
+
+		const bool bRead = ReadFileRange( *pRead );
+
+		std::unique_lock oLock( m_oMutex );
+		Finish( pRead, bRead ? AsyncReadStatus::COMPLETED : AsyncReadStatus::FAILED );
+	}
+}
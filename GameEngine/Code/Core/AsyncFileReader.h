@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "Array.h"
+
+inline constexpr uint ASYNC_READ_QUEUE_DEPTH = 64;
+inline constexpr uint ASYNC_READ_DEFAULT_THREAD_COUNT = 4;
+
+enum class AsyncReadStatus : uint8
+{
+	PENDING,
+	IN_FLIGHT,
+	COMPLETED,
+	FAILED,
+	CANCELLED
+};
+
+// A read of m_uSize bytes at m_uOffset of a file, or of the whole file when m_uSize is 0, reads of 4 GB or more fail
+// Reads are owned by the reader until they are popped, completed, failed or cancelled, they are then deleted by the caller
+struct AsyncRead
+{
+	AsyncRead();
+
+	std::filesystem::path	m_oFilePath;
+	uint64					m_uOffset;
+	uint64					m_uSize;
+	int						m_iPriority;
+	void*					m_pUserData;
+
+	AsyncReadStatus			m_eStatus;
+	Array< uint8 >			m_aData;
+
+private:
+	friend class AsyncFileReader;
+
+	bool					m_bCancelled;
+	int						m_iFile;
+	uint64					m_uReadSize;
+	uint64					m_uSequence;
+};
+
+// Keeps many reads in flight, highest priorities first, so that a slow file does not stall the ones behind it
+// Uses io_uring on Linux, with a single thread submitting and completing reads, and a pool of threads doing blocking reads elsewhere
+class AsyncFileReader
+{
+public:
+	explicit AsyncFileReader( const uint uThreadCount = ASYNC_READ_DEFAULT_THREAD_COUNT, const bool bAllowIOUring = true );
+	~AsyncFileReader();
+
+	AsyncFileReader( const AsyncFileReader& ) = delete;
+	AsyncFileReader& operator=( const AsyncFileReader& ) = delete;
+
+	AsyncRead*	Read( const std::filesystem::path& oFilePath, const uint64 uOffset, const uint64 uSize, const int iPriority, void* pUserData = nullptr );
+
+	// Pending reads are delivered as cancelled right away, reads in flight once their IO is done
+	void		Cancel( AsyncRead* pRead );
+	void		CancelAll();
+	// Only changes the order of reads still pending
+	void		SetPriority( AsyncRead* pRead, const int iPriority );
+
+	// Returns nullptr when no read is delivered, after waiting for one when bWait is set and some reads are not delivered yet
+	AsyncRead*	PopDelivered( const bool bWait );
+	// Makes a waiting PopDelivered return nullptr, or the next one to wait when none is waiting
+	void		Interrupt();
+
+	uint		GetPendingCount() const;
+	uint		GetInFlightCount() const;
+	bool		IsUsingIOUring() const;
+
+private:
+	struct IOUring;
+
+	AsyncRead*	PopPending();
+	// Both expect the lock to be held
+	void		Finish( AsyncRead* pRead, const AsyncReadStatus eStatus );
+	void		Deliver( AsyncRead* pRead );
+
+	// Also started by the ring thread when io_uring fails, to read the pending reads and the next ones
+	void		StartWorkers( const bool bIOUringFailed );
+	void		RunWorker();
+	void		RunIOUring();
+	void		FinishReads( Array< AsyncRead* >& aReads, Array< AsyncReadStatus >& aStatus );
+
+	bool		CreateIOUring();
+	void		DestroyIOUring();
+	void		WakeUpIOUring();
+
+	mutable std::mutex		m_oMutex;
+	std::condition_variable	m_oPendingCondition;
+	std::condition_variable	m_oDeliveredCondition;
+
+	Array< AsyncRead* >		m_aPendingReads;
+	Array< AsyncRead* >		m_aInFlightReads;
+	Array< AsyncRead* >		m_aDeliveredReads;
+	uint64					m_uNextSequence;
+	bool					m_bRunning;
+	bool					m_bInterrupted;
+	bool					m_bIOUringFailed;
+	uint					m_uThreadCount;
+
+	// Threads cannot be copied, which Array requires
+	Array< std::thread* >	m_aThreads;
+	IOUring*				m_pIOUring;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "Array.h"
+
+// Appends values to a buffer as they are in memory, arrays and strings are preceded by their count
+class BinaryWriter
+{
+public:
+	template < typename T >
+	void Write( const T& oValue )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		WriteBytes( &oValue, sizeof( T ) );
+	}
+
+	template < typename T >
+	void WriteArray( const Array< T >& aValues )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		Write( aValues.Count() );
+		WriteBytes( aValues.Data(), ( uint64 )aValues.Count() * sizeof( T ) );
+	}
+
+	void WriteString( const std::string& sValue )
+	{
+		Write( ( uint )sValue.length() );
+		WriteBytes( sValue.data(), sValue.length() );
+	}
+
+	void WriteBytes( const void* pData, const uint64 uSize )
+	{
+		if( uSize == 0 )
+			return;
+
+		const uint uOffset = m_aData.Count();
+		m_aData.Resize( uOffset + ( uint )uSize );
+		memcpy( m_aData.Data() + uOffset, pData, uSize );
+	}
+
+	const Array< uint8 >& GetData() const
+	{
+		return m_aData;
+	}
+
+private:
+	Array< uint8 > m_aData;
+};
+
+// Reads what a BinaryWriter wrote, a read past the end fails and every read after it does too
+class BinaryReader
+{
+public:
+	explicit BinaryReader( const ArrayView< const uint8 > aData )
+		: m_aData( aData )
+		, m_uPosition( 0 )
+		, m_bValid( true )
+	{
+	}
+
+	template < typename T >
+	bool Read( T& oValue )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+		return ReadBytes( &oValue, sizeof( T ) );
+	}
+
+	template < typename T >
+	bool ReadArray( Array< T >& aValues )
+	{
+		static_assert( std::is_trivially_copyable_v< T > );
+
+		uint uCount = 0;
+		if( Read( uCount ) == false || CanRead( ( uint64 )uCount * sizeof( T ) ) == false )
+			return false;
+
+		aValues.Resize( uCount );
+		return ReadBytes( aValues.Data(), ( uint64 )uCount * sizeof( T ) );
+	}
+
+	bool ReadString( std::string& sValue )
+	{
+		uint uLength = 0;
+		if( Read( uLength ) == false || CanRead( uLength ) == false )
+			return false;
+
+		sValue.assign( ( const char* )m_aData.Data() + m_uPosition, uLength );
+		m_uPosition += uLength;
+		return true;
+	}
+
+	bool ReadBytes( void* pData, const uint64 uSize )
+	{
+		if( CanRead( uSize ) == false )
+			return false;
+
+		if( uSize > 0 )
+			memcpy( pData, m_aData.Data() + m_uPosition, uSize );
+
+		m_uPosition += uSize;
+		return true;
+	}
+
+	bool IsValid() const
+	{
+		return m_bValid;
+	}
+
+	bool IsAtEnd() const
+	{
+		return m_uPosition == m_aData.Count();
+	}
+
+private:
+	bool CanRead( const uint64 uSize )
+	{
+		if( m_bValid && uSize > m_aData.Count() - m_uPosition )
+			m_bValid = false;
+
+		return m_bValid;
+	}
+
+	ArrayView< const uint8 >	m_aData;
+	uint64						m_uPosition;
+	bool						m_bValid;
+};
@@ -0,0 +1,118 @@
+#include "DerivedDataCache.h"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+#include "Logger.h"
+
+uint64 HashData( const void* pData, const uint64 uSize, const uint64 uSeed /*= 14695981039346656037ull*/ )
+{
+	// FNV-1a on words, the high half is folded back so that every byte reaches the low bits
+	const uint8* pBytes = ( const uint8* )pData;
+	uint64 uHash = uSeed;
+
+	const uint64 uWordCount = uSize / sizeof( uint64 );
+	for( uint64 u = 0; u < uWordCount; ++u )
+	{
+		uint64 uWord;
+		memcpy( &uWord, pBytes + u * sizeof( uint64 ), sizeof( uint64 ) );
+		uHash = ( uHash ^ uWord ) * 1099511628211ull;
+		uHash ^= uHash >> 32;
+	}
+
+	for( uint64 u = uWordCount * sizeof( uint64 ); u < uSize; ++u )
+	{
+		uHash ^= pBytes[ u ];
+		uHash *= 1099511628211ull;
+	}
+
+	return uHash;
+}
+
+DerivedDataCache::DerivedDataCache( const std::filesystem::path& oDirectory )
+	: m_oDirectory( oDirectory )
+{
+}
+
+bool DerivedDataCache::Load( const uint64 uKey, const uint32 uVersion, MappedFile& oMappedFile, ArrayView< const uint8 >& aData ) const
+{
+	// Misses are expected, only an entry which exists but cannot be opened is an error
+	const std::filesystem::path oFilePath = GetEntryPath( uKey );
+	std::error_code oError;
+	if( std::filesystem::exists( oFilePath, oError ) == false )
+		return false;
+
+	if( oMappedFile.Open( oFilePath ) == false )
+		return false;
+
+	// The size of the mapping is not truncated to the count of a view, entries larger than a view can hold are misses
+	const uint64 uFileSize = oMappedFile.GetSize();
+	if( uFileSize < sizeof( DerivedDataHeader ) )
+	{
+		oMappedFile.Close();
+		return false;
+	}
+
+	DerivedDataHeader oHeader;
+	memcpy( &oHeader, oMappedFile.GetData().Data(), sizeof( DerivedDataHeader ) );
+
+	if( oHeader.m_uMagic != DERIVED_DATA_MAGIC || oHeader.m_uVersion != uVersion || oHeader.m_uKey != uKey || oHeader.m_uSize != uFileSize - sizeof( DerivedDataHeader ) )
+	{
+		oMappedFile.Close();
+		return false;
+	}
+
+	if( oHeader.m_uSize > std::numeric_limits< uint >::max() )
+	{
+		oMappedFile.Close();
+		return false;
+	}
+
+	aData = ArrayView< const uint8 >( oMappedFile.GetData().Data() + sizeof( DerivedDataHeader ), ( uint )oHeader.m_uSize );
+	return true;
+}
+
+bool DerivedDataCache::Store( const uint64 uKey, const uint32 uVersion, const ArrayView< const uint8 > aData ) const
+{
+	std::error_code oError;
+	std::filesystem::create_directories( m_oDirectory, oError );
+
+	const std::filesystem::path oFilePath = GetEntryPath( uKey );
+	std::filesystem::path oTemporaryFilePath = oFilePath;
+	oTemporaryFilePath += std::format( ".{:x}.tmp", std::hash< std::thread::id >()( std::this_thread::get_id() ) );
+
+	{
+		const DerivedDataHeader oHeader { DERIVED_DATA_MAGIC, uVersion, uKey, aData.Count() };
+
+		std::ofstream oFileStream( oTemporaryFilePath, std::ios::binary | std::ios::trunc );
+		oFileStream.write( ( const char* )&oHeader, sizeof( DerivedDataHeader ) );
+		oFileStream.write( ( const char* )aData.Data(), aData.Count() );
+
+		if( oFileStream.good() == false )
+		{
+			oFileStream.close();
+			std::filesystem::remove( oTemporaryFilePath, oError );
+
+			LOG_ERROR( "Error writing file {}", oTemporaryFilePath.string() );
+			return false;
+		}
+	}
+
+	// Fails when the entry is opened by another thread, which already has the same data
+	std::filesystem::rename( oTemporaryFilePath, oFilePath, oError );
+	if( oError )
+	{
+		std::filesystem::remove( oTemporaryFilePath, oError );
+		return false;
+	}
+
+	return true;
+}
+
+std::filesystem::path DerivedDataCache::GetEntryPath( const uint64 uKey ) const
+{
+	return m_oDirectory / std::format( "{:016x}.ddc", uKey );
+}
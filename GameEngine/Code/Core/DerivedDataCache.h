@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+
+#include "Array.h"
+#include "MappedFile.h"
+
+// Entry layout : a DerivedDataHeader then the data, in a file named after the key
+// Entries written by another version of their data are ignored, and replaced when stored again
+inline constexpr uint32 DERIVED_DATA_MAGIC = 0x43444447;
+
+struct DerivedDataHeader
+{
+	uint32	m_uMagic;
+	uint32	m_uVersion;
+	uint64	m_uKey;
+	uint64	m_uSize;
+};
+
+// Hashes 8 bytes at a time, chain calls through uSeed to hash several buffers
+uint64 HashData( const void* pData, const uint64 uSize, const uint64 uSeed = 14695981039346656037ull );
+
+// Keeps the data derived from source files, like imported models and decoded textures, so that it is not processed again on the next runs
+// Loads and stores can be done from any thread, entries are written to a temporary file first so that they are never read partially written
+class DerivedDataCache
+{
+public:
+	explicit DerivedDataCache( const std::filesystem::path& oDirectory );
+
+	// aData points into oMappedFile, it is only valid while the file is open
+	bool					Load( const uint64 uKey, const uint32 uVersion, MappedFile& oMappedFile, ArrayView< const uint8 >& aData ) const;
+	bool					Store( const uint64 uKey, const uint32 uVersion, const ArrayView< const uint8 > aData ) const;
+
+	std::filesystem::path	GetEntryPath( const uint64 uKey ) const;
+
+private:
+	std::filesystem::path	m_oDirectory;
+};
@@ -1,13 +1,26 @@
 #include "FileUtils.h"
 
+#include <cstring>
 #include <fstream>
 
 #include "Logger.h"
+#include "VirtualFileSystem.h"
 
 std::string ReadTextFile( const std::filesystem::path& oFilePath )
 {
-	std::string sFileContent;
-	std::ifstream oFileStream( oFilePath );
+	if( g_pVirtualFileSystem != nullptr )
+	{
+		const VirtualFile oVirtualFile = g_pVirtualFileSystem->Open( oFilePath );
+		if( oVirtualFile.IsOpen() == false )
+		{
+			LOG_ERROR( "Error reading file {}", oFilePath.string() );
+			return "";
+		}
+
+		return std::string( oVirtualFile.GetText() );
+	}
+
+	std::ifstream oFileStream( oFilePath, std::ios::binary );
 
 	if( !oFileStream.is_open() )
 	{
@@ -15,12 +28,14 @@ std::string ReadTextFile( const std::filesystem::path& oFilePath )
 		return "";
 	}
 
-	std::string sLine;
-	while( !oFileStream.eof() )
-	{
-		std::getline( oFileStream, sLine );
-		sFileContent.append( sLine + '\n' );
-	}
+	// Whole file in a single read, line endings are left as they are
+	oFileStream.seekg( 0, std::ios_base::end );
+	const size_t uLength = ( size_t )oFileStream.tellg();
+	oFileStream.seekg( 0, std::ios_base::beg );
+
+	std::string sFileContent;
+	sFileContent.resize( uLength );
+	oFileStream.read( sFileContent.data(), uLength );
 
 	oFileStream.close();
 
@@ -29,6 +44,24 @@ std::string ReadTextFile( const std::filesystem::path& oFilePath )
 
 Array< uint8 > ReadBinaryFile( const std::filesystem::path& oFilePath )
 {
+	if( g_pVirtualFileSystem != nullptr )
+	{
+		const VirtualFile oVirtualFile = g_pVirtualFileSystem->Open( oFilePath );
+		if( oVirtualFile.IsOpen() == false )
+		{
+			LOG_ERROR( "Error reading file {}", oFilePath.string() );
+			return Array< uint8 >();
+		}
+
+		const ArrayView< const uint8 > aData = oVirtualFile.GetData();
+
+		Array< uint8 > aContent( aData.Count() );
+		if( aData.Empty() == false )
+			memcpy( aContent.Data(), aData.Data(), aData.Count() );
+
+		return aContent;
+	}
+
 	std::ifstream oFileStream( oFilePath, std::ios::binary );
 
 	Array< uint8 > aContent;
@@ -0,0 +1,52 @@
+#include "GLMSerialization.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <nlohmann/json.hpp>
+
+namespace glm
+{
+	void to_json( nlohmann::json& oJsonContent, const bvec3& vVector )
+	{
+		oJsonContent[ "x" ] = vVector.x;
+		oJsonContent[ "y" ] = vVector.y;
+		oJsonContent[ "z" ] = vVector.z;
+	}
+
+	void from_json( const nlohmann::json& oJsonContent, bvec3& vVector )
+	{
+		vVector.x = oJsonContent[ "x" ];
+		vVector.y = oJsonContent[ "y" ];
+		vVector.z = oJsonContent[ "z" ];
+	}
+
+	void to_json( nlohmann::json& oJsonContent, const vec3& vVector )
+	{
+		oJsonContent[ "x" ] = vVector.x;
+		oJsonContent[ "y" ] = vVector.y;
+		oJsonContent[ "z" ] = vVector.z;
+	}
+
+	void from_json( const nlohmann::json& oJsonContent, vec3& vVector )
+	{
+		vVector.x = oJsonContent[ "x" ];
+		vVector.y = oJsonContent[ "y" ];
+		vVector.z = oJsonContent[ "z" ];
+	}
+
+	void to_json( nlohmann::json& oJsonContent, const quat& qQuaternion )
+	{
+		oJsonContent[ "x" ] = qQuaternion.x;
+		oJsonContent[ "y" ] = qQuaternion.y;
+		oJsonContent[ "z" ] = qQuaternion.z;
+		oJsonContent[ "w" ] = qQuaternion.w;
+	}
+
+	void from_json( const nlohmann::json& oJsonContent, quat& qQuaternion )
+	{
+		qQuaternion.x = oJsonContent[ "x" ];
+		qQuaternion.y = oJsonContent[ "y" ];
+		qQuaternion.z = oJsonContent[ "z" ];
+		qQuaternion.w = oJsonContent[ "w" ];
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/fwd.hpp>
+#include <nlohmann/json_fwd.hpp>
+
+// Kept apart from Serialization, which needs the whole game, so that the benchmarks read and write the same JSON as scenes
+namespace glm
+{
+	void to_json( nlohmann::json& oJsonContent, const glm::bvec3& vVector );
+	void from_json( const nlohmann::json& oJsonContent, glm::bvec3& vVector );
+
+	void to_json( nlohmann::json& oJsonContent, const glm::vec3& vVector );
+	void from_json( const nlohmann::json& oJsonContent, glm::vec3& vVector );
+
+	void to_json( nlohmann::json& oJsonContent, const glm::quat& vVector );
+	void from_json( const nlohmann::json& oJsonContent, glm::quat& qQuaternion );
+}
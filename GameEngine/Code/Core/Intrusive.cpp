@@ -1,49 +1,178 @@
 #include "Intrusive.h"
 
+#include <mutex>
+
 #ifdef TRACK_MEMORY
 #include "MemoryTracker.h"
 #endif
 
+#ifdef AUDIT_ALLOCATIONS
+#include "AllocationAudit.h"
+#endif
+
+// The pointer and the generation are read without the lock when resolving, the counts and the free list are only used under it
+struct WeakHandle
+{
+	WeakHandle();
+
+	std::atomic< Intrusive* >	m_pPtr;
+	std::atomic< uint >			m_uGeneration;
+	uint						m_uWeakCount;
+	uint						m_uNextFreeIndex;
+};
+
+static constexpr uint WEAK_HANDLE_PAGE_SIZE = 1024;
+static constexpr uint WEAK_HANDLE_MAX_PAGE_COUNT = 4096;
+
+// Slot 0 is never allocated and never matches a live object, null weak references point to it and never reach the table
+// Objects are destroyed on the loader threads too, allocating and freeing slots goes through the mutex
+// Slots are allocated by pages which are never moved nor freed, so that resolving a weak reference does not need the mutex
+struct WeakHandleTable
+{
+	WeakHandleTable();
+
+	uint				Allocate( Intrusive* pPtr );
+	void				Free( const uint uIndex );
+
+	WeakHandle&			GetHandle( const uint uIndex );
+
+	std::atomic< WeakHandle* >	m_aPages[ WEAK_HANDLE_MAX_PAGE_COUNT ];
+	uint						m_uHandleCount;
+	uint						m_uFirstFreeIndex;
+	std::mutex					m_oMutex;
+};
+
+WeakHandle::WeakHandle()
+	: m_pPtr( nullptr )
+	, m_uGeneration( 0 )
+	, m_uWeakCount( 0 )
+	, m_uNextFreeIndex( 0 )
+{
+}
+
+WeakHandleTable::WeakHandleTable()
+	: m_aPages()
+	, m_uHandleCount( 1 )
+	, m_uFirstFreeIndex( 0 )
+{
+	m_aPages[ 0 ].store( new WeakHandle[ WEAK_HANDLE_PAGE_SIZE ], std::memory_order_release );
+}
+
+uint WeakHandleTable::Allocate( Intrusive* pPtr )
+{
+	uint uIndex = m_uFirstFreeIndex;
+	if( uIndex != 0 )
+	{
+		m_uFirstFreeIndex = GetHandle( uIndex ).m_uNextFreeIndex;
+	}
+	else
+	{
+		uIndex = m_uHandleCount++;
+		if( uIndex % WEAK_HANDLE_PAGE_SIZE == 0 )
+		{
+			ASSERT( uIndex / WEAK_HANDLE_PAGE_SIZE < WEAK_HANDLE_MAX_PAGE_COUNT );
+			m_aPages[ uIndex / WEAK_HANDLE_PAGE_SIZE ].store( new WeakHandle[ WEAK_HANDLE_PAGE_SIZE ], std::memory_order_release );
+		}
+
+		// Generation 0 is kept for null references
+		GetHandle( uIndex ).m_uGeneration.store( 1, std::memory_order_relaxed );
+	}
+
+	WeakHandle& oHandle = GetHandle( uIndex );
+	oHandle.m_uWeakCount = 0;
+	oHandle.m_uNextFreeIndex = 0;
+
+	// Published after the generation, a thread seeing the new object also sees the generation it comes with
+	oHandle.m_pPtr.store( pPtr, std::memory_order_release );
+
+	return uIndex;
+}
+
+void WeakHandleTable::Free( const uint uIndex )
+{
+	ASSERT( uIndex != 0 );
+
+	WeakHandle& oHandle = GetHandle( uIndex );
+	oHandle.m_pPtr.store( nullptr, std::memory_order_relaxed );
+	oHandle.m_uWeakCount = 0;
+	oHandle.m_uNextFreeIndex = m_uFirstFreeIndex;
+
+	// Weak references still holding the previous generation now resolve to nullptr
+	uint uGeneration = oHandle.m_uGeneration.load( std::memory_order_relaxed ) + 1;
+	if( uGeneration == 0 )
+		uGeneration = 1;
+	oHandle.m_uGeneration.store( uGeneration, std::memory_order_release );
+
+	m_uFirstFreeIndex = uIndex;
+}
+
+WeakHandle& WeakHandleTable::GetHandle( const uint uIndex )
+{
+	return m_aPages[ uIndex / WEAK_HANDLE_PAGE_SIZE ].load( std::memory_order_acquire )[ uIndex % WEAK_HANDLE_PAGE_SIZE ];
+}
+
+// Created on first use and never destroyed, so that static objects of any translation unit can use it while they are built or destroyed
+static WeakHandleTable& GetWeakHandleTable()
+{
+	static WeakHandleTable* s_pWeakHandleTable = new WeakHandleTable();
+	return *s_pWeakHandleTable;
+}
+
 Intrusive::Intrusive()
-	: m_pWeakLink( nullptr )
-	, m_uReferenceCount( 0 )
+	: Intrusive( ReferencePolicy::LOCAL )
+{
+}
+
+Intrusive::Intrusive( const ReferencePolicy eReferencePolicy )
+	: m_uReferenceCount( 0 )
+	, m_uWeakHandleIndex( 0 )
+	, m_eReferencePolicy( eReferencePolicy )
 {
 	TrackMemory();
+
+#ifdef AUDIT_ALLOCATIONS
+	AllocationAudit::OnIntrusiveCreated( this, ALLOCATION_CALL_SITE() );
+#endif
 }
 
 Intrusive::~Intrusive()
 {
 	UnTrackMemory();
 
-	ASSERT( m_uReferenceCount == 0 );
+	ASSERT( GetReferenceCount() == 0 );
 	m_uReferenceCount = 0;
 
-	WeakPtrBase* pLink = m_pWeakLink;
-	while( pLink != nullptr )
+	// Most objects never get a weak reference and skip the lock, no weak reference can be acquired on an object being destroyed
+	if( GetWeakHandleIndex() == 0 )
+		return;
+
+	// The last weak reference may be released on another thread at the same time, which resets the index
+	WeakHandleTable& oWeakHandleTable = GetWeakHandleTable();
+	std::lock_guard oLock( oWeakHandleTable.m_oMutex );
+
+	const uint uWeakHandleIndex = GetWeakHandleIndex();
+	if( uWeakHandleIndex != 0 )
 	{
-		ASSERT( pLink->m_pPtr != nullptr );
-		pLink->m_pPtr = nullptr;
-		pLink = pLink->m_pNext;
+		oWeakHandleTable.Free( uWeakHandleIndex );
+		SetWeakHandleIndex( 0 );
 	}
 }
 
-uint Intrusive::GetReferenceCount() const
+ReferencePolicy Intrusive::GetReferencePolicy() const
 {
-	return m_uReferenceCount;
+	return m_eReferencePolicy;
 }
 
 uint Intrusive::CountWeakReferences() const
 {
-	uint uCount = 0;
+	if( GetWeakHandleIndex() == 0 )
+		return 0;
 
-	WeakPtrBase* pLink = m_pWeakLink;
-	while( pLink != nullptr )
-	{
-		++uCount;
-		pLink = pLink->m_pNext;
-	}
+	WeakHandleTable& oWeakHandleTable = GetWeakHandleTable();
+	std::lock_guard oLock( oWeakHandleTable.m_oMutex );
 
-	return uCount;
+	const uint uWeakHandleIndex = GetWeakHandleIndex();
+	return uWeakHandleIndex != 0 ? oWeakHandleTable.GetHandle( uWeakHandleIndex ).m_uWeakCount : 0;
 }
 
 void Intrusive::TrackMemory()
@@ -56,160 +185,134 @@ void Intrusive::TrackMemory()
 
 void Intrusive::UnTrackMemory()
 {
-#if TRACK_MEMORY
+#ifdef TRACK_MEMORY
 	if( g_pMemoryTracker != nullptr )
 		g_pMemoryTracker->UnRegisterIntrusive( this );
 #endif
 }
 
-StrongPtrBase::StrongPtrBase()
-	: m_pPtr( nullptr )
+WeakPtrBase::WeakPtrBase()
+	: m_uHandleIndex( 0 )
+	, m_uHandleGeneration( 0 )
 {
 }
 
-StrongPtrBase::StrongPtrBase( Intrusive* pPtr )
-	: m_pPtr( pPtr )
+WeakPtrBase::WeakPtrBase( Intrusive* pPtr )
+	: m_uHandleIndex( 0 )
+	, m_uHandleGeneration( 0 )
 {
-	if( m_pPtr != nullptr )
-		++( m_pPtr->m_uReferenceCount );
+	AcquireHandle( pPtr );
 }
 
-StrongPtrBase::StrongPtrBase( const StrongPtrBase& xPtr )
-	: m_pPtr( xPtr.m_pPtr )
+WeakPtrBase::WeakPtrBase( const WeakPtrBase& xPtr )
+	: m_uHandleIndex( 0 )
+	, m_uHandleGeneration( 0 )
 {
-	AddReference();
+	AcquireHandle( xPtr.Resolve() );
 }
 
-StrongPtrBase& StrongPtrBase::operator=( const StrongPtrBase& xPtr )
+WeakPtrBase& WeakPtrBase::operator=( const WeakPtrBase& xPtr )
 {
 	if( &xPtr == this )
 		return *this;
 
-	RemoveReference();
-
-	m_pPtr = xPtr.m_pPtr;
+	ReleaseHandle();
 
-	AddReference();
+	AcquireHandle( xPtr.Resolve() );
 
 	return *this;
 }
 
-StrongPtrBase::StrongPtrBase( StrongPtrBase&& xPtr ) noexcept
-	: m_pPtr( xPtr.m_pPtr )
+WeakPtrBase::WeakPtrBase( WeakPtrBase&& xPtr ) noexcept
+	: m_uHandleIndex( xPtr.m_uHandleIndex )
+	, m_uHandleGeneration( xPtr.m_uHandleGeneration )
 {
-	if( m_pPtr != nullptr )
-		ASSERT( m_pPtr->m_uReferenceCount > 0 );
-
-	xPtr.m_pPtr = nullptr;
+	xPtr.m_uHandleIndex = 0;
+	xPtr.m_uHandleGeneration = 0;
 }
 
-StrongPtrBase& StrongPtrBase::operator=( StrongPtrBase&& xPtr ) noexcept
+WeakPtrBase& WeakPtrBase::operator=( WeakPtrBase&& xPtr ) noexcept
 {
 	if( &xPtr == this )
 		return *this;
 
-	RemoveReference();
+	ReleaseHandle();
 
-	m_pPtr = xPtr.m_pPtr;
-	if( m_pPtr != nullptr )
-		ASSERT( m_pPtr->m_uReferenceCount > 0 );
+	m_uHandleIndex = xPtr.m_uHandleIndex;
+	m_uHandleGeneration = xPtr.m_uHandleGeneration;
 
-	xPtr.m_pPtr = nullptr;
+	xPtr.m_uHandleIndex = 0;
+	xPtr.m_uHandleGeneration = 0;
 
 	return *this;
 }
 
-StrongPtrBase::~StrongPtrBase()
+WeakPtrBase::~WeakPtrBase()
 {
-	RemoveReference();
+	ReleaseHandle();
 }
 
-void StrongPtrBase::AddReference()
+Intrusive* WeakPtrBase::Resolve() const
 {
-	if( m_pPtr != nullptr )
-	{
-		ASSERT( m_pPtr->m_uReferenceCount > 0 );
-		++( m_pPtr->m_uReferenceCount );
-	}
+	if( m_uHandleIndex == 0 )
+		return nullptr;
+
+	// Lock-free, the pointer is read first : a pointer published for a newer object comes with its newer generation, which does not match
+	WeakHandle& oHandle = GetWeakHandleTable().GetHandle( m_uHandleIndex );
+	Intrusive* pPtr = oHandle.m_pPtr.load( std::memory_order_acquire );
+	return oHandle.m_uGeneration.load( std::memory_order_acquire ) == m_uHandleGeneration ? pPtr : nullptr;
 }
 
-void StrongPtrBase::RemoveReference()
+void WeakPtrBase::AcquireHandle( Intrusive* pPtr )
 {
-	if( m_pPtr != nullptr )
+	if( pPtr == nullptr )
 	{
-		ASSERT( m_pPtr->m_uReferenceCount > 0 );
-		if( --( m_pPtr->m_uReferenceCount ) == 0 )
-			delete m_pPtr;;
+		m_uHandleIndex = 0;
+		m_uHandleGeneration = 0;
+		return;
 	}
-}
-
-WeakPtrBase::WeakPtrBase()
-	: m_pPtr( nullptr )
-	, m_pNext( nullptr )
-{
-}
-
-WeakPtrBase::WeakPtrBase( Intrusive* pPtr )
-	: m_pPtr( pPtr )
-	, m_pNext( nullptr )
-{
-	AddLink();
-}
-
-WeakPtrBase::WeakPtrBase( const WeakPtrBase& xPtr )
-	: m_pPtr( xPtr.m_pPtr )
-	, m_pNext( nullptr )
-{
-	AddLink();
-}
 
-WeakPtrBase& WeakPtrBase::operator=( const WeakPtrBase& xPtr )
-{
-	if( &xPtr == this )
-		return *this;
+	ASSERT( pPtr->GetReferenceCount() > 0 );
 
-	RemoveLink();
+	WeakHandleTable& oWeakHandleTable = GetWeakHandleTable();
+	std::lock_guard oLock( oWeakHandleTable.m_oMutex );
 
-	m_pPtr = xPtr.m_pPtr;
+	uint uWeakHandleIndex = pPtr->GetWeakHandleIndex();
+	if( uWeakHandleIndex == 0 )
+	{
+		uWeakHandleIndex = oWeakHandleTable.Allocate( pPtr );
+		pPtr->SetWeakHandleIndex( uWeakHandleIndex );
+	}
 
-	AddLink();
+	WeakHandle& oHandle = oWeakHandleTable.GetHandle( uWeakHandleIndex );
+	++oHandle.m_uWeakCount;
 
-	return *this;
+	m_uHandleIndex = uWeakHandleIndex;
+	m_uHandleGeneration = oHandle.m_uGeneration.load( std::memory_order_relaxed );
 }
 
-WeakPtrBase::~WeakPtrBase()
+void WeakPtrBase::ReleaseHandle()
 {
-	RemoveLink();
-}
+	if( m_uHandleIndex == 0 )
+		return;
 
-void WeakPtrBase::AddLink()
-{
-	if( m_pPtr != nullptr )
+	WeakHandleTable& oWeakHandleTable = GetWeakHandleTable();
 	{
-		ASSERT( m_pPtr->m_uReferenceCount > 0 );
-		m_pNext = m_pPtr->m_pWeakLink;
-		m_pPtr->m_pWeakLink = this;
-	}
-}
+		std::lock_guard oLock( oWeakHandleTable.m_oMutex );
 
-void WeakPtrBase::RemoveLink()
-{
-	if( m_pPtr != nullptr && m_pPtr->m_pWeakLink != nullptr )
-	{
-		if( m_pPtr->m_pWeakLink == this )
+		// Handles of destroyed objects have already been recycled, there is nothing to release
+		WeakHandle& oHandle = oWeakHandleTable.GetHandle( m_uHandleIndex );
+		if( oHandle.m_uGeneration.load( std::memory_order_relaxed ) == m_uHandleGeneration )
 		{
-			m_pPtr->m_pWeakLink = m_pNext;
-		}
-		else
-		{
-			WeakPtrBase* pLink = m_pPtr->m_pWeakLink;
-			while( pLink->m_pNext != nullptr )
+			ASSERT( oHandle.m_uWeakCount > 0 );
+			if( --oHandle.m_uWeakCount == 0 )
 			{
-				if( pLink->m_pNext == this )
-					pLink->m_pNext = m_pNext;
-				else
-					pLink = pLink->m_pNext;
+				oHandle.m_pPtr.load( std::memory_order_relaxed )->SetWeakHandleIndex( 0 );
+				oWeakHandleTable.Free( m_uHandleIndex );
 			}
 		}
 	}
+
+	m_uHandleIndex = 0;
+	m_uHandleGeneration = 0;
 }
@@ -1,10 +1,20 @@
 #pragma once
 
+#include <atomic>
 #include <type_traits>
 
 #include "Common.h"
 #include "Types.h"
 
+// Objects only referenced from one thread at a time keep the cheaper local policy which Intrusive defaults to
+// Objects referenced and released from several threads use the atomic one, the last release is the only one destroying the object
+// The policy is stored in the object rather than taken from the type of the StrongPtr, pointers to a base class count references as the object needs
+enum class ReferencePolicy : uint8
+{
+	LOCAL,
+	ATOMIC
+};
+
 class Intrusive
 {
 public:
@@ -16,39 +26,73 @@ public:
 	friend class WeakPtrBase;
 
 	Intrusive();
+	explicit Intrusive( const ReferencePolicy eReferencePolicy );
 	virtual ~Intrusive();
 
 	virtual uint64 GetSize() const = 0;
 
-	uint GetReferenceCount() const;
+	uint GetReferenceCount() const
+	{
+		if( m_eReferencePolicy == ReferencePolicy::ATOMIC )
+			return std::atomic_ref< uint >( const_cast< uint& >( m_uReferenceCount ) ).load( std::memory_order_relaxed );
+
+		return m_uReferenceCount;
+	}
+
+	ReferencePolicy GetReferencePolicy() const;
 	uint CountWeakReferences() const;
 
 private:
+	void AddReference()
+	{
+		if( m_eReferencePolicy == ReferencePolicy::ATOMIC )
+			std::atomic_ref< uint >( m_uReferenceCount ).fetch_add( 1, std::memory_order_relaxed );
+		else
+			++m_uReferenceCount;
+	}
+
+	// Returns true for the last reference
+	bool RemoveReference()
+	{
+		if( m_eReferencePolicy == ReferencePolicy::ATOMIC )
+			return std::atomic_ref< uint >( m_uReferenceCount ).fetch_sub( 1, std::memory_order_acq_rel ) == 1;
+
+		return --m_uReferenceCount == 0;
+	}
+
+	// Set and reset under the lock of the weak handles, read without it to skip the lock when the object has no weak reference
+	uint GetWeakHandleIndex() const
+	{
+		return std::atomic_ref< uint >( const_cast< uint& >( m_uWeakHandleIndex ) ).load( std::memory_order_relaxed );
+	}
+
+	void SetWeakHandleIndex( const uint uIndex )
+	{
+		std::atomic_ref< uint >( m_uWeakHandleIndex ).store( uIndex, std::memory_order_relaxed );
+	}
+
 	void TrackMemory();
 	void UnTrackMemory();
 
-	WeakPtrBase*	m_pWeakLink;
 	uint			m_uReferenceCount;
+	uint			m_uWeakHandleIndex;
+	ReferencePolicy	m_eReferencePolicy;
 };
 
 class StrongPtrBase
 {
 public:
-	StrongPtrBase();
-	StrongPtrBase( Intrusive* pPtr );
-
-	StrongPtrBase( const StrongPtrBase& xPtr );
-	StrongPtrBase& operator=( const StrongPtrBase& xPtr );
-
-	StrongPtrBase( StrongPtrBase&& xPtr ) noexcept;
-	StrongPtrBase& operator=( StrongPtrBase&& xPtr ) noexcept;
+	StrongPtrBase()
+		: m_pPtr( nullptr )
+	{
+	}
 
-	~StrongPtrBase();
+	StrongPtrBase( Intrusive* pPtr )
+		: m_pPtr( pPtr )
+	{
+	}
 
 protected:
-	void	AddReference();
-	void	RemoveReference();
-
 	Intrusive* m_pPtr;
 };
 
@@ -65,29 +109,82 @@ public:
 		: StrongPtrBase( ( Intrusive* )pPtr )
 	{
 		static_assert( std::is_base_of_v< Intrusive, T >, "Trying to make a StrongPtr to a non-intrusive object." );
+
+		if( m_pPtr != nullptr )
+			m_pPtr->AddReference();
+	}
+
+	StrongPtr( const StrongPtr& xPtr )
+		: StrongPtrBase( xPtr.m_pPtr )
+	{
+		AddReference();
+	}
+
+	StrongPtr& operator=( const StrongPtr& xPtr )
+	{
+		if( &xPtr == this )
+			return *this;
+
+		RemoveReference();
+
+		m_pPtr = xPtr.m_pPtr;
+
+		AddReference();
+
+		return *this;
+	}
+
+	StrongPtr( StrongPtr&& xPtr ) noexcept
+		: StrongPtrBase( xPtr.m_pPtr )
+	{
+		if( m_pPtr != nullptr )
+			ASSERT( m_pPtr->GetReferenceCount() > 0 );
+
+		xPtr.m_pPtr = nullptr;
+	}
+
+	StrongPtr& operator=( StrongPtr&& xPtr ) noexcept
+	{
+		if( &xPtr == this )
+			return *this;
+
+		RemoveReference();
+
+		m_pPtr = xPtr.m_pPtr;
+		if( m_pPtr != nullptr )
+			ASSERT( m_pPtr->GetReferenceCount() > 0 );
+
+		xPtr.m_pPtr = nullptr;
+
+		return *this;
+	}
+
+	~StrongPtr()
+	{
+		RemoveReference();
 	}
 
 	T* operator->()
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
+		ASSERT( m_pPtr != nullptr && m_pPtr->GetReferenceCount() > 0 );
 		return ( T* )m_pPtr;
 	}
 
 	const T* operator->() const
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
+		ASSERT( m_pPtr != nullptr && m_pPtr->GetReferenceCount() > 0 );
 		return ( T* ) m_pPtr;
 	}
 
 	T& operator*()
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
+		ASSERT( m_pPtr != nullptr && m_pPtr->GetReferenceCount() > 0 );
 		return *( ( T* ) m_pPtr );
 	}
 
 	const T& operator*() const
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
+		ASSERT( m_pPtr != nullptr && m_pPtr->GetReferenceCount() > 0 );
 		return *( ( T* ) m_pPtr );
 	}
 
@@ -115,8 +212,33 @@ public:
 	{
 		return ( T* ) m_pPtr;
 	}
+
+private:
+	void AddReference()
+	{
+		if( m_pPtr != nullptr )
+		{
+			ASSERT( m_pPtr->GetReferenceCount() > 0 );
+			m_pPtr->AddReference();
+		}
+	}
+
+	void RemoveReference()
+	{
+		if( m_pPtr != nullptr )
+		{
+			ASSERT( m_pPtr->GetReferenceCount() > 0 );
+			if( m_pPtr->RemoveReference() )
+				delete m_pPtr;
+		}
+	}
 };
 
+// Weak references point to a slot of a global table of generational handles rather than to the object itself
+// Destroying the object bumps the generation of its slot, which invalidates every weak reference to it at once
+// Acquiring and releasing handles goes through a mutex, objects with weak references may be destroyed on any thread
+// Resolving is lock-free, it only checks the generation of the slot
+// The resolved pointer is only guaranteed to stay valid while the object cannot be destroyed : a thread resolving a weak reference to an object released on another thread must hold a StrongPtr to it
 class WeakPtrBase
 {
 public:
@@ -128,17 +250,19 @@ public:
 	WeakPtrBase( const WeakPtrBase& xPtr );
 	WeakPtrBase& operator=( const WeakPtrBase& xPtr );
 
-	WeakPtrBase( WeakPtrBase&& xPtr ) = delete;
-	WeakPtrBase& operator=( WeakPtrBase&& xPtr ) = delete;
+	WeakPtrBase( WeakPtrBase&& xPtr ) noexcept;
+	WeakPtrBase& operator=( WeakPtrBase&& xPtr ) noexcept;
 
 	~WeakPtrBase();
 
 protected:
-	void AddLink();
-	void RemoveLink();
+	Intrusive*	Resolve() const;
 
-	Intrusive*		m_pPtr;
-	WeakPtrBase*	m_pNext;
+	void		AcquireHandle( Intrusive* pPtr );
+	void		ReleaseHandle();
+
+	uint		m_uHandleIndex;
+	uint		m_uHandleGeneration;
 };
 
 template < typename T >
@@ -158,50 +282,54 @@ public:
 
 	T* operator->()
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
-		return ( T* ) m_pPtr;
+		Intrusive* pPtr = Resolve();
+		ASSERT( pPtr != nullptr && pPtr->GetReferenceCount() > 0 );
+		return ( T* )pPtr;
 	}
 
 	const T* operator->() const
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
-		return ( T* ) m_pPtr;
+		Intrusive* pPtr = Resolve();
+		ASSERT( pPtr != nullptr && pPtr->GetReferenceCount() > 0 );
+		return ( T* )pPtr;
 	}
 
 	T& operator*()
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
-		return *( ( T* ) m_pPtr );
+		Intrusive* pPtr = Resolve();
+		ASSERT( pPtr != nullptr && pPtr->GetReferenceCount() > 0 );
+		return *( ( T* )pPtr );
 	}
 
 	const T& operator*() const
 	{
-		ASSERT( m_pPtr != nullptr && m_pPtr->m_uReferenceCount > 0 );
-		return *( ( T* ) m_pPtr );
+		Intrusive* pPtr = Resolve();
+		ASSERT( pPtr != nullptr && pPtr->GetReferenceCount() > 0 );
+		return *( ( T* )pPtr );
 	}
 
 	bool operator!() const
 	{
-		return !m_pPtr;
+		return Resolve() == nullptr;
 	}
 
 	bool operator==( T* pPtr ) const
 	{
-		return m_pPtr == pPtr;
+		return Resolve() == pPtr;
 	}
 
 	bool operator!=( T* pPtr ) const
 	{
-		return m_pPtr != pPtr;
+		return Resolve() != pPtr;
 	}
 
 	T* GetPtr()
 	{
-		return ( T* ) m_pPtr;
+		return ( T* )Resolve();
 	}
 
 	const T* GetPtr() const
 	{
-		return ( T* ) m_pPtr;
+		return ( T* )Resolve();
 	}
 };
\ No newline at end of file
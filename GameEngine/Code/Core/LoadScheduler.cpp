@@ -0,0 +1,761 @@
+#include "LoadScheduler.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+#include <algorithm>
+#include <format>
+
+#include "Common.h"
+#include "PackFile.h"
+#include "Profiler.h"
+
+//constexpr uint IO_THREAD_AFFINITY_MASK = 1 << 1;
+
+// Time given each frame to the finalization of loaded resources, matches the budget of HandleLoadedResources
+static constexpr std::chrono::microseconds FINALIZATION_BUDGET( 2000 );
+
+// Background loads leave room for the others
+static constexpr uint64 DEFAULT_IN_FLIGHT_BYTES_BUDGETS[] = { 64ull << 20, 192ull << 20, 256ull << 20 };
+static_assert( std::size( DEFAULT_IN_FLIGHT_BYTES_BUDGETS ) == ( size_t )LoadPriority::_COUNT );
+
+// Distances are rounded to the unit, the ones further away are loaded in the order they were requested
+static constexpr int MAX_PRIORITY_DISTANCE = 0xFFFF;
+
+LoadScheduler::LoadScheduler( const uint uDecodeThreadCount )
+	: m_uNextLoadCommandSequence( 0 )
+	, m_uWaitingDependenciesLoadCommandCount( 0 )
+	, m_bReadsOutdated( false )
+	, m_bRunning( true )
+	, m_bUpdateReads( false )
+	, m_uInFlightBytes( 0 )
+{
+	for( int i = 0; i < ( int )LoadPriority::_COUNT; ++i )
+		m_aInFlightBytesBudgets[ i ] = DEFAULT_IN_FLIGHT_BYTES_BUDGETS[ i ];
+
+	// Threads are started last, once every member they use is constructed
+	m_oIOThread = std::jthread( &LoadScheduler::Load, this );
+
+#ifdef _WIN32
+	//SetThreadAffinityMask( m_oIOThread.native_handle(), IO_THREAD_AFFINITY_MASK );
+	SetThreadDescription( m_oIOThread.native_handle(), L"IO thread" );
+#endif
+
+	for( uint u = 0; u < uDecodeThreadCount; ++u )
+	{
+		std::thread* pThread = new std::thread( &LoadScheduler::Decode, this );
+#ifdef _WIN32
+		SetThreadDescription( pThread->native_handle(), L"Decode thread" );
+#endif
+		m_aDecodeThreads.PushBack( pThread );
+	}
+}
+
+LoadScheduler::~LoadScheduler()
+{
+	{
+		std::unique_lock oLock( m_oProcessingCommandsMutex );
+		m_bRunning = false;
+	}
+	m_oProcessingCommandsConditionVariable.notify_one();
+	m_oFileReader.Interrupt();
+
+	// The IO thread is stopped first so that no decode job is added after the decode threads are stopped
+	m_oIOThread.join();
+
+	{
+		std::unique_lock oLock( m_oDecodeJobsMutex );
+		m_oDecodeJobsConditionVariable.notify_all();
+	}
+
+	for( std::thread* pThread : m_aDecodeThreads )
+	{
+		pThread->join();
+		delete pThread;
+	}
+
+	for( const DecodeJob& oDecodeJob : m_aDecodeJobs )
+	{
+		delete oDecodeJob.m_pLoadCommand;
+		delete oDecodeJob.m_pRead;
+	}
+
+	// Reads not delivered to the IO thread yet own their command
+	m_oFileReader.CancelAll();
+	uint uReadCount = m_aReadingLoadCommands.Count();
+	while( uReadCount > 0 )
+	{
+		// Returns nullptr once when the IO thread stopped before being interrupted
+		AsyncRead* pRead = m_oFileReader.PopDelivered( true );
+		if( pRead == nullptr )
+			continue;
+
+		delete static_cast< LoadCommandBase* >( pRead->m_pUserData );
+		delete pRead;
+		--uReadCount;
+	}
+
+	for( Array< LoadCommandBase* >* pLoadCommands : { &m_aPendingLoadCommands, &m_aProcessingLoadCommands, &m_aQueuedLoadCommands, &m_aLoadedLoadCommands, &m_aFinalizingLoadCommands } )
+	{
+		for( LoadCommandBase* pLoadCommand : *pLoadCommands )
+			delete pLoadCommand;
+	}
+
+	for( const auto& oPair : m_mLoadCommands )
+	{
+		if( oPair.second->m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
+			delete oPair.second;
+	}
+}
+
+void LoadScheduler::PushLoadCommand( LoadCommandBase* pLoadCommand, const LoadPriority ePriority )
+{
+	pLoadCommand->m_uSequence = m_uNextLoadCommandSequence++;
+	pLoadCommand->UpdatePriority( ePriority, 0.f );
+	m_aPendingLoadCommands.PushBack( pLoadCommand );
+	m_mLoadCommands[ pLoadCommand->GetResource() ] = pLoadCommand;
+}
+
+void LoadScheduler::PushLoadCommand( LoadCommandBase* pLoadCommand, const LoadPriority ePriority, Array< uint8 >&& aData )
+{
+	pLoadCommand->m_uSequence = m_uNextLoadCommandSequence++;
+	pLoadCommand->UpdatePriority( ePriority, 0.f );
+	pLoadCommand->m_eStatus = LoadCommandStatus::LOADING;
+	m_mLoadCommands[ pLoadCommand->GetResource() ] = pLoadCommand;
+
+	// There is nothing to read, the data is handed over to the decode threads as a completed read
+	AsyncRead* pRead = new AsyncRead();
+	pRead->m_eStatus = AsyncReadStatus::COMPLETED;
+	pRead->m_aData = std::move( aData );
+	pRead->m_pUserData = pLoadCommand;
+	PushDecodeJob( pLoadCommand, pRead );
+}
+
+void LoadScheduler::UpdateLoadPriority( const Resource* pResource, const LoadPriority ePriority, const float fDistance /*= 0.f*/ )
+{
+	if( m_mLoadCommands.contains( pResource ) )
+		AddLoadRequest( pResource, LoadRequest { ePriority, fDistance } );
+}
+
+void LoadScheduler::RaiseLoadPriority( const Resource* pResource, const LoadPriority ePriority )
+{
+	const auto it = m_mLoadCommands.find( pResource );
+	if( it == m_mLoadCommands.end() || it->second->m_ePriority >= ePriority )
+		return;
+
+	it->second->UpdatePriority( ePriority, it->second->m_fDistance );
+	m_bReadsOutdated = true;
+}
+
+void LoadScheduler::SetInFlightBytesBudget( const LoadPriority ePriority, const uint64 uBytes )
+{
+	m_aInFlightBytesBudgets[ ( int )ePriority ] = uBytes;
+	m_bReadsOutdated = true;
+}
+
+uint64 LoadScheduler::GetInFlightBytesBudget( const LoadPriority ePriority ) const
+{
+	return m_aInFlightBytesBudgets[ ( int )ePriority ];
+}
+
+void LoadScheduler::CancelLoadCommand( const Resource* pResource )
+{
+	const auto it = m_mLoadCommands.find( pResource );
+	ASSERT( it != m_mLoadCommands.end() );
+
+	SLOG_INFO( LogCategory::RESOURCES, "Cancelling {}", it->second->m_sFilePath );
+	it->second->m_bCancelled = true;
+	m_bReadsOutdated = true;
+}
+
+void LoadScheduler::ProcessPendingLoadCommands()
+{
+	PROFILE_SCOPE( "ProcessLoadCommands" );
+
+	PROFILE_COUNTER( "Pending load commands", m_aPendingLoadCommands.Count() );
+
+	ApplyLoadRequests();
+
+	if( m_aPendingLoadCommands.Empty() && m_bReadsOutdated == false )
+		return;
+
+	// New commands are handed over every frame, even when others are still loading
+	{
+		std::unique_lock oLock( m_oProcessingCommandsMutex );
+
+		m_aProcessingLoadCommands.Reserve( m_aProcessingLoadCommands.Count() + m_aPendingLoadCommands.Count() );
+		for( LoadCommandBase* pLoadCommand : m_aPendingLoadCommands )
+			m_aProcessingLoadCommands.PushBack( pLoadCommand );
+
+		m_bUpdateReads |= m_bReadsOutdated;
+	}
+
+	m_aPendingLoadCommands.Clear();
+	m_bReadsOutdated = false;
+
+	m_oProcessingCommandsConditionVariable.notify_one();
+	m_oFileReader.Interrupt();
+}
+
+void LoadScheduler::FinalizeLoadCommands()
+{
+	PROFILE_SCOPE( "FinalizeLoadCommands" );
+
+	const GameTimePoint oDeadline = std::chrono::high_resolution_clock::now() + FINALIZATION_BUDGET;
+
+	{
+		std::unique_lock oLock( m_oProcessingCommandsMutex );
+
+		PROFILE_COUNTER( "Processing load commands", m_aProcessingLoadCommands.Count() );
+		PROFILE_COUNTER( "Loaded load commands", m_aLoadedLoadCommands.Count() );
+
+		m_aFinalizingLoadCommands.Reserve( m_aFinalizingLoadCommands.Count() + m_aLoadedLoadCommands.Count() );
+		for( LoadCommandBase* pLoadCommand : m_aLoadedLoadCommands )
+			m_aFinalizingLoadCommands.PushBack( pLoadCommand );
+
+		m_aLoadedLoadCommands.Clear();
+	}
+
+	{
+		std::unique_lock oDecodeJobsLock( m_oDecodeJobsMutex );
+		PROFILE_COUNTER( "Decode jobs", m_aDecodeJobs.Count() );
+	}
+
+	PROFILE_COUNTER( "Pending reads", m_oFileReader.GetPendingCount() );
+	PROFILE_COUNTER( "In flight reads", m_oFileReader.GetInFlightCount() );
+	PROFILE_COUNTER( "Finalizing load commands", m_aFinalizingLoadCommands.Count() );
+	PROFILE_COUNTER( "In flight bytes", m_uInFlightBytes.load() );
+
+	if( m_aFinalizingLoadCommands.Empty() )
+		return;
+
+	// The next command to finalize is at the back
+	std::sort( m_aFinalizingLoadCommands.begin(), m_aFinalizingLoadCommands.end(), &LoadCommandBase::ComparePriorities );
+
+	// At least one command is finalized each frame, even when it does not fit in the budget
+	uint64 uReleasedBytes = 0;
+	bool bFirst = true;
+	while( m_aFinalizingLoadCommands.Empty() == false )
+	{
+		if( bFirst == false && std::chrono::high_resolution_clock::now() >= oDeadline )
+			break;
+
+		bFirst = false;
+
+		LoadCommandBase* pLoadCommand = m_aFinalizingLoadCommands.Back();
+		const uint64 uInFlightBytes = pLoadCommand->m_uInFlightBytes;
+		if( FinalizeLoadCommand( pLoadCommand, oDeadline ) == false )
+			break;
+
+		m_aFinalizingLoadCommands.PopBack();
+		uReleasedBytes += uInFlightBytes;
+	}
+
+	// Lets the IO thread issue the reads waiting for the budgets
+	if( uReleasedBytes > 0 )
+	{
+		m_uInFlightBytes -= uReleasedBytes;
+		m_bReadsOutdated = true;
+	}
+}
+
+uint LoadScheduler::GetPendingLoadCommandCount() const
+{
+	return m_aPendingLoadCommands.Count();
+}
+
+uint LoadScheduler::GetFinalizingLoadCommandCount() const
+{
+	return m_aFinalizingLoadCommands.Count();
+}
+
+uint LoadScheduler::GetWaitingDependenciesLoadCommandCount() const
+{
+	return m_uWaitingDependenciesLoadCommandCount;
+}
+
+uint64 LoadScheduler::GetInFlightBytes() const
+{
+	return m_uInFlightBytes;
+}
+
+bool LoadScheduler::AddLoadRequest( const Resource* pResource, const LoadRequest& oRequest )
+{
+	const auto oResult = m_mLoadRequests.try_emplace( pResource, oRequest );
+	if( oResult.second )
+		return true;
+
+	LoadRequest& oFrameRequest = oResult.first->second;
+	if( oRequest.m_ePriority <= oFrameRequest.m_ePriority && oRequest.m_fDistance >= oFrameRequest.m_fDistance )
+		return false;
+
+	oFrameRequest.m_ePriority = std::max( oFrameRequest.m_ePriority, oRequest.m_ePriority );
+	oFrameRequest.m_fDistance = std::min( oFrameRequest.m_fDistance, oRequest.m_fDistance );
+	return true;
+}
+
+void LoadScheduler::ApplyLoadRequests()
+{
+	if( m_mLoadRequests.empty() )
+		return;
+
+	// Dependencies still loading, like the textures of a model, are requested along with the commands waiting for them
+	Array< const Resource* > aRequestedResources;
+	aRequestedResources.Reserve( ( uint )m_mLoadRequests.size() );
+	for( const auto& oPair : m_mLoadRequests )
+		aRequestedResources.PushBack( oPair.first );
+
+	while( aRequestedResources.Empty() == false )
+	{
+		const Resource* pResource = aRequestedResources.Back();
+		aRequestedResources.PopBack();
+
+		const auto it = m_mLoadCommands.find( pResource );
+		if( it == m_mLoadCommands.end() )
+			continue;
+
+		// Copied as adding the requests of the dependencies can rehash the map
+		const LoadRequest oRequest = m_mLoadRequests[ pResource ];
+		for( const StrongPtr< Resource >& xDependency : it->second->m_aDependencies )
+		{
+			if( xDependency->IsLoading() && AddLoadRequest( xDependency.GetPtr(), oRequest ) )
+				aRequestedResources.PushBack( xDependency.GetPtr() );
+		}
+	}
+
+	for( const auto& oPair : m_mLoadRequests )
+	{
+		const auto it = m_mLoadCommands.find( oPair.first );
+		if( it == m_mLoadCommands.end() )
+			continue;
+
+		LoadCommandBase* pLoadCommand = it->second;
+		const LoadPriority ePriority = std::max( pLoadCommand->m_ePriority.load(), oPair.second.m_ePriority );
+		if( ePriority == pLoadCommand->m_ePriority && oPair.second.m_fDistance == pLoadCommand->m_fDistance )
+			continue;
+
+		pLoadCommand->UpdatePriority( ePriority, oPair.second.m_fDistance );
+		m_bReadsOutdated = true;
+	}
+
+	m_mLoadRequests.clear();
+}
+
+void LoadScheduler::Load()
+{
+	PROFILE_THREAD_NAME( "IO thread" );
+
+	std::unique_lock oLock( m_oProcessingCommandsMutex, std::defer_lock );
+	Array< LoadCommandBase* > aLoadCommands;
+
+	while( true )
+	{
+		oLock.lock();
+		// Only waits for new commands when no read is left, they interrupt the wait for reads otherwise
+		if( m_aReadingLoadCommands.Empty() )
+			m_oProcessingCommandsConditionVariable.wait( oLock, [ this ]() { return m_aProcessingLoadCommands.Empty() == false || m_bUpdateReads || m_bRunning == false; } );
+
+		if( m_bRunning == false )
+			return;
+
+		aLoadCommands.Grab( m_aProcessingLoadCommands );
+		const bool bUpdateReads = m_bUpdateReads;
+		m_bUpdateReads = false;
+		oLock.unlock();
+
+		LocateFiles( aLoadCommands, oLock );
+		aLoadCommands.Clear();
+
+		if( bUpdateReads )
+			UpdateReads();
+
+		// Every read that fits in the budgets is in flight at once, so that a slow file does not stall the others, and files are decoded as they come
+		ReadFiles( oLock );
+
+		while( m_aReadingLoadCommands.Empty() == false && m_bRunning )
+		{
+			AsyncRead* pRead = m_oFileReader.PopDelivered( true );
+			if( pRead == nullptr )
+				break;
+
+			LoadCommandBase& oLoadCommand = *static_cast< LoadCommandBase* >( pRead->m_pUserData );
+			for( uint u = 0; u < m_aReadingLoadCommands.Count(); ++u )
+			{
+				if( m_aReadingLoadCommands[ u ] == &oLoadCommand )
+				{
+					m_aReadingLoadCommands[ u ] = m_aReadingLoadCommands.Back();
+					m_aReadingLoadCommands.PopBack();
+					break;
+				}
+			}
+
+			oLoadCommand.m_pRead = nullptr;
+
+			if( oLoadCommand.m_eStage == LoadStage::IO || oLoadCommand.m_bCancelled )
+			{
+				DecodeFile( oLoadCommand, pRead, oLock );
+				continue;
+			}
+
+			PushDecodeJob( &oLoadCommand, pRead );
+		}
+	}
+}
+
+void LoadScheduler::Decode()
+{
+	PROFILE_THREAD_NAME( "Decode thread" );
+
+	std::unique_lock oLock( m_oProcessingCommandsMutex, std::defer_lock );
+
+	while( true )
+	{
+		DecodeJob oDecodeJob;
+
+		{
+			std::unique_lock oDecodeJobsLock( m_oDecodeJobsMutex );
+			m_oDecodeJobsConditionVariable.wait( oDecodeJobsLock, [ this ]() { return m_aDecodeJobs.Empty() == false || m_bRunning == false; } );
+
+			if( m_bRunning == false )
+				return;
+
+			// Highest priority first, then in the order the files were read
+			uint uJob = 0;
+			for( uint u = 1; u < m_aDecodeJobs.Count(); ++u )
+			{
+				if( m_aDecodeJobs[ u ].m_pLoadCommand->m_iPriority > m_aDecodeJobs[ uJob ].m_pLoadCommand->m_iPriority )
+					uJob = u;
+			}
+
+			oDecodeJob = m_aDecodeJobs[ uJob ];
+			m_aDecodeJobs.Remove( uJob );
+		}
+
+		DecodeFile( *oDecodeJob.m_pLoadCommand, oDecodeJob.m_pRead, oLock );
+	}
+}
+
+void LoadScheduler::LocateFiles( const Array< LoadCommandBase* >& aLoadCommands, std::unique_lock< std::mutex >& oLock )
+{
+	for( LoadCommandBase* pLoadCommand : aLoadCommands )
+	{
+		if( pLoadCommand->m_bCancelled )
+		{
+			pLoadCommand->m_eStatus = LoadCommandStatus::CANCELLED;
+			PushLoadedLoadCommand( *pLoadCommand, oLock );
+			continue;
+		}
+
+		{
+			PROFILE_SCOPE_DETAILED( "CheckResource" );
+
+			if( g_pVirtualFileSystem->Locate( pLoadCommand->GetFilePath(), pLoadCommand->m_oLocation ) == false )
+			{
+				pLoadCommand->m_eStatus = LoadCommandStatus::NOT_FOUND;
+				PushLoadedLoadCommand( *pLoadCommand, oLock );
+				continue;
+			}
+		}
+
+		// Reads of an empty size would read the whole file, mapped files are not read at all
+		if( pLoadCommand->m_oLocation.m_uStoredSize == 0 || pLoadCommand->m_eStage == LoadStage::MAP )
+		{
+			PROFILE_SCOPE_NAMED( pLoadCommand->m_sCommandName );
+			pLoadCommand->Load( ArrayView< const uint8 >() );
+			PushLoadedLoadCommand( *pLoadCommand, oLock );
+			continue;
+		}
+
+		m_aQueuedLoadCommands.PushBack( pLoadCommand );
+	}
+}
+
+void LoadScheduler::UpdateReads()
+{
+	// Only reads still pending are reordered or dropped, the others are cancelled once delivered
+	for( LoadCommandBase* pLoadCommand : m_aReadingLoadCommands )
+	{
+		if( pLoadCommand->m_bCancelled )
+			m_oFileReader.Cancel( pLoadCommand->m_pRead );
+		else
+			m_oFileReader.SetPriority( pLoadCommand->m_pRead, pLoadCommand->m_iPriority );
+	}
+}
+
+void LoadScheduler::ReadFiles( std::unique_lock< std::mutex >& oLock )
+{
+	if( m_aQueuedLoadCommands.Empty() )
+		return;
+
+	std::sort( m_aQueuedLoadCommands.begin(), m_aQueuedLoadCommands.end(), &LoadCommandBase::ComparePriorities );
+
+	while( m_aQueuedLoadCommands.Empty() == false )
+	{
+		LoadCommandBase* pLoadCommand = m_aQueuedLoadCommands.Back();
+
+		if( pLoadCommand->m_bCancelled )
+		{
+			m_aQueuedLoadCommands.PopBack();
+			pLoadCommand->m_eStatus = LoadCommandStatus::CANCELLED;
+			PushLoadedLoadCommand( *pLoadCommand, oLock );
+			continue;
+		}
+
+		// A file larger than the budget is still read when nothing else is in flight
+		const VirtualFileLocation& oLocation = pLoadCommand->m_oLocation;
+		const uint64 uInFlightBytes = m_uInFlightBytes;
+		if( uInFlightBytes > 0 && uInFlightBytes + oLocation.m_uSize > m_aInFlightBytesBudgets[ ( int )pLoadCommand->m_ePriority.load() ] )
+			break;
+
+		m_aQueuedLoadCommands.PopBack();
+
+		pLoadCommand->m_eStatus = LoadCommandStatus::LOADING;
+		pLoadCommand->m_uInFlightBytes = oLocation.m_uSize;
+		m_uInFlightBytes += oLocation.m_uSize;
+
+		pLoadCommand->m_pRead = m_oFileReader.Read( oLocation.m_oFilePath, oLocation.m_uOffset, oLocation.m_uStoredSize, pLoadCommand->m_iPriority, pLoadCommand );
+		m_aReadingLoadCommands.PushBack( pLoadCommand );
+	}
+}
+
+void LoadScheduler::PushDecodeJob( LoadCommandBase* pLoadCommand, AsyncRead* pRead )
+{
+	{
+		std::unique_lock oDecodeJobsLock( m_oDecodeJobsMutex );
+		m_aDecodeJobs.PushBack( DecodeJob { pLoadCommand, pRead } );
+	}
+	m_oDecodeJobsConditionVariable.notify_one();
+}
+
+void LoadScheduler::DecodeFile( LoadCommandBase& oLoadCommand, AsyncRead* pRead, std::unique_lock< std::mutex >& oLock )
+{
+	const VirtualFileLocation& oLocation = oLoadCommand.m_oLocation;
+
+	{
+		PROFILE_SCOPE_NAMED( oLoadCommand.m_sCommandName );
+
+		Array< uint8 > aBuffer;
+		ArrayView< const uint8 > aData( pRead->m_aData.Data(), pRead->m_aData.Count() );
+
+		bool bRead = pRead->m_eStatus == AsyncReadStatus::COMPLETED && oLoadCommand.m_bCancelled == false;
+		if( bRead && oLocation.m_eCompression != PackCompression::NONE )
+		{
+			PROFILE_SCOPE_DETAILED( "Decompress" );
+
+			bRead = DecompressPackData( aData, oLocation.m_uSize, oLocation.m_eCompression, aBuffer );
+			aData = ArrayView< const uint8 >( aBuffer.Data(), aBuffer.Count() );
+		}
+
+		if( oLoadCommand.m_bCancelled )
+			oLoadCommand.m_eStatus = LoadCommandStatus::CANCELLED;
+		else if( bRead )
+			oLoadCommand.Load( aData );
+		else
+			oLoadCommand.m_eStatus = LoadCommandStatus::ERROR_READING;
+	}
+
+	delete pRead;
+
+	PushLoadedLoadCommand( oLoadCommand, oLock );
+}
+
+void LoadScheduler::PushLoadedLoadCommand( LoadCommandBase& oLoadCommand, std::unique_lock< std::mutex >& oLock )
+{
+	// The lock also publishes what the command loaded to the main thread
+	oLock.lock();
+	m_aLoadedLoadCommands.PushBack( &oLoadCommand );
+	oLock.unlock();
+}
+
+bool LoadScheduler::FinalizeLoadCommand( LoadCommandBase* pLoadCommand, const GameTimePoint oDeadline )
+{
+	// What was decoded or uploaded so far is dropped with the resource
+	if( pLoadCommand->m_bCancelled )
+	{
+		SLOG_INFO( LogCategory::RESOURCES, "Cancelled {}", pLoadCommand->m_sFilePath );
+		CompleteLoadCommand( pLoadCommand );
+		return true;
+	}
+
+	switch( pLoadCommand->m_eStatus )
+	{
+	case LoadCommandStatus::NOT_FOUND:
+		SLOG_ERROR( LogCategory::RESOURCES, "File not found {}", pLoadCommand->m_sFilePath );
+		pLoadCommand->OnFinished();
+		CompleteLoadCommand( pLoadCommand );
+		return true;
+	case LoadCommandStatus::ERROR_READING:
+		SLOG_ERROR( LogCategory::RESOURCES, "Error reading file {}", pLoadCommand->m_sFilePath );
+		pLoadCommand->OnFinished();
+		CompleteLoadCommand( pLoadCommand );
+		return true;
+	case LoadCommandStatus::LOADED:
+		SLOG_INFO( LogCategory::RESOURCES, "Loaded {}", pLoadCommand->m_sFilePath );
+		pLoadCommand->m_eStatus = LoadCommandStatus::FINISHED;
+		pLoadCommand->OnFinished();
+		pLoadCommand->m_eStatus = LoadCommandStatus::UPLOADING;
+		[[fallthrough]];
+	case LoadCommandStatus::UPLOADING:
+		if( pLoadCommand->Upload( oDeadline ) == false )
+			return false;
+
+		pLoadCommand->m_eStatus = LoadCommandStatus::FINISHED;
+		if( pLoadCommand->HasDependencies() )
+			WaitDependencies( pLoadCommand );
+		else
+			CompleteLoadCommand( pLoadCommand );
+		return true;
+	default:
+		ASSERT( false );
+		return true;
+	}
+}
+
+void LoadScheduler::WaitDependencies( LoadCommandBase* pLoadCommand )
+{
+	// Each dependency still loading gets an edge to the command, resolved once when its own command completes
+	for( const StrongPtr< Resource >& xDependency : pLoadCommand->m_aDependencies )
+	{
+		if( xDependency->IsLoading() == false )
+			continue;
+
+		const auto it = m_mLoadCommands.find( xDependency.GetPtr() );
+		ASSERT( it != m_mLoadCommands.end() );
+
+		it->second->m_aDependents.PushBack( pLoadCommand );
+		++pLoadCommand->m_uWaitingDependencyCount;
+
+		// Dependencies requested by the command are loaded as urgently as it
+		AddLoadRequest( xDependency.GetPtr(), LoadRequest { pLoadCommand->m_ePriority, pLoadCommand->m_fDistance } );
+	}
+
+	if( pLoadCommand->m_uWaitingDependencyCount == 0 )
+	{
+		ResolveDependencies( *pLoadCommand );
+		CompleteLoadCommand( pLoadCommand );
+		return;
+	}
+
+	SLOG_INFO( LogCategory::RESOURCES, "Waiting dependencies for {}", pLoadCommand->m_sFilePath );
+	pLoadCommand->m_eStatus = LoadCommandStatus::WAITING_DEPENDENCIES;
+	++m_uWaitingDependenciesLoadCommandCount;
+}
+
+void LoadScheduler::ResolveDependencies( LoadCommandBase& oLoadCommand )
+{
+	if( oLoadCommand.m_bCancelled )
+		return;
+
+	if( oLoadCommand.AnyDependencyFailed() )
+	{
+		SLOG_ERROR( LogCategory::RESOURCES, "Failed to load a dependency for {}", oLoadCommand.m_sFilePath );
+		oLoadCommand.m_eStatus = LoadCommandStatus::ERROR_READING;
+	}
+	else
+	{
+		SLOG_INFO( LogCategory::RESOURCES, "Dependencies ready for {}", oLoadCommand.m_sFilePath );
+		oLoadCommand.m_eStatus = LoadCommandStatus::FINISHED;
+	}
+
+	oLoadCommand.OnDependenciesReady();
+}
+
+void LoadScheduler::CompleteLoadCommand( LoadCommandBase* pLoadCommand )
+{
+	// Completing a command can complete its dependents in turn, they are handled here rather than recursively
+	Array< LoadCommandBase* > aCompletedLoadCommands;
+	aCompletedLoadCommands.PushBack( pLoadCommand );
+
+	while( aCompletedLoadCommands.Empty() == false )
+	{
+		LoadCommandBase* pCompletedLoadCommand = aCompletedLoadCommands.Back();
+		aCompletedLoadCommands.PopBack();
+
+		m_mLoadCommands.erase( pCompletedLoadCommand->GetResource() );
+
+		// No one references the resource anymore, it only needs to release what it created
+		if( pCompletedLoadCommand->m_bCancelled )
+			pCompletedLoadCommand->GetResource()->Destroy();
+
+		for( LoadCommandBase* pDependent : pCompletedLoadCommand->m_aDependents )
+		{
+			ASSERT( pDependent->m_uWaitingDependencyCount > 0 );
+			if( --pDependent->m_uWaitingDependencyCount > 0 )
+				continue;
+
+			--m_uWaitingDependenciesLoadCommandCount;
+			ResolveDependencies( *pDependent );
+			aCompletedLoadCommands.PushBack( pDependent );
+		}
+
+		delete pCompletedLoadCommand;
+	}
+}
+
+LoadCommandBase::LoadCommandBase( const char* sFilePath, const LoadStage eStage, const int iTypePriority, const char* sCommandName )
+	: m_sFilePath( sFilePath )
+	, m_eStatus( LoadCommandStatus::PENDING )
+	, m_eStage( eStage )
+	, m_ePriority( LoadPriority::NORMAL )
+	, m_iPriority( 0 )
+	, m_fDistance( 0.f )
+	, m_iTypePriority( iTypePriority )
+	, m_uSequence( 0 )
+	, m_bCancelled( false )
+	, m_uInFlightBytes( 0 )
+	, m_pRead( nullptr )
+	, m_sCommandName( sCommandName )
+	, m_uWaitingDependencyCount( 0 )
+{
+	UpdatePriority( LoadPriority::NORMAL, 0.f );
+}
+
+LoadCommandBase::~LoadCommandBase()
+{
+}
+
+std::string LoadCommandBase::GetFilePath() const
+{
+	return std::format( "Data/{}", m_sFilePath );
+}
+
+void LoadCommandBase::UpdatePriority( const LoadPriority ePriority, const float fDistance )
+{
+	m_ePriority = ePriority;
+	m_fDistance = fDistance;
+
+	// The class comes first, then the distance, then the type of resource
+	const int iDistance = ( int )std::clamp( fDistance, 0.f, ( float )MAX_PRIORITY_DISTANCE );
+	m_iPriority = ( ( int )ePriority << 24 ) | ( ( MAX_PRIORITY_DISTANCE - iDistance ) << 8 ) | m_iTypePriority;
+}
+
+bool LoadCommandBase::ComparePriorities( const LoadCommandBase* pA, const LoadCommandBase* pB )
+{
+	if( pA->m_iPriority != pB->m_iPriority )
+		return pA->m_iPriority < pB->m_iPriority;
+
+	return pA->m_uSequence > pB->m_uSequence;
+}
+
+bool LoadCommandBase::HasDependencies() const
+{
+	return m_aDependencies.Empty() == false;
+}
+
+bool LoadCommandBase::AnyDependencyFailed() const
+{
+	for( const StrongPtr< Resource >& xDependency : m_aDependencies )
+	{
+		if( xDependency->IsFailed() )
+			return true;
+	}
+
+	return false;
+}
+
+bool LoadCommandBase::Upload( const GameTimePoint /*oDeadline*/ )
+{
+	return true;
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "Array.h"
+#include "AsyncFileReader.h"
+#include "Intrusive.h"
+#include "Logger.h"
+#include "Resource.h"
+#include "Time.h"
+#include "VirtualFileSystem.h"
+
+// Resources of a higher class are read, decoded and finalized first, and get a larger share of the bytes in flight
+enum class LoadPriority : uint8
+{
+	BACKGROUND,
+	NORMAL,
+	HIGH,
+	_COUNT
+};
+
+enum class LoadCommandStatus : uint8
+{
+	PENDING,
+	LOADING,
+	LOADED,
+	UPLOADING,
+	FINISHED,
+	WAITING_DEPENDENCIES,
+	NOT_FOUND,
+	ERROR_READING,
+	CANCELLED
+};
+
+// Work that is cheap once the file is read stays on the IO thread, the rest goes to the decode threads
+// Files used in place are mapped by their command on the IO thread rather than read
+enum class LoadStage : uint8
+{
+	IO,
+	DECODE,
+	MAP
+};
+
+// Commands go through the loader threads and the finalization as their base, only their resource is typed
+struct LoadCommandBase
+{
+	LoadCommandBase( const char* sFilePath, const LoadStage eStage, const int iTypePriority, const char* sCommandName );
+	virtual ~LoadCommandBase();
+
+	// Files are looked up in the Data directory of the virtual file system
+	virtual std::string	GetFilePath() const;
+
+	virtual Resource*	GetResource() = 0;
+
+	void			UpdatePriority( const LoadPriority ePriority, const float fDistance );
+	// Highest priority last, then in request order
+	static bool		ComparePriorities( const LoadCommandBase* pA, const LoadCommandBase* pB );
+
+	bool			HasDependencies() const;
+	bool			AnyDependencyFailed() const;
+
+	// Decodes the content of the file, read beforehand by the IO thread
+	virtual void	Load( const ArrayView< const uint8 > aData ) = 0;
+	virtual void	OnFinished() = 0;
+	virtual void	OnDependenciesReady() = 0;
+	// Called on the following frames when the data cannot be uploaded within the budget, returns true when everything is uploaded
+	virtual bool	Upload( const GameTimePoint oDeadline );
+
+	std::string						m_sFilePath;
+	LoadCommandStatus				m_eStatus;
+	LoadStage						m_eStage;
+	// Written by the main thread, higher priorities are read, decoded and finalized first
+	std::atomic< LoadPriority >		m_ePriority;
+	std::atomic_int					m_iPriority;
+	float							m_fDistance;
+	int								m_iTypePriority;
+	uint64							m_uSequence;
+	// Set once no one but the loader references the resource, the command then skips what is left to do
+	std::atomic_bool				m_bCancelled;
+	VirtualFileLocation				m_oLocation;
+	// Counted against the budgets from the read to the finalization
+	uint64							m_uInFlightBytes;
+	AsyncRead*						m_pRead;
+	const char*						m_sCommandName;
+	Array< StrongPtr< Resource > >	m_aDependencies;
+	// Commands waiting for the resource of this one, and the number of dependencies this one still waits for
+	Array< LoadCommandBase* >		m_aDependents;
+	uint							m_uWaitingDependencyCount;
+};
+
+// The typed part of the commands
+template < typename Res >
+struct LoadCommand : LoadCommandBase
+{
+	LoadCommand( const char* sFilePath, const StrongPtr< Res >& xResource, const LoadStage eStage, const int iPriority, const char* sCommandName )
+		: LoadCommandBase( sFilePath, eStage, iPriority, sCommandName )
+		, m_xResource( xResource )
+	{
+	}
+
+	Resource* GetResource() override
+	{
+		return m_xResource.GetPtr();
+	}
+
+	StrongPtr< Res >	m_xResource;
+};
+
+// Runs load commands through the IO thread, which reads their files, the decode threads, and the finalization on the main thread
+// Commands waiting for the resources of others complete once all of them are loaded or failed
+class LoadScheduler
+{
+public:
+	explicit LoadScheduler( const uint uDecodeThreadCount );
+	~LoadScheduler();
+
+	// The scheduler owns the command until it completes
+	void			PushLoadCommand( LoadCommandBase* pLoadCommand, const LoadPriority ePriority );
+	// Commands given their data, such as the textures embedded in a model, skip the IO thread
+	void			PushLoadCommand( LoadCommandBase* pLoadCommand, const LoadPriority ePriority, Array< uint8 >&& aData );
+
+	// Called every frame by what waits for a resource still loading, the closest ones of a class are loaded first
+	// A resource takes the closest distance requested during the frame and passes it to its dependencies, classes are only raised
+	void			UpdateLoadPriority( const Resource* pResource, const LoadPriority ePriority, const float fDistance = 0.f );
+	void			RaiseLoadPriority( const Resource* pResource, const LoadPriority ePriority );
+	// Reads of a class are only issued while the bytes in flight, from their read to their finalization, fit in its budget
+	void			SetInFlightBytesBudget( const LoadPriority ePriority, const uint64 uBytes );
+	uint64			GetInFlightBytesBudget( const LoadPriority ePriority ) const;
+	void			CancelLoadCommand( const Resource* pResource );
+
+	// Hands the new commands over to the IO thread, once per frame
+	void			ProcessPendingLoadCommands();
+	// Finalizes the loaded commands until the budget of the frame is spent
+	void			FinalizeLoadCommands();
+
+	// Unloads the resources only referenced by the map, and cancels the ones still loading
+	template < typename Res >
+	void			DestroyUnusedResources( std::unordered_map< std::string, StrongPtr< Res > >& mResources );
+
+	uint			GetPendingLoadCommandCount() const;
+	uint			GetFinalizingLoadCommandCount() const;
+	uint			GetWaitingDependenciesLoadCommandCount() const;
+	uint64			GetInFlightBytes() const;
+
+private:
+	struct DecodeJob
+	{
+		LoadCommandBase*	m_pLoadCommand;
+		AsyncRead*			m_pRead;
+	};
+
+	struct LoadRequest
+	{
+		LoadPriority	m_ePriority;
+		float			m_fDistance;
+	};
+
+	bool			AddLoadRequest( const Resource* pResource, const LoadRequest& oRequest );
+	void			ApplyLoadRequests();
+	void			Load();
+	void			Decode();
+	void			LocateFiles( const Array< LoadCommandBase* >& aLoadCommands, std::unique_lock< std::mutex >& oLock );
+	void			UpdateReads();
+	void			ReadFiles( std::unique_lock< std::mutex >& oLock );
+	void			PushDecodeJob( LoadCommandBase* pLoadCommand, AsyncRead* pRead );
+	void			DecodeFile( LoadCommandBase& oLoadCommand, AsyncRead* pRead, std::unique_lock< std::mutex >& oLock );
+	void			PushLoadedLoadCommand( LoadCommandBase& oLoadCommand, std::unique_lock< std::mutex >& oLock );
+	bool			FinalizeLoadCommand( LoadCommandBase* pLoadCommand, const GameTimePoint oDeadline );
+	void			WaitDependencies( LoadCommandBase* pLoadCommand );
+	void			ResolveDependencies( LoadCommandBase& oLoadCommand );
+	void			CompleteLoadCommand( LoadCommandBase* pLoadCommand );
+
+	// Commands are owned by the list they are in, or by their read or decode job in between
+	Array< LoadCommandBase* >	m_aPendingLoadCommands;
+	Array< LoadCommandBase* >	m_aFinalizingLoadCommands;
+	uint64						m_uNextLoadCommandSequence;
+	// The command of every resource still loading, the ones waiting for dependencies are only owned by this map
+	std::unordered_map< const Resource*, LoadCommandBase* >	m_mLoadCommands;
+	uint													m_uWaitingDependenciesLoadCommandCount;
+	// Set when priorities, cancellations or the bytes in flight changed, the IO thread is told once per frame
+	bool													m_bReadsOutdated;
+	// Priorities requested during the frame, applied together once the frame is done
+	std::unordered_map< const Resource*, LoadRequest >		m_mLoadRequests;
+
+	std::atomic_bool			m_bRunning;
+
+	// Protects the commands handed over to the IO thread and the ones handed back by the loader threads
+	std::mutex					m_oProcessingCommandsMutex;
+	std::condition_variable		m_oProcessingCommandsConditionVariable;
+	Array< LoadCommandBase* >	m_aProcessingLoadCommands;
+	Array< LoadCommandBase* >	m_aLoadedLoadCommands;
+	bool						m_bUpdateReads;
+	AsyncFileReader				m_oFileReader;
+	std::atomic< uint64 >		m_uInFlightBytes;
+	std::atomic< uint64 >		m_aInFlightBytesBudgets[ ( int )LoadPriority::_COUNT ];
+	// Only used by the IO thread, and by the destructor once it is stopped
+	Array< LoadCommandBase* >	m_aQueuedLoadCommands;
+	Array< LoadCommandBase* >	m_aReadingLoadCommands;
+	std::jthread				m_oIOThread;
+
+	std::mutex				m_oDecodeJobsMutex;
+	std::condition_variable m_oDecodeJobsConditionVariable;
+	Array< DecodeJob >		m_aDecodeJobs;
+	// Threads cannot be copied, which Array requires
+	Array< std::thread* >	m_aDecodeThreads;
+};
+
+template < typename Res >
+void LoadScheduler::DestroyUnusedResources( std::unordered_map< std::string, StrongPtr< Res > >& mResources )
+{
+	for( auto& oPair : mResources )
+	{
+		// Resources still loading are also referenced by their command
+		if( oPair.second->IsLoading() )
+		{
+			if( oPair.second->GetReferenceCount() == 2 )
+			{
+				CancelLoadCommand( oPair.second.GetPtr() );
+				oPair.second = nullptr;
+			}
+		}
+		else if( oPair.second->GetReferenceCount() == 1 )
+		{
+			SLOG_INFO( LogCategory::RESOURCES, "Unloading {}", oPair.first );
+			oPair.second->Destroy();
+			oPair.second = nullptr;
+		}
+	}
+
+	std::erase_if( mResources, []( const std::pair< std::string, StrongPtr< Res > >& oPair ) { return oPair.second == nullptr; } );
+}
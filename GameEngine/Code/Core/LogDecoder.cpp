@@ -0,0 +1,394 @@
+#include "LogDecoder.h"
+
+#include <cstring>
+#include <iterator>
+
+// Size of the argument at pData, 0 when it goes past the end of the arguments
+static uint GetArgumentSize( const LogArgumentType eType, const uint8* pData, const uint uRemainingSize )
+{
+	uint uSize = 0;
+	switch( eType )
+	{
+	case LogArgumentType::BOOL:
+	case LogArgumentType::CHAR:
+	case LogArgumentType::INT8:
+	case LogArgumentType::UINT8:
+		uSize = 1;
+		break;
+	case LogArgumentType::INT16:
+	case LogArgumentType::UINT16:
+		uSize = 2;
+		break;
+	case LogArgumentType::INT32:
+	case LogArgumentType::UINT32:
+	case LogArgumentType::FLOAT:
+		uSize = 4;
+		break;
+	case LogArgumentType::INT64:
+	case LogArgumentType::UINT64:
+	case LogArgumentType::DOUBLE:
+		uSize = 8;
+		break;
+	case LogArgumentType::POINTER:
+		uSize = sizeof( const void* );
+		break;
+	case LogArgumentType::STRING:
+	{
+		if( uRemainingSize < sizeof( uint ) )
+			return 0;
+
+		// Checked before adding the length prefix, a corrupt length would wrap around
+		uint uLength = 0;
+		memcpy( &uLength, pData, sizeof( uint ) );
+		if( uLength > uRemainingSize - sizeof( uint ) )
+			return 0;
+
+		uSize = uLength + sizeof( uint );
+		break;
+	}
+	}
+
+	return uSize <= uRemainingSize ? uSize : 0;
+}
+
+template < typename T >
+static void FormatValue( std::string& sOutput, const std::string& sFormat, const uint8* pData )
+{
+	T oValue;
+	memcpy( &oValue, pData, sizeof( T ) );
+	std::vformat_to( std::back_inserter( sOutput ), sFormat, std::make_format_args( oValue ) );
+}
+
+static void FormatArgument( std::string& sOutput, const std::string& sFormat, const LogArgumentType eType, const uint8* pData )
+{
+	const size_t uLength = sOutput.length();
+
+	try
+	{
+		switch( eType )
+		{
+		case LogArgumentType::BOOL:
+			FormatValue< bool >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::CHAR:
+			FormatValue< char >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::INT8:
+			FormatValue< int8 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::INT16:
+			FormatValue< int16 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::INT32:
+			FormatValue< int32 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::INT64:
+			FormatValue< int64 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::UINT8:
+			FormatValue< uint8 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::UINT16:
+			FormatValue< uint16 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::UINT32:
+			FormatValue< uint32 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::UINT64:
+			FormatValue< uint64 >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::FLOAT:
+			FormatValue< float >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::DOUBLE:
+			FormatValue< double >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::POINTER:
+			FormatValue< const void* >( sOutput, sFormat, pData );
+			break;
+		case LogArgumentType::STRING:
+		{
+			uint uStringLength = 0;
+			memcpy( &uStringLength, pData, sizeof( uint ) );
+
+			const std::string_view sValue( ( const char* )pData + sizeof( uint ), uStringLength );
+			std::vformat_to( std::back_inserter( sOutput ), sFormat, std::make_format_args( sValue ) );
+			break;
+		}
+		}
+	}
+	catch( const std::format_error& )
+	{
+		sOutput.resize( uLength );
+		sOutput += "{?}";
+	}
+}
+
+void FormatStructuredLog( std::string& sOutput, const char* sFormat, const LogArgumentType* pArgumentTypes, const uint uArgumentCount, const uint8* pArguments, const uint uSize )
+{
+	// Arguments are located first, a format may use them in any order
+	const uint8* aArguments[ 256 ];
+	uint uValidArgumentCount = 0;
+
+	uint uOffset = 0;
+	for( ; uValidArgumentCount < uArgumentCount && uValidArgumentCount < 256; ++uValidArgumentCount )
+	{
+		const uint uArgumentSize = GetArgumentSize( pArgumentTypes[ uValidArgumentCount ], pArguments + uOffset, uSize - uOffset );
+		if( uArgumentSize == 0 )
+			break;
+
+		aArguments[ uValidArgumentCount ] = pArguments + uOffset;
+		uOffset += uArgumentSize;
+	}
+
+	std::string sArgumentFormat;
+	uint uNextArgument = 0;
+
+	for( const char* pCursor = sFormat; *pCursor != '\0'; ++pCursor )
+	{
+		if( ( pCursor[ 0 ] == '{' && pCursor[ 1 ] == '{' ) || ( pCursor[ 0 ] == '}' && pCursor[ 1 ] == '}' ) )
+		{
+			sOutput += *pCursor++;
+			continue;
+		}
+
+		if( *pCursor != '{' )
+		{
+			sOutput += *pCursor;
+			continue;
+		}
+
+		const char* pFieldEnd = strchr( pCursor, '}' );
+		if( pFieldEnd == nullptr )
+		{
+			sOutput += pCursor;
+			return;
+		}
+
+		// Fields are {}, {index} or {index:spec}, each argument is formatted alone with the spec of its field
+		const char* pSpec = pCursor + 1;
+		uint uArgument = uNextArgument++;
+		if( *pSpec >= '0' && *pSpec <= '9' )
+		{
+			uArgument = 0;
+			for( ; *pSpec >= '0' && *pSpec <= '9'; ++pSpec )
+				uArgument = uArgument * 10 + ( *pSpec - '0' );
+		}
+
+		// Nested fields, like a width taken from an argument, are not supported
+		if( uArgument >= uValidArgumentCount || memchr( pSpec, '{', pFieldEnd - pSpec ) != nullptr )
+		{
+			sOutput += "{?}";
+		}
+		else
+		{
+			sArgumentFormat.assign( "{" );
+			sArgumentFormat.append( pSpec, pFieldEnd - pSpec );
+			sArgumentFormat += '}';
+
+			FormatArgument( sOutput, sArgumentFormat, pArgumentTypes[ uArgument ], aArguments[ uArgument ] );
+		}
+
+		pCursor = pFieldEnd;
+	}
+}
+
+void FormatLogDate( char* sDate, const size_t uSize, const std::chrono::system_clock::time_point& oTime )
+{
+	const std::chrono::system_clock::time_point oSecond = std::chrono::floor< std::chrono::seconds >( oTime );
+
+	std::chrono::year_month_day oYMD( std::chrono::floor< std::chrono::days >( oSecond ) );
+	std::chrono::hh_mm_ss oHMS( std::chrono::floor< std::chrono::seconds >( oSecond - std::chrono::floor< std::chrono::days >( oSecond ) ) );
+
+	const int iYear = ( int )oYMD.year();
+	const uint uMonth = ( uint )oYMD.month();
+	const uint uDay = ( uint )oYMD.day();
+	const int uHour = ( int )oHMS.hours().count();
+	const int uMinute = ( int )oHMS.minutes().count();
+	const int uSecond = ( int )oHMS.seconds().count();
+
+	snprintf( sDate, uSize, "%d-%02d-%02d %02d:%02d:%02d", iYear, uMonth, uDay, uHour, uMinute, uSecond );
+}
+
+struct DecodedLogDescriptor
+{
+	std::string					m_sFile;
+	std::string					m_sFormat;
+	Array< LogArgumentType >	m_aArgumentTypes;
+	int							m_iLine = 0;
+	uint8						m_uLogLevel = 0;
+	uint8						m_uCategory = 0;
+};
+
+// Reads values from the file content, every read fails once one went past its end
+struct LogReader
+{
+	template < typename T >
+	bool Read( T& oValue )
+	{
+		return ReadBytes( &oValue, sizeof( T ) );
+	}
+
+	bool ReadBytes( void* pData, const uint uSize )
+	{
+		if( uSize == 0 )
+			return m_bValid;
+
+		if( m_bValid == false || uSize > m_aContent.Count() - m_uOffset )
+		{
+			m_bValid = false;
+			return false;
+		}
+
+		memcpy( pData, m_aContent.Data() + m_uOffset, uSize );
+		m_uOffset += uSize;
+		return true;
+	}
+
+	bool ReadString( std::string& sValue, const uint uLength )
+	{
+		sValue.resize( uLength );
+		return ReadBytes( sValue.data(), uLength );
+	}
+
+	const Array< uint8 >&	m_aContent;
+	uint					m_uOffset = 0;
+	bool					m_bValid = true;
+};
+
+static void WriteDecodedLine( FILE* pOutput, const int64 iTime, const char* sLogLevel )
+{
+	const std::chrono::system_clock::time_point oTime( std::chrono::duration_cast< std::chrono::system_clock::duration >( std::chrono::nanoseconds( iTime ) ) );
+	const int iMilliSecond = ( int )( ( iTime / 1000000 ) % 1000 );
+
+	char sDate[ 32 ];
+	FormatLogDate( sDate, sizeof( sDate ), oTime );
+
+	fprintf( pOutput, "%s.%03d [%s] ", sDate, iMilliSecond, sLogLevel );
+}
+
+bool DecodeBinaryLog( const std::filesystem::path& oFilePath, FILE* pOutput )
+{
+	FILE* pFile = fopen( oFilePath.string().c_str(), "rb" );
+	if( pFile == nullptr )
+		return false;
+
+	Array< uint8 > aContent;
+	fseek( pFile, 0, SEEK_END );
+	aContent.Resize( ( uint )ftell( pFile ) );
+	fseek( pFile, 0, SEEK_SET );
+	const size_t uReadSize = aContent.Count() != 0 ? fread( aContent.Data(), 1, aContent.Count(), pFile ) : 0;
+	fclose( pFile );
+
+	if( uReadSize != aContent.Count() )
+		return false;
+
+	LogReader oReader{ aContent };
+
+	uint32 uMagic = 0;
+	uint32 uVersion = 0;
+	uint8 uCategoryCount = 0;
+	if( oReader.Read( uMagic ) == false || uMagic != LOG_BINARY_MAGIC || oReader.Read( uVersion ) == false || uVersion != LOG_BINARY_VERSION || oReader.Read( uCategoryCount ) == false )
+		return false;
+
+	Array< std::string > aCategories;
+	for( uint u = 0; u < uCategoryCount; ++u )
+	{
+		uint8 uLength = 0;
+		aCategories.PushBack( std::string() );
+		if( oReader.Read( uLength ) == false || oReader.ReadString( aCategories.Back(), uLength ) == false )
+			return false;
+	}
+
+	Array< DecodedLogDescriptor > aDescriptors;
+	std::string sMessage;
+	Array< uint8 > aArguments;
+
+	while( oReader.m_uOffset < aContent.Count() )
+	{
+		uint8 uRecordType = 0;
+		oReader.Read( uRecordType );
+
+		switch( ( LogRecordType )uRecordType )
+		{
+		case LogRecordType::DESCRIPTOR:
+		{
+			uint32 uIndex = 0;
+			uint8 uArgumentCount = 0;
+			uint16 uFileLength = 0;
+			uint16 uFormatLength = 0;
+			DecodedLogDescriptor oDescriptor;
+
+			oReader.Read( uIndex );
+			oReader.Read( oDescriptor.m_uLogLevel );
+			oReader.Read( oDescriptor.m_uCategory );
+			oReader.Read( oDescriptor.m_iLine );
+			oReader.Read( uArgumentCount );
+			oReader.m_bValid &= oDescriptor.m_uLogLevel <= Logger::LEVEL_ERROR && oDescriptor.m_uCategory < aCategories.Count() && uIndex == aDescriptors.Count();
+
+			oDescriptor.m_aArgumentTypes.Resize( uArgumentCount );
+			oReader.ReadBytes( oDescriptor.m_aArgumentTypes.Data(), uArgumentCount );
+			oReader.Read( uFileLength );
+			oReader.ReadString( oDescriptor.m_sFile, uFileLength );
+			oReader.Read( uFormatLength );
+			oReader.ReadString( oDescriptor.m_sFormat, uFormatLength );
+
+			if( oReader.m_bValid )
+				aDescriptors.PushBack( oDescriptor );
+			break;
+		}
+		case LogRecordType::ENTRY:
+		{
+			uint32 uIndex = 0;
+			int64 iTime = 0;
+			uint32 uSize = 0;
+
+			oReader.Read( uIndex );
+			oReader.Read( iTime );
+			oReader.Read( uSize );
+			oReader.m_bValid &= uIndex < aDescriptors.Count() && uSize <= aContent.Count();
+			if( oReader.m_bValid == false )
+				break;
+
+			aArguments.Resize( uSize );
+			if( oReader.ReadBytes( aArguments.Data(), uSize ) == false )
+				break;
+
+			const DecodedLogDescriptor& oDescriptor = aDescriptors[ uIndex ];
+
+			sMessage.clear();
+			FormatStructuredLog( sMessage, oDescriptor.m_sFormat.c_str(), oDescriptor.m_aArgumentTypes.Data(), oDescriptor.m_aArgumentTypes.Count(), aArguments.Data(), uSize );
+			if( sMessage.length() > LOG_MESSAGE_SIZE )
+			{
+				sMessage.resize( LOG_MESSAGE_SIZE );
+				sMessage.replace( LOG_MESSAGE_SIZE - 3, 3, "..." );
+			}
+
+			WriteDecodedLine( pOutput, iTime, Logger::GetLevelName( ( Logger::LogLevel )oDescriptor.m_uLogLevel ) );
+			fprintf( pOutput, "[%s] %s(%d) : %s\n", aCategories[ oDescriptor.m_uCategory ].c_str(), oDescriptor.m_sFile.c_str(), oDescriptor.m_iLine, sMessage.c_str() );
+			break;
+		}
+		case LogRecordType::DROPPED:
+		{
+			int64 iTime = 0;
+			uint64 uDroppedCount = 0;
+
+			oReader.Read( iTime );
+			if( oReader.Read( uDroppedCount ) == false )
+				break;
+
+			WriteDecodedLine( pOutput, iTime, Logger::GetLevelName( Logger::LEVEL_WARN ) );
+			fprintf( pOutput, "%llu log entries dropped, the buffers of the logging threads were full\n", ( unsigned long long )uDroppedCount );
+			break;
+		}
+		default:
+			oReader.m_bValid = false;
+			break;
+		}
+
+		if( oReader.m_bValid == false )
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "Logger.h"
+
+// Binary log layout : a header with the magic, the version and the category names, then records starting with their LogRecordType
+inline constexpr uint32 LOG_BINARY_MAGIC = 0x474F4C42;
+inline constexpr uint32 LOG_BINARY_VERSION = 1;
+
+enum class LogRecordType : uint8
+{
+	DESCRIPTOR,	// Index, level, category, line, argument count and types, file and format, written before its first entry
+	ENTRY,		// Descriptor index, time in nanoseconds, argument bytes size and argument bytes
+	DROPPED		// Time in nanoseconds and count of entries dropped since the previous record
+};
+
+// Appends the format with its arguments, as std::format would, to sOutput
+// Arguments not matching their format spec are written as {?} rather than failing the whole log
+void	FormatStructuredLog( std::string& sOutput, const char* sFormat, const LogArgumentType* pArgumentTypes, const uint uArgumentCount, const uint8* pArguments, const uint uSize );
+
+// Formats the date and time of a log, down to the second
+void	FormatLogDate( char* sDate, const size_t uSize, const std::chrono::system_clock::time_point& oTime );
+
+// Writes a binary log to pOutput as the text log would have been written, returns false when the file is not a valid binary log
+bool	DecodeBinaryLog( const std::filesystem::path& oFilePath, FILE* pOutput );
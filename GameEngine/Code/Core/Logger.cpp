@@ -1,19 +1,172 @@
 #include "Logger.h"
 
+#include "LogDecoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <thread>
+#include <unordered_map>
+
+static constexpr uint LOG_BUFFER_SIZE = 64 * 1024;
+static constexpr uint LOG_PREFIX_SIZE = 512;
+static constexpr std::chrono::milliseconds LOG_FLUSH_PERIOD( 10 );
+
+// Staged entry, followed by the characters of its message or the bytes of its arguments and padded to keep entries aligned
+struct LogEntry
+{
+	std::chrono::system_clock::time_point	m_oTime;
+	const char*								m_sFile;
+	const LogDescriptor*					m_pDescriptor;
+	const LogArgumentType*					m_pArgumentTypes;
+	uint									m_uSize;
+	uint									m_uLength;
+	uint									m_uArgumentCount;
+	int										m_iLine;
+	Logger::LogLevel						m_eLogLevel;
+};
 
-static constexpr uint LOG_BUFFER_SIZE = 10 * 1024;
+// Only the owning thread writes entries and only the writer thread reads them
+// An entry never wraps around the end of the ring, the end is skipped when too short for it
+struct LoggerThread
+{
+	LoggerThread()
+		: m_uWriteIndex( 0 )
+		, m_uReadIndex( 0 )
+		, m_pNext( nullptr )
+		, m_bExited( false )
+		, m_uReservedIndex( 0 )
+		, m_uDrainIndex( 0 )
+	{
+	}
+
+	alignas( 8 ) uint8					m_aBuffer[ LOG_THREAD_BUFFER_SIZE ];
+	alignas( 64 ) std::atomic< uint64 >	m_uWriteIndex;
+	alignas( 64 ) std::atomic< uint64 >	m_uReadIndex;
+
+	LoggerThread*						m_pNext;
+
+	// Set once the owning thread exited, the writer deletes the ring after draining it
+	std::atomic< bool >					m_bExited;
+
+	// Owner side, where the entry being reserved ends
+	uint64								m_uReservedIndex;
+
+	// Writer side, where the entries gathered by the current drain end
+	uint64								m_uDrainIndex;
+};
+
+// Flags the ring of the thread as exited when the thread ends
+struct LoggerThreadRegistration
+{
+	~LoggerThreadRegistration()
+	{
+		if( m_pThread != nullptr )
+			m_pThread->m_bExited.store( true, std::memory_order_release );
+
+		// Logs made by later thread_local destructors go to a new ring, kept until the process exits
+		m_pThread = nullptr;
+	}
+
+	LoggerThread* m_pThread = nullptr;
+};
+
+// Threads are pushed on a lock-free list the first time they log, only the writer removes them once they exited
+static std::atomic< LoggerThread* > s_pLoggerThreads( nullptr );
+static thread_local LoggerThreadRegistration s_oLoggerThreadRegistration;
+
+static std::atomic< uint64 > s_uDroppedCount( 0 );
+
+static LoggerThread& GetLoggerThread()
+{
+	LoggerThreadRegistration& oRegistration = s_oLoggerThreadRegistration;
+	if( oRegistration.m_pThread == nullptr )
+	{
+		LoggerThread* pThread = new LoggerThread;
+		oRegistration.m_pThread = pThread;
+
+		LoggerThread* pHead = s_pLoggerThreads.load( std::memory_order_relaxed );
+		do
+		{
+			pThread->m_pNext = pHead;
+		} while( s_pLoggerThreads.compare_exchange_weak( pHead, pThread, std::memory_order_release, std::memory_order_relaxed ) == false );
+	}
+
+	return *oRegistration.m_pThread;
+}
+
+static uint GetEntrySize( const uint uLength )
+{
+	return ( uint )( ( sizeof( LogEntry ) + uLength + 7 ) & ~( size_t )7 );
+}
+
+// Runs the thread draining the staged entries, it is declared after the loggers so it is destroyed first and hands them the last entries
+struct LoggerWriter
+{
+	LoggerWriter();
+	~LoggerWriter();
+
+	static void	Run();
+	static void	Drain();
+
+	static void	WriteBinaryEntry( const LogEntry* pEntry );
+	static void	WriteBinaryDropped( const uint64 uDroppedCount );
+
+	static const char*	GetFileName( const char* sFile );
+	static const char*	GetDatePrefix( const std::chrono::system_clock::time_point& oTime, int& iMilliSecond );
+
+	static std::thread					s_oThread;
+	static std::mutex					s_oMutex;
+	static std::condition_variable		s_oWakeUp;
+	static std::condition_variable		s_oFlushed;
+	static bool							s_bRunning;
+	static uint64						s_uFlushRequests;
+	static uint64						s_uFlushedRequests;
+
+	// Only used by the thread draining
+	static Array< const LogEntry* >		s_aEntries;
+	static uint64						s_uReportedDroppedCount;
+	static std::string					s_sStructuredMessage;
+
+	// Held while draining, the binary log may be changed from any thread
+	static std::mutex										s_oDrainMutex;
+	static FILE*											s_pBinaryLog;
+	static std::unordered_map< const LogDescriptor*, uint >	s_mDescriptorIndices;
+};
+
+std::thread LoggerWriter::s_oThread;
+std::mutex LoggerWriter::s_oMutex;
+std::condition_variable LoggerWriter::s_oWakeUp;
+std::condition_variable LoggerWriter::s_oFlushed;
+bool LoggerWriter::s_bRunning = false;
+uint64 LoggerWriter::s_uFlushRequests = 0;
+uint64 LoggerWriter::s_uFlushedRequests = 0;
+Array< const LogEntry* > LoggerWriter::s_aEntries;
+uint64 LoggerWriter::s_uReportedDroppedCount = 0;
+std::string LoggerWriter::s_sStructuredMessage;
+std::mutex LoggerWriter::s_oDrainMutex;
+FILE* LoggerWriter::s_pBinaryLog = nullptr;
+std::unordered_map< const LogDescriptor*, uint > LoggerWriter::s_mDescriptorIndices;
 
 char* Logger::s_pLogBuffer = nullptr;
 uint Logger::s_uLogBufferCursor = 0;
 
 const char* Logger::s_aLogLevels[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
 Array< Logger* > Logger::s_aLoggers;
+std::mutex Logger::s_oLoggersMutex;
+std::atomic< uint8 > Logger::s_aCategoryLevels[ ( uint8 )LogCategory::_COUNT ] = {};
+
+static const char* s_aLogCategories[] = { "GENERAL", "RESOURCES", "GAME", "GRAPHICS", "PHYSICS", "EDITOR" };
+static_assert( sizeof( s_aLogCategories ) / sizeof( s_aLogCategories[ 0 ] ) == ( size_t )LogCategory::_COUNT );
 
 static OutputLogger sOutputLogger;
 static FileLogger sFileLogger( "GameEngine.log" );
+static LoggerWriter sLoggerWriter;
 
 Logger::Logger()
 {
@@ -25,17 +178,13 @@ Logger::Logger()
 
 Logger::~Logger()
 {
-	if( s_aLoggers.Empty() && s_pLogBuffer != nullptr )
-	{
-		delete[] s_pLogBuffer;
-		s_pLogBuffer = nullptr;
-	}
-
 	UnRegisterLogger( this );
 }
 
 void Logger::RegisterLogger( Logger* pLogger )
 {
+	std::unique_lock oLock( s_oLoggersMutex );
+
 	for( Logger* pCurrentLogger : s_aLoggers )
 	{
 		if( pCurrentLogger == pLogger )
@@ -47,6 +196,8 @@ void Logger::RegisterLogger( Logger* pLogger )
 
 void Logger::UnRegisterLogger( Logger* pLogger )
 {
+	std::unique_lock oLock( s_oLoggersMutex );
+
 	for( uint u = 0; u < s_aLoggers.Count(); ++u )
 	{
 		if( s_aLoggers[ u ] == pLogger )
@@ -57,21 +208,153 @@ void Logger::UnRegisterLogger( Logger* pLogger )
 	}
 }
 
-void Logger::Log( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage )
+void Logger::Flush()
+{
+	std::unique_lock oLock( LoggerWriter::s_oMutex );
+
+	// Before the writer starts or once it stopped, the calling thread drains the entries itself
+	if( LoggerWriter::s_bRunning == false )
+	{
+		LoggerWriter::Drain();
+		return;
+	}
+
+	const uint64 uRequest = ++LoggerWriter::s_uFlushRequests;
+	LoggerWriter::s_oWakeUp.notify_one();
+	LoggerWriter::s_oFlushed.wait( oLock, [ uRequest ]() { return LoggerWriter::s_uFlushedRequests >= uRequest; } );
+}
+
+uint64 Logger::GetDroppedCount()
 {
-	static const std::size_t uFilePrefixLength = std::filesystem::current_path().string().length() + 1;
+	return s_uDroppedCount.load( std::memory_order_relaxed );
+}
 
-	std::string sLog = ProduceLog( eLogLevel, sFile.substr( uFilePrefixLength ), iLine, sMessage );
+void Logger::SetCategoryLevel( const LogCategory eCategory, const LogLevel eLogLevel )
+{
+	s_aCategoryLevels[ ( uint8 )eCategory ].store( ( uint8 )eLogLevel, std::memory_order_relaxed );
+}
 
-	if( s_uLogBufferCursor + sLog.length() + 1 >= LOG_BUFFER_SIZE )
-		Flush();
+const char* Logger::GetCategoryName( const LogCategory eCategory )
+{
+	return s_aLogCategories[ ( uint8 )eCategory ];
+}
 
-	strcpy( &s_pLogBuffer[ s_uLogBufferCursor ], sLog.c_str() );
-	s_uLogBufferCursor += ( uint )sLog.length();
+const char* Logger::GetLevelName( const LogLevel eLogLevel )
+{
+	return s_aLogLevels[ eLogLevel ];
 }
 
-void Logger::Flush()
+void Logger::SetBinaryLog( const std::filesystem::path& oFilePath )
+{
+	std::unique_lock oLock( LoggerWriter::s_oDrainMutex );
+
+	if( LoggerWriter::s_pBinaryLog != nullptr )
+	{
+		fclose( LoggerWriter::s_pBinaryLog );
+		LoggerWriter::s_pBinaryLog = nullptr;
+	}
+
+	LoggerWriter::s_mDescriptorIndices.clear();
+
+	if( oFilePath.empty() )
+		return;
+
+	LoggerWriter::s_pBinaryLog = fopen( oFilePath.string().c_str(), "wb" );
+	if( LoggerWriter::s_pBinaryLog == nullptr )
+		return;
+
+	// Categories are named in the header so the decoder does not depend on the engine they were logged with
+	const uint32 uMagic = LOG_BINARY_MAGIC;
+	const uint32 uVersion = LOG_BINARY_VERSION;
+	const uint8 uCategoryCount = ( uint8 )LogCategory::_COUNT;
+	fwrite( &uMagic, sizeof( uMagic ), 1, LoggerWriter::s_pBinaryLog );
+	fwrite( &uVersion, sizeof( uVersion ), 1, LoggerWriter::s_pBinaryLog );
+	fwrite( &uCategoryCount, sizeof( uCategoryCount ), 1, LoggerWriter::s_pBinaryLog );
+
+	for( const char* sCategory : s_aLogCategories )
+	{
+		const uint8 uLength = ( uint8 )strlen( sCategory );
+		fwrite( &uLength, sizeof( uLength ), 1, LoggerWriter::s_pBinaryLog );
+		fwrite( sCategory, 1, uLength, LoggerWriter::s_pBinaryLog );
+	}
+}
+
+uint8* Logger::Reserve( const LogLevel eLogLevel, const char* sFile, const int iLine, const LogDescriptor* pDescriptor, const LogArgumentType* pArgumentTypes, const uint uArgumentCount, const uint uLength )
 {
+	LoggerThread& oThread = GetLoggerThread();
+
+	const uint uSize = GetEntrySize( uLength );
+
+	uint64 uWriteIndex = oThread.m_uWriteIndex.load( std::memory_order_relaxed );
+	const uint64 uReadIndex = oThread.m_uReadIndex.load( std::memory_order_acquire );
+
+	uint uOffset = ( uint )( uWriteIndex % LOG_THREAD_BUFFER_SIZE );
+	const uint uContiguousSize = LOG_THREAD_BUFFER_SIZE - uOffset;
+	const uint uSkippedSize = uContiguousSize < uSize ? uContiguousSize : 0;
+
+	if( uWriteIndex + uSkippedSize + uSize - uReadIndex > LOG_THREAD_BUFFER_SIZE )
+	{
+		s_uDroppedCount.fetch_add( 1, std::memory_order_relaxed );
+		return nullptr;
+	}
+
+	// The skipped end is marked for the writer, unless it is too short to hold an entry
+	if( uSkippedSize != 0 )
+	{
+		if( uSkippedSize >= sizeof( LogEntry ) )
+			( ( LogEntry* )&oThread.m_aBuffer[ uOffset ] )->m_sFile = nullptr;
+
+		uWriteIndex += uSkippedSize;
+		uOffset = 0;
+	}
+
+	LogEntry* pEntry = ( LogEntry* )&oThread.m_aBuffer[ uOffset ];
+	pEntry->m_oTime = std::chrono::system_clock::now();
+	pEntry->m_sFile = sFile;
+	pEntry->m_pDescriptor = pDescriptor;
+	pEntry->m_pArgumentTypes = pArgumentTypes;
+	pEntry->m_uSize = uSize;
+	pEntry->m_uLength = uLength;
+	pEntry->m_uArgumentCount = uArgumentCount;
+	pEntry->m_iLine = iLine;
+	pEntry->m_eLogLevel = eLogLevel;
+
+	oThread.m_uReservedIndex = uWriteIndex + uSize;
+
+	return ( uint8* )( pEntry + 1 );
+}
+
+void Logger::Commit()
+{
+	LoggerThread& oThread = *s_oLoggerThreadRegistration.m_pThread;
+
+	const uint64 uWriteIndex = oThread.m_uWriteIndex.load( std::memory_order_relaxed );
+	const uint64 uReadIndex = oThread.m_uReadIndex.load( std::memory_order_relaxed );
+
+	oThread.m_uWriteIndex.store( oThread.m_uReservedIndex, std::memory_order_release );
+
+	// Wake the writer early rather than dropping entries of threads logging a lot, once when the ring gets half full
+	if( uWriteIndex - uReadIndex <= LOG_THREAD_BUFFER_SIZE / 2 && oThread.m_uReservedIndex - uReadIndex > LOG_THREAD_BUFFER_SIZE / 2 )
+		LoggerWriter::s_oWakeUp.notify_one();
+}
+
+void Logger::Push( const LogLevel eLogLevel, const char* sFile, const int iLine, const char* sMessage, const uint uLength )
+{
+	uint8* pData = Reserve( eLogLevel, sFile, iLine, nullptr, nullptr, 0, uLength );
+	if( pData == nullptr )
+		return;
+
+	memcpy( pData, sMessage, uLength );
+	Commit();
+}
+
+void Logger::FlushLoggers()
+{
+	if( s_uLogBufferCursor == 0 )
+		return;
+
+	std::unique_lock oLock( s_oLoggersMutex );
+
 	for( Logger* pCurrentLogger : s_aLoggers )
 		pCurrentLogger->FlushLogs();
 
@@ -79,49 +362,277 @@ void Logger::Flush()
 	s_uLogBufferCursor = 0;
 }
 
-// std::string Logger::ProduceLog( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage )
-// {
-// 	std::chrono::system_clock::time_point oNow = std::chrono::system_clock::now();
-// 
-// 	return std::format( "{} [{}] {}({}) : {}\n", oNow, s_aLogLevels[ eLogLevel ], sFile, iLine, sMessage );
-// }
-
-// std::string Logger::ProduceLog( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage )
-// {
-// 	std::chrono::system_clock::time_point oNow = std::chrono::system_clock::now();
-// 
-// 	std::chrono::year_month_day oYMD( std::chrono::floor< std::chrono::days >( oNow ) );
-// 	std::chrono::hh_mm_ss oHMS( std::chrono::floor< std::chrono::milliseconds >( oNow - std::chrono::floor< std::chrono::days >( oNow ) ) );
-// 	
-// 	const int iYear = ( int )oYMD.year();
-// 	const uint uMonth = ( uint )oYMD.month();
-// 	const uint uDay = ( uint )oYMD.day();
-// 	const int uHour = ( int )oHMS.hours().count();
-// 	const int uMinute = ( int )oHMS.minutes().count();
-// 	const int uSecond = ( int )oHMS.seconds().count();
-// 	const int uMilliSecond = ( int )oHMS.subseconds().count();
-// 
-// 	return std::format( "{}-{:02d}-{:02d} {:02d}:{:02d}:{:02d}.{:03d} [{}] {}({}) : {}\n", iYear, uMonth, uDay, uHour, uMinute, uSecond, uMilliSecond, s_aLogLevels[ eLogLevel ], sFile, iLine, sMessage );
-// }
-
-std::string Logger::ProduceLog( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage )
-{
-	std::chrono::system_clock::time_point oNow = std::chrono::system_clock::now();
-
-	std::chrono::year_month_day oYMD( std::chrono::floor< std::chrono::days >( oNow ) );
-	std::chrono::hh_mm_ss oHMS( std::chrono::floor< std::chrono::milliseconds >( oNow - std::chrono::floor< std::chrono::days >( oNow ) ) );
-	
-	const int iYear = ( int )oYMD.year();
-	const uint uMonth = ( uint )oYMD.month();
-	const uint uDay = ( uint )oYMD.day();
-	const int uHour = ( int )oHMS.hours().count();
-	const int uMinute = ( int )oHMS.minutes().count();
-	const int uSecond = ( int )oHMS.seconds().count();
-	const int uMilliSecond = ( int )oHMS.subseconds().count();
-	
-	char sBuffer[ 1024 ];
-	snprintf( sBuffer, 1024, "%d-%02d-%02d %02d:%02d:%02d.%03d [%s] %s(%d) : %s\n", iYear, uMonth, uDay, uHour, uMinute, uSecond, uMilliSecond, s_aLogLevels[ eLogLevel ], sFile.c_str(), iLine, sMessage.c_str() );
-	return sBuffer;
+LoggerWriter::LoggerWriter()
+{
+	std::unique_lock oLock( s_oMutex );
+	s_bRunning = true;
+	s_oThread = std::thread( &LoggerWriter::Run );
+}
+
+LoggerWriter::~LoggerWriter()
+{
+	{
+		std::unique_lock oLock( s_oMutex );
+		s_bRunning = false;
+	}
+
+	s_oWakeUp.notify_one();
+	s_oThread.join();
+
+	Drain();
+
+	if( s_pBinaryLog != nullptr )
+	{
+		fclose( s_pBinaryLog );
+		s_pBinaryLog = nullptr;
+	}
+}
+
+void LoggerWriter::Run()
+{
+	std::unique_lock oLock( s_oMutex );
+	while( s_bRunning )
+	{
+		if( s_uFlushRequests == s_uFlushedRequests )
+			s_oWakeUp.wait_for( oLock, LOG_FLUSH_PERIOD );
+
+		const uint64 uFlushRequests = s_uFlushRequests;
+
+		oLock.unlock();
+		Drain();
+		oLock.lock();
+
+		s_uFlushedRequests = uFlushRequests;
+		s_oFlushed.notify_all();
+	}
+
+	// Threads may still be waiting for a flush, the destructor drains what is left
+	s_uFlushedRequests = s_uFlushRequests;
+	s_oFlushed.notify_all();
+}
+
+void LoggerWriter::Drain()
+{
+	if( Logger::s_pLogBuffer == nullptr )
+		return;
+
+	std::unique_lock oLock( s_oDrainMutex );
+
+	s_aEntries.Clear();
+
+	LoggerThread* pFirstThread = s_pLoggerThreads.load( std::memory_order_acquire );
+	for( LoggerThread* pThread = pFirstThread; pThread != nullptr; pThread = pThread->m_pNext )
+	{
+		uint64 uReadIndex = pThread->m_uReadIndex.load( std::memory_order_relaxed );
+		pThread->m_uDrainIndex = pThread->m_uWriteIndex.load( std::memory_order_acquire );
+
+		while( uReadIndex < pThread->m_uDrainIndex )
+		{
+			const uint uOffset = ( uint )( uReadIndex % LOG_THREAD_BUFFER_SIZE );
+			const uint uContiguousSize = LOG_THREAD_BUFFER_SIZE - uOffset;
+			const LogEntry* pEntry = ( const LogEntry* )&pThread->m_aBuffer[ uOffset ];
+
+			if( uContiguousSize < sizeof( LogEntry ) || pEntry->m_sFile == nullptr )
+			{
+				uReadIndex += uContiguousSize;
+				continue;
+			}
+
+			s_aEntries.PushBack( pEntry );
+			uReadIndex += pEntry->m_uSize;
+		}
+	}
+
+	// Entries of a thread are already ordered, a stable sort keeps them that way when they share a time
+	std::stable_sort( s_aEntries.begin(), s_aEntries.end(), []( const LogEntry* pA, const LogEntry* pB ) {
+		return pA->m_oTime < pB->m_oTime;
+	} );
+
+	for( const LogEntry* pEntry : s_aEntries )
+	{
+		const char* sMessage = ( const char* )( pEntry + 1 );
+		uint uLength = pEntry->m_uLength;
+		char sCategory[ 32 ] = "";
+
+		// Structured entries go as is to the binary log when there is one, otherwise they are formatted here
+		if( pEntry->m_pDescriptor != nullptr )
+		{
+			if( s_pBinaryLog != nullptr )
+			{
+				WriteBinaryEntry( pEntry );
+				continue;
+			}
+
+			s_sStructuredMessage.clear();
+			FormatStructuredLog( s_sStructuredMessage, pEntry->m_pDescriptor->m_sFormat, pEntry->m_pArgumentTypes, pEntry->m_uArgumentCount, ( const uint8* )( pEntry + 1 ), pEntry->m_uLength );
+
+			if( s_sStructuredMessage.length() > LOG_MESSAGE_SIZE )
+			{
+				s_sStructuredMessage.resize( LOG_MESSAGE_SIZE );
+				s_sStructuredMessage.replace( LOG_MESSAGE_SIZE - 3, 3, "..." );
+			}
+
+			sMessage = s_sStructuredMessage.c_str();
+			uLength = ( uint )s_sStructuredMessage.length();
+			snprintf( sCategory, sizeof( sCategory ), "[%s] ", Logger::GetCategoryName( pEntry->m_pDescriptor->m_eCategory ) );
+		}
+
+		if( Logger::s_uLogBufferCursor + LOG_MESSAGE_SIZE + LOG_PREFIX_SIZE >= LOG_BUFFER_SIZE )
+			Logger::FlushLoggers();
+
+		int iMilliSecond = 0;
+		const char* sDatePrefix = GetDatePrefix( pEntry->m_oTime, iMilliSecond );
+
+		char* pLog = &Logger::s_pLogBuffer[ Logger::s_uLogBufferCursor ];
+		const int iLength = snprintf( pLog, LOG_BUFFER_SIZE - Logger::s_uLogBufferCursor, "%s.%03d [%s] %s%s(%d) : %.*s\n", sDatePrefix, iMilliSecond, Logger::s_aLogLevels[ pEntry->m_eLogLevel ], sCategory, GetFileName( pEntry->m_sFile ),
+			pEntry->m_iLine, ( int )uLength, sMessage );
+
+		if( iLength > 0 )
+			Logger::s_uLogBufferCursor += std::min( ( uint )iLength, LOG_BUFFER_SIZE - Logger::s_uLogBufferCursor - 1 );
+	}
+
+	// Rings are only released once their entries are formatted
+	for( LoggerThread* pThread = pFirstThread; pThread != nullptr; pThread = pThread->m_pNext )
+		pThread->m_uReadIndex.store( pThread->m_uDrainIndex, std::memory_order_release );
+
+	// Rings of exited threads are deleted once empty, new threads only change the head of the list so it is kept
+	LoggerThread* pPreviousThread = pFirstThread;
+	while( pPreviousThread != nullptr && pPreviousThread->m_pNext != nullptr )
+	{
+		LoggerThread* pThread = pPreviousThread->m_pNext;
+		if( pThread->m_bExited.load( std::memory_order_acquire ) && pThread->m_uWriteIndex.load( std::memory_order_acquire ) == pThread->m_uDrainIndex )
+		{
+			pPreviousThread->m_pNext = pThread->m_pNext;
+			delete pThread;
+		}
+		else
+		{
+			pPreviousThread = pThread;
+		}
+	}
+
+	const uint64 uDroppedCount = s_uDroppedCount.load( std::memory_order_relaxed );
+	if( uDroppedCount != s_uReportedDroppedCount )
+	{
+		if( Logger::s_uLogBufferCursor + LOG_PREFIX_SIZE >= LOG_BUFFER_SIZE )
+			Logger::FlushLoggers();
+
+		int iMilliSecond = 0;
+		const char* sDatePrefix = GetDatePrefix( std::chrono::system_clock::now(), iMilliSecond );
+
+		const int iLength = snprintf( &Logger::s_pLogBuffer[ Logger::s_uLogBufferCursor ], LOG_BUFFER_SIZE - Logger::s_uLogBufferCursor, "%s.%03d [%s] %llu log entries dropped, the buffers of the logging threads were full\n", sDatePrefix, iMilliSecond,
+			Logger::s_aLogLevels[ Logger::LEVEL_WARN ], ( unsigned long long )( uDroppedCount - s_uReportedDroppedCount ) );
+		if( iLength > 0 )
+			Logger::s_uLogBufferCursor += std::min( ( uint )iLength, LOG_BUFFER_SIZE - Logger::s_uLogBufferCursor - 1 );
+
+		if( s_pBinaryLog != nullptr )
+			WriteBinaryDropped( uDroppedCount - s_uReportedDroppedCount );
+
+		s_uReportedDroppedCount = uDroppedCount;
+	}
+
+	if( s_pBinaryLog != nullptr )
+		fflush( s_pBinaryLog );
+
+	Logger::FlushLoggers();
+}
+
+void LoggerWriter::WriteBinaryEntry( const LogEntry* pEntry )
+{
+	const LogDescriptor* pDescriptor = pEntry->m_pDescriptor;
+
+	// Descriptors are written once, before the first entry using them
+	auto it = s_mDescriptorIndices.find( pDescriptor );
+	if( it == s_mDescriptorIndices.end() )
+	{
+		it = s_mDescriptorIndices.emplace( pDescriptor, ( uint )s_mDescriptorIndices.size() ).first;
+
+		const uint8 uRecordType = ( uint8 )LogRecordType::DESCRIPTOR;
+		const uint32 uIndex = it->second;
+		const uint8 uLogLevel = ( uint8 )pDescriptor->m_eLogLevel;
+		const uint8 uCategory = ( uint8 )pDescriptor->m_eCategory;
+		const int32 iLine = pDescriptor->m_iLine;
+		const uint8 uArgumentCount = ( uint8 )pEntry->m_uArgumentCount;
+		const char* sFile = GetFileName( pDescriptor->m_sFile );
+		const uint16 uFileLength = ( uint16 )strlen( sFile );
+		const uint16 uFormatLength = ( uint16 )strlen( pDescriptor->m_sFormat );
+
+		fwrite( &uRecordType, sizeof( uRecordType ), 1, s_pBinaryLog );
+		fwrite( &uIndex, sizeof( uIndex ), 1, s_pBinaryLog );
+		fwrite( &uLogLevel, sizeof( uLogLevel ), 1, s_pBinaryLog );
+		fwrite( &uCategory, sizeof( uCategory ), 1, s_pBinaryLog );
+		fwrite( &iLine, sizeof( iLine ), 1, s_pBinaryLog );
+		fwrite( &uArgumentCount, sizeof( uArgumentCount ), 1, s_pBinaryLog );
+		fwrite( pEntry->m_pArgumentTypes, sizeof( LogArgumentType ), uArgumentCount, s_pBinaryLog );
+		fwrite( &uFileLength, sizeof( uFileLength ), 1, s_pBinaryLog );
+		fwrite( sFile, 1, uFileLength, s_pBinaryLog );
+		fwrite( &uFormatLength, sizeof( uFormatLength ), 1, s_pBinaryLog );
+		fwrite( pDescriptor->m_sFormat, 1, uFormatLength, s_pBinaryLog );
+	}
+
+	const uint8 uRecordType = ( uint8 )LogRecordType::ENTRY;
+	const uint32 uIndex = it->second;
+	const int64 iTime = std::chrono::duration_cast< std::chrono::nanoseconds >( pEntry->m_oTime.time_since_epoch() ).count();
+	const uint32 uSize = pEntry->m_uLength;
+
+	fwrite( &uRecordType, sizeof( uRecordType ), 1, s_pBinaryLog );
+	fwrite( &uIndex, sizeof( uIndex ), 1, s_pBinaryLog );
+	fwrite( &iTime, sizeof( iTime ), 1, s_pBinaryLog );
+	fwrite( &uSize, sizeof( uSize ), 1, s_pBinaryLog );
+	fwrite( pEntry + 1, 1, uSize, s_pBinaryLog );
+}
+
+void LoggerWriter::WriteBinaryDropped( const uint64 uDroppedCount )
+{
+	const uint8 uRecordType = ( uint8 )LogRecordType::DROPPED;
+	const int64 iTime = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::system_clock::now().time_since_epoch() ).count();
+
+	fwrite( &uRecordType, sizeof( uRecordType ), 1, s_pBinaryLog );
+	fwrite( &iTime, sizeof( iTime ), 1, s_pBinaryLog );
+	fwrite( &uDroppedCount, sizeof( uDroppedCount ), 1, s_pBinaryLog );
+}
+
+const char* LoggerWriter::GetFileName( const char* sFile )
+{
+	static const std::string sCurrentPath = std::filesystem::current_path().string();
+	static std::unordered_map< const char*, const char* > s_mFileNames;
+
+	auto it = s_mFileNames.find( sFile );
+	if( it != s_mFileNames.end() )
+		return it->second;
+
+	// Files under the working directory are shown relative to it, the comparison ignores case and separators as paths given to the compiler may differ on both
+	auto IsSameCharacter = []( const char cA, const char cB ) {
+		const bool bSeparatorA = cA == '/' || cA == '\\';
+		const bool bSeparatorB = cB == '/' || cB == '\\';
+		return bSeparatorA || bSeparatorB ? bSeparatorA == bSeparatorB : tolower( ( unsigned char )cA ) == tolower( ( unsigned char )cB );
+	};
+
+	const char* sFileName = sFile;
+	const size_t uFileLength = strlen( sFile );
+	if( uFileLength > sCurrentPath.length() && std::equal( sCurrentPath.begin(), sCurrentPath.end(), sFile, IsSameCharacter ) )
+		sFileName = sFile + sCurrentPath.length() + 1;
+
+	s_mFileNames.emplace( sFile, sFileName );
+	return sFileName;
+}
+
+const char* LoggerWriter::GetDatePrefix( const std::chrono::system_clock::time_point& oTime, int& iMilliSecond )
+{
+	static char s_sDatePrefix[ 32 ] = {};
+	static std::chrono::system_clock::time_point s_oDatePrefixSecond;
+
+	const std::chrono::system_clock::time_point oSecond = std::chrono::floor< std::chrono::seconds >( oTime );
+	iMilliSecond = ( int )std::chrono::duration_cast< std::chrono::milliseconds >( oTime - oSecond ).count();
+
+	// The date and time only change once per second, they are formatted again when it does
+	if( oSecond != s_oDatePrefixSecond || s_sDatePrefix[ 0 ] == '\0' )
+	{
+		s_oDatePrefixSecond = oSecond;
+		FormatLogDate( s_sDatePrefix, sizeof( s_sDatePrefix ), oSecond );
+	}
+
+	return s_sDatePrefix;
 }
 
 void OutputLogger::FlushLogs()
@@ -1,10 +1,57 @@
 #pragma once
 
+#include <atomic>
+#include <filesystem>
 #include <format>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 #include "Array.h"
 
+// Longer messages, and longer strings given to structured logs, are cut and end with "..."
+inline constexpr uint LOG_MESSAGE_SIZE = 1024;
+inline constexpr uint LOG_THREAD_BUFFER_SIZE = 64 * 1024;
+
+struct LogDescriptor;
+struct LoggerThread;
+struct LoggerWriter;
+
+enum class LogCategory : uint8
+{
+	GENERAL,
+	RESOURCES,
+	GAME,
+	GRAPHICS,
+	PHYSICS,
+	EDITOR,
+	_COUNT
+};
+
+// Arguments of structured logs are stored as raw bytes, strings as their length followed by their characters
+enum class LogArgumentType : uint8
+{
+	BOOL,
+	CHAR,
+	INT8,
+	INT16,
+	INT32,
+	INT64,
+	UINT8,
+	UINT16,
+	UINT32,
+	UINT64,
+	FLOAT,
+	DOUBLE,
+	POINTER,
+	STRING
+};
+
+// Messages are formatted by the calling thread and staged in a ring buffer of its own, without taking any lock
+// A writer thread drains the rings in time order, adds the date and location prefixes and hands the logs to the registered loggers
+// An entry not fitting in its thread's ring is dropped and counted, the writer reports how many were lost
+// Structured logs only copy their arguments, they are formatted by the writer or written as is to the binary log, which LogDecoder turns into text
 class Logger
 {
 public:
@@ -17,27 +64,176 @@ public:
 		LEVEL_ERROR
 	};
 
+	friend struct LoggerWriter;
+
 	Logger();
 	~Logger();
 
 	static void			RegisterLogger( Logger* pLogger );
 	static void			UnRegisterLogger( Logger* pLogger );
-	static void			Log( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage );
+
+	// Use the LOG_ macros, messages are truncated to LOG_MESSAGE_SIZE characters
+	template < typename... Args >
+	static void			Log( const LogLevel eLogLevel, const char* sFile, const int iLine, const std::format_string< Args... > sFormat, Args&&... oArgs )
+	{
+		if( IsEnabled( LogCategory::GENERAL, eLogLevel ) == false )
+			return;
+
+		char sMessage[ LOG_MESSAGE_SIZE ];
+		const std::format_to_n_result< char* > oResult = std::format_to_n( sMessage, LOG_MESSAGE_SIZE, sFormat, std::forward< Args >( oArgs )... );
+		if( oResult.size > LOG_MESSAGE_SIZE )
+			memcpy( sMessage + LOG_MESSAGE_SIZE - 3, "...", 3 );
+
+		Push( eLogLevel, sFile, iLine, sMessage, ( uint )( oResult.out - sMessage ) );
+	}
+
+	// Use the SLOG_ macros, the format is only checked here
+	template < typename... Args >
+	static void			LogStructured( const LogDescriptor& oDescriptor, const std::format_string< Args... > sFormat, Args&&... oArgs );
+
+	// Levels below the one of their category are skipped at runtime, LOG_ macros belong to LogCategory::GENERAL
+	static bool			IsEnabled( const LogCategory eCategory, const LogLevel eLogLevel )
+	{
+		return eLogLevel >= s_aCategoryLevels[ ( uint8 )eCategory ].load( std::memory_order_relaxed );
+	}
+
+	static void			SetCategoryLevel( const LogCategory eCategory, const LogLevel eLogLevel );
+	static const char*	GetCategoryName( const LogCategory eCategory );
+	static const char*	GetLevelName( const LogLevel eLogLevel );
+
+	// Structured logs are written to this file instead of being formatted, an empty path formats them again
+	static void			SetBinaryLog( const std::filesystem::path& oFilePath );
+
+	// Blocks until everything the calling thread logged reached the loggers
 	static void			Flush();
 
+	static uint64		GetDroppedCount();
+
 protected:
+	// Only used by the writer thread, loggers are flushed from it
 	static char*			s_pLogBuffer;
 	static uint				s_uLogBufferCursor;
 
 private:
-	static std::string	ProduceLog( const LogLevel eLogLevel, const std::string& sFile, const int iLine, const std::string& sMessage );
+	// Reserve returns nullptr when the entry is dropped, otherwise where its message or arguments go before calling Commit
+	static uint8*		Reserve( const LogLevel eLogLevel, const char* sFile, const int iLine, const LogDescriptor* pDescriptor, const LogArgumentType* pArgumentTypes, const uint uArgumentCount, const uint uLength );
+	static void			Commit();
+
+	static void			Push( const LogLevel eLogLevel, const char* sFile, const int iLine, const char* sMessage, const uint uLength );
+	static void			FlushLoggers();
 
 	virtual void		FlushLogs() = 0;
 
 	static const char*		s_aLogLevels[ 5 ];
 	static Array< Logger* >	s_aLoggers;
+	static std::mutex		s_oLoggersMutex;
+
+	static std::atomic< uint8 >	s_aCategoryLevels[ ( uint8 )LogCategory::_COUNT ];
+};
+
+// Built at compile time for each SLOG_ call site
+struct LogDescriptor
+{
+	constexpr LogDescriptor( const char* sFormat, const char* sFile, const int iLine, const Logger::LogLevel eLogLevel, const LogCategory eCategory )
+		: m_sFormat( sFormat )
+		, m_sFile( sFile )
+		, m_iLine( iLine )
+		, m_eLogLevel( eLogLevel )
+		, m_eCategory( eCategory )
+	{
+	}
+
+	const char*			m_sFormat;
+	const char*			m_sFile;
+	int					m_iLine;
+	Logger::LogLevel	m_eLogLevel;
+	LogCategory			m_eCategory;
+};
+
+template < typename T >
+constexpr LogArgumentType GetLogArgumentType()
+{
+	using Type = std::remove_cvref_t< T >;
+
+	if constexpr( std::is_same_v< Type, bool > )
+		return LogArgumentType::BOOL;
+	else if constexpr( std::is_same_v< Type, char > )
+		return LogArgumentType::CHAR;
+	else if constexpr( std::is_integral_v< Type > && std::is_signed_v< Type > )
+		return sizeof( Type ) == 1 ? LogArgumentType::INT8 : sizeof( Type ) == 2 ? LogArgumentType::INT16 : sizeof( Type ) == 4 ? LogArgumentType::INT32 : LogArgumentType::INT64;
+	else if constexpr( std::is_integral_v< Type > )
+		return sizeof( Type ) == 1 ? LogArgumentType::UINT8 : sizeof( Type ) == 2 ? LogArgumentType::UINT16 : sizeof( Type ) == 4 ? LogArgumentType::UINT32 : LogArgumentType::UINT64;
+	else if constexpr( std::is_same_v< Type, float > )
+		return LogArgumentType::FLOAT;
+	else if constexpr( std::is_same_v< Type, double > )
+		return LogArgumentType::DOUBLE;
+	else if constexpr( std::is_convertible_v< const Type&, std::string_view > )
+		return LogArgumentType::STRING;
+	else
+	{
+		static_assert( std::is_pointer_v< Type > || std::is_null_pointer_v< Type >, "Structured logs take arithmetic values, strings and pointers" );
+		return LogArgumentType::POINTER;
+	}
+}
+
+template < typename... Args >
+struct LogArgumentTypes
+{
+	// One more element than needed, arrays can't be empty
+	static constexpr LogArgumentType s_aTypes[ sizeof...( Args ) + 1 ] = { GetLogArgumentType< Args >()..., LogArgumentType::BOOL };
 };
 
+template < typename T >
+uint GetLogArgumentSize( const T& oArgument )
+{
+	if constexpr( GetLogArgumentType< T >() == LogArgumentType::STRING )
+		return ( uint )sizeof( uint ) + ( uint )std::min( std::string_view( oArgument ).length(), ( size_t )LOG_MESSAGE_SIZE );
+	else if constexpr( GetLogArgumentType< T >() == LogArgumentType::POINTER )
+		return ( uint )sizeof( const void* );
+	else
+		return ( uint )sizeof( std::remove_cvref_t< T > );
+}
+
+template < typename T >
+uint8* WriteLogArgument( uint8* pData, const T& oArgument )
+{
+	if constexpr( GetLogArgumentType< T >() == LogArgumentType::STRING )
+	{
+		const std::string_view sArgument( oArgument );
+		const uint uLength = ( uint )std::min( sArgument.length(), ( size_t )LOG_MESSAGE_SIZE );
+		memcpy( pData, &uLength, sizeof( uint ) );
+		memcpy( pData + sizeof( uint ), sArgument.data(), uLength );
+		if( sArgument.length() > uLength )
+			memcpy( pData + sizeof( uint ) + uLength - 3, "...", 3 );
+
+		return pData + sizeof( uint ) + uLength;
+	}
+	else if constexpr( GetLogArgumentType< T >() == LogArgumentType::POINTER )
+	{
+		const void* pArgument = oArgument;
+		memcpy( pData, &pArgument, sizeof( const void* ) );
+		return pData + sizeof( const void* );
+	}
+	else
+	{
+		memcpy( pData, &oArgument, sizeof( std::remove_cvref_t< T > ) );
+		return pData + sizeof( std::remove_cvref_t< T > );
+	}
+}
+
+template < typename... Args >
+void Logger::LogStructured( const LogDescriptor& oDescriptor, const std::format_string< Args... > /*sFormat*/, Args&&... oArgs )
+{
+	const uint uSize = ( 0 + ... + GetLogArgumentSize( oArgs ) );
+
+	uint8* pData = Reserve( oDescriptor.m_eLogLevel, oDescriptor.m_sFile, oDescriptor.m_iLine, &oDescriptor, LogArgumentTypes< Args... >::s_aTypes, sizeof...( Args ), uSize );
+	if( pData == nullptr )
+		return;
+
+	( ( pData = WriteLogArgument( pData, oArgs ) ), ... );
+	Commit();
+}
+
 class OutputLogger : public Logger
 {
 private:
@@ -56,31 +252,71 @@ private:
 };
 
 #if LOG_LEVEL >= 5
-#define LOG_TRACE( sMessage, ... ) Logger::Log( Logger::LEVEL_TRACE, __FILE__, __LINE__, std::format( sMessage, __VA_ARGS__ ) 
+#define LOG_TRACE( sMessage, ... ) Logger::Log( Logger::LEVEL_TRACE, __FILE__, __LINE__, sMessage, __VA_ARGS__ )
 #else
 #define LOG_TRACE( sMessage, ... ) ( void )( sMessage );
 #endif
 
 #if LOG_LEVEL >= 4
-#define LOG_DEBUG( sMessage, ... ) Logger::Log( Logger::LEVEL_DEBUG, __FILE__, __LINE__, std::format( sMessage, __VA_ARGS__ ) )
+#define LOG_DEBUG( sMessage, ... ) Logger::Log( Logger::LEVEL_DEBUG, __FILE__, __LINE__, sMessage, __VA_ARGS__ )
 #else
 #define LOG_DEBUG( sMessage, ... ) ( void )( sMessage );
 #endif
 
 #if LOG_LEVEL >= 3
-#define LOG_INFO( sMessage, ... ) Logger::Log( Logger::LEVEL_INFO, __FILE__, __LINE__, std::format( sMessage, __VA_ARGS__ ) )
+#define LOG_INFO( sMessage, ... ) Logger::Log( Logger::LEVEL_INFO, __FILE__, __LINE__, sMessage, __VA_ARGS__ )
 #else
 #define LOG_INFO( sMessage, ... ) ( void )( sMessage );
 #endif
 
 #if LOG_LEVEL >= 2
-#define LOG_WARN( sMessage, ... ) Logger::Log( Logger::LEVEL_WARN, __FILE__, __LINE__, std::format( sMessage, __VA_ARGS__ ) )
+#define LOG_WARN( sMessage, ... ) Logger::Log( Logger::LEVEL_WARN, __FILE__, __LINE__, sMessage, __VA_ARGS__ )
 #else
 #define LOG_WARN( sMessage, ... ) ( void )( sMessage );
 #endif
 
 #if LOG_LEVEL >= 1
-#define LOG_ERROR( sMessage, ... ) Logger::Log( Logger::LEVEL_ERROR, __FILE__, __LINE__, std::format( sMessage, __VA_ARGS__ ) )
+#define LOG_ERROR( sMessage, ... ) Logger::Log( Logger::LEVEL_ERROR, __FILE__, __LINE__, sMessage, __VA_ARGS__ )
 #else
 #define LOG_ERROR( sMessage, ... ) ( void )( sMessage );
 #endif
+
+
+#define SLOG_IMPL( eLogLevel, eCategory, sFormat, ... ) \
+	do \
+	{ \
+		static constexpr LogDescriptor s_oLogDescriptor( sFormat, __FILE__, __LINE__, eLogLevel, eCategory ); \
+		if( Logger::IsEnabled( eCategory, eLogLevel ) ) \
+			Logger::LogStructured( s_oLogDescriptor, sFormat, __VA_ARGS__ ); \
+	} while( false )
+
+// Structured logs, meant for hot paths, follow the same LOG_LEVEL and take arithmetic values, strings and pointers
+#if LOG_LEVEL >= 5
+#define SLOG_TRACE( eCategory, sFormat, ... ) SLOG_IMPL( Logger::LEVEL_TRACE, eCategory, sFormat, __VA_ARGS__ )
+#else
+#define SLOG_TRACE( eCategory, sFormat, ... ) ( void )( sFormat )
+#endif
+
+#if LOG_LEVEL >= 4
+#define SLOG_DEBUG( eCategory, sFormat, ... ) SLOG_IMPL( Logger::LEVEL_DEBUG, eCategory, sFormat, __VA_ARGS__ )
+#else
+#define SLOG_DEBUG( eCategory, sFormat, ... ) ( void )( sFormat )
+#endif
+
+#if LOG_LEVEL >= 3
+#define SLOG_INFO( eCategory, sFormat, ... ) SLOG_IMPL( Logger::LEVEL_INFO, eCategory, sFormat, __VA_ARGS__ )
+#else
+#define SLOG_INFO( eCategory, sFormat, ... ) ( void )( sFormat )
+#endif
+
+#if LOG_LEVEL >= 2
+#define SLOG_WARN( eCategory, sFormat, ... ) SLOG_IMPL( Logger::LEVEL_WARN, eCategory, sFormat, __VA_ARGS__ )
+#else
+#define SLOG_WARN( eCategory, sFormat, ... ) ( void )( sFormat )
+#endif
+
+#if LOG_LEVEL >= 1
+#define SLOG_ERROR( eCategory, sFormat, ... ) SLOG_IMPL( Logger::LEVEL_ERROR, eCategory, sFormat, __VA_ARGS__ )
+#else
+#define SLOG_ERROR( eCategory, sFormat, ... ) ( void )( sFormat )
+#endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+MappedFile::MappedFile()
+	: m_pData( nullptr )
+	, m_uSize( 0 )
+	, m_bOpen( false )
+#ifdef _WIN32
+	, m_hFile( INVALID_HANDLE_VALUE )
+	, m_hMapping( nullptr )
+#endif
+{
+}
+
+MappedFile::MappedFile( const std::filesystem::path& oFilePath )
+	: MappedFile()
+{
+	Open( oFilePath );
+}
+
+MappedFile::MappedFile( MappedFile&& oMappedFile ) noexcept
+	: MappedFile()
+{
+	*this = std::move( oMappedFile );
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile& MappedFile::operator=( MappedFile&& oMappedFile ) noexcept
+{
+	if( this != &oMappedFile )
+	{
+		Close();
+
+		std::swap( m_pData, oMappedFile.m_pData );
+		std::swap( m_uSize, oMappedFile.m_uSize );
+		std::swap( m_bOpen, oMappedFile.m_bOpen );
+#ifdef _WIN32
+		std::swap( m_hFile, oMappedFile.m_hFile );
+		std::swap( m_hMapping, oMappedFile.m_hMapping );
+#endif
+	}
+
+	return *this;
+}
+
+bool MappedFile::Open( const std::filesystem::path& oFilePath )
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFileW( oFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if( m_hFile == INVALID_HANDLE_VALUE )
+	{
+		LOG_ERROR( "Error reading file {}", oFilePath.string() );
+		return false;
+	}
+
+	LARGE_INTEGER oSize;
+	if( GetFileSizeEx( m_hFile, &oSize ) == FALSE )
+	{
+		LOG_ERROR( "Error reading file {}", oFilePath.string() );
+		Close();
+		return false;
+	}
+
+	m_uSize = ( uint64 )oSize.QuadPart;
+
+	// Empty files cannot be mapped but are still valid
+	if( m_uSize != 0 )
+	{
+		m_hMapping = CreateFileMappingW( m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if( m_hMapping != nullptr )
+			m_pData = ( const uint8* )MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 );
+
+		if( m_pData == nullptr )
+		{
+			LOG_ERROR( "Error mapping file {}", oFilePath.string() );
+			Close();
+			return false;
+		}
+	}
+#else
+	const int iFile = open( oFilePath.c_str(), O_RDONLY );
+	if( iFile == -1 )
+	{
+		LOG_ERROR( "Error reading file {}", oFilePath.string() );
+		return false;
+	}
+
+	struct stat oStat;
+	if( fstat( iFile, &oStat ) != 0 )
+	{
+		LOG_ERROR( "Error reading file {}", oFilePath.string() );
+		close( iFile );
+		return false;
+	}
+
+	m_uSize = ( uint64 )oStat.st_size;
+
+	// Empty files cannot be mapped but are still valid
+	if( m_uSize != 0 )
+	{
+		void* pData = mmap( nullptr, m_uSize, PROT_READ, MAP_PRIVATE, iFile, 0 );
+		if( pData == MAP_FAILED )
+		{
+			LOG_ERROR( "Error mapping file {}", oFilePath.string() );
+			close( iFile );
+			m_uSize = 0;
+			return false;
+		}
+
+		madvise( pData, m_uSize, MADV_SEQUENTIAL );
+		m_pData = ( const uint8* )pData;
+	}
+
+	// The mapping keeps its own reference to the file
+	close( iFile );
+#endif
+
+	m_bOpen = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if( m_pData != nullptr )
+		UnmapViewOfFile( m_pData );
+
+	if( m_hMapping != nullptr )
+		CloseHandle( m_hMapping );
+
+	if( m_hFile != INVALID_HANDLE_VALUE )
+		CloseHandle( m_hFile );
+
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = nullptr;
+#else
+	if( m_pData != nullptr )
+		munmap( ( void* )m_pData, m_uSize );
+#endif
+
+	m_pData = nullptr;
+	m_uSize = 0;
+	m_bOpen = false;
+}
+
+bool MappedFile::IsOpen() const
+{
+	return m_bOpen;
+}
+
+ArrayView< const uint8 > MappedFile::GetData() const
+{
+	return ArrayView< const uint8 >( m_pData, ( uint )m_uSize );
+}
+
+std::string_view MappedFile::GetText() const
+{
+	return std::string_view( ( const char* )m_pData, m_uSize );
+}
+
+uint64 MappedFile::GetSize() const
+{
+	return m_uSize;
+}
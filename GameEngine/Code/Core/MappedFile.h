@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+#include "Array.h"
+
+// Read-only view of a whole file mapped in memory, the content is paged in by the system when read and never copied
+class MappedFile
+{
+public:
+	MappedFile();
+	explicit MappedFile( const std::filesystem::path& oFilePath );
+	MappedFile( MappedFile&& oMappedFile ) noexcept;
+	~MappedFile();
+
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+	MappedFile& operator=( MappedFile&& oMappedFile ) noexcept;
+
+	bool						Open( const std::filesystem::path& oFilePath );
+	void						Close();
+
+	bool						IsOpen() const;
+
+	ArrayView< const uint8 >	GetData() const;
+	std::string_view			GetText() const;
+	uint64						GetSize() const;
+
+private:
+	const uint8*	m_pData;
+	uint64			m_uSize;
+	bool			m_bOpen;
+
+#ifdef _WIN32
+	void*			m_hFile;
+	void*			m_hMapping;
+#endif
+};
@@ -9,6 +9,7 @@
 #include "Game/InputHandler.h"
 #include "ImGui/imgui.h"
 #include "Intrusive.h"
+#include "PoolAllocator.h"
 #include "Profiler.h"
 #include "StringUtils.h"
 
@@ -63,6 +64,12 @@ IntrusiveMemory::IntrusiveMemory()
 {
 }
 
+IntrusiveReference::IntrusiveReference()
+	: m_pIntrusiveMemory( nullptr )
+	, m_uBytes( 0 )
+{
+}
+
 ComponentMemory::ComponentMemory( const std::type_index oComponentType, const uint64 uComponentSize, const ComponentsHolderBase* pComponentHolder )
 	: m_oComponentType( oComponentType )
 	, m_uComponentSize( uComponentSize )
@@ -70,25 +77,50 @@ ComponentMemory::ComponentMemory( const std::type_index oComponentType, const ui
 {
 }
 
-ArrayMemory::ArrayMemory()
-	: m_uUsedBytes( 0 )
-	, m_uReservedBytes( 0 )
-	, m_uArrayCount( 0 )
+ArrayMemory::ArrayMemory( const std::type_index oArrayType, const uint64 uArrayTypeSize )
+	: m_oArrayType( oArrayType )
+	, m_uArrayTypeSize( uArrayTypeSize )
 	, m_uElementCount( 0 )
+	, m_uReservedElementCount( 0 )
+	, m_uArrayCount( 0 )
+	, m_pNext( nullptr )
 {
+	MemoryTracker::RegisterArrayMemory( this );
 }
 
-ArrayReference::ArrayReference( const ArrayBase* pArray, const std::type_index oArrayType, const uint64 uArrayTypeSize )
-	: m_pArray( pArray )
-	, m_oArrayType( oArrayType )
-	, m_uArrayTypeSize( uArrayTypeSize )
+void ArrayMemory::Track( const uint uPreviousCount, const uint uPreviousCapacity, const uint uCount, const uint uCapacity )
+{
+	if( uCount != uPreviousCount )
+		m_uElementCount.fetch_add( ( uint64 )uCount - ( uint64 )uPreviousCount, std::memory_order_relaxed );
+
+	if( uCapacity != uPreviousCapacity )
+	{
+		m_uReservedElementCount.fetch_add( ( uint64 )uCapacity - ( uint64 )uPreviousCapacity, std::memory_order_relaxed );
+
+		// Only arrays owning memory are counted as instances
+		if( uPreviousCapacity == 0 )
+			m_uArrayCount.fetch_add( 1, std::memory_order_relaxed );
+		else if( uCapacity == 0 )
+			m_uArrayCount.fetch_sub( 1, std::memory_order_relaxed );
+	}
+}
+
+PoolAllocatorRate::PoolAllocatorRate()
+	: m_uPreviousAllocationCount( 0 )
+	, m_uPreviousFreeCount( 0 )
+	, m_uAllocationsPerFrame( 0 )
+	, m_uFreesPerFrame( 0 )
 {
 }
 
+// Constant initialized, array memories of static arrays can register before any dynamic initialization
+static std::atomic< ArrayMemory* > s_pArrayMemories = nullptr;
+
 MemoryTracker* g_pMemoryTracker = nullptr;
 
 MemoryTracker::MemoryTracker()
-	: m_bDisplayMemoryTracker( false )
+	: m_uPendingIntrusiveCount( 0 )
+	, m_bDisplayMemoryTracker( false )
 {
 	g_pMemoryTracker = this;
 }
@@ -100,7 +132,12 @@ MemoryTracker::~MemoryTracker()
 
 void MemoryTracker::Display()
 {
-	ProfilerBlock oBlock( "MemoryTracker" );
+	PROFILE_SCOPE( "MemoryTracker" );
+	AllocationAuditIgnore oAllocationAuditIgnore;
+
+	ClassifyIntrusives();
+	UpdatePoolAllocatorRates();
+	UpdateProfilerCounters();
 
 	if( g_pInputHandler->IsInputActionTriggered( InputActionID::ACTION_TOGGLE_MEMORY_TRACKER ) )
 		m_bDisplayMemoryTracker = !m_bDisplayMemoryTracker;
@@ -114,15 +151,6 @@ void MemoryTracker::Display()
 			uint64 uTotalBytes = 0;
 			uint uTotalCount = 0;
 
-			std::unordered_map< std::type_index, IntrusiveMemory > mObjects;
-
-			for( const Intrusive* pIntrusive : m_lIntrusives )
-			{
-				IntrusiveMemory& oObjectMemory = mObjects[ typeid( *pIntrusive ) ];
-				oObjectMemory.m_uBytes += pIntrusive->GetSize();
-				oObjectMemory.m_uCount += 1;
-			}
-
 			if( ImGui::BeginTable( "IntrusiveTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp ) )
 			{
 				ImGui::TableSetupColumn( "Type" );
@@ -130,25 +158,28 @@ void MemoryTracker::Display()
 				ImGui::TableSetupColumn( "Count" );
 				ImGui::TableHeadersRow();
 
-				for( const auto& oPair : mObjects )
+				for( const auto& oPair : m_mIntrusiveMemories )
 				{
-					const IntrusiveMemory& oObjectMemory = oPair.second;
+					const uint64 uBytes = oPair.second.m_uBytes.load( std::memory_order_relaxed );
+					const uint uCount = oPair.second.m_uCount.load( std::memory_order_relaxed );
+					if( uCount == 0 )
+						continue;
 
-					uTotalBytes += oObjectMemory.m_uBytes;
-					uTotalCount += oObjectMemory.m_uCount;
+					uTotalBytes += uBytes;
+					uTotalCount += uCount;
 
 					ImGui::TableNextRow();
 					ImGui::TableSetColumnIndex( 0 );
 					ImGui::Text( GetDisplayableTypeName( oPair.first ).c_str() );
 					ImGui::TableSetColumnIndex( 1 );
-					ImGui::Text( GetDisplayableMemory( oObjectMemory.m_uBytes ).c_str() );
+					ImGui::Text( GetDisplayableMemory( uBytes ).c_str() );
 					ImGui::TableSetColumnIndex( 2 );
-					ImGui::Text( "%d", oObjectMemory.m_uCount);
+					ImGui::Text( "%d", uCount );
 				}
 				ImGui::EndTable();
 			}
 
-			ImGui::Text( "Total : Memory %s, Count %d", GetDisplayableMemory( uTotalBytes ).c_str(), uTotalCount );
+			ImGui::Text( "Total : Memory %s, Count %d, Pending classification %d", GetDisplayableMemory( uTotalBytes ).c_str(), uTotalCount, m_uPendingIntrusiveCount );
 		}
 
 		if( ImGui::CollapsingHeader( "Components" ) )
@@ -189,20 +220,6 @@ void MemoryTracker::Display()
 			uint64 uTotalUsedBytes = 0;
 			uint64 uTotalReservedBytes = 0;
 
-			std::unordered_map< std::type_index, ArrayMemory > mArrays;
-
-			for( const ArrayReference& oMemory : m_lArrays )
-			{
-				if( oMemory.m_pArray->Capacity() == 0 )
-					continue;
-
-				ArrayMemory& oArrayMemory = mArrays[ oMemory.m_oArrayType ];
-				oArrayMemory.m_uUsedBytes += oMemory.m_uArrayTypeSize * oMemory.m_pArray->Count();
-				oArrayMemory.m_uReservedBytes += oMemory.m_uArrayTypeSize * oMemory.m_pArray->Capacity();
-				oArrayMemory.m_uArrayCount += 1;
-				oArrayMemory.m_uElementCount += oMemory.m_pArray->Count();
-			}
-
 			if( ImGui::BeginTable( "ArrayTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp ) )
 			{
 				ImGui::TableSetupColumn( "Type" );
@@ -213,30 +230,32 @@ void MemoryTracker::Display()
 				ImGui::TableSetupColumn( "Instances" );
 				ImGui::TableHeadersRow();
 
-				for( const auto& oPair : mArrays )
+				for( const ArrayMemory* pArrayMemory = s_pArrayMemories.load( std::memory_order_acquire ); pArrayMemory != nullptr; pArrayMemory = pArrayMemory->m_pNext )
 				{
-					const ArrayMemory& oArrayMemory = oPair.second;
-					if( oArrayMemory.m_uReservedBytes == 0 )
+					const uint64 uElementCount = pArrayMemory->m_uElementCount.load( std::memory_order_relaxed );
+					const uint64 uUsedBytes = pArrayMemory->m_uArrayTypeSize * uElementCount;
+					const uint64 uReservedBytes = pArrayMemory->m_uArrayTypeSize * pArrayMemory->m_uReservedElementCount.load( std::memory_order_relaxed );
+					if( uReservedBytes == 0 )
 						continue;
 
-					float fRatio = ( float )( ( double )oArrayMemory.m_uUsedBytes / ( double )oArrayMemory.m_uReservedBytes );
+					float fRatio = ( float )( ( double )uUsedBytes / ( double )uReservedBytes );
 
-					uTotalUsedBytes += oArrayMemory.m_uUsedBytes;
-					uTotalReservedBytes += oArrayMemory.m_uReservedBytes;
+					uTotalUsedBytes += uUsedBytes;
+					uTotalReservedBytes += uReservedBytes;
 
 					ImGui::TableNextRow();
 					ImGui::TableSetColumnIndex( 0 );
-					ImGui::Text( GetDisplayableTypeName( oPair.first ).c_str() );
+					ImGui::Text( GetDisplayableTypeName( pArrayMemory->m_oArrayType ).c_str() );
 					ImGui::TableSetColumnIndex( 1 );
-					ImGui::Text( GetDisplayableMemory( oArrayMemory.m_uUsedBytes ).c_str() );
+					ImGui::Text( GetDisplayableMemory( uUsedBytes ).c_str() );
 					ImGui::TableSetColumnIndex( 2 );
-					ImGui::Text( GetDisplayableMemory( oArrayMemory.m_uReservedBytes ).c_str() );
+					ImGui::Text( GetDisplayableMemory( uReservedBytes ).c_str() );
 					ImGui::TableSetColumnIndex( 3 );
 					ImGui::ProgressBar( fRatio, ImVec2( ImGui::GetContentRegionAvail().x, 0.0f ) );
 					ImGui::TableSetColumnIndex( 4 );
-					ImGui::Text( "%d", oArrayMemory.m_uElementCount );
+					ImGui::Text( "%llu", uElementCount );
 					ImGui::TableSetColumnIndex( 5 );
-					ImGui::Text( "%d", oArrayMemory.m_uArrayCount );
+					ImGui::Text( "%d", pArrayMemory->m_uArrayCount.load( std::memory_order_relaxed ) );
 				}
 				ImGui::EndTable();
 			}
@@ -245,27 +264,162 @@ void MemoryTracker::Display()
 			ImGui::Text( "Total : Used %s, Reserved %s, Usage Ratio %.0f%%", GetDisplayableMemory( uTotalUsedBytes ).c_str(), GetDisplayableMemory( uTotalReservedBytes ).c_str(), fRatio * 100.f );
 		}
 
+		if( ImGui::CollapsingHeader( "Pool allocators" ) )
+		{
+			uint64 uTotalLiveBytes = 0;
+			uint64 uTotalReservedBytes = 0;
+
+			if( ImGui::BeginTable( "PoolAllocatorTable", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp ) )
+			{
+				ImGui::TableSetupColumn( "Type" );
+				ImGui::TableSetupColumn( "Live" );
+				ImGui::TableSetupColumn( "Peak" );
+				ImGui::TableSetupColumn( "Reserved" );
+				ImGui::TableSetupColumn( "Usage ratio" );
+				ImGui::TableSetupColumn( "Slabs" );
+				ImGui::TableSetupColumn( "Allocs / frees per frame" );
+				ImGui::TableSetupColumn( "Heap fallbacks" );
+				ImGui::TableHeadersRow();
+
+				for( const PoolAllocator* pPoolAllocator : PoolAllocator::GetPoolAllocators() )
+				{
+					const PoolAllocatorStatistics oStatistics = pPoolAllocator->GetStatistics();
+					const PoolAllocatorRate& oRate = m_mPoolAllocatorRates[ pPoolAllocator ];
+
+					const uint64 uLiveBytes = oStatistics.m_uElementSize * oStatistics.m_uLiveCount;
+					const uint64 uReservedBytes = oStatistics.m_uElementSize * oStatistics.m_uCapacity;
+					const float fRatio = oStatistics.m_uCapacity != 0 ? ( float )oStatistics.m_uLiveCount / ( float )oStatistics.m_uCapacity : 0.f;
+
+					uTotalLiveBytes += uLiveBytes;
+					uTotalReservedBytes += uReservedBytes;
+
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex( 0 );
+					ImGui::TextUnformatted( pPoolAllocator->GetName() );
+					ImGui::TableSetColumnIndex( 1 );
+					ImGui::Text( "%u (%s)", oStatistics.m_uLiveCount, GetDisplayableMemory( uLiveBytes ).c_str() );
+					ImGui::TableSetColumnIndex( 2 );
+					ImGui::Text( "%u", oStatistics.m_uPeakLiveCount );
+					ImGui::TableSetColumnIndex( 3 );
+					ImGui::Text( "%u (%s)", oStatistics.m_uCapacity, GetDisplayableMemory( uReservedBytes ).c_str() );
+					ImGui::TableSetColumnIndex( 4 );
+					ImGui::ProgressBar( fRatio, ImVec2( ImGui::GetContentRegionAvail().x, 0.0f ) );
+					ImGui::TableSetColumnIndex( 5 );
+					ImGui::Text( "%u", oStatistics.m_uSlabCount );
+					ImGui::TableSetColumnIndex( 6 );
+					ImGui::Text( "%u / %u", oRate.m_uAllocationsPerFrame, oRate.m_uFreesPerFrame );
+					ImGui::TableSetColumnIndex( 7 );
+					ImGui::Text( "%llu", oStatistics.m_uFallbackCount );
+				}
+				ImGui::EndTable();
+			}
+
+			const float fRatio = uTotalReservedBytes != 0 ? ( float )( ( double )uTotalLiveBytes / ( double )uTotalReservedBytes ) : 0.f;
+			ImGui::Text( "Total : Live %s, Reserved %s, Usage Ratio %.0f%%", GetDisplayableMemory( uTotalLiveBytes ).c_str(), GetDisplayableMemory( uTotalReservedBytes ).c_str(), fRatio * 100.f );
+		}
+
 		ImGui::End();
 	}
 }
 
+void MemoryTracker::UpdatePoolAllocatorRates()
+{
+	for( const PoolAllocator* pPoolAllocator : PoolAllocator::GetPoolAllocators() )
+	{
+		const PoolAllocatorStatistics oStatistics = pPoolAllocator->GetStatistics();
+
+		PoolAllocatorRate& oRate = m_mPoolAllocatorRates[ pPoolAllocator ];
+		oRate.m_uAllocationsPerFrame = ( uint )( oStatistics.m_uAllocationCount - oRate.m_uPreviousAllocationCount );
+		oRate.m_uFreesPerFrame = ( uint )( oStatistics.m_uFreeCount - oRate.m_uPreviousFreeCount );
+		oRate.m_uPreviousAllocationCount = oStatistics.m_uAllocationCount;
+		oRate.m_uPreviousFreeCount = oStatistics.m_uFreeCount;
+	}
+}
+
+void MemoryTracker::UpdateProfilerCounters()
+{
+	uint64 uIntrusiveBytes = 0;
+	for( const auto& oPair : m_mIntrusiveMemories )
+		uIntrusiveBytes += oPair.second.m_uBytes.load( std::memory_order_relaxed );
+
+	uint64 uArrayReservedBytes = 0;
+	for( const ArrayMemory* pArrayMemory = s_pArrayMemories.load( std::memory_order_acquire ); pArrayMemory != nullptr; pArrayMemory = pArrayMemory->m_pNext )
+		uArrayReservedBytes += pArrayMemory->m_uArrayTypeSize * pArrayMemory->m_uReservedElementCount.load( std::memory_order_relaxed );
+
+	PROFILE_COUNTER( "Intrusive memory (bytes)", uIntrusiveBytes );
+	PROFILE_COUNTER( "Array memory (bytes)", uArrayReservedBytes );
+}
+
 void MemoryTracker::RegisterIntrusive( const Intrusive* pIntrusive )
 {
-	std::unique_lock oLock( m_oMutex );
+	IntrusiveShard& oShard = GetIntrusiveShard( pIntrusive );
+	std::unique_lock oLock( oShard.m_oMutex );
 
-	m_lIntrusives.push_back( pIntrusive );
+	oShard.m_mIntrusives.emplace( pIntrusive, IntrusiveReference() );
+	oShard.m_sNewIntrusives.insert( pIntrusive );
 }
 
 void MemoryTracker::UnRegisterIntrusive( const Intrusive* pIntrusive )
 {
-	std::unique_lock oLock( m_oMutex );
+	IntrusiveShard& oShard = GetIntrusiveShard( pIntrusive );
+	std::unique_lock oLock( oShard.m_oMutex );
 
-	m_lIntrusives.remove( pIntrusive );
+	auto it = oShard.m_mIntrusives.find( pIntrusive );
+	if( it == oShard.m_mIntrusives.end() )
+		return;
+
+	const IntrusiveReference& oReference = it->second;
+	if( oReference.m_pIntrusiveMemory != nullptr )
+	{
+		oReference.m_pIntrusiveMemory->m_uBytes.fetch_sub( oReference.m_uBytes, std::memory_order_relaxed );
+		oReference.m_pIntrusiveMemory->m_uCount.fetch_sub( 1, std::memory_order_relaxed );
+	}
+	else if( oShard.m_sNewIntrusives.erase( pIntrusive ) == 0 )
+	{
+		oShard.m_sPendingIntrusives.erase( pIntrusive );
+	}
+
+	oShard.m_mIntrusives.erase( it );
+}
+
+void MemoryTracker::RegisterArrayMemory( ArrayMemory* pArrayMemory )
+{
+	ArrayMemory* pHead = s_pArrayMemories.load( std::memory_order_relaxed );
+	do
+	{
+		pArrayMemory->m_pNext = pHead;
+	}
+	while( s_pArrayMemories.compare_exchange_weak( pHead, pArrayMemory, std::memory_order_release, std::memory_order_relaxed ) == false );
 }
 
-void MemoryTracker::UnRegisterArray( ArrayBase* pArray )
+IntrusiveShard& MemoryTracker::GetIntrusiveShard( const Intrusive* pIntrusive )
 {
-	std::unique_lock oLock( m_oMutex );
+	const uint64 uAddress = ( uint64 )pIntrusive;
+	return m_aIntrusiveShards[ ( ( uAddress >> 4 ) ^ ( uAddress >> 12 ) ) % INTRUSIVE_SHARD_COUNT ];
+}
+
+void MemoryTracker::ClassifyIntrusives()
+{
+	// Objects registered during the previous frame are fully constructed by now, their dynamic type can be queried safely
+	m_uPendingIntrusiveCount = 0;
 
-	m_lArrays.remove_if( [ pArray ]( ArrayReference oArrayMemory ) { return oArrayMemory.m_pArray == pArray; } );
+	for( IntrusiveShard& oShard : m_aIntrusiveShards )
+	{
+		std::unique_lock oLock( oShard.m_oMutex );
+
+		for( const Intrusive* pIntrusive : oShard.m_sPendingIntrusives )
+		{
+			IntrusiveReference& oReference = oShard.m_mIntrusives[ pIntrusive ];
+			oReference.m_pIntrusiveMemory = &m_mIntrusiveMemories[ typeid( *pIntrusive ) ];
+			oReference.m_uBytes = pIntrusive->GetSize();
+
+			oReference.m_pIntrusiveMemory->m_uBytes.fetch_add( oReference.m_uBytes, std::memory_order_relaxed );
+			oReference.m_pIntrusiveMemory->m_uCount.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		oShard.m_sPendingIntrusives.clear();
+		oShard.m_sPendingIntrusives.swap( oShard.m_sNewIntrusives );
+
+		m_uPendingIntrusiveCount += ( uint )oShard.m_sPendingIntrusives.size();
+	}
 }
@@ -1,22 +1,42 @@
 #pragma once
 
-#include <list>
+#include <atomic>
 #include <mutex>
 #include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Types.h"
 
-class ArrayBase;
 class Intrusive;
 class ComponentsHolderBase;
+class PoolAllocator;
 
 struct IntrusiveMemory
 {
 	IntrusiveMemory();
 
-	uint64	m_uBytes;
-	uint	m_uCount;
+	std::atomic< uint64 >	m_uBytes;
+	std::atomic< uint >		m_uCount;
+};
+
+struct IntrusiveReference
+{
+	IntrusiveReference();
+
+	IntrusiveMemory*	m_pIntrusiveMemory;
+	uint64				m_uBytes;
+};
+
+// Intrusives are spread over several shards so that threads creating and destroying objects rarely contend on the same lock
+// Their dynamic type is not known yet when they register from the Intrusive constructor, they are classified one frame later
+struct IntrusiveShard
+{
+	std::unordered_map< const Intrusive*, IntrusiveReference >	m_mIntrusives;
+	std::unordered_set< const Intrusive* >						m_sNewIntrusives;
+	std::unordered_set< const Intrusive* >						m_sPendingIntrusives;
+	std::mutex													m_oMutex;
 };
 
 struct ComponentMemory
@@ -28,23 +48,31 @@ struct ComponentMemory
 	const ComponentsHolderBase*	m_pComponentHolder;
 };
 
+// Aggregated memory of every Array< T > for a given T, updated by the arrays themselves whenever their count or capacity changes
 struct ArrayMemory
 {
-	ArrayMemory();
+	ArrayMemory( const std::type_index oArrayType, const uint64 uArrayTypeSize );
+
+	void					Track( const uint uPreviousCount, const uint uPreviousCapacity, const uint uCount, const uint uCapacity );
 
-	uint64	m_uUsedBytes;
-	uint64	m_uReservedBytes;
-	uint	m_uArrayCount;
-	uint	m_uElementCount;
+	std::type_index			m_oArrayType;
+	uint64					m_uArrayTypeSize;
+
+	std::atomic< uint64 >	m_uElementCount;
+	std::atomic< uint64 >	m_uReservedElementCount;
+	std::atomic< uint >		m_uArrayCount;
+
+	ArrayMemory*			m_pNext;
 };
 
-struct ArrayReference
+struct PoolAllocatorRate
 {
-	ArrayReference( const ArrayBase* pArray, const std::type_index oArrayType, const uint64 uArrayTypeSize );
+	PoolAllocatorRate();
 
-	const ArrayBase*	m_pArray;
-	std::type_index		m_oArrayType;
-	uint64				m_uArrayTypeSize;
+	uint64	m_uPreviousAllocationCount;
+	uint64	m_uPreviousFreeCount;
+	uint	m_uAllocationsPerFrame;
+	uint	m_uFreesPerFrame;
 };
 
 class MemoryTracker
@@ -53,34 +81,44 @@ public:
 	MemoryTracker();
 	~MemoryTracker();
 
-	void		Display();
+	void				Display();
 
-	void		RegisterIntrusive( const Intrusive* pIntrusive );
-	void		UnRegisterIntrusive( const Intrusive* pIntrusive );
+	void				RegisterIntrusive( const Intrusive* pIntrusive );
+	void				UnRegisterIntrusive( const Intrusive* pIntrusive );
 
 	template < typename ComponentType >
-	void		RegisterComponent( const ComponentsHolderBase* pComponentHolder )
+	void				RegisterComponent( const ComponentsHolderBase* pComponentHolder )
 	{
 		m_aComponents.push_back( ComponentMemory( typeid( ComponentType ), sizeof( ComponentType ), pComponentHolder ) );
 	}
 
-	template < typename ComponentType >
-	void		RegisterArray( ArrayBase* pArray )
+	// Does not depend on the tracker instance, arrays can be created before it and destroyed after it
+	template < typename ArrayType >
+	static ArrayMemory&	GetArrayMemory()
 	{
-		std::unique_lock oLock( m_oMutex );
-
-		m_lArrays.push_back( ArrayReference( pArray, typeid( ComponentType ), sizeof( ComponentType ) ) );
+		static ArrayMemory s_oArrayMemory( typeid( ArrayType ), sizeof( ArrayType ) );
+		return s_oArrayMemory;
 	}
-	void		UnRegisterArray( ArrayBase* pArray );
+
+	static void			RegisterArrayMemory( ArrayMemory* pArrayMemory );
 
 private:
-	std::list< const Intrusive* >	m_lIntrusives;
-	std::vector< ComponentMemory >	m_aComponents;
-	std::list< ArrayReference >		m_lArrays;
+	static constexpr uint INTRUSIVE_SHARD_COUNT = 16;
+
+	IntrusiveShard&		GetIntrusiveShard( const Intrusive* pIntrusive );
+	void				ClassifyIntrusives();
+	void				UpdatePoolAllocatorRates();
+	void				UpdateProfilerCounters();
+
+	IntrusiveShard											m_aIntrusiveShards[ INTRUSIVE_SHARD_COUNT ];
+	std::unordered_map< std::type_index, IntrusiveMemory >	m_mIntrusiveMemories;
+	uint													m_uPendingIntrusiveCount;
+
+	std::vector< ComponentMemory >							m_aComponents;
 
-	std::mutex						m_oMutex;
+	std::unordered_map< const PoolAllocator*, PoolAllocatorRate >	m_mPoolAllocatorRates;
 
-	bool							m_bDisplayMemoryTracker;
+	bool													m_bDisplayMemoryTracker;
 };
 
 extern MemoryTracker* g_pMemoryTracker;
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "Logger.h"
+
+// Size of an element of each section, in MeshFileSection order
+static constexpr uint64 MESH_FILE_ELEMENT_SIZES[] = {
+	sizeof( float ),
+	sizeof( uint32 ),
+	sizeof( MeshFileSubmesh ),
+	sizeof( MeshFileNode ),
+	sizeof( MeshFileMatrix ),
+	sizeof( MeshFileMatrix ),
+	sizeof( MeshFileAnimation ),
+	sizeof( MeshFileChannel ),
+	sizeof( float ),
+	sizeof( float ),
+	sizeof( MeshFileMaterial ),
+	sizeof( MeshFileMaterialTexture ),
+	sizeof( uint8 )
+};
+static_assert( std::size( MESH_FILE_ELEMENT_SIZES ) == ( size_t )MeshFileSection::_COUNT );
+
+static bool IsInRange( const MeshFileRange& oRange, const uint64 uCount )
+{
+	return ( uint64 )oRange.m_uOffset + oRange.m_uCount <= uCount;
+}
+
+MeshFileData::MeshFileData()
+	: m_oAABB {}
+{
+}
+
+MeshFileRange MeshFileData::AddBlob( const void* pData, const uint uSize )
+{
+	const MeshFileRange oRange { m_aBlob.Count(), uSize };
+
+	m_aBlob.Resize( m_aBlob.Count() + uSize );
+	if( uSize > 0 )
+		memcpy( m_aBlob.Data() + oRange.m_uOffset, pData, uSize );
+
+	return oRange;
+}
+
+bool WriteMeshFile( const std::filesystem::path& oFilePath, const MeshFileData& oData )
+{
+	std::ofstream oFileStream( oFilePath, std::ios::binary );
+	if( oFileStream.is_open() == false )
+	{
+		LOG_ERROR( "Error writing file {}", oFilePath.string() );
+		return false;
+	}
+
+	MeshFileHeader oHeader {};
+	oHeader.m_uMagic = MESH_FILE_MAGIC;
+	oHeader.m_uVersion = MESH_FILE_VERSION;
+	oHeader.m_oAABB = oData.m_oAABB;
+
+	uint64 uOffset = sizeof( MeshFileHeader );
+	oFileStream.write( ( const char* )&oHeader, sizeof( MeshFileHeader ) );
+
+	auto WriteSection = [ & ]( const MeshFileSection eSection, const void* pData, const uint uCount ) {
+		static const char s_aZeros[ MESH_FILE_ALIGNMENT ] = {};
+
+		const uint64 uPadding = ( MESH_FILE_ALIGNMENT - uOffset % MESH_FILE_ALIGNMENT ) % MESH_FILE_ALIGNMENT;
+		oFileStream.write( s_aZeros, uPadding );
+		uOffset += uPadding;
+
+		MeshFileSectionLocation& oLocation = oHeader.m_aSections[ ( size_t )eSection ];
+		oLocation.m_uOffset = uOffset;
+		oLocation.m_uSize = uCount * MESH_FILE_ELEMENT_SIZES[ ( size_t )eSection ];
+
+		oFileStream.write( ( const char* )pData, oLocation.m_uSize );
+		uOffset += oLocation.m_uSize;
+	};
+
+	WriteSection( MeshFileSection::VERTICES, oData.m_aVertices.Data(), oData.m_aVertices.Count() );
+	WriteSection( MeshFileSection::INDICES, oData.m_aIndices.Data(), oData.m_aIndices.Count() );
+	WriteSection( MeshFileSection::SUBMESHES, oData.m_aSubmeshes.Data(), oData.m_aSubmeshes.Count() );
+	WriteSection( MeshFileSection::NODES, oData.m_aNodes.Data(), oData.m_aNodes.Count() );
+	WriteSection( MeshFileSection::POSE_MATRICES, oData.m_aPoseMatrices.Data(), oData.m_aPoseMatrices.Count() );
+	WriteSection( MeshFileSection::SKIN_MATRICES, oData.m_aSkinMatrices.Data(), oData.m_aSkinMatrices.Count() );
+	WriteSection( MeshFileSection::ANIMATIONS, oData.m_aAnimations.Data(), oData.m_aAnimations.Count() );
+	WriteSection( MeshFileSection::CHANNELS, oData.m_aChannels.Data(), oData.m_aChannels.Count() );
+	WriteSection( MeshFileSection::KEY_TIMES, oData.m_aKeyTimes.Data(), oData.m_aKeyTimes.Count() );
+	WriteSection( MeshFileSection::KEY_VALUES, oData.m_aKeyValues.Data(), oData.m_aKeyValues.Count() );
+	WriteSection( MeshFileSection::MATERIALS, oData.m_aMaterials.Data(), oData.m_aMaterials.Count() );
+	WriteSection( MeshFileSection::MATERIAL_TEXTURES, oData.m_aMaterialTextures.Data(), oData.m_aMaterialTextures.Count() );
+	WriteSection( MeshFileSection::BLOB, oData.m_aBlob.Data(), oData.m_aBlob.Count() );
+
+	oFileStream.seekp( 0 );
+	oFileStream.write( ( const char* )&oHeader, sizeof( MeshFileHeader ) );
+
+	if( oFileStream.good() == false )
+	{
+		LOG_ERROR( "Error writing file {}", oFilePath.string() );
+		return false;
+	}
+
+	return true;
+}
+
+MeshFile::MeshFile()
+	: m_pHeader( nullptr )
+{
+}
+
+template < typename T >
+ArrayView< const T > MeshFile::GetSection( const MeshFileSection eSection ) const
+{
+	ASSERT( m_pHeader != nullptr );
+
+	const MeshFileSectionLocation& oLocation = m_pHeader->m_aSections[ ( size_t )eSection ];
+	return ArrayView< const T >( ( const T* )( m_aData.Data() + oLocation.m_uOffset ), ( uint )( oLocation.m_uSize / sizeof( T ) ) );
+}
+
+bool MeshFile::Open( const std::filesystem::path& oFilePath )
+{
+	if( m_oMappedFile.Open( oFilePath ) == false )
+		return false;
+
+	if( Open( m_oMappedFile.GetData() ) == false )
+	{
+		LOG_ERROR( "Invalid mesh file {}", oFilePath.string() );
+		m_oMappedFile.Close();
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshFile::Open( const ArrayView< const uint8 > aData )
+{
+	if( aData.Count() < sizeof( MeshFileHeader ) || ( uintptr_t )aData.Data() % MESH_FILE_ALIGNMENT != 0 )
+		return false;
+
+	const MeshFileHeader* pHeader = ( const MeshFileHeader* )aData.Data();
+	if( pHeader->m_uMagic != MESH_FILE_MAGIC || pHeader->m_uVersion != MESH_FILE_VERSION )
+		return false;
+
+	for( uint u = 0; u < ( uint )MeshFileSection::_COUNT; ++u )
+	{
+		const MeshFileSectionLocation& oLocation = pHeader->m_aSections[ u ];
+		if( oLocation.m_uOffset % MESH_FILE_ALIGNMENT != 0 || oLocation.m_uOffset > aData.Count() || oLocation.m_uSize > aData.Count() - oLocation.m_uOffset )
+			return false;
+
+		if( oLocation.m_uSize % MESH_FILE_ELEMENT_SIZES[ u ] != 0 )
+			return false;
+	}
+
+	m_aData = aData;
+	m_pHeader = pHeader;
+
+	if( IsValid() == false )
+	{
+		m_aData = ArrayView< const uint8 >();
+		m_pHeader = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void MeshFile::Close()
+{
+	m_oMappedFile.Close();
+	m_aData = ArrayView< const uint8 >();
+	m_pHeader = nullptr;
+}
+
+const MeshFileBox& MeshFile::GetAABB() const
+{
+	return m_pHeader->m_oAABB;
+}
+
+ArrayView< const float > MeshFile::GetVertices() const
+{
+	return GetSection< float >( MeshFileSection::VERTICES );
+}
+
+ArrayView< const uint32 > MeshFile::GetIndices() const
+{
+	return GetSection< uint32 >( MeshFileSection::INDICES );
+}
+
+ArrayView< const MeshFileSubmesh > MeshFile::GetSubmeshes() const
+{
+	return GetSection< MeshFileSubmesh >( MeshFileSection::SUBMESHES );
+}
+
+ArrayView< const MeshFileNode > MeshFile::GetNodes() const
+{
+	return GetSection< MeshFileNode >( MeshFileSection::NODES );
+}
+
+ArrayView< const MeshFileMatrix > MeshFile::GetPoseMatrices() const
+{
+	return GetSection< MeshFileMatrix >( MeshFileSection::POSE_MATRICES );
+}
+
+ArrayView< const MeshFileMatrix > MeshFile::GetSkinMatrices() const
+{
+	return GetSection< MeshFileMatrix >( MeshFileSection::SKIN_MATRICES );
+}
+
+ArrayView< const MeshFileAnimation > MeshFile::GetAnimations() const
+{
+	return GetSection< MeshFileAnimation >( MeshFileSection::ANIMATIONS );
+}
+
+ArrayView< const MeshFileChannel > MeshFile::GetChannels() const
+{
+	return GetSection< MeshFileChannel >( MeshFileSection::CHANNELS );
+}
+
+ArrayView< const float > MeshFile::GetKeyTimes() const
+{
+	return GetSection< float >( MeshFileSection::KEY_TIMES );
+}
+
+ArrayView< const float > MeshFile::GetKeyValues() const
+{
+	return GetSection< float >( MeshFileSection::KEY_VALUES );
+}
+
+ArrayView< const MeshFileMaterial > MeshFile::GetMaterials() const
+{
+	return GetSection< MeshFileMaterial >( MeshFileSection::MATERIALS );
+}
+
+ArrayView< const MeshFileMaterialTexture > MeshFile::GetMaterialTextures() const
+{
+	return GetSection< MeshFileMaterialTexture >( MeshFileSection::MATERIAL_TEXTURES );
+}
+
+ArrayView< const float > MeshFile::GetVertices( const MeshFileSubmesh& oSubmesh ) const
+{
+	return ArrayView< const float >( GetVertices().Data() + oSubmesh.m_oVertices.m_uOffset, oSubmesh.m_oVertices.m_uCount );
+}
+
+ArrayView< const uint32 > MeshFile::GetIndices( const MeshFileSubmesh& oSubmesh ) const
+{
+	return ArrayView< const uint32 >( GetIndices().Data() + oSubmesh.m_oIndices.m_uOffset, oSubmesh.m_oIndices.m_uCount );
+}
+
+ArrayView< const uint8 > MeshFile::GetBlob( const MeshFileRange& oRange ) const
+{
+	return ArrayView< const uint8 >( GetSection< uint8 >( MeshFileSection::BLOB ).Data() + oRange.m_uOffset, oRange.m_uCount );
+}
+
+std::string_view MeshFile::GetString( const MeshFileRange& oRange ) const
+{
+	const ArrayView< const uint8 > aBlob = GetBlob( oRange );
+	return std::string_view( ( const char* )aBlob.Data(), aBlob.Count() );
+}
+
+bool MeshFile::IsValid() const
+{
+	const uint64 uBlobSize = GetSection< uint8 >( MeshFileSection::BLOB ).Count();
+
+	for( const MeshFileSubmesh& oSubmesh : GetSubmeshes() )
+	{
+		const uint64 uVertexSize = 3ull + oSubmesh.m_uUVsSize + oSubmesh.m_uNormalsSize + oSubmesh.m_uTangentsSize + oSubmesh.m_uBonesSize + oSubmesh.m_uWeightsSize;
+		if( IsInRange( oSubmesh.m_oVertices, GetVertices().Count() ) == false || oSubmesh.m_oVertices.m_uCount % uVertexSize != 0 )
+			return false;
+
+		if( IsInRange( oSubmesh.m_oIndices, GetIndices().Count() ) == false )
+			return false;
+
+		// Indices are uploaded as they are, the renderer would read past the vertices of the submesh
+		const uint64 uVertexCount = oSubmesh.m_oVertices.m_uCount / uVertexSize;
+		for( const uint32 uIndex : GetIndices( oSubmesh ) )
+		{
+			if( uIndex >= uVertexCount )
+				return false;
+		}
+	}
+
+	// Nodes and channels index both the pose and the skin matrices
+	const uint64 uMatrixCount = std::min( GetPoseMatrices().Count(), GetSkinMatrices().Count() );
+
+	// Each node takes the place of one pending node and adds its children, the tree is complete when none is pending after the last one
+	uint64 uPendingNodeCount = GetNodes().Empty() ? 0 : 1;
+	for( const MeshFileNode& oNode : GetNodes() )
+	{
+		if( uPendingNodeCount == 0 || oNode.m_uMatrixIndex >= uMatrixCount )
+			return false;
+
+		uPendingNodeCount += oNode.m_uChildCount - 1ull;
+	}
+
+	if( uPendingNodeCount != 0 )
+		return false;
+
+	for( const MeshFileAnimation& oAnimation : GetAnimations() )
+	{
+		if( IsInRange( oAnimation.m_oName, uBlobSize ) == false || IsInRange( oAnimation.m_oChannels, GetChannels().Count() ) == false )
+			return false;
+	}
+
+	auto IsCurveValid = [ this ]( const MeshFileCurve& oCurve, const uint64 uValueSize ) {
+		return IsInRange( oCurve.m_oTimes, GetKeyTimes().Count() ) && IsInRange( oCurve.m_oValues, GetKeyValues().Count() ) && oCurve.m_oValues.m_uCount == oCurve.m_oTimes.m_uCount * uValueSize;
+	};
+
+	for( const MeshFileChannel& oChannel : GetChannels() )
+	{
+		if( IsCurveValid( oChannel.m_oPositionCurve, 3 ) == false || IsCurveValid( oChannel.m_oRotationCurve, 4 ) == false || IsCurveValid( oChannel.m_oScaleCurve, 3 ) == false )
+			return false;
+
+		if( oChannel.m_uMatrixIndex >= uMatrixCount )
+			return false;
+	}
+
+	for( const MeshFileMaterialTexture& oMaterialTexture : GetMaterialTextures() )
+	{
+		if( oMaterialTexture.m_uMaterialIndex >= GetMaterials().Count() || IsInRange( oMaterialTexture.m_oPath, uBlobSize ) == false || IsInRange( oMaterialTexture.m_oEmbeddedData, uBlobSize ) == false )
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+#include "Array.h"
+#include "MappedFile.h"
+
+// Mesh file layout : a MeshFileHeader, then one section per MeshFileSection, each aligned on MESH_FILE_ALIGNMENT and located by the header
+// Every section is an array of its element type, stored as it is in memory so that the file can be mapped and used in place
+//  - VERTICES			float, the interleaved vertices of every submesh, laid out as PackedMesh does
+//  - INDICES			uint32, relative to the first vertex of their submesh
+//  - SUBMESHES			MeshFileSubmesh, each one is a Mesh of the model
+//  - NODES				MeshFileNode, the skeleton in depth first order, each node followed by its children
+//  - POSE_MATRICES		MeshFileMatrix, the bind pose of every node, by matrix index
+//  - SKIN_MATRICES		MeshFileMatrix, the inverse bind pose of every bone, by matrix index
+//  - ANIMATIONS		MeshFileAnimation
+//  - CHANNELS			MeshFileChannel, the animated nodes of every animation
+//  - KEY_TIMES			float, in seconds
+//  - KEY_VALUES		float, 3 per key for positions and scales, 4 per key for rotations in glm::quat order
+//  - MATERIALS			MeshFileMaterial
+//  - MATERIAL_TEXTURES	MeshFileMaterialTexture
+//  - BLOB				uint8, the names, texture paths and embedded textures
+// Ranges are in elements of the section they refer to
+inline constexpr uint32 MESH_FILE_MAGIC = 0x4853454D;
+inline constexpr uint32 MESH_FILE_VERSION = 1;
+inline constexpr uint64 MESH_FILE_ALIGNMENT = 16;
+
+enum class MeshFileSection : uint8
+{
+	VERTICES,
+	INDICES,
+	SUBMESHES,
+	NODES,
+	POSE_MATRICES,
+	SKIN_MATRICES,
+	ANIMATIONS,
+	CHANNELS,
+	KEY_TIMES,
+	KEY_VALUES,
+	MATERIALS,
+	MATERIAL_TEXTURES,
+	BLOB,
+	_COUNT
+};
+
+struct MeshFileRange
+{
+	uint32	m_uOffset;
+	uint32	m_uCount;
+};
+
+struct MeshFileBox
+{
+	float	m_aMin[ 3 ];
+	float	m_aMax[ 3 ];
+};
+
+struct MeshFileSectionLocation
+{
+	uint64	m_uOffset;
+	uint64	m_uSize;
+};
+
+struct MeshFileHeader
+{
+	uint32					m_uMagic;
+	uint32					m_uVersion;
+	MeshFileBox				m_oAABB;
+	MeshFileSectionLocation	m_aSections[ ( size_t )MeshFileSection::_COUNT ];
+};
+
+// A vertex is its position then the streams of a non zero size, in PackedMesh order
+struct MeshFileSubmesh
+{
+	MeshFileRange	m_oVertices;
+	MeshFileRange	m_oIndices;
+	uint32			m_uUVsSize;
+	uint32			m_uNormalsSize;
+	uint32			m_uTangentsSize;
+	uint32			m_uBonesSize;
+	uint32			m_uWeightsSize;
+	uint32			m_uMaterialIndex;
+	MeshFileBox		m_oAABB;
+};
+
+struct MeshFileNode
+{
+	uint32	m_uMatrixIndex;
+	uint32	m_uChildCount;
+};
+
+// 4 columns of 3 rows, as glm::mat4x3
+struct MeshFileMatrix
+{
+	float	m_aValues[ 12 ];
+};
+
+struct MeshFileCurve
+{
+	MeshFileRange	m_oTimes;
+	MeshFileRange	m_oValues;
+};
+
+struct MeshFileChannel
+{
+	MeshFileCurve	m_oPositionCurve;
+	MeshFileCurve	m_oRotationCurve;
+	MeshFileCurve	m_oScaleCurve;
+	uint32			m_uMatrixIndex;
+};
+
+struct MeshFileAnimation
+{
+	MeshFileRange	m_oName;
+	MeshFileRange	m_oChannels;
+	float			m_fDuration;
+};
+
+struct MeshFileMaterial
+{
+	float	m_aDiffuseColor[ 3 ];
+	float	m_aSpecularColor[ 3 ];
+	float	m_aEmissiveColor[ 3 ];
+	float	m_fShininess;
+};
+
+// The slot is the texture of the material, the loader decides what it maps to
+struct MeshFileMaterialTexture
+{
+	uint32			m_uMaterialIndex;
+	uint32			m_uSlot;
+	MeshFileRange	m_oPath;
+	MeshFileRange	m_oEmbeddedData;
+	uint32			m_uSRGB;
+};
+
+// What a mesh file is written from, one array per section
+struct MeshFileData
+{
+	MeshFileData();
+
+	// Appends to the blob
+	MeshFileRange						AddBlob( const void* pData, const uint uSize );
+
+	MeshFileBox							m_oAABB;
+	Array< float >						m_aVertices;
+	Array< uint32 >						m_aIndices;
+	Array< MeshFileSubmesh >			m_aSubmeshes;
+	Array< MeshFileNode >				m_aNodes;
+	Array< MeshFileMatrix >				m_aPoseMatrices;
+	Array< MeshFileMatrix >				m_aSkinMatrices;
+	Array< MeshFileAnimation >			m_aAnimations;
+	Array< MeshFileChannel >			m_aChannels;
+	Array< float >						m_aKeyTimes;
+	Array< float >						m_aKeyValues;
+	Array< MeshFileMaterial >			m_aMaterials;
+	Array< MeshFileMaterialTexture >	m_aMaterialTextures;
+	Array< uint8 >						m_aBlob;
+};
+
+bool WriteMeshFile( const std::filesystem::path& oFilePath, const MeshFileData& oData );
+
+// Read-only mesh file, the sections are used in place and every range is checked when it is opened
+class MeshFile
+{
+public:
+	MeshFile();
+
+	bool									Open( const std::filesystem::path& oFilePath );
+	// aData has to outlive the views, it must be aligned on MESH_FILE_ALIGNMENT
+	bool									Open( const ArrayView< const uint8 > aData );
+	void									Close();
+
+	const MeshFileBox&						GetAABB() const;
+	ArrayView< const float >				GetVertices() const;
+	ArrayView< const uint32 >				GetIndices() const;
+	ArrayView< const MeshFileSubmesh >		GetSubmeshes() const;
+	ArrayView< const MeshFileNode >			GetNodes() const;
+	ArrayView< const MeshFileMatrix >		GetPoseMatrices() const;
+	ArrayView< const MeshFileMatrix >		GetSkinMatrices() const;
+	ArrayView< const MeshFileAnimation >	GetAnimations() const;
+	ArrayView< const MeshFileChannel >		GetChannels() const;
+	ArrayView< const float >				GetKeyTimes() const;
+	ArrayView< const float >				GetKeyValues() const;
+	ArrayView< const MeshFileMaterial >		GetMaterials() const;
+	ArrayView< const MeshFileMaterialTexture >	GetMaterialTextures() const;
+
+	ArrayView< const float >				GetVertices( const MeshFileSubmesh& oSubmesh ) const;
+	ArrayView< const uint32 >				GetIndices( const MeshFileSubmesh& oSubmesh ) const;
+	ArrayView< const uint8 >				GetBlob( const MeshFileRange& oRange ) const;
+	std::string_view						GetString( const MeshFileRange& oRange ) const;
+
+private:
+	template < typename T >
+	ArrayView< const T >					GetSection( const MeshFileSection eSection ) const;
+
+	bool									IsValid() const;
+
+	MappedFile					m_oMappedFile;
+	ArrayView< const uint8 >	m_aData;
+	const MeshFileHeader*		m_pHeader;
+};
@@ -0,0 +1,264 @@
+#include "PackFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#define STBI_WRITE_NO_STDIO
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+#include <limits>
+
+#include "ArrayUtils.h"
+#include "Logger.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+
+uint64 HashPackPath( const std::string_view sPath )
+{
+	// FNV-1a
+	uint64 uHash = 14695981039346656037ull;
+	for( const char cCharacter : sPath )
+	{
+		uHash ^= ( uint8 )cCharacter;
+		uHash *= 1099511628211ull;
+	}
+
+	return uHash;
+}
+
+static bool IsInRange( const uint64 uOffset, const uint64 uSize, const uint64 uTotalSize )
+{
+	return uOffset <= uTotalSize && uSize <= uTotalSize - uOffset;
+}
+
+// Entries are used without any further check, anything a truncated or corrupted pack could make them point to is refused here
+static bool IsValidEntry( const PackEntry& oEntry, const uint64 uFileSize, const uint64 uPathsSize )
+{
+	if( IsInRange( oEntry.m_uOffset, oEntry.m_uStoredSize, uFileSize ) == false || IsInRange( oEntry.m_uPathOffset, oEntry.m_uPathLength, uPathsSize ) == false )
+		return false;
+
+	// Data is handed out as Array and ArrayView, the count of which is a uint
+	if( oEntry.m_uSize > std::numeric_limits< uint >::max() )
+		return false;
+
+	switch( oEntry.m_eCompression )
+	{
+	case PackCompression::NONE:
+		return oEntry.m_uSize == oEntry.m_uStoredSize;
+	case PackCompression::ZLIB:
+		return true;
+	}
+
+	return false;
+}
+
+bool DecompressPackData( const ArrayView< const uint8 > aStoredData, const uint64 uSize, const PackCompression eCompression, Array< uint8 >& aBuffer )
+{
+	switch( eCompression )
+	{
+	case PackCompression::NONE:
+		aBuffer.Resize( aStoredData.Count() );
+		memcpy( aBuffer.Data(), aStoredData.Data(), aStoredData.Count() );
+		return true;
+	case PackCompression::ZLIB:
+		aBuffer.Resize( ( uint )uSize );
+		return stbi_zlib_decode_buffer( ( char* )aBuffer.Data(), ( int )uSize, ( const char* )aStoredData.Data(), ( int )aStoredData.Count() ) == ( int )uSize;
+	}
+
+	return false;
+}
+
+PackFile::PackFile()
+	: m_pEntries( nullptr )
+	, m_pPaths( nullptr )
+	, m_uEntryCount( 0 )
+{
+}
+
+bool PackFile::Open( const std::filesystem::path& oFilePath )
+{
+	if( m_oMappedFile.Open( oFilePath ) == false )
+		return false;
+
+	const ArrayView< const uint8 > aData = m_oMappedFile.GetData();
+	if( aData.Count() < sizeof( PackHeader ) )
+	{
+		LOG_ERROR( "Invalid pack file {}", oFilePath.string() );
+		m_oMappedFile.Close();
+		return false;
+	}
+
+	const PackHeader& oHeader = *( const PackHeader* )aData.Data();
+	const uint64 uEntriesSize = ( uint64 )oHeader.m_uEntryCount * sizeof( PackEntry );
+	bool bValid = oHeader.m_uMagic == PACK_MAGIC && oHeader.m_uVersion == PACK_VERSION && oHeader.m_uEntriesOffset % alignof( PackEntry ) == 0
+		&& IsInRange( oHeader.m_uEntriesOffset, uEntriesSize, aData.Count() ) && IsInRange( oHeader.m_uPathsOffset, oHeader.m_uPathsSize, aData.Count() );
+
+	const PackEntry* pEntries = ( const PackEntry* )( aData.Data() + oHeader.m_uEntriesOffset );
+	for( uint u = 0; bValid && u < oHeader.m_uEntryCount; ++u )
+		bValid = IsValidEntry( pEntries[ u ], aData.Count(), oHeader.m_uPathsSize );
+
+	if( bValid == false )
+	{
+		LOG_ERROR( "Invalid pack file {}", oFilePath.string() );
+		m_oMappedFile.Close();
+		return false;
+	}
+
+	m_pEntries = pEntries;
+	m_pPaths = ( const char* )( aData.Data() + oHeader.m_uPathsOffset );
+	m_uEntryCount = oHeader.m_uEntryCount;
+	m_oFilePath = oFilePath;
+
+	return true;
+}
+
+const PackEntry* PackFile::Find( const std::string_view sPath ) const
+{
+	const uint64 uHash = HashPackPath( sPath );
+
+	const PackEntry* pEnd = m_pEntries + m_uEntryCount;
+	for( const PackEntry* pEntry = std::lower_bound( m_pEntries, pEnd, uHash, []( const PackEntry& oEntry, const uint64 uHash ) { return oEntry.m_uPathHash < uHash; } ); pEntry != pEnd && pEntry->m_uPathHash == uHash; ++pEntry )
+	{
+		// Paths are compared as well in case of a hash collision
+		if( GetPath( *pEntry ) == sPath )
+			return pEntry;
+	}
+
+	return nullptr;
+}
+
+bool PackFile::Read( const PackEntry& oEntry, ArrayView< const uint8 >& aData, Array< uint8 >& aBuffer ) const
+{
+	const uint8* pStoredData = m_oMappedFile.GetData().Data() + oEntry.m_uOffset;
+
+	switch( oEntry.m_eCompression )
+	{
+	case PackCompression::NONE:
+		aData = ArrayView< const uint8 >( pStoredData, ( uint )oEntry.m_uSize );
+		return true;
+	case PackCompression::ZLIB:
+		if( DecompressPackData( ArrayView< const uint8 >( pStoredData, ( uint )oEntry.m_uStoredSize ), oEntry.m_uSize, oEntry.m_eCompression, aBuffer ) == false )
+		{
+			LOG_ERROR( "Error decompressing {}", GetPath( oEntry ) );
+			return false;
+		}
+
+		aData = ArrayView< const uint8 >( aBuffer.Data(), aBuffer.Count() );
+		return true;
+	}
+
+	return false;
+}
+
+std::string_view PackFile::GetPath( const PackEntry& oEntry ) const
+{
+	return std::string_view( m_pPaths + oEntry.m_uPathOffset, oEntry.m_uPathLength );
+}
+
+ArrayView< const PackEntry > PackFile::GetEntries() const
+{
+	return ArrayView< const PackEntry >( m_pEntries, m_uEntryCount );
+}
+
+const std::filesystem::path& PackFile::GetFilePath() const
+{
+	return m_oFilePath;
+}
+
+bool WritePackFile( const std::filesystem::path& oDirectory, const std::filesystem::path& oFilePath, const bool bCompress )
+{
+	std::ofstream oFileStream( oFilePath, std::ios::binary );
+	if( oFileStream.is_open() == false )
+	{
+		LOG_ERROR( "Error writing file {}", oFilePath.string() );
+		return false;
+	}
+
+	PackHeader oHeader {};
+	oHeader.m_uMagic = PACK_MAGIC;
+	oHeader.m_uVersion = PACK_VERSION;
+
+	Array< PackEntry > aEntries;
+	std::string sPaths;
+
+	uint64 uOffset = sizeof( PackHeader );
+	oFileStream.write( ( const char* )&oHeader, sizeof( PackHeader ) );
+
+	auto Align = [ & ]() {
+		static const char s_aZeros[ PACK_DATA_ALIGNMENT ] = {};
+
+		const uint64 uPadding = ( PACK_DATA_ALIGNMENT - uOffset % PACK_DATA_ALIGNMENT ) % PACK_DATA_ALIGNMENT;
+		oFileStream.write( s_aZeros, uPadding );
+		uOffset += uPadding;
+	};
+
+	for( const std::filesystem::directory_entry& oDirectoryEntry : std::filesystem::recursive_directory_iterator( oDirectory ) )
+	{
+		if( oDirectoryEntry.is_regular_file() == false )
+			continue;
+
+		const std::string sPath = std::filesystem::relative( oDirectoryEntry.path(), oDirectory ).generic_string();
+		// Read as loose files, never through mounted packs
+		const MappedFile oMappedFile( oDirectoryEntry.path() );
+		if( oMappedFile.IsOpen() == false )
+			return false;
+
+		const ArrayView< const uint8 > aContent = oMappedFile.GetData();
+
+		PackEntry oEntry {};
+		oEntry.m_uPathHash = HashPackPath( sPath );
+		oEntry.m_uSize = aContent.Count();
+		oEntry.m_uStoredSize = aContent.Count();
+		oEntry.m_uPathOffset = ( uint32 )sPaths.length();
+		oEntry.m_uPathLength = ( uint16 )sPath.length();
+		oEntry.m_eCompression = PackCompression::NONE;
+
+		sPaths += sPath;
+
+		Align();
+		oEntry.m_uOffset = uOffset;
+
+		int iCompressedSize = 0;
+		uint8* pCompressedData = bCompress && aContent.Empty() == false ? stbi_zlib_compress( ( uint8* )aContent.Data(), ( int )aContent.Count(), &iCompressedSize, 8 ) : nullptr;
+		if( pCompressedData != nullptr && ( uint64 )iCompressedSize <= oEntry.m_uSize - oEntry.m_uSize / 8 )
+		{
+			oEntry.m_uStoredSize = ( uint64 )iCompressedSize;
+			oEntry.m_eCompression = PackCompression::ZLIB;
+			oFileStream.write( ( const char* )pCompressedData, iCompressedSize );
+		}
+		else
+		{
+			oFileStream.write( ( const char* )aContent.Data(), aContent.Count() );
+		}
+
+		free( pCompressedData );
+
+		uOffset += oEntry.m_uStoredSize;
+		aEntries.PushBack( oEntry );
+	}
+
+	Sort( aEntries, []( const PackEntry& oEntryA, const PackEntry& oEntryB ) { return oEntryA.m_uPathHash < oEntryB.m_uPathHash; } );
+
+	Align();
+	oHeader.m_uEntryCount = aEntries.Count();
+	oHeader.m_uEntriesOffset = uOffset;
+	oFileStream.write( ( const char* )aEntries.Data(), aEntries.Count() * sizeof( PackEntry ) );
+	uOffset += aEntries.Count() * sizeof( PackEntry );
+
+	oHeader.m_uPathsSize = ( uint32 )sPaths.length();
+	oHeader.m_uPathsOffset = uOffset;
+	oFileStream.write( sPaths.data(), sPaths.length() );
+
+	oFileStream.seekp( 0 );
+	oFileStream.write( ( const char* )&oHeader, sizeof( PackHeader ) );
+
+	if( oFileStream.good() == false )
+	{
+		LOG_ERROR( "Error writing file {}", oFilePath.string() );
+		return false;
+	}
+
+	LOG_INFO( "Packed {} files from {} into {}", aEntries.Count(), oDirectory.string(), oFilePath.string() );
+	return true;
+}
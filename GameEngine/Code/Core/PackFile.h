@@ -0,0 +1,75 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+#include "Array.h"
+#include "MappedFile.h"
+
+// Pack layout : a PackHeader, the data of each entry aligned on PACK_DATA_ALIGNMENT, the PackEntry table sorted by path hash, then the paths
+// Paths are relative to the packed directory, with '/' separators
+inline constexpr uint32 PACK_MAGIC = 0x4B434150;
+inline constexpr uint32 PACK_VERSION = 1;
+inline constexpr uint64 PACK_DATA_ALIGNMENT = 16;
+
+enum class PackCompression : uint8
+{
+	NONE,
+	ZLIB
+};
+
+struct PackHeader
+{
+	uint32	m_uMagic;
+	uint32	m_uVersion;
+	uint32	m_uEntryCount;
+	uint32	m_uPathsSize;
+	uint64	m_uEntriesOffset;
+	uint64	m_uPathsOffset;
+};
+
+struct PackEntry
+{
+	uint64			m_uPathHash;
+	uint64			m_uOffset;
+	uint64			m_uSize;
+	uint64			m_uStoredSize;
+	uint32			m_uPathOffset;
+	uint16			m_uPathLength;
+	PackCompression	m_eCompression;
+	uint8			m_uPadding;
+};
+
+uint64 HashPackPath( const std::string_view sPath );
+
+// Decompresses the stored data of an entry into aBuffer, for entries read from the pack without going through its mapping
+bool DecompressPackData( const ArrayView< const uint8 > aStoredData, const uint64 uSize, const PackCompression eCompression, Array< uint8 >& aBuffer );
+
+// Read-only pack, mapped as a whole so that uncompressed entries are used in place
+class PackFile
+{
+public:
+	PackFile();
+
+	bool						Open( const std::filesystem::path& oFilePath );
+
+	// Returns nullptr when the path is not in the pack
+	const PackEntry*			Find( const std::string_view sPath ) const;
+
+	// Uncompressed entries point into the mapping, compressed ones are decompressed into aBuffer
+	bool						Read( const PackEntry& oEntry, ArrayView< const uint8 >& aData, Array< uint8 >& aBuffer ) const;
+
+	std::string_view			GetPath( const PackEntry& oEntry ) const;
+	ArrayView< const PackEntry >	GetEntries() const;
+	const std::filesystem::path&	GetFilePath() const;
+
+private:
+	std::filesystem::path	m_oFilePath;
+	MappedFile				m_oMappedFile;
+	const PackEntry*		m_pEntries;
+	const char*				m_pPaths;
+	uint					m_uEntryCount;
+};
+
+// Packs every file under oDirectory, entries are only compressed when it saves at least an eighth of their size
+bool WritePackFile( const std::filesystem::path& oDirectory, const std::filesystem::path& oFilePath, const bool bCompress );
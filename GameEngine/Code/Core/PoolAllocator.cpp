@@ -0,0 +1,313 @@
+#include "PoolAllocator.h"
+
+#include <new>
+
+#include "Common.h"
+
+// Free elements a thread keeps per pool, half of them move from or to the shared free list at once
+static constexpr uint THREAD_CACHE_CAPACITY = 32;
+static constexpr uint THREAD_CACHE_BATCH = THREAD_CACHE_CAPACITY / 2;
+
+struct PoolAllocatorRegistry
+{
+	PoolAllocatorRegistry()
+		: m_uNextIndex( 0 )
+	{
+	}
+
+	Array< PoolAllocator* >	m_aPoolAllocators;
+	uint					m_uNextIndex;
+	std::mutex				m_oMutex;
+};
+
+static PoolAllocatorRegistry& GetPoolAllocatorRegistry()
+{
+	static PoolAllocatorRegistry s_oRegistry;
+	return s_oRegistry;
+}
+
+// Gives the cached elements back to their pools when the thread ends
+struct PoolAllocatorThreadCache
+{
+	~PoolAllocatorThreadCache()
+	{
+		// Pools destroyed before the thread ended are no longer registered, their elements are dropped
+		PoolAllocatorRegistry& oRegistry = GetPoolAllocatorRegistry();
+		std::unique_lock oLock( oRegistry.m_oMutex );
+
+		for( PoolAllocator* pPoolAllocator : oRegistry.m_aPoolAllocators )
+		{
+			if( pPoolAllocator->m_uIndex < m_aFreeLists.Count() )
+			{
+				std::unique_lock oPoolLock( pPoolAllocator->m_oMutex );
+				pPoolAllocator->FlushThreadFreeList( m_aFreeLists[ pPoolAllocator->m_uIndex ], 0 );
+			}
+		}
+
+		// Elements freed by later thread_local destructors go straight to the shared free lists
+		m_aFreeLists.Clear();
+		m_bExited = true;
+	}
+
+	Array< PoolAllocator::ThreadFreeList >	m_aFreeLists;
+	bool									m_bExited = false;
+};
+
+static thread_local PoolAllocatorThreadCache s_oPoolAllocatorThreadCache;
+
+PoolAllocatorStatistics::PoolAllocatorStatistics()
+	: m_uElementSize( 0 )
+	, m_uLiveCount( 0 )
+	, m_uPeakLiveCount( 0 )
+	, m_uCapacity( 0 )
+	, m_uSlabCount( 0 )
+	, m_uAllocationCount( 0 )
+	, m_uFreeCount( 0 )
+	, m_uFallbackCount( 0 )
+{
+}
+
+PoolAllocator::PoolAllocator( const char* sName, const uint64 uElementSize, const uint64 uElementAlignment, const uint uElementsPerSlab )
+	: m_sName( sName )
+	, m_uIndex( 0 )
+	, m_uElementSize( uElementSize )
+	, m_uElementStride( 0 )
+	, m_uElementAlignment( uElementAlignment < alignof( FreeElement ) ? alignof( FreeElement ) : uElementAlignment )
+	, m_uElementsPerSlab( uElementsPerSlab )
+	, m_pFreeList( nullptr )
+	, m_uLiveCount( 0 )
+	, m_uPeakLiveCount( 0 )
+	, m_uAllocationCount( 0 )
+	, m_uFreeCount( 0 )
+	, m_uFallbackCount( 0 )
+{
+	ASSERT( m_uElementsPerSlab > 0 );
+
+	const uint64 uMinimumSize = m_uElementSize < sizeof( FreeElement ) ? sizeof( FreeElement ) : m_uElementSize;
+	m_uElementStride = ( uMinimumSize + m_uElementAlignment - 1 ) & ~( m_uElementAlignment - 1 );
+
+	PoolAllocatorRegistry& oRegistry = GetPoolAllocatorRegistry();
+	std::unique_lock oLock( oRegistry.m_oMutex );
+	m_uIndex = oRegistry.m_uNextIndex++;
+	oRegistry.m_aPoolAllocators.PushBack( this );
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	{
+		PoolAllocatorRegistry& oRegistry = GetPoolAllocatorRegistry();
+		std::unique_lock oLock( oRegistry.m_oMutex );
+
+		for( uint u = 0; u < oRegistry.m_aPoolAllocators.Count(); ++u )
+		{
+			if( oRegistry.m_aPoolAllocators[ u ] == this )
+			{
+				oRegistry.m_aPoolAllocators.Remove( u );
+				break;
+			}
+		}
+	}
+
+	// Elements still alive at shutdown keep their slab, it is better to leak than to have them point to freed memory
+	ASSERT( m_uLiveCount == 0 );
+	if( m_uLiveCount != 0 )
+		return;
+
+	for( uint8* pSlab : m_aSlabs )
+		::operator delete( pSlab, std::align_val_t( m_uElementAlignment ) );
+
+	m_aSlabs.Clear();
+	m_pFreeList = nullptr;
+}
+
+void* PoolAllocator::Allocate( const std::size_t uSize )
+{
+	m_uAllocationCount.fetch_add( 1, std::memory_order_relaxed );
+
+	if( uSize != m_uElementSize )
+	{
+		m_uFallbackCount.fetch_add( 1, std::memory_order_relaxed );
+		return ::operator new( uSize );
+	}
+
+	FreeElement* pElement = nullptr;
+	ThreadFreeList* pFreeList = GetThreadFreeList( m_uIndex );
+	if( pFreeList != nullptr )
+	{
+		if( pFreeList->m_pHead == nullptr )
+			RefillThreadFreeList( *pFreeList );
+
+		pElement = pFreeList->m_pHead;
+		pFreeList->m_pHead = pElement->m_pNext;
+		--pFreeList->m_uCount;
+	}
+	else
+	{
+		std::unique_lock oLock( m_oMutex );
+		pElement = PopSharedElement();
+	}
+
+	OnAllocated();
+
+	return pElement;
+}
+
+void PoolAllocator::Free( void* pPtr, const std::size_t uSize )
+{
+	if( pPtr == nullptr )
+		return;
+
+	m_uFreeCount.fetch_add( 1, std::memory_order_relaxed );
+
+	if( uSize != m_uElementSize )
+	{
+		::operator delete( pPtr );
+		return;
+	}
+
+	ASSERT( m_uLiveCount > 0 );
+	m_uLiveCount.fetch_sub( 1, std::memory_order_relaxed );
+
+	FreeElement* pElement = static_cast< FreeElement* >( pPtr );
+	ThreadFreeList* pFreeList = GetThreadFreeList( m_uIndex );
+	if( pFreeList != nullptr )
+	{
+		pElement->m_pNext = pFreeList->m_pHead;
+		pFreeList->m_pHead = pElement;
+
+		// The most recently freed elements are kept, they are the likeliest to be in the cache
+		if( ++pFreeList->m_uCount > THREAD_CACHE_CAPACITY )
+		{
+			std::unique_lock oLock( m_oMutex );
+			FlushThreadFreeList( *pFreeList, THREAD_CACHE_BATCH );
+		}
+	}
+	else
+	{
+		std::unique_lock oLock( m_oMutex );
+		pElement->m_pNext = m_pFreeList;
+		m_pFreeList = pElement;
+	}
+}
+
+PoolAllocator::FreeElement* PoolAllocator::PopSharedElement()
+{
+	if( m_pFreeList == nullptr )
+		AllocateSlab();
+
+	FreeElement* pElement = m_pFreeList;
+	m_pFreeList = pElement->m_pNext;
+
+	return pElement;
+}
+
+void PoolAllocator::RefillThreadFreeList( ThreadFreeList& oFreeList )
+{
+	std::unique_lock oLock( m_oMutex );
+
+	if( m_pFreeList == nullptr )
+		AllocateSlab();
+
+	// The batch is cut from the front of the shared list, elements of a new slab stay in address order
+	FreeElement* pLast = m_pFreeList;
+	uint uCount = 1;
+	while( uCount < THREAD_CACHE_BATCH && pLast->m_pNext != nullptr )
+	{
+		pLast = pLast->m_pNext;
+		++uCount;
+	}
+
+	oFreeList.m_pHead = m_pFreeList;
+	oFreeList.m_uCount = uCount;
+
+	m_pFreeList = pLast->m_pNext;
+	pLast->m_pNext = nullptr;
+}
+
+void PoolAllocator::FlushThreadFreeList( ThreadFreeList& oFreeList, const uint uKeptCount )
+{
+	if( oFreeList.m_uCount <= uKeptCount )
+		return;
+
+	// Called with the mutex locked, the elements after the kept ones go back to the shared list
+	FreeElement** ppFirst = &oFreeList.m_pHead;
+	for( uint u = 0; u < uKeptCount; ++u )
+		ppFirst = &( *ppFirst )->m_pNext;
+
+	FreeElement* pFirst = *ppFirst;
+	FreeElement* pLast = pFirst;
+	while( pLast->m_pNext != nullptr )
+		pLast = pLast->m_pNext;
+
+	pLast->m_pNext = m_pFreeList;
+	m_pFreeList = pFirst;
+
+	*ppFirst = nullptr;
+	oFreeList.m_uCount = uKeptCount;
+}
+
+void PoolAllocator::OnAllocated()
+{
+	const uint uLiveCount = m_uLiveCount.fetch_add( 1, std::memory_order_relaxed ) + 1;
+
+	uint uPeakLiveCount = m_uPeakLiveCount.load( std::memory_order_relaxed );
+	while( uPeakLiveCount < uLiveCount && m_uPeakLiveCount.compare_exchange_weak( uPeakLiveCount, uLiveCount, std::memory_order_relaxed ) == false )
+	{
+	}
+}
+
+const char* PoolAllocator::GetName() const
+{
+	return m_sName;
+}
+
+PoolAllocatorStatistics PoolAllocator::GetStatistics() const
+{
+	std::unique_lock oLock( m_oMutex );
+
+	PoolAllocatorStatistics oStatistics;
+	oStatistics.m_uElementSize = m_uElementSize;
+	oStatistics.m_uLiveCount = m_uLiveCount.load( std::memory_order_relaxed );
+	oStatistics.m_uPeakLiveCount = m_uPeakLiveCount.load( std::memory_order_relaxed );
+	oStatistics.m_uCapacity = m_aSlabs.Count() * m_uElementsPerSlab;
+	oStatistics.m_uSlabCount = m_aSlabs.Count();
+	oStatistics.m_uAllocationCount = m_uAllocationCount.load( std::memory_order_relaxed );
+	oStatistics.m_uFreeCount = m_uFreeCount.load( std::memory_order_relaxed );
+	oStatistics.m_uFallbackCount = m_uFallbackCount.load( std::memory_order_relaxed );
+
+	return oStatistics;
+}
+
+Array< PoolAllocator* > PoolAllocator::GetPoolAllocators()
+{
+	PoolAllocatorRegistry& oRegistry = GetPoolAllocatorRegistry();
+	std::unique_lock oLock( oRegistry.m_oMutex );
+
+	return oRegistry.m_aPoolAllocators;
+}
+
+PoolAllocator::ThreadFreeList* PoolAllocator::GetThreadFreeList( const uint uIndex )
+{
+	PoolAllocatorThreadCache& oThreadCache = s_oPoolAllocatorThreadCache;
+	if( oThreadCache.m_bExited )
+		return nullptr;
+
+	if( uIndex >= oThreadCache.m_aFreeLists.Count() )
+		oThreadCache.m_aFreeLists.Resize( uIndex + 1, ThreadFreeList { nullptr, 0 } );
+
+	return &oThreadCache.m_aFreeLists[ uIndex ];
+}
+
+void PoolAllocator::AllocateSlab()
+{
+	uint8* pSlab = static_cast< uint8* >( ::operator new( m_uElementStride * m_uElementsPerSlab, std::align_val_t( m_uElementAlignment ) ) );
+	m_aSlabs.PushBack( pSlab );
+
+	// Thread the new elements in address order so consecutive allocations stay contiguous
+	for( int i = ( int )m_uElementsPerSlab - 1; i >= 0; --i )
+	{
+		FreeElement* pElement = reinterpret_cast< FreeElement* >( pSlab + i * m_uElementStride );
+		pElement->m_pNext = m_pFreeList;
+		m_pFreeList = pElement;
+	}
+}
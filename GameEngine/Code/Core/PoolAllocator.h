@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#include "Array.h"
+#include "Types.h"
+
+#ifdef AUDIT_ALLOCATIONS
+#include "AllocationAudit.h"
+// The new expression of a pooled object is where it is created, Intrusive objects report it rather than their constructor
+#define POOL_ALLOCATOR_AUDIT_OBJECT( pPtr, uSize ) AllocationAudit::OnObjectAllocated( pPtr, uSize, ALLOCATION_CALL_SITE() )
+#else
+#define POOL_ALLOCATOR_AUDIT_OBJECT( pPtr, uSize )
+#endif
+
+struct PoolAllocatorStatistics
+{
+	PoolAllocatorStatistics();
+
+	uint64	m_uElementSize;
+	uint	m_uLiveCount;
+	uint	m_uPeakLiveCount;
+	uint	m_uCapacity;
+	uint	m_uSlabCount;
+	uint64	m_uAllocationCount;
+	uint64	m_uFreeCount;
+	uint64	m_uFallbackCount;
+};
+
+// Fixed size free-list allocator, memory is requested from the system by slabs of several elements
+// Each thread keeps a few free elements of every pool, the shared free list is only locked to move them by batches
+// Classes opt into it with DECLARE_POOL_ALLOCATOR in their declaration and DEFINE_POOL_ALLOCATOR in their translation unit
+class PoolAllocator
+{
+public:
+	PoolAllocator( const char* sName, const uint64 uElementSize, const uint64 uElementAlignment, const uint uElementsPerSlab );
+	~PoolAllocator();
+
+	PoolAllocator( const PoolAllocator& ) = delete;
+	PoolAllocator& operator=( const PoolAllocator& ) = delete;
+
+	void*							Allocate( const std::size_t uSize );
+	void							Free( void* pPtr, const std::size_t uSize );
+
+	const char*						GetName() const;
+	PoolAllocatorStatistics			GetStatistics() const;
+
+	static Array< PoolAllocator* >	GetPoolAllocators();
+
+private:
+	friend struct PoolAllocatorThreadCache;
+
+	struct FreeElement
+	{
+		FreeElement* m_pNext;
+	};
+
+	struct ThreadFreeList
+	{
+		FreeElement*	m_pHead;
+		uint			m_uCount;
+	};
+
+	static ThreadFreeList*			GetThreadFreeList( const uint uIndex );
+
+	void							AllocateSlab();
+	FreeElement*					PopSharedElement();
+	void							RefillThreadFreeList( ThreadFreeList& oFreeList );
+	void							FlushThreadFreeList( ThreadFreeList& oFreeList, const uint uKeptCount );
+	void							OnAllocated();
+
+	const char*						m_sName;
+	// Index of the free lists of the pool in the thread caches, never reused
+	uint							m_uIndex;
+	uint64							m_uElementSize;
+	uint64							m_uElementStride;
+	uint64							m_uElementAlignment;
+	uint							m_uElementsPerSlab;
+
+	// Protected by the mutex, along with the shared free list
+	Array< uint8* >					m_aSlabs;
+	FreeElement*					m_pFreeList;
+
+	// Elements cached by the threads are not live, they are counted as free
+	std::atomic_uint				m_uLiveCount;
+	std::atomic_uint				m_uPeakLiveCount;
+	std::atomic< uint64 >			m_uAllocationCount;
+	std::atomic< uint64 >			m_uFreeCount;
+	std::atomic< uint64 >			m_uFallbackCount;
+
+	mutable std::mutex				m_oMutex;
+};
+
+#define DECLARE_POOL_ALLOCATOR()													\
+public:																				\
+	static void*			operator new( const std::size_t uSize );				\
+	static void				operator delete( void* pPtr, const std::size_t uSize );	\
+	static PoolAllocator&	GetPoolAllocator();
+
+// Types deriving from a pooled class without declaring their own pool fall back to the global heap
+#define DEFINE_POOL_ALLOCATOR( ClassName, uElementsPerSlab )																		\
+PoolAllocator& ClassName::GetPoolAllocator()																						\
+{																																	\
+	static PoolAllocator s_oPoolAllocator( #ClassName, sizeof( ClassName ), alignof( ClassName ), uElementsPerSlab );				\
+	return s_oPoolAllocator;																										\
+}																																	\
+																																	\
+void* ClassName::operator new( const std::size_t uSize )																			\
+{																																	\
+	void* pPtr = GetPoolAllocator().Allocate( uSize );																				\
+	POOL_ALLOCATOR_AUDIT_OBJECT( pPtr, uSize );																						\
+	return pPtr;																													\
+}																																	\
+																																	\
+void ClassName::operator delete( void* pPtr, const std::size_t uSize )																\
+{																																	\
+	GetPoolAllocator().Free( pPtr, uSize );																							\
+}
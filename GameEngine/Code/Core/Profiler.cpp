@@ -1,9 +1,15 @@
 #include "Profiler.h"
 
+#include <algorithm>
 #include <format>
+#include <string_view>
 
 #include <GL/glew.h>
 
+#include "AllocationAudit.h"
+#include "FileUtils.h"
+#include "Logger.h"
+#include "ProfilerClock.h"
 #include "Time.h"
 #include "Game/GameEngine.h"
 #include "Game/InputHandler.h"
@@ -21,7 +27,7 @@ static constexpr ImColor TextColor( const ImColor& oBackgroundColor )
 	return fLum > 0.5f ? ImColor( 0.05f, 0.05f, 0.05f ) : ImColor( 0.95f, 0.95f, 0.95f );
 }
 
-static constexpr ImColor BACKGROUND_COLORS[ 64 ] = {
+static constexpr ImColor BACKGROUND_COLORS[ PROFILER_COLOR_COUNT ] = {
 	ImColor( 255, 0, 0 ),		ImColor( 0, 255, 0 ),		ImColor( 0, 0, 255 ),		ImColor( 255, 255, 0 ),
 	ImColor( 0, 255, 255 ),		ImColor( 255, 0, 255 ),		ImColor( 128, 0, 0 ),		ImColor( 0, 128, 0 ),
 	ImColor( 0, 0, 128 ),		ImColor( 128, 128, 0 ),		ImColor( 0, 128, 128 ),		ImColor( 128, 0, 128 ),
@@ -40,7 +46,7 @@ static constexpr ImColor BACKGROUND_COLORS[ 64 ] = {
 	ImColor( 255, 128, 128 ),	ImColor( 128, 255, 128 ),	ImColor( 128, 128, 255 ),	ImColor( 255, 64, 6 )
 };
 
-static constexpr ImColor BORDER_COLORS[ 64 ] = {
+static constexpr ImColor BORDER_COLORS[ PROFILER_COLOR_COUNT ] = {
 	BorderColor( BACKGROUND_COLORS[ 0 ] ),	BorderColor( BACKGROUND_COLORS[ 1 ] ),	BorderColor( BACKGROUND_COLORS[ 2 ] ),	BorderColor( BACKGROUND_COLORS[ 3 ] ),
 	BorderColor( BACKGROUND_COLORS[ 4 ] ),	BorderColor( BACKGROUND_COLORS[ 5 ] ),	BorderColor( BACKGROUND_COLORS[ 6 ] ),	BorderColor( BACKGROUND_COLORS[ 7 ] ),
 	BorderColor( BACKGROUND_COLORS[ 8 ] ),	BorderColor( BACKGROUND_COLORS[ 9 ] ),	BorderColor( BACKGROUND_COLORS[ 10 ] ),	BorderColor( BACKGROUND_COLORS[ 11 ] ),
@@ -59,7 +65,7 @@ static constexpr ImColor BORDER_COLORS[ 64 ] = {
 	BorderColor( BACKGROUND_COLORS[ 60 ] ), BorderColor( BACKGROUND_COLORS[ 61 ] ),	BorderColor( BACKGROUND_COLORS[ 62 ] ),	BorderColor( BACKGROUND_COLORS[ 63 ] )
 };
 
-static constexpr ImColor TEXT_COLORS[ 64 ] = {
+static constexpr ImColor TEXT_COLORS[ PROFILER_COLOR_COUNT ] = {
 	TextColor( BACKGROUND_COLORS[ 0 ] ),	TextColor( BACKGROUND_COLORS[ 1 ] ),	TextColor( BACKGROUND_COLORS[ 2 ] ),	TextColor( BACKGROUND_COLORS[ 3 ] ),
 	TextColor( BACKGROUND_COLORS[ 4 ] ),	TextColor( BACKGROUND_COLORS[ 5 ] ),	TextColor( BACKGROUND_COLORS[ 6 ] ),	TextColor( BACKGROUND_COLORS[ 7 ] ),
 	TextColor( BACKGROUND_COLORS[ 8 ] ),	TextColor( BACKGROUND_COLORS[ 9 ] ),	TextColor( BACKGROUND_COLORS[ 10 ] ),	TextColor( BACKGROUND_COLORS[ 11 ] ),
@@ -78,27 +84,23 @@ static constexpr ImColor TEXT_COLORS[ 64 ] = {
 	TextColor( BACKGROUND_COLORS[ 60 ] ),	TextColor( BACKGROUND_COLORS[ 61 ] ),	TextColor( BACKGROUND_COLORS[ 62 ] ),	TextColor( BACKGROUND_COLORS[ 63 ] )
 };
 
-static uint GenerateColorIndex( const char* sName )
+// Threads may still run blocks while the profiler is destroyed or before it is created
+ProfilerBlock::ProfilerBlock( const ProfilerBlockDescriptor& oDescriptor )
 {
-	uint uHash = 0;
-	while( *sName )
-	{
-		uHash = ( uHash * 31 ) ^ uint( *sName );
-		++sName;
-	}
-
-	return uHash % 64;
+	if( g_pProfiler != nullptr )
+		g_pProfiler->StartBlock( oDescriptor );
 }
 
-ProfilerBlock::ProfilerBlock( const char* sName, const bool bAsync )
-	: m_uBlockID( bAsync ? g_pProfiler->StartAsyncBlock( sName ) : g_pProfiler->StartBlock( sName ) )
-	, m_bAsync( bAsync )
+ProfilerBlock::ProfilerBlock( const char* sName )
 {
+	if( g_pProfiler != nullptr )
+		g_pProfiler->StartBlock( sName );
 }
 
 ProfilerBlock::~ProfilerBlock()
 {
-	m_bAsync ? g_pProfiler->EndAsyncBlock( m_uBlockID ) : g_pProfiler->EndBlock( m_uBlockID );
+	if( g_pProfiler != nullptr )
+		g_pProfiler->EndBlock();
 }
 
 GPUProfilerBlock::GPUProfilerBlock( const char* sName )
@@ -113,68 +115,369 @@ GPUProfilerBlock::~GPUProfilerBlock()
 
 struct Block
 {
-	Block( const char* sName, const uint uDepth )
-		: m_sName( sName )
-		, m_oStart( std::chrono::high_resolution_clock::now() )
+	Block( const ProfilerBlockDescriptor* pDescriptor, const GameTimePoint& oStart, const uint uDepth )
+		: m_pDescriptor( pDescriptor )
+		, m_oStart( oStart )
 		, m_uDepth( uDepth )
 	{
 	}
 
-	bool IsFinished() const
-	{
-		return m_oStart <= m_oEnd;
-	}
+	const ProfilerBlockDescriptor*	m_pDescriptor;
+	GameTimePoint					m_oStart;
+	GameTimePoint					m_oEnd;
+	uint							m_uDepth;
 
-	const char*		m_sName;
-	GameTimePoint	m_oStart;
-	GameTimePoint	m_oEnd;
-	uint			m_uDepth;
+	// Allocation counters of the thread when the block starts, replaced by what the block allocated once it ends
+	AllocationCounters				m_oAllocations;
 };
 
-struct AsyncBlock : Block
+struct GPUBlock : Block
 {
-	AsyncBlock( const uint uID, const char* sName, const uint uDepth )
-		: Block( sName, uDepth )
-		, m_uID( uID )
+	GPUBlock( const GLuint uStartID, const ProfilerBlockDescriptor* pDescriptor, const uint uDepth )
+		: Block( pDescriptor, GameTimePoint(), uDepth )
+		, m_uStartID( uStartID )
 	{
 	}
 
-	uint m_uID;
+	GLuint m_uStartID;
+	GLuint m_uEndID;
 };
 
-struct GPUBlock : Block
+struct ThreadLane
 {
-	GPUBlock( const GLuint uStartID, const char* sName, const uint uDepth )
-		: Block( sName, uDepth )
-		, m_uStartID( uStartID )
+	ThreadLane()
+		: m_sThreadName( nullptr )
+		, m_uDroppedBlocks( 0 )
 	{
 	}
 
-	GLuint m_uStartID;
-	GLuint m_uEndID;
+	Array< Block >	m_aBlocks;
+	const char*		m_sThreadName;
+	uint			m_uDroppedBlocks;
 };
 
 struct Frame
 {
-	GameTimePoint		m_oFrameStart;
-	GameTimePoint		m_oFrameEnd;
-	Array< Block >		m_aBlocks;
-	Array< AsyncBlock >	m_aAsyncBlocks;
-	Array< GPUBlock >	m_aGPUBlocks;
-	bool				m_bReady;
+	GameTimePoint			m_oFrameStart;
+	GameTimePoint			m_oFrameEnd;
+	Array< ThreadLane >		m_aThreadLanes;
+	Array< GPUBlock >		m_aGPUBlocks;
+	AllocationCounters		m_oAllocations;
+	Array< double >			m_aCounters;
+	bool					m_bReady;
+};
+
+struct ProfilerBlockBudget
+{
+	const char*	m_sName;
+	float		m_fBudgetMs;
+
+	// Time spent in the block during the checked frame
+	float		m_fDurationMs;
+};
+
+// Frames around a frame over budget, the spike frame being at m_uSpikeFrame
+struct ProfilerSpike
+{
+	Array< Frame >	m_aFrames;
+	uint			m_uSpikeFrame;
+
+	uint64			m_uFrameIndex;
+	const char*		m_sBlockName;
+	float			m_fDurationMs;
+	float			m_fBudgetMs;
+	std::string		m_sSummary;
+};
+
+enum class ProfilerEventType : uint8
+{
+	BEGIN,
+	END,
+	COUNTER
+};
+
+// Times are kept as ProfilerClock ticks, they are only converted when collected
+struct ProfilerEvent
+{
+	union
+	{
+		const ProfilerBlockDescriptor*	m_pDescriptor;
+		const char*						m_sCounterName;
+	};
+	uint64								m_uTicks;
+#ifdef AUDIT_ALLOCATIONS
+	AllocationCounters					m_oAllocations;
+#endif
+	double								m_fValue;
+	ProfilerEventType					m_eType;
+};
+
+struct ProfilerCounterSample
+{
+	const char*	m_sName;
+	double		m_fValue;
+};
+
+// Each thread records its block events in its own ring buffer, without taking any lock
+// Only the owning thread writes events and only the main thread reads them, when collecting them into a frame
+struct ProfilerThread
+{
+	explicit ProfilerThread( const uint uIndex );
+
+	void								Begin( const ProfilerBlockDescriptor& oDescriptor );
+	void								End();
+	void								SetCounter( const char* sName, const double fValue );
+
+	void								Collect( const GameTimePoint& oFrameStart, const GameTimePoint& oFrameEnd, ThreadLane& oLane, ProfilerStatistics& oStatistics, Array< ProfilerCounterSample >& aCounterSamples );
+
+	ProfilerEvent						m_aEvents[ PROFILER_THREAD_EVENT_COUNT ];
+	alignas( 64 ) std::atomic< uint >	m_uWriteIndex;
+	alignas( 64 ) std::atomic< uint >	m_uReadIndex;
+
+	std::atomic< const char* >			m_sName;
+	std::atomic< uint >					m_uDroppedBlocks;
+	std::atomic< bool >					m_bExited;
+	uint								m_uIndex;
+
+	// Writer side, a block whose begin event was dropped must also drop its end event
+	uint64								m_uRecordedDepths;
+	uint								m_uDepth;
+	uint								m_uPendingEnds;
+	// Descriptors of blocks named at runtime already used by the thread, by hash of their name
+	std::unordered_map< size_t, const ProfilerBlockDescriptor* >	m_mDescriptors;
+
+	// Reader side, blocks begun but not ended yet and when they actually began, their start is moved when they are cut at the end of a frame
+	Array< Block >						m_aOpenBlocks;
+	Array< GameTimePoint >				m_aOpenBlockBeginTimes;
+};
+
+// Record of the calling thread in the profiler of a given generation, records of a destroyed profiler are never used again
+// The record is given back when the thread exits, the profiler deletes it once it collected its last events
+struct ProfilerThreadRegistration
+{
+	ProfilerThreadRegistration();
+	~ProfilerThreadRegistration();
+
+	ProfilerThread*	m_pThread;
+	uint			m_uGeneration;
 };
 
+// Outlive every profiler, threads may exit after the profiler is destroyed
+static std::mutex s_oProfilerThreadsMutex;
+static std::atomic< uint > s_uProfilerGeneration = 0;
+
+static thread_local ProfilerThreadRegistration s_oProfilerThreadRegistration;
+
+ProfilerThreadRegistration::ProfilerThreadRegistration()
+	: m_pThread( nullptr )
+	, m_uGeneration( 0 )
+{
+}
+
+ProfilerThreadRegistration::~ProfilerThreadRegistration()
+{
+	std::unique_lock oLock( s_oProfilerThreadsMutex );
+
+	if( m_pThread != nullptr && m_uGeneration == s_uProfilerGeneration.load( std::memory_order_relaxed ) )
+		m_pThread->m_bExited.store( true, std::memory_order_release );
+}
+
+ProfilerThread::ProfilerThread( const uint uIndex )
+	: m_uWriteIndex( 0 )
+	, m_uReadIndex( 0 )
+	, m_sName( nullptr )
+	, m_uDroppedBlocks( 0 )
+	, m_bExited( false )
+	, m_uIndex( uIndex )
+	, m_uRecordedDepths( 0 )
+	, m_uDepth( 0 )
+	, m_uPendingEnds( 0 )
+{
+}
+
+void ProfilerThread::Begin( const ProfilerBlockDescriptor& oDescriptor )
+{
+	const uint64 uTicks = ProfilerClock::GetTicks();
+
+	const uint uWriteIndex = m_uWriteIndex.load( std::memory_order_relaxed );
+	const uint uUsedEvents = uWriteIndex - m_uReadIndex.load( std::memory_order_acquire );
+
+	// Room is kept for the end events of every recorded block, a recorded begin always gets its end
+	if( m_uDepth < 64 && uUsedEvents + m_uPendingEnds + 2 <= PROFILER_THREAD_EVENT_COUNT )
+	{
+		ProfilerEvent& oEvent = m_aEvents[ uWriteIndex % PROFILER_THREAD_EVENT_COUNT ];
+		oEvent.m_pDescriptor = &oDescriptor;
+		oEvent.m_uTicks = uTicks;
+#ifdef AUDIT_ALLOCATIONS
+		oEvent.m_oAllocations = AllocationAudit::GetThreadCounters();
+#endif
+		oEvent.m_eType = ProfilerEventType::BEGIN;
+		m_uWriteIndex.store( uWriteIndex + 1, std::memory_order_release );
+
+		m_uRecordedDepths |= 1ull << m_uDepth;
+		++m_uPendingEnds;
+	}
+	else
+	{
+		m_uDroppedBlocks.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	++m_uDepth;
+}
+
+void ProfilerThread::End()
+{
+	const uint64 uTicks = ProfilerClock::GetTicks();
+
+	// Blocks begun before the thread was registered in this profiler
+	if( m_uDepth == 0 )
+		return;
+
+	--m_uDepth;
+
+	if( m_uDepth >= 64 || ( m_uRecordedDepths & ( 1ull << m_uDepth ) ) == 0 )
+		return;
+
+	m_uRecordedDepths &= ~( 1ull << m_uDepth );
+	--m_uPendingEnds;
+
+	const uint uWriteIndex = m_uWriteIndex.load( std::memory_order_relaxed );
+	ProfilerEvent& oEvent = m_aEvents[ uWriteIndex % PROFILER_THREAD_EVENT_COUNT ];
+	oEvent.m_pDescriptor = nullptr;
+	oEvent.m_uTicks = uTicks;
+#ifdef AUDIT_ALLOCATIONS
+	oEvent.m_oAllocations = AllocationAudit::GetThreadCounters();
+#endif
+	oEvent.m_eType = ProfilerEventType::END;
+	m_uWriteIndex.store( uWriteIndex + 1, std::memory_order_release );
+}
+
+void ProfilerThread::SetCounter( const char* sName, const double fValue )
+{
+	const uint uWriteIndex = m_uWriteIndex.load( std::memory_order_relaxed );
+	const uint uUsedEvents = uWriteIndex - m_uReadIndex.load( std::memory_order_acquire );
+
+	// A dropped sample leaves the counter to its previous value
+	if( uUsedEvents + m_uPendingEnds + 1 > PROFILER_THREAD_EVENT_COUNT )
+		return;
+
+	ProfilerEvent& oEvent = m_aEvents[ uWriteIndex % PROFILER_THREAD_EVENT_COUNT ];
+	oEvent.m_sCounterName = sName;
+	oEvent.m_fValue = fValue;
+	oEvent.m_eType = ProfilerEventType::COUNTER;
+	m_uWriteIndex.store( uWriteIndex + 1, std::memory_order_release );
+}
+
+
+void ProfilerThread::Collect( const GameTimePoint& oFrameStart, const GameTimePoint& oFrameEnd, ThreadLane& oLane, ProfilerStatistics& oStatistics, Array< ProfilerCounterSample >& aCounterSamples )
+{
+	oLane.m_sThreadName = m_sName.load( std::memory_order_relaxed );
+	oLane.m_uDroppedBlocks = m_uDroppedBlocks.exchange( 0, std::memory_order_relaxed );
+
+	const uint uWriteIndex = m_uWriteIndex.load( std::memory_order_acquire );
+	uint uReadIndex = m_uReadIndex.load( std::memory_order_relaxed );
+
+	for( ; uReadIndex != uWriteIndex; ++uReadIndex )
+	{
+		const ProfilerEvent& oEvent = m_aEvents[ uReadIndex % PROFILER_THREAD_EVENT_COUNT ];
+
+		if( oEvent.m_eType == ProfilerEventType::BEGIN )
+		{
+			const GameTimePoint oTime = ProfilerClock::ToTimePoint( oEvent.m_uTicks );
+			m_aOpenBlocks.PushBack( Block( oEvent.m_pDescriptor, oTime, m_aOpenBlocks.Count() ) );
+			m_aOpenBlockBeginTimes.PushBack( oTime );
+#ifdef AUDIT_ALLOCATIONS
+			m_aOpenBlocks.Back().m_oAllocations = oEvent.m_oAllocations;
+#endif
+		}
+		else if( oEvent.m_eType == ProfilerEventType::COUNTER )
+		{
+			aCounterSamples.PushBack( ProfilerCounterSample{ oEvent.m_sCounterName, oEvent.m_fValue } );
+		}
+		else
+		{
+			ASSERT( m_aOpenBlocks.Empty() == false );
+
+			const GameTimePoint oTime = ProfilerClock::ToTimePoint( oEvent.m_uTicks );
+			const uint64 uDurationNs = std::chrono::duration_cast< std::chrono::nanoseconds >( oTime - m_aOpenBlockBeginTimes.Back() ).count();
+
+			oLane.m_aBlocks.PushBack( m_aOpenBlocks.Back() );
+			m_aOpenBlocks.PopBack();
+			m_aOpenBlockBeginTimes.PopBack();
+
+			Block& oBlock = oLane.m_aBlocks.Back();
+			oBlock.m_oEnd = oTime;
+			oBlock.m_oStart = std::min( std::max( oBlock.m_oStart, oFrameStart ), oBlock.m_oEnd );
+#ifdef AUDIT_ALLOCATIONS
+			oBlock.m_oAllocations = oEvent.m_oAllocations - oBlock.m_oAllocations;
+			oStatistics.AddBlock( oBlock.m_pDescriptor->m_sName, uDurationNs, ProfilerBlockAllocations( oBlock.m_oAllocations.m_uAllocationCount, oBlock.m_oAllocations.m_uAllocatedBytes, oBlock.m_oAllocations.m_uFreedBytes ) );
+#else
+			oStatistics.AddBlock( oBlock.m_pDescriptor->m_sName, uDurationNs );
+#endif
+		}
+	}
+
+	m_uReadIndex.store( uReadIndex, std::memory_order_release );
+
+	// Blocks still running are cut at the end of the frame and continue in the next one
+	for( Block& oOpenBlock : m_aOpenBlocks )
+	{
+		oLane.m_aBlocks.PushBack( oOpenBlock );
+
+		Block& oBlock = oLane.m_aBlocks.Back();
+		oBlock.m_oStart = std::max( oBlock.m_oStart, oFrameStart );
+		oBlock.m_oEnd = std::max( oBlock.m_oStart, oFrameEnd );
+
+		// Counters of other threads can't be read from here, the part of the block ending it reports everything
+		oBlock.m_oAllocations = AllocationCounters();
+
+		oOpenBlock.m_oStart = oBlock.m_oEnd;
+	}
+}
+
+static float GetFrameLength( const Frame& oFrame )
+{
+	return std::chrono::duration< float, std::milli >( oFrame.m_oFrameEnd - oFrame.m_oFrameStart ).count();
+}
+
+static std::string BlockTooltip( const Block& oBlock, const float fDuration )
+{
+	const ProfilerBlockDescriptor& oDescriptor = *oBlock.m_pDescriptor;
+
+	std::string sTooltip = std::format( "{} ({:.3f} ms)", oDescriptor.m_sName, fDuration );
+	if( oDescriptor.m_sFile != nullptr )
+		sTooltip += std::format( "\n{}({})", oDescriptor.m_sFile, oDescriptor.m_uLine );
+
+#ifdef AUDIT_ALLOCATIONS
+	const AllocationCounters& oAllocations = oBlock.m_oAllocations;
+	sTooltip += std::format( "\n{} allocations ({} bytes)\n{} frees ({} bytes)\n{} intrusives created", oAllocations.m_uAllocationCount, oAllocations.m_uAllocatedBytes, oAllocations.m_uFreeCount, oAllocations.m_uFreedBytes, oAllocations.m_uIntrusiveCount );
+#endif
+
+	return sTooltip;
+}
+
 Profiler* g_pProfiler = nullptr;
 
 Profiler::Profiler()
 	: m_aFrames( FRAME_HISTORY_COUNT )
 	, m_uCurrentFrameIndex( 0 )
-	, m_uBlocksDepth( 0 )
-	, m_uAsyncBlocksDepth( 0 )
-	, m_uAsyncBlocksCount( 0 )
 	, m_uGPUBlocksDepth( 0 )
 	, m_bDisplayProfiler( false )
 	, m_bPauseProfiler( false )
+	, m_bAuditSteadyState( false )
+	, m_fFrameBudgetMs( 0.f )
+	, m_aSpikes( PROFILER_SPIKE_COUNT )
+	, m_uSpikeCount( 0 )
+	, m_uNextSpikeIndex( 0 )
+	, m_uSpikeFramesAfterLeft( 0 )
+	, m_uSpikeCooldown( 0 )
+	, m_iDisplayedSpike( -1 )
+	, m_eCaptureState( CaptureState::NONE )
+	, m_oCaptureOrigin( std::chrono::high_resolution_clock::now() )
+	, m_uCaptureFramesLeft( 0 )
+	, m_uSpikeFramesBefore( 0 )
+	, m_fSpikeThresholdMs( 0.f )
+	, m_uGeneration( ++s_uProfilerGeneration )
 {
 	glCreateQueries( GL_TIMESTAMP, GPU_QUERY_COUNT, m_aGPUQueries );
 	m_aAvailableGPUQueries.Resize( GPU_QUERY_COUNT );
@@ -182,89 +485,96 @@ Profiler::Profiler()
 		m_aAvailableGPUQueries[ u ] = m_aGPUQueries[ u ];
 
 	g_pProfiler = this;
+
+	ProfilerClock::Calibrate();
+
+	SetThreadName( "Main thread" );
 }
 
 Profiler::~Profiler()
 {
+	if( m_eCaptureState == CaptureState::RECORDING )
+		EndCapture();
+
+	if( m_oStatistics.GetBlockStatistics().Empty() == false )
+		WriteStatisticsReports();
+
 	glDeleteQueries( GPU_QUERY_COUNT, m_aGPUQueries );
 
 	g_pProfiler = nullptr;
+
+	// Threads still registered in this profiler notice it has been destroyed, and no longer use their record
+	std::unique_lock oLock( s_oProfilerThreadsMutex );
+	++s_uProfilerGeneration;
+
+	for( ProfilerThread* pThread : m_aThreads )
+		delete pThread;
 }
 
 void Profiler::NewFrame()
 {
-	std::unique_lock oLock( m_oFrameMutex );
+	Frame& oPreviousFrame = m_aFrames[ m_uCurrentFrameIndex ];
+	oPreviousFrame.m_oFrameEnd = g_pGameEngine->GetGameContext().m_oFrameStart;
 
-	for( int i = m_aPendingFrames.Count() - 1; i >= 0; --i )
-	{
-		Frame* pFrame = m_aPendingFrames[ i ];
+	ProfilerClock::Calibrate();
+	CollectThreads( oPreviousFrame );
+	m_oStatistics.EndFrame();
 
+	// Oldest first, so that the frames around a spike or a capture are ready when it is handled
+	m_oPendingFrames.PopReady( [ this ]( Frame* pFrame ) {
 		if( pFrame->m_aGPUBlocks.Empty() )
-		{
-			pFrame->m_bReady = true;
-			m_aPendingFrames.Remove( i );
-			continue;
-		}
+			return true;
 
 		GLint iResultAvailable;
 		glGetQueryObjectiv( pFrame->m_aGPUBlocks.Front().m_uEndID, GL_QUERY_RESULT_AVAILABLE, &iResultAvailable );
-		if( iResultAvailable == GL_TRUE )
-		{
-			for( GPUBlock& oBlock : pFrame->m_aGPUBlocks )
-			{
-				GLuint64 uStart;
-				glGetQueryObjectui64v( oBlock.m_uStartID, GL_QUERY_RESULT, &uStart );
+		if( iResultAvailable != GL_TRUE )
+			return false;
 
-				GLuint64 uEnd;
-				glGetQueryObjectui64v( oBlock.m_uEndID, GL_QUERY_RESULT, &uEnd );
+		for( GPUBlock& oBlock : pFrame->m_aGPUBlocks )
+		{
+			GLuint64 uStart;
+			glGetQueryObjectui64v( oBlock.m_uStartID, GL_QUERY_RESULT, &uStart );
 
-				oBlock.m_oStart = std::chrono::high_resolution_clock::time_point( std::chrono::nanoseconds( uStart ) );
-				oBlock.m_oEnd = std::chrono::high_resolution_clock::time_point( std::chrono::nanoseconds( uEnd ) );
+			GLuint64 uEnd;
+			glGetQueryObjectui64v( oBlock.m_uEndID, GL_QUERY_RESULT, &uEnd );
 
-				m_aAvailableGPUQueries.PushBack( oBlock.m_uStartID );
-				m_aAvailableGPUQueries.PushBack( oBlock.m_uEndID );
-			}
+			oBlock.m_oStart = std::chrono::high_resolution_clock::time_point( std::chrono::nanoseconds( uStart ) );
+			oBlock.m_oEnd = std::chrono::high_resolution_clock::time_point( std::chrono::nanoseconds( uEnd ) );
 
-			pFrame->m_bReady = true;
-			m_aPendingFrames.Remove( i );
+			m_aAvailableGPUQueries.PushBack( oBlock.m_uStartID );
+			m_aAvailableGPUQueries.PushBack( oBlock.m_uEndID );
 		}
-	}
 
- 	Frame& oPreviousFrame = m_aFrames[ m_uCurrentFrameIndex ];
+		return true;
+	}, [ this ]( Frame* pFrame ) {
+		pFrame->m_bReady = true;
+		OnFrameReady( ( uint )( pFrame - m_aFrames.Data() ) );
+	} );
 
 	if( m_bPauseProfiler == false)
  		m_uCurrentFrameIndex = ( m_uCurrentFrameIndex + 1 ) % FRAME_HISTORY_COUNT;
 	
  	Frame& oCurrentFrame = m_aFrames[ m_uCurrentFrameIndex ];
 
-	oCurrentFrame.m_aBlocks.Clear();
-	oCurrentFrame.m_aAsyncBlocks.Clear();
+	for( ThreadLane& oLane : oCurrentFrame.m_aThreadLanes )
+		oLane.m_aBlocks.Clear();
 	oCurrentFrame.m_aGPUBlocks.Clear();
 	oCurrentFrame.m_bReady = false;
-	m_aPendingFrames.PushBack( &oCurrentFrame );
-
-	oCurrentFrame.m_oFrameStart = g_pGameEngine->GetGameContext().m_oFrameStart;
-	oPreviousFrame.m_oFrameEnd = oCurrentFrame.m_oFrameStart;
+	m_oPendingFrames.Push( &oCurrentFrame );
 
-	int uAsyncBlocksInFlight = 0;
+	oCurrentFrame.m_oFrameStart = oPreviousFrame.m_oFrameEnd;
 
-	for( uint u = 0; u < oPreviousFrame.m_aAsyncBlocks.Count(); ++u )
-	{
-		if( oPreviousFrame.m_aAsyncBlocks[ u ].IsFinished() == false )
-		{
-			if( uAsyncBlocksInFlight == 0 )
-				uAsyncBlocksInFlight = u;
+	const AllocationCounters oFrameStartAllocations = AllocationAudit::GetThreadCounters();
+	oPreviousFrame.m_oAllocations = oFrameStartAllocations - m_oFrameStartAllocations;
+	m_oFrameStartAllocations = oFrameStartAllocations;
 
-			oCurrentFrame.m_aAsyncBlocks.PushBack( oPreviousFrame.m_aAsyncBlocks[ u ] );
-			oCurrentFrame.m_aAsyncBlocks.Back().m_oStart = oCurrentFrame.m_oFrameStart;
-			oPreviousFrame.m_aAsyncBlocks[ u ].m_oEnd = oCurrentFrame.m_oFrameStart;
-		}
-	}
+	AllocationAudit::SetSteadyState( m_bAuditSteadyState );
 }
 
 void Profiler::Display()
 {
-	ProfilerBlock oBlock( "Profiler" );
+	PROFILE_SCOPE( "Profiler" );
+	AllocationAuditIgnore oAllocationAuditIgnore;
 
 	if( g_pInputHandler->IsInputActionTriggered( InputActionID::ACTION_TOGGLE_PROFILER ) )
 		m_bDisplayProfiler = !m_bDisplayProfiler;
@@ -280,6 +590,125 @@ void Profiler::Display()
 		ImGui::Checkbox( "Pause on long frame", &bPauseOnLongFrame );
 		ImGui::InputInt( "Long frame (ms)", &iLongFrameMs );
 
+#ifdef AUDIT_ALLOCATIONS
+		ImGui::Checkbox( "Log steady state allocations", &m_bAuditSteadyState );
+#endif
+
+		if( ImGui::CollapsingHeader( "Statistics" ) )
+		{
+			int iWindowFrameCount = ( int )m_oStatistics.GetWindowFrameCount();
+			if( ImGui::InputInt( "Window (frames, 0 for session)", &iWindowFrameCount ) )
+				m_oStatistics.SetWindowFrameCount( ( uint )glm::max( iWindowFrameCount, 0 ) );
+
+			if( ImGui::Button( "Write reports" ) )
+				WriteStatisticsReports();
+
+			const Array< ProfilerBlockStatistics >& aBlockStatistics = m_oStatistics.GetBlockStatistics();
+
+			Array< const ProfilerBlockStatistics* > aSortedBlockStatistics;
+			aSortedBlockStatistics.Reserve( aBlockStatistics.Count() );
+			for( const ProfilerBlockStatistics& oBlockStatistics : aBlockStatistics )
+				aSortedBlockStatistics.PushBack( &oBlockStatistics );
+
+#ifdef AUDIT_ALLOCATIONS
+			// Sorting by heap traffic puts allocation hot spots at the top, next to their timings
+			static int iSortKey = 0;
+			ImGui::Combo( "Sort by", &iSortKey, "Total time\0Allocations\0Allocated bytes\0" );
+
+			const uint uColumnCount = 11;
+#else
+			const int iSortKey = 0;
+			const uint uColumnCount = 8;
+#endif
+
+			std::sort( aSortedBlockStatistics.begin(), aSortedBlockStatistics.end(), [ this, iSortBy = iSortKey ]( const ProfilerBlockStatistics* pA, const ProfilerBlockStatistics* pB ) {
+				if( iSortBy == 1 )
+					return m_oStatistics.GetWindowAllocations( *pA ).m_uAllocationCount > m_oStatistics.GetWindowAllocations( *pB ).m_uAllocationCount;
+				if( iSortBy == 2 )
+					return m_oStatistics.GetWindowAllocations( *pA ).m_uAllocatedBytes > m_oStatistics.GetWindowAllocations( *pB ).m_uAllocatedBytes;
+
+				return m_oStatistics.GetWindowHistogram( *pA ).m_uTotalNs > m_oStatistics.GetWindowHistogram( *pB ).m_uTotalNs;
+			} );
+
+			if( ImGui::BeginTable( "StatisticsTable", uColumnCount, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY, ImVec2( 0.f, 300.f ) ) )
+			{
+				ImGui::TableSetupScrollFreeze( 0, 1 );
+				ImGui::TableSetupColumn( "Block" );
+				ImGui::TableSetupColumn( "Count" );
+				ImGui::TableSetupColumn( "Total (ms)" );
+				ImGui::TableSetupColumn( "Mean (ms)" );
+				ImGui::TableSetupColumn( "p50 (ms)" );
+				ImGui::TableSetupColumn( "p95 (ms)" );
+				ImGui::TableSetupColumn( "p99 (ms)" );
+				ImGui::TableSetupColumn( "Max (ms)" );
+#ifdef AUDIT_ALLOCATIONS
+				ImGui::TableSetupColumn( "Allocations" );
+				ImGui::TableSetupColumn( "Allocated (B)" );
+				ImGui::TableSetupColumn( "Freed (B)" );
+#endif
+				ImGui::TableHeadersRow();
+
+				for( const ProfilerBlockStatistics* pBlockStatistics : aSortedBlockStatistics )
+				{
+					const ProfilerHistogram& oHistogram = m_oStatistics.GetWindowHistogram( *pBlockStatistics );
+					if( oHistogram.m_uCount == 0 )
+						continue;
+
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex( 0 );
+					ImGui::TextUnformatted( pBlockStatistics->m_sName.c_str() );
+					ImGui::TableSetColumnIndex( 1 );
+					ImGui::Text( "%llu", oHistogram.m_uCount );
+					ImGui::TableSetColumnIndex( 2 );
+					ImGui::Text( "%.3f", oHistogram.m_uTotalNs / 1000000.0 );
+					ImGui::TableSetColumnIndex( 3 );
+					ImGui::Text( "%.4f", oHistogram.GetMean() / 1000000.0 );
+					ImGui::TableSetColumnIndex( 4 );
+					ImGui::Text( "%.4f", oHistogram.GetPercentile( 0.5f ) / 1000000.0 );
+					ImGui::TableSetColumnIndex( 5 );
+					ImGui::Text( "%.4f", oHistogram.GetPercentile( 0.95f ) / 1000000.0 );
+					ImGui::TableSetColumnIndex( 6 );
+					ImGui::Text( "%.4f", oHistogram.GetPercentile( 0.99f ) / 1000000.0 );
+					ImGui::TableSetColumnIndex( 7 );
+					ImGui::Text( "%.4f", oHistogram.m_uMaxNs / 1000000.0 );
+#ifdef AUDIT_ALLOCATIONS
+					const ProfilerBlockAllocations& oAllocations = m_oStatistics.GetWindowAllocations( *pBlockStatistics );
+					ImGui::TableSetColumnIndex( 8 );
+					ImGui::Text( "%llu", oAllocations.m_uAllocationCount );
+					ImGui::TableSetColumnIndex( 9 );
+					ImGui::Text( "%llu", oAllocations.m_uAllocatedBytes );
+					ImGui::TableSetColumnIndex( 10 );
+					ImGui::Text( "%llu", oAllocations.m_uFreedBytes );
+#endif
+				}
+				ImGui::EndTable();
+			}
+		}
+
+		if( ImGui::CollapsingHeader( "Capture" ) )
+		{
+			const std::filesystem::path oCaptureFilePath = std::filesystem::path( "Captures" ) / std::format( "capture_{}.json", g_pGameEngine->GetGameContext().m_uFrameIndex );
+
+			static int iCaptureFrameCount = 300;
+			ImGui::InputInt( "Captured frames", &iCaptureFrameCount );
+			if( ImGui::Button( "Capture frames" ) && IsCapturing() == false )
+				CaptureFrames( ( uint )glm::max( iCaptureFrameCount, 1 ), oCaptureFilePath );
+
+			static float fSpikeThresholdMs = 33.f;
+			static int iFramesBeforeSpike = 30;
+			static int iFramesAfterSpike = 10;
+			ImGui::InputFloat( "Spike (ms)", &fSpikeThresholdMs );
+			ImGui::InputInt( "Frames before spike", &iFramesBeforeSpike );
+			ImGui::InputInt( "Frames after spike", &iFramesAfterSpike );
+			if( ImGui::Button( "Capture next spike" ) && IsCapturing() == false )
+				CaptureNextSpike( fSpikeThresholdMs, ( uint )glm::max( iFramesBeforeSpike, 0 ), ( uint )glm::max( iFramesAfterSpike, 0 ), oCaptureFilePath );
+
+			if( m_eCaptureState == CaptureState::WAITING_FOR_SPIKE )
+				ImGui::Text( "Waiting for a spike..." );
+			else if( m_eCaptureState == CaptureState::RECORDING )
+				ImGui::Text( "Capturing, %u frames left...", m_uCaptureFramesLeft );
+		}
+
 		int iCurrentFrameIndex = ( int )m_uCurrentFrameIndex - 1;
 		if( iCurrentFrameIndex < 0 )
 			iCurrentFrameIndex += FRAME_HISTORY_COUNT;
@@ -322,8 +751,69 @@ void Profiler::Display()
 
 		ImGui::PlotHistogram( "Frame history", aFrameLengths, IM_ARRAYSIZE( aFrameLengths ), 0, NULL, fHistogramMin, fHistogramMax, ImVec2( 0, 80.0f ) );
 
+		// Counters are plotted over the same frames as the frame history, to be compared with it
+		if( m_aCounterNames.Empty() == false && ImGui::CollapsingHeader( "Counters" ) )
+		{
+			float aCounterValues[ FRAME_HISTORY_COUNT - 1 ];
+			for( uint uCounter = 0; uCounter < m_aCounterNames.Count(); ++uCounter )
+			{
+				float fMinValue = FLT_MAX;
+				float fMaxValue = -FLT_MAX;
+				for( uint u = 0; u < FRAME_HISTORY_COUNT - 1; ++u )
+				{
+					int iFrameIndex = ( int )m_uCurrentFrameIndex - ( int )( u + 1 );
+					if( iFrameIndex < 0 )
+						iFrameIndex += FRAME_HISTORY_COUNT;
+
+					const Array< double >& aCounters = m_aFrames[ iFrameIndex ].m_aCounters;
+					const float fValue = uCounter < aCounters.Count() ? ( float )aCounters[ uCounter ] : 0.f;
+
+					fMinValue = glm::min( fMinValue, fValue );
+					fMaxValue = glm::max( fMaxValue, fValue );
+
+					aCounterValues[ FRAME_HISTORY_COUNT - 2 - u ] = fValue;
+				}
+
+				if( fMaxValue == fMinValue )
+					fMaxValue = fMinValue + 1.f;
+
+				const std::string sOverlay = std::format( "{}", m_aCounterValues[ uCounter ] );
+				ImGui::PlotLines( m_aCounterNames[ uCounter ], aCounterValues, IM_ARRAYSIZE( aCounterValues ), 0, sOverlay.c_str(), fMinValue, fMaxValue, ImVec2( 0, 40.0f ) );
+			}
+		}
+
+		if( ImGui::CollapsingHeader( "Budgets" ) )
+		{
+			ImGui::InputFloat( "Frame (ms)", &m_fFrameBudgetMs );
+			for( ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+				ImGui::InputFloat( std::format( "{} (ms)", oBudget.m_sName ).c_str(), &oBudget.m_fBudgetMs );
+
+			if( ImGui::Selectable( "Frame history", m_iDisplayedSpike < 0 ) )
+				m_iDisplayedSpike = -1;
+
+			// Latest spikes first
+			for( uint u = 1; u <= m_uSpikeCount; ++u )
+			{
+				const int iSpike = ( int )( ( m_uNextSpikeIndex + PROFILER_SPIKE_COUNT - u ) % PROFILER_SPIKE_COUNT );
+				ImGui::PushID( iSpike );
+				if( ImGui::Selectable( m_aSpikes[ iSpike ].m_sSummary.c_str(), m_iDisplayedSpike == iSpike ) )
+					m_iDisplayedSpike = iSpike;
+				ImGui::PopID();
+			}
+		}
+
+		const ProfilerSpike* pDisplayedSpike = m_iDisplayedSpike >= 0 ? &m_aSpikes[ m_iDisplayedSpike ] : nullptr;
+
+		static int iSpikeSlider = 0;
 		static int iSlider = 0;
-		if( m_bPauseProfiler == false )
+		if( pDisplayedSpike != nullptr )
+		{
+			const int iFirstFrame = -( int )pDisplayedSpike->m_uSpikeFrame;
+			const int iLastFrame = ( int )pDisplayedSpike->m_aFrames.Count() - 1 + iFirstFrame;
+			iSpikeSlider = glm::clamp( iSpikeSlider, iFirstFrame, iLastFrame );
+			ImGui::SliderInt( "Spike frame", &iSpikeSlider, iFirstFrame, iLastFrame );
+		}
+		else if( m_bPauseProfiler == false )
 		{
 			iSlider = 0;
 
@@ -339,7 +829,9 @@ void Profiler::Display()
 			while( m_aFrames[ GetSliderFrameIndex( iSlider ) ].m_bReady == false )
 				--iSlider;
 		}
-		ImGui::SliderInt( "Frame index", &iSlider, -( int )FRAME_HISTORY_COUNT + 2, 0 );
+
+		if( pDisplayedSpike == nullptr )
+			ImGui::SliderInt( "Frame index", &iSlider, -( int )FRAME_HISTORY_COUNT + 2, 0 );
 
 		static float fZoom = 1.f;
 		ImGui::SliderFloat( "Zoom", &fZoom, 0.1f, 10.f, "%.1f" );
@@ -358,58 +850,60 @@ void Profiler::Display()
 		if( iDisplayedFrameIndex < 0 )
 			iDisplayedFrameIndex += FRAME_HISTORY_COUNT;
 
-		Frame& oDisplayedFrame = m_aFrames[ iDisplayedFrameIndex ];
+		const Frame& oDisplayedFrame = pDisplayedSpike != nullptr ? pDisplayedSpike->m_aFrames[ pDisplayedSpike->m_uSpikeFrame + iSpikeSlider ] : m_aFrames[ iDisplayedFrameIndex ];
 
-		ImGui::Text( "\n Main thread" );
+		// The block over budget is highlighted in every frame of the spike, a whole frame over budget has none
+		const char* sHighlightedBlock = pDisplayedSpike != nullptr ? pDisplayedSpike->m_sBlockName : nullptr;
 
 		float fMaxX = 0.f;
 		float fMaxY = 0.f;
-		for( const Block& oBlock : oDisplayedFrame.m_aBlocks )
+		for( uint uLane = 0; uLane < oDisplayedFrame.m_aThreadLanes.Count(); ++uLane )
 		{
-			const uint64 uStartMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oStart - oDisplayedFrame.m_oFrameStart ).count();
-			const float fStartMilliSeconds = uStartMicroSeconds / 1000.f;
-
-			const uint64 uEndMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oEnd - oDisplayedFrame.m_oFrameStart ).count();
-			const float fEndMilliSeconds = uEndMicroSeconds / 1000.f;
+			const ThreadLane& oLane = oDisplayedFrame.m_aThreadLanes[ uLane ];
+			const char* sThreadName = oLane.m_sThreadName != nullptr ? oLane.m_sThreadName : "Unnamed thread";
 
-			const float fStart = fStartMilliSeconds * fReferenceWidth;
-			const float fEnd = fEndMilliSeconds * fReferenceWidth;
-
-			const ImVec2 vCursorPos = DrawBlock( oBlock.m_sName, std::format( "{} ({:.3f} ms)", oBlock.m_sName, fEndMilliSeconds - fStartMilliSeconds ).c_str(), fStart, fEnd, oBlock.m_uDepth );
-
-			if( fMaxX < vCursorPos.x )
-				fMaxX = vCursorPos.x;
-			if( fMaxY < vCursorPos.y )
-				fMaxY = vCursorPos.y;
-		}
+#ifdef AUDIT_ALLOCATIONS
+			if( uLane == 0 )
+			{
+				const AllocationCounters& oFrameAllocations = oDisplayedFrame.m_oAllocations;
+				ImGui::Text( "\n %s (%llu allocations, %llu bytes, %llu frees, %llu intrusives)", sThreadName, oFrameAllocations.m_uAllocationCount, oFrameAllocations.m_uAllocatedBytes, oFrameAllocations.m_uFreeCount, oFrameAllocations.m_uIntrusiveCount );
+			}
+			else
+#endif
+			if( oLane.m_uDroppedBlocks != 0 )
+				ImGui::Text( "\n %s (%u blocks dropped)", sThreadName, oLane.m_uDroppedBlocks );
+			else
+				ImGui::Text( "\n %s", sThreadName );
 
-		ImGui::SetCursorScreenPos( ImVec2( ImGui::GetCursorScreenPos().x, fMaxY ) );
-		ImGui::Separator();
+			if( fMaxY < ImGui::GetCursorScreenPos().y )
+				fMaxY = ImGui::GetCursorScreenPos().y;
 
-		ImGui::Text( "\n IO thread" );
+			for( const Block& oBlock : oLane.m_aBlocks )
+			{
+				const uint64 uStartMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oStart - oDisplayedFrame.m_oFrameStart ).count();
+				const float fStartMilliSeconds = uStartMicroSeconds / 1000.f;
 
-		for( const Block& oBlock : oDisplayedFrame.m_aAsyncBlocks )
-		{
-			const uint64 uStartMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oStart - oDisplayedFrame.m_oFrameStart ).count();
-			const float fStartMilliSeconds = uStartMicroSeconds / 1000.f;
+				const uint64 uEndMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oEnd - oDisplayedFrame.m_oFrameStart ).count();
+				const float fEndMilliSeconds = uEndMicroSeconds / 1000.f;
 
-			const uint64 uEndMicroSeconds = std::chrono::duration_cast< std::chrono::microseconds >( oBlock.m_oEnd - oDisplayedFrame.m_oFrameStart ).count();
-			const float fEndMilliSeconds = uEndMicroSeconds / 1000.f;
+				const float fStart = fStartMilliSeconds * fReferenceWidth;
+				const float fEnd = fEndMilliSeconds * fReferenceWidth;
 
-			const float fStart = fStartMilliSeconds * fReferenceWidth;
-			const float fEnd = fEndMilliSeconds * fReferenceWidth;
+				const bool bHighlighted = uLane == 0 && sHighlightedBlock != nullptr && strcmp( oBlock.m_pDescriptor->m_sName, sHighlightedBlock ) == 0;
+				const ImVec2 vCursorPos = DrawBlock( *oBlock.m_pDescriptor, BlockTooltip( oBlock, fEndMilliSeconds - fStartMilliSeconds ).c_str(), fStart, fEnd, oBlock.m_uDepth, bHighlighted );
 
-			const ImVec2 vCursorPos = DrawBlock( oBlock.m_sName, std::format( "{} ({:.3f} ms)", oBlock.m_sName, fEndMilliSeconds - fStartMilliSeconds ).c_str(), fStart, fEnd, oBlock.m_uDepth );
+				if( fMaxX < vCursorPos.x )
+					fMaxX = vCursorPos.x;
+				if( fMaxY < vCursorPos.y )
+					fMaxY = vCursorPos.y;
+			}
 
-			if( fMaxX < vCursorPos.x )
-				fMaxX = vCursorPos.x;
-			if( fMaxY < vCursorPos.y )
-				fMaxY = vCursorPos.y;
+			ImGui::SetCursorScreenPos( ImVec2( ImGui::GetCursorScreenPos().x, fMaxY ) );
+			ImGui::Separator();
 		}
 
 		if( oDisplayedFrame.m_bReady )
 		{
-			ImGui::Separator();
 			ImGui::Text( "\n GPU (not synced with CPU)" );
 
 			uint64 uDeltaMicroSeconds = 0;
@@ -427,7 +921,7 @@ void Profiler::Display()
 				const float fStart = fStartMilliSeconds * fReferenceWidth;
 				const float fEnd = fEndMilliSeconds * fReferenceWidth;
 
-				const ImVec2 vCursorPos = DrawBlock( oBlock.m_sName, std::format( "{} ({:.3f} ms)", oBlock.m_sName, fEndMilliSeconds - fStartMilliSeconds ).c_str(), fStart, fEnd, oBlock.m_uDepth );
+				const ImVec2 vCursorPos = DrawBlock( *oBlock.m_pDescriptor, std::format( "{} ({:.3f} ms)", oBlock.m_pDescriptor->m_sName, fEndMilliSeconds - fStartMilliSeconds ).c_str(), fStart, fEnd, oBlock.m_uDepth );
 
 				if( fMaxX < vCursorPos.x )
 					fMaxX = vCursorPos.x;
@@ -447,18 +941,35 @@ void Profiler::Display()
 	}
 }
 
-uint Profiler::StartBlock( const char* sName )
+void Profiler::SetThreadName( const char* sName )
 {
-	const uint uID = m_aFrames[ m_uCurrentFrameIndex ].m_aBlocks.Count();
-	m_aFrames[ m_uCurrentFrameIndex ].m_aBlocks.PushBack( Block( sName, m_uBlocksDepth ) );
-	++m_uBlocksDepth;
-	return uID;
+	const char* sPreviousName = nullptr;
+	GetThread().m_sName.compare_exchange_strong( sPreviousName, sName, std::memory_order_relaxed );
+}
+
+void Profiler::StartBlock( const ProfilerBlockDescriptor& oDescriptor )
+{
+	GetThread().Begin( oDescriptor );
+	AllocationAudit::PushScope( oDescriptor.m_sName );
 }
 
-void Profiler::EndBlock( const uint uBlockID )
+void Profiler::StartBlock( const char* sName )
 {
-	m_aFrames[ m_uCurrentFrameIndex ].m_aBlocks[ uBlockID ].m_oEnd = std::chrono::high_resolution_clock::now();
-	--m_uBlocksDepth;
+	StartBlock( GetDescriptor( sName ) );
+}
+
+void Profiler::EndBlock()
+{
+	AllocationAudit::PopScope();
+
+	// A thread not registered in this profiler has no block to end
+	if( s_oProfilerThreadRegistration.m_pThread != nullptr && s_oProfilerThreadRegistration.m_uGeneration == m_uGeneration )
+		s_oProfilerThreadRegistration.m_pThread->End();
+}
+
+void Profiler::SetCounter( const char* sName, const double fValue )
+{
+	GetThread().SetCounter( sName, fValue );
 }
 
 uint Profiler::StartGPUBlock( const char* sName )
@@ -476,7 +987,7 @@ uint Profiler::StartGPUBlock( const char* sName )
 	glQueryCounter( uStartID, GL_TIMESTAMP );
 
 	const uint uID = m_aFrames[ m_uCurrentFrameIndex ].m_aGPUBlocks.Count();
-	m_aFrames[ m_uCurrentFrameIndex ].m_aGPUBlocks.PushBack( GPUBlock( uStartID, sName, m_uGPUBlocksDepth ) );
+	m_aFrames[ m_uCurrentFrameIndex ].m_aGPUBlocks.PushBack( GPUBlock( uStartID, &GetDescriptor( sName ), m_uGPUBlocksDepth ) );
 	++m_uGPUBlocksDepth;
 	return uID;
 }
@@ -499,31 +1010,356 @@ void Profiler::EndGPUBlock( const uint uBlockID )
 	--m_uGPUBlocksDepth;
 }
 
-uint Profiler::StartAsyncBlock( const char* sName )
+void Profiler::SetFrameBudget( const float fBudgetMs )
 {
-	std::unique_lock oLock( m_oFrameMutex );
+	m_fFrameBudgetMs = fBudgetMs;
+}
 
-	const uint uID = m_uAsyncBlocksCount;
-	m_aFrames[ m_uCurrentFrameIndex ].m_aAsyncBlocks.PushBack( AsyncBlock( uID, sName, m_uAsyncBlocksDepth ) );
-	++m_uAsyncBlocksDepth;
-	++m_uAsyncBlocksCount;
-	return uID;
+void Profiler::SetBlockBudget( const char* sName, const float fBudgetMs )
+{
+	for( ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+	{
+		if( strcmp( oBudget.m_sName, sName ) == 0 )
+		{
+			oBudget.m_fBudgetMs = fBudgetMs;
+			return;
+		}
+	}
+
+	m_aBlockBudgets.PushBack( ProfilerBlockBudget{ sName, fBudgetMs, 0.f } );
 }
 
-void Profiler::EndAsyncBlock( const uint uBlockID )
+void Profiler::CaptureFrames( const uint uFrameCount, const std::filesystem::path& oFilePath )
 {
-	std::unique_lock oLock( m_oFrameMutex );
+	StartCapture( CaptureState::RECORDING, oFilePath );
+	m_uCaptureFramesLeft = uFrameCount;
+}
+
+void Profiler::CaptureNextSpike( const float fThresholdMs, const uint uFramesBefore, const uint uFramesAfter, const std::filesystem::path& oFilePath )
+{
+	StartCapture( CaptureState::WAITING_FOR_SPIKE, oFilePath );
+	m_fSpikeThresholdMs = fThresholdMs;
+	m_uSpikeFramesBefore = glm::min( uFramesBefore, FRAME_HISTORY_COUNT - 2 );
+	m_uCaptureFramesLeft = uFramesAfter;
+}
+
+bool Profiler::IsCapturing() const
+{
+	return m_eCaptureState != CaptureState::NONE;
+}
+
+ProfilerThread& Profiler::GetThread()
+{
+	ProfilerThreadRegistration& oRegistration = s_oProfilerThreadRegistration;
+	if( oRegistration.m_pThread == nullptr || oRegistration.m_uGeneration != m_uGeneration )
+	{
+		std::unique_lock oLock( s_oProfilerThreadsMutex );
+
+		// Lanes of exited threads are reused
+		uint uIndex = 0;
+		while( uIndex < m_aThreads.Count() && m_aThreads[ uIndex ] != nullptr )
+			++uIndex;
+
+		if( uIndex == m_aThreads.Count() )
+			m_aThreads.PushBack( nullptr );
+
+		m_aThreads[ uIndex ] = new ProfilerThread( uIndex );
+
+		oRegistration.m_pThread = m_aThreads[ uIndex ];
+		oRegistration.m_uGeneration = m_uGeneration;
+	}
+
+	return *oRegistration.m_pThread;
+}
+
+const ProfilerBlockDescriptor& Profiler::GetDescriptor( const char* sName )
+{
+	// The lock is only taken the first time a thread uses a name, a name sharing the hash of another one is looked up again
+	std::unordered_map< size_t, const ProfilerBlockDescriptor* >& mThreadDescriptors = GetThread().m_mDescriptors;
+	const size_t uHash = std::hash< std::string_view >()( sName );
+
+	auto itThread = mThreadDescriptors.find( uHash );
+	if( itThread != mThreadDescriptors.end() && strcmp( itThread->second->m_sName, sName ) == 0 )
+		return *itThread->second;
+
+	std::unique_lock oLock( m_oDescriptorsMutex );
 
-	for( AsyncBlock& oBlock : m_aFrames[ m_uCurrentFrameIndex ].m_aAsyncBlocks )
+	// Nodes of an unordered_map never move, events can point to them and descriptors are named by their key
+	auto it = m_mDescriptors.find( sName );
+	if( it == m_mDescriptors.end() )
 	{
-		if( oBlock.m_uID == uBlockID )
+		it = m_mDescriptors.try_emplace( sName, "", nullptr, 0 ).first;
+		it->second = ProfilerBlockDescriptor( it->first.c_str(), nullptr, 0 );
+	}
+
+	mThreadDescriptors[ uHash ] = &it->second;
+	return it->second;
+}
+
+uint Profiler::GetCounterIndex( const char* sName )
+{
+	auto it = m_mCounterIndices.find( sName );
+	if( it != m_mCounterIndices.end() )
+		return it->second;
+
+	// The same name may come from several string literals
+	uint uIndex = 0;
+	while( uIndex < m_aCounterNames.Count() && strcmp( m_aCounterNames[ uIndex ], sName ) != 0 )
+		++uIndex;
+
+	if( uIndex == m_aCounterNames.Count() )
+	{
+		m_aCounterNames.PushBack( sName );
+		m_aCounterValues.PushBack( 0.0 );
+	}
+
+	m_mCounterIndices.emplace( sName, uIndex );
+	return uIndex;
+}
+
+void Profiler::CollectThreads( Frame& oFrame )
+{
+	std::unique_lock oLock( s_oProfilerThreadsMutex );
+
+	if( oFrame.m_aThreadLanes.Count() < m_aThreads.Count() )
+		oFrame.m_aThreadLanes.Resize( m_aThreads.Count() );
+
+	for( ProfilerThread*& pThread : m_aThreads )
+	{
+		if( pThread == nullptr )
+			continue;
+
+		// Read before collecting, the events written before the thread exited are collected with the others
+		const bool bExited = pThread->m_bExited.load( std::memory_order_acquire );
+		pThread->Collect( oFrame.m_oFrameStart, oFrame.m_oFrameEnd, oFrame.m_aThreadLanes[ pThread->m_uIndex ], m_oStatistics, m_aCounterSamples );
+
+		if( bExited )
 		{
-			oBlock.m_oEnd = std::chrono::high_resolution_clock::now();
+			delete pThread;
+			pThread = nullptr;
+		}
+	}
+
+	// Threads are collected one after the other, a counter set by several threads keeps the value of the last collected one
+	for( const ProfilerCounterSample& oSample : m_aCounterSamples )
+		m_aCounterValues[ GetCounterIndex( oSample.m_sName ) ] = oSample.m_fValue;
+	m_aCounterSamples.Clear();
+
+	oFrame.m_aCounters.Resize( m_aCounterValues.Count() );
+	for( uint u = 0; u < m_aCounterValues.Count(); ++u )
+		oFrame.m_aCounters[ u ] = m_aCounterValues[ u ];
+}
+
+void Profiler::CheckBudgets( const uint uFrameIndex )
+{
+	const Frame& oFrame = m_aFrames[ uFrameIndex ];
+
+	if( m_uSpikeFramesAfterLeft != 0 )
+	{
+		m_aSpikes[ ( m_uNextSpikeIndex + PROFILER_SPIKE_COUNT - 1 ) % PROFILER_SPIKE_COUNT ].m_aFrames.PushBack( oFrame );
+		--m_uSpikeFramesAfterLeft;
+	}
+
+	// Long hitches such as loading a scene would otherwise report every frame
+	if( m_uSpikeCooldown != 0 )
+	{
+		--m_uSpikeCooldown;
+		return;
+	}
+
+	for( ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+		oBudget.m_fDurationMs = 0.f;
+
+	if( oFrame.m_aThreadLanes.Empty() == false && m_aBlockBudgets.Empty() == false )
+	{
+		for( const Block& oBlock : oFrame.m_aThreadLanes[ 0 ].m_aBlocks )
+		{
+			for( ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+			{
+				if( oBlock.m_pDescriptor->m_sName == oBudget.m_sName || strcmp( oBlock.m_pDescriptor->m_sName, oBudget.m_sName ) == 0 )
+					oBudget.m_fDurationMs += std::chrono::duration< float, std::milli >( oBlock.m_oEnd - oBlock.m_oStart ).count();
+			}
+		}
+	}
+
+	// The block the most over its budget is blamed, the frame itself only when no block is over budget
+	const float fFrameLength = GetFrameLength( oFrame );
+	const ProfilerBlockBudget* pWorstBudget = nullptr;
+	for( const ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+	{
+		if( oBudget.m_fBudgetMs <= 0.f || oBudget.m_fDurationMs <= oBudget.m_fBudgetMs )
+			continue;
+
+		if( pWorstBudget == nullptr || oBudget.m_fDurationMs / oBudget.m_fBudgetMs > pWorstBudget->m_fDurationMs / pWorstBudget->m_fBudgetMs )
+			pWorstBudget = &oBudget;
+	}
+
+	if( pWorstBudget == nullptr && ( m_fFrameBudgetMs <= 0.f || fFrameLength <= m_fFrameBudgetMs ) )
+		return;
+
+	ProfilerSpike& oSpike = m_aSpikes[ m_uNextSpikeIndex ];
+	m_uNextSpikeIndex = ( m_uNextSpikeIndex + 1 ) % PROFILER_SPIKE_COUNT;
+	m_uSpikeCount = glm::min( m_uSpikeCount + 1, PROFILER_SPIKE_COUNT );
+
+	oSpike.m_aFrames.Clear();
+	for( uint u = PROFILER_SPIKE_FRAMES_BEFORE; u > 0; --u )
+	{
+		const Frame& oPreviousFrame = m_aFrames[ ( uFrameIndex + FRAME_HISTORY_COUNT - u ) % FRAME_HISTORY_COUNT ];
+		if( oPreviousFrame.m_bReady && oPreviousFrame.m_oFrameEnd <= oFrame.m_oFrameStart )
+			oSpike.m_aFrames.PushBack( oPreviousFrame );
+	}
+
+	oSpike.m_uSpikeFrame = oSpike.m_aFrames.Count();
+	oSpike.m_aFrames.PushBack( oFrame );
+
+	oSpike.m_uFrameIndex = g_pGameEngine->GetGameContext().m_uFrameIndex;
+	oSpike.m_sBlockName = pWorstBudget != nullptr ? pWorstBudget->m_sName : nullptr;
+	oSpike.m_fDurationMs = pWorstBudget != nullptr ? pWorstBudget->m_fDurationMs : fFrameLength;
+	oSpike.m_fBudgetMs = pWorstBudget != nullptr ? pWorstBudget->m_fBudgetMs : m_fFrameBudgetMs;
+
+	oSpike.m_sSummary = std::format( "Frame {} over budget, {} {:.2f} / {:.2f} ms", oSpike.m_uFrameIndex, oSpike.m_sBlockName != nullptr ? oSpike.m_sBlockName : "frame", oSpike.m_fDurationMs, oSpike.m_fBudgetMs );
+	if( oSpike.m_sBlockName != nullptr )
+		oSpike.m_sSummary += std::format( " (frame {:.2f} ms)", fFrameLength );
+
+	std::string sBudgets;
+	for( const ProfilerBlockBudget& oBudget : m_aBlockBudgets )
+		sBudgets += std::format( " | {} {:.2f} ms", oBudget.m_sName, oBudget.m_fDurationMs );
+
+	LOG_WARN( "{}{}", oSpike.m_sSummary, sBudgets );
+
+	m_uSpikeFramesAfterLeft = PROFILER_SPIKE_FRAMES_AFTER;
+	m_uSpikeCooldown = PROFILER_SPIKE_COOLDOWN;
+}
+
+void Profiler::StartCapture( const CaptureState eState, const std::filesystem::path& oFilePath )
+{
+	m_eCaptureState = eState;
+	m_oCaptureFilePath = oFilePath;
+	m_oCapture.Clear();
+	m_aCaptureThreadNames.Clear();
+}
+
+void Profiler::OnFrameReady( const uint uFrameIndex )
+{
+	// A paused profiler keeps recording the same frame, it would be captured again and again
+	if( m_bPauseProfiler )
+		return;
+
+	CheckBudgets( uFrameIndex );
+
+	const Frame& oFrame = m_aFrames[ uFrameIndex ];
+
+	switch( m_eCaptureState )
+	{
+	case CaptureState::NONE:
+		return;
+	case CaptureState::WAITING_FOR_SPIKE:
+		if( GetFrameLength( oFrame ) < m_fSpikeThresholdMs )
+			return;
+
+		for( uint u = m_uSpikeFramesBefore; u > 0; --u )
+		{
+			const Frame& oPreviousFrame = m_aFrames[ ( uFrameIndex + FRAME_HISTORY_COUNT - u ) % FRAME_HISTORY_COUNT ];
+			if( oPreviousFrame.m_bReady )
+				CaptureFrame( oPreviousFrame );
+		}
+
+		CaptureFrame( oFrame );
+		m_eCaptureState = CaptureState::RECORDING;
+		break;
+	case CaptureState::RECORDING:
+		// A capture of 0 frames ends without recording any
+		if( m_uCaptureFramesLeft == 0 )
 			break;
+
+		CaptureFrame( oFrame );
+		--m_uCaptureFramesLeft;
+		break;
+	}
+
+	if( m_uCaptureFramesLeft == 0 )
+		EndCapture();
+}
+
+void Profiler::CaptureFrame( const Frame& oFrame )
+{
+	auto GetTimestamp = [ this ]( const GameTimePoint& oTime ) {
+		return std::chrono::duration< double, std::micro >( oTime - m_oCaptureOrigin ).count();
+	};
+
+	if( m_aCaptureThreadNames.Count() < oFrame.m_aThreadLanes.Count() )
+		m_aCaptureThreadNames.Resize( oFrame.m_aThreadLanes.Count(), nullptr );
+
+	for( uint uLane = 0; uLane < oFrame.m_aThreadLanes.Count(); ++uLane )
+	{
+		const ThreadLane& oLane = oFrame.m_aThreadLanes[ uLane ];
+		if( oLane.m_sThreadName != nullptr )
+			m_aCaptureThreadNames[ uLane ] = oLane.m_sThreadName;
+
+		for( const Block& oBlock : oLane.m_aBlocks )
+		{
+			const double fStart = GetTimestamp( oBlock.m_oStart );
+			const double fDuration = std::chrono::duration< double, std::micro >( oBlock.m_oEnd - oBlock.m_oStart ).count();
+#ifdef AUDIT_ALLOCATIONS
+			m_oCapture.AddBlock( oBlock.m_pDescriptor->m_sName, 1, uLane, fStart, fDuration, oBlock.m_oAllocations );
+#else
+			m_oCapture.AddBlock( oBlock.m_pDescriptor->m_sName, 1, uLane, fStart, fDuration );
+#endif
+		}
+	}
+
+	// GPU timestamps use another clock, they are aligned on the start of the frame like in the profiler window
+	if( oFrame.m_aGPUBlocks.Empty() == false )
+	{
+		const GameTimePoint& oGPUStart = oFrame.m_aGPUBlocks.Front().m_oStart;
+		const double fFrameStart = GetTimestamp( oFrame.m_oFrameStart );
+
+		for( const GPUBlock& oBlock : oFrame.m_aGPUBlocks )
+		{
+			const double fStart = fFrameStart + std::chrono::duration< double, std::micro >( oBlock.m_oStart - oGPUStart ).count();
+			const double fDuration = std::chrono::duration< double, std::micro >( oBlock.m_oEnd - oBlock.m_oStart ).count();
+			m_oCapture.AddBlock( oBlock.m_pDescriptor->m_sName, 2, 0, fStart, fDuration );
 		}
 	}
 
-	--m_uAsyncBlocksDepth;
+	const double fFrameStart = GetTimestamp( oFrame.m_oFrameStart );
+	m_oCapture.AddCounter( "Frame time", 1, fFrameStart, { { "ms", GetFrameLength( oFrame ) } } );
+	for( uint uCounter = 0; uCounter < oFrame.m_aCounters.Count(); ++uCounter )
+		m_oCapture.AddCounter( m_aCounterNames[ uCounter ], 1, fFrameStart, { { "value", oFrame.m_aCounters[ uCounter ] } } );
+#ifdef AUDIT_ALLOCATIONS
+	m_oCapture.AddCounter( "Main thread allocations", 1, fFrameStart, { { "count", ( double )oFrame.m_oAllocations.m_uAllocationCount }, { "bytes", ( double )oFrame.m_oAllocations.m_uAllocatedBytes } } );
+#endif
+}
+
+void Profiler::EndCapture()
+{
+	m_oCapture.SetProcessName( 1, "CPU" );
+	m_oCapture.SetProcessName( 2, "GPU (not synced with CPU)" );
+	for( uint uLane = 0; uLane < m_aCaptureThreadNames.Count(); ++uLane )
+		m_oCapture.SetThreadName( 1, uLane, m_aCaptureThreadNames[ uLane ] != nullptr ? m_aCaptureThreadNames[ uLane ] : "Unnamed thread" );
+
+	const std::string sCapture = m_oCapture.GetJSON();
+
+	if( m_oCaptureFilePath.has_parent_path() )
+		std::filesystem::create_directories( m_oCaptureFilePath.parent_path() );
+
+	if( WriteTextFile( sCapture, m_oCaptureFilePath ) )
+		LOG_INFO( "Profiler capture written to {}", m_oCaptureFilePath.string() );
+
+	m_eCaptureState = CaptureState::NONE;
+	m_oCapture.Clear();
+}
+
+void Profiler::WriteStatisticsReports()
+{
+	const std::string sFileName = std::format( "statistics_{:%Y%m%d_%H%M%S}", std::chrono::floor< std::chrono::seconds >( std::chrono::system_clock::now() ) );
+	const std::filesystem::path oDirectory( "Captures" );
+	std::filesystem::create_directories( oDirectory );
+
+	if( WriteTextFile( m_oStatistics.GetReport( ProfilerStatistics::ReportFormat::TEXT ), oDirectory / ( sFileName + ".txt" ) ) )
+		LOG_INFO( "Profiler statistics written to {}", ( oDirectory / ( sFileName + ".txt" ) ).string() );
+
+	WriteTextFile( m_oStatistics.GetReport( ProfilerStatistics::ReportFormat::CSV ), oDirectory / ( sFileName + ".csv" ) );
 }
 
 void Profiler::DrawGrid( const float fReferenceWidth )
@@ -549,7 +1385,7 @@ void Profiler::DrawGrid( const float fReferenceWidth )
 	ImGui::GetWindowDrawList()->AddLine( ImVec2( fHorizontal30Limit, vCursorPos.y ), ImVec2( fHorizontal30Limit, vCursorPos.y + oSize.y ), ImColor( 0.8f, 0.f, 0.f, 1.f ) );
 }
 
-ImVec2 Profiler::DrawBlock( const char* sName, const char* sTooltip, const float fStart, const float fEnd, const int iDepth )
+ImVec2 Profiler::DrawBlock( const ProfilerBlockDescriptor& oDescriptor, const char* sTooltip, const float fStart, const float fEnd, const int iDepth, const bool bHighlighted /*= false*/ )
 {
 	const float fWidth = glm::floor( fEnd ) - glm::floor( fStart );
 	const float fHeight = 20.f;
@@ -557,15 +1393,17 @@ ImVec2 Profiler::DrawBlock( const char* sName, const char* sTooltip, const float
 	const ImVec2 vCursorPos = ImGui::GetCursorScreenPos();
 	const ImVec2 vFrom( glm::floor( fStart ) + vCursorPos.x, iDepth * fHeight + vCursorPos.y );
 	const ImVec2 vTo( fWidth + vFrom.x, fHeight + vFrom.y );
-	const ImVec2 vTextSize = ImGui::CalcTextSize( sName );
+	const ImVec2 vTextSize = ImGui::CalcTextSize( oDescriptor.m_sName );
 	const ImVec2 vTextPos( vFrom.x + ( fWidth - vTextSize.x ) / 2.f, vFrom.y + ( fHeight - vTextSize.y ) / 2.f );
 
-	const uint uColorIndex = GenerateColorIndex( sName );
+	const uint uColorIndex = oDescriptor.m_uColorIndex;
 
 	ImGui::PushClipRect( vFrom, vTo, true );
 	ImGui::GetWindowDrawList()->AddRectFilled( vFrom, vTo, BACKGROUND_COLORS[ uColorIndex ] );
-	ImGui::GetWindowDrawList()->AddText( vTextPos, TEXT_COLORS[ uColorIndex ], sName );
+	ImGui::GetWindowDrawList()->AddText( vTextPos, TEXT_COLORS[ uColorIndex ], oDescriptor.m_sName );
 	ImGui::GetWindowDrawList()->AddRect( vFrom, vTo, BORDER_COLORS[ uColorIndex ] );
+	if( bHighlighted )
+		ImGui::GetWindowDrawList()->AddRect( vFrom, vTo, ImColor( 255, 255, 255 ), 0.f, 0, 3.f );
 	ImGui::PopClipRect();
 
 	if( ImGui::IsMouseHoveringRect( vFrom, vTo ) )
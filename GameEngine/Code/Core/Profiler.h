@@ -1,23 +1,71 @@
 #pragma once
 
+#include <atomic>
+#include <filesystem>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 
+#include "AllocationAudit.h"
 #include "Array.h"
+#include "ProfilerFrameQueue.h"
+#include "ProfilerStatistics.h"
+#include "ProfilerTrace.h"
+#include "Time.h"
 #include "ImGui/imgui.h"
 
 inline constexpr uint GPU_QUERY_COUNT = 1024;
+inline constexpr uint PROFILER_THREAD_EVENT_COUNT = 1 << 14;
+inline constexpr uint PROFILER_SPIKE_COUNT = 8;
+inline constexpr uint PROFILER_SPIKE_FRAMES_BEFORE = 5;
+inline constexpr uint PROFILER_SPIKE_FRAMES_AFTER = 2;
+inline constexpr uint PROFILER_SPIKE_COOLDOWN = 60;
 
 struct Frame;
+struct ProfilerBlockBudget;
+struct ProfilerCounterSample;
+struct ProfilerSpike;
+struct ProfilerThread;
 
+inline constexpr uint PROFILER_COLOR_COUNT = 64;
+
+constexpr uint GetProfilerColorIndex( const char* sName )
+{
+	uint uHash = 0;
+	while( *sName )
+	{
+		uHash = ( uHash * 31 ) ^ uint( *sName );
+		++sName;
+	}
+
+	return uHash % PROFILER_COLOR_COUNT;
+}
+
+// Everything known about a block before it runs, PROFILE_SCOPE builds one per call site at compile time
+// Blocks named at runtime get a descriptor the first time their name is seen by a thread
+struct ProfilerBlockDescriptor
+{
+	constexpr ProfilerBlockDescriptor( const char* sName, const char* sFile, const uint uLine )
+		: m_sName( sName )
+		, m_sFile( sFile )
+		, m_uLine( uLine )
+		, m_uColorIndex( GetProfilerColorIndex( sName ) )
+	{
+	}
+
+	const char*	m_sName;
+	const char*	m_sFile;
+	uint		m_uLine;
+	uint		m_uColorIndex;
+};
+
+// Can be used from any thread, each thread gets its own lane in the profiler
 class ProfilerBlock
 {
 public:
-	explicit ProfilerBlock( const char* sName, const bool bAsync = false );
+	explicit ProfilerBlock( const ProfilerBlockDescriptor& oDescriptor );
+	explicit ProfilerBlock( const char* sName );
 	~ProfilerBlock();
-
-private:
-	uint m_uBlockID;
-	bool m_bAsync;
 };
 
 class GPUProfilerBlock
@@ -40,36 +88,161 @@ public:
 
 	void	NewFrame();
 	void	Display();
-			
-	uint	StartBlock( const char* sName );
-	void	EndBlock( const uint uBlockID );
+
+	// Names the lane of the calling thread, a thread keeps the first name it is given and the name must outlive the profiler
+	void	SetThreadName( const char* sName );
+
+	void	StartBlock( const ProfilerBlockDescriptor& oDescriptor );
+	void	StartBlock( const char* sName );
+	void	EndBlock();
+
+	// Use PROFILE_COUNTER, the name must outlive the profiler
+	void	SetCounter( const char* sName, const double fValue );
 
 	uint	StartGPUBlock( const char* sName );
 	void	EndGPUBlock( const uint uBlockID );
 
-	uint	StartAsyncBlock( const char* sName );
-	void	EndAsyncBlock( const uint uBlockID );
+	// Frames and main thread blocks running over their budget are saved with the frames around them, the block is highlighted when displaying them, and logged
+	// A budget of 0 disables it, a block budget applies to the total time spent in blocks of that name during the frame and the name must outlive the profiler
+	void	SetFrameBudget( const float fBudgetMs );
+	void	SetBlockBudget( const char* sName, const float fBudgetMs );
+
+	// Captures are written as Chrome trace event files, which chrome://tracing and Perfetto can open
+	// Frames are captured once their GPU blocks are available, so the file is written a few frames after the last captured one
+	void	CaptureFrames( const uint uFrameCount, const std::filesystem::path& oFilePath );
+	void	CaptureNextSpike( const float fThresholdMs, const uint uFramesBefore, const uint uFramesAfter, const std::filesystem::path& oFilePath );
+	bool	IsCapturing() const;
 
 private:
+	enum class CaptureState : uint8
+	{
+		NONE,
+		WAITING_FOR_SPIKE,
+		RECORDING
+	};
+
+	ProfilerThread&	GetThread();
+	// Descriptors of blocks named at runtime are kept until the profiler is destroyed, their names are copied so that a reused buffer never names another block
+	// Each thread caches the descriptors it uses, the profiler lock is only taken for names new to the thread
+	const ProfilerBlockDescriptor&	GetDescriptor( const char* sName );
+	uint			GetCounterIndex( const char* sName );
+	void			CollectThreads( Frame& oFrame );
+	void			CheckBudgets( const uint uFrameIndex );
+
+	void			StartCapture( const CaptureState eState, const std::filesystem::path& oFilePath );
+	void			OnFrameReady( const uint uFrameIndex );
+	void			CaptureFrame( const Frame& oFrame );
+	void			EndCapture();
+
+	// Written at shutdown too, to compare sessions
+	void			WriteStatisticsReports();
+
 	void	DrawGrid( const float fReferenceWidth );
-	ImVec2	DrawBlock( const char* sName, const char* sTooltip, const float fStart, const float fEnd, const int iDepth );
+	ImVec2	DrawBlock( const ProfilerBlockDescriptor& oDescriptor, const char* sTooltip, const float fStart, const float fEnd, const int iDepth, const bool bHighlighted = false );
 
 	Array< Frame >				m_aFrames;
-	Array< Frame* >				m_aPendingFrames;
+	ProfilerFrameQueue< Frame >	m_oPendingFrames;
 	uint						m_uCurrentFrameIndex;
 
-	uint						m_uBlocksDepth;
-	uint						m_uAsyncBlocksDepth;
-	uint						m_uAsyncBlocksCount;
 	uint						m_uGPUBlocksDepth;
 
 	bool						m_bDisplayProfiler;
 	bool						m_bPauseProfiler;
+	bool						m_bAuditSteadyState;
+
+	AllocationCounters			m_oFrameStartAllocations;
+
+	// Slots of exited threads are null until another thread takes them, guarded by a mutex outliving the profiler
+	Array< ProfilerThread* >	m_aThreads;
 
-	std::mutex					m_oFrameMutex;
+	std::mutex													m_oDescriptorsMutex;
+	std::unordered_map< std::string, ProfilerBlockDescriptor >	m_mDescriptors;
+
+	ProfilerStatistics			m_oStatistics;
+
+	Array< const char* >						m_aCounterNames;
+	std::unordered_map< const char*, uint >		m_mCounterIndices;
+	Array< double >								m_aCounterValues;
+	Array< ProfilerCounterSample >				m_aCounterSamples;
+
+	float							m_fFrameBudgetMs;
+	Array< ProfilerBlockBudget >	m_aBlockBudgets;
+	Array< ProfilerSpike >			m_aSpikes;
+	uint							m_uSpikeCount;
+	uint							m_uNextSpikeIndex;
+	uint							m_uSpikeFramesAfterLeft;
+	uint							m_uSpikeCooldown;
+	int								m_iDisplayedSpike;
+
+	CaptureState				m_eCaptureState;
+	std::filesystem::path		m_oCaptureFilePath;
+	ProfilerTrace				m_oCapture;
+	Array< const char* >		m_aCaptureThreadNames;
+	GameTimePoint				m_oCaptureOrigin;
+	uint						m_uCaptureFramesLeft;
+	uint						m_uSpikeFramesBefore;
+	float						m_fSpikeThresholdMs;
 
 	uint						m_aGPUQueries[ GPU_QUERY_COUNT ];
 	Array< uint >				m_aAvailableGPUQueries;
+
+	// Tells apart the thread records of this profiler from those of a destroyed one
+	uint						m_uGeneration;
 };
 
-extern Profiler* g_pProfiler;
\ No newline at end of file
+extern Profiler* g_pProfiler;
+
+#define PROFILER_CONCATENATE_IMPL( a, b ) a##b
+#define PROFILER_CONCATENATE( a, b ) PROFILER_CONCATENATE_IMPL( a, b )
+
+#define PROFILER_SCOPE_IMPL( sName ) \
+	static constexpr ProfilerBlockDescriptor PROFILER_CONCATENATE( s_oProfilerBlockDescriptor, __LINE__ )( sName, __FILE__, __LINE__ ); \
+	ProfilerBlock PROFILER_CONCATENATE( oProfilerBlock, __LINE__ )( PROFILER_CONCATENATE( s_oProfilerBlockDescriptor, __LINE__ ) )
+
+// PROFILER_LEVEL selects the instrumentation compiled in, scopes above it cost nothing
+// 1 : PROFILE_SCOPE, engine systems run once or a few times per frame
+// 2 : PROFILE_SCOPE_DETAILED, work done per resource, per component type...
+// 3 : PROFILE_SCOPE_FINE, bodies of hot loops
+// Set by every configuration of the projects, builds which do not set it keep the engine systems only
+#ifndef PROFILER_LEVEL
+#define PROFILER_LEVEL 1
+#endif
+
+#if PROFILER_LEVEL >= 1
+#define PROFILE_SCOPE( sName ) PROFILER_SCOPE_IMPL( sName )
+#else
+#define PROFILE_SCOPE( sName ) ( void )( sName )
+#endif
+
+#if PROFILER_LEVEL >= 2
+#define PROFILE_SCOPE_DETAILED( sName ) PROFILER_SCOPE_IMPL( sName )
+#else
+#define PROFILE_SCOPE_DETAILED( sName ) ( void )( sName )
+#endif
+
+#if PROFILER_LEVEL >= 3
+#define PROFILE_SCOPE_FINE( sName ) PROFILER_SCOPE_IMPL( sName )
+#else
+#define PROFILE_SCOPE_FINE( sName ) ( void )( sName )
+#endif
+
+// Scope whose name is only known at runtime, like the kind of resource being loaded
+#if PROFILER_LEVEL >= 1
+#define PROFILE_SCOPE_NAMED( sName ) ProfilerBlock PROFILER_CONCATENATE( oProfilerBlock, __LINE__ )( sName )
+#else
+#define PROFILE_SCOPE_NAMED( sName ) ( void )( sName )
+#endif
+
+#if PROFILER_LEVEL >= 1
+#define PROFILE_THREAD_NAME( sName ) g_pProfiler->SetThreadName( sName )
+#else
+#define PROFILE_THREAD_NAME( sName ) ( void )( sName )
+#endif
+
+// Numeric value sampled per frame from any thread, plotted in the profiler and written in captures
+// A counter keeps its value in the following frames until it is set again
+#if PROFILER_LEVEL >= 1
+#define PROFILE_COUNTER( sName, value ) g_pProfiler->SetCounter( sName, ( double )( value ) )
+#else
+#define PROFILE_COUNTER( sName, value ) ( void )( sName ), ( void )sizeof( value )
+#endif
\ No newline at end of file
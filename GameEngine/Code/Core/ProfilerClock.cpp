@@ -0,0 +1,69 @@
+#include "ProfilerClock.h"
+
+#if defined( PROFILER_CLOCK_TSC ) && !defined( _MSC_VER )
+#include <cpuid.h>
+#endif
+
+const bool ProfilerClock::s_bInvariantTSC = ProfilerClock::IsInvariantTSCAvailable();
+
+uint64 ProfilerClock::s_uFirstTicks = ProfilerClock::GetTicks();
+GameTimePoint ProfilerClock::s_oFirstTime = std::chrono::high_resolution_clock::now();
+uint64 ProfilerClock::s_uReferenceTicks = ProfilerClock::s_uFirstTicks;
+GameTimePoint ProfilerClock::s_oReferenceTime = ProfilerClock::s_oFirstTime;
+double ProfilerClock::s_fNanoSecondsPerTick = 1.0;
+
+void ProfilerClock::Calibrate()
+{
+	// The chrono clock is read between two reads of the ticks, both samples are taken as close as possible
+	const uint64 uTicksBefore = GetTicks();
+	const GameTimePoint oTime = std::chrono::high_resolution_clock::now();
+	const uint64 uTicksAfter = GetTicks();
+	const uint64 uTicks = uTicksBefore + ( uTicksAfter - uTicksBefore ) / 2;
+
+	// Measured over the whole run rather than since the previous call, the error of each sample weighs less and less
+	const int64 iElapsedNanoSeconds = std::chrono::duration_cast< std::chrono::nanoseconds >( oTime - s_oFirstTime ).count();
+	if( uTicks > s_uFirstTicks && iElapsedNanoSeconds > 0 )
+		s_fNanoSecondsPerTick = ( double )iElapsedNanoSeconds / ( double )( uTicks - s_uFirstTicks );
+
+	s_uReferenceTicks = uTicks;
+	s_oReferenceTime = oTime;
+}
+
+GameTimePoint ProfilerClock::ToTimePoint( const uint64 uTicks )
+{
+	// Ticks read before the reference give a negative delta
+	const double fDeltaNanoSeconds = ( double )( int64 )( uTicks - s_uReferenceTicks ) * s_fNanoSecondsPerTick;
+	return s_oReferenceTime + std::chrono::duration_cast< GameTimePoint::duration >( std::chrono::duration< double, std::nano >( fDeltaNanoSeconds ) );
+}
+
+double ProfilerClock::GetNanoSecondsPerTick()
+{
+	return s_fNanoSecondsPerTick;
+}
+
+bool ProfilerClock::UsesInvariantTSC()
+{
+	return s_bInvariantTSC;
+}
+
+bool ProfilerClock::IsInvariantTSCAvailable()
+{
+#ifdef PROFILER_CLOCK_TSC
+	// CPUID 0x80000007, bit 8 of EDX : the TSC runs at a constant rate in every power state and is synchronized between cores
+	uint aRegisters[ 4 ] = { 0, 0, 0, 0 };
+#ifdef _MSC_VER
+	__cpuid( ( int* )aRegisters, 0x80000000 );
+	if( aRegisters[ 0 ] < 0x80000007 )
+		return false;
+
+	__cpuid( ( int* )aRegisters, 0x80000007 );
+#else
+	if( __get_cpuid( 0x80000007, &aRegisters[ 0 ], &aRegisters[ 1 ], &aRegisters[ 2 ], &aRegisters[ 3 ] ) == 0 )
+		return false;
+#endif
+
+	return ( aRegisters[ 3 ] & ( 1u << 8 ) ) != 0;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Time.h"
+#include "Types.h"
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#elif defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define PROFILER_CLOCK_TSC
+#endif
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+// Timestamps of the profiler events, read from the invariant TSC when the CPU has one, which is far cheaper than std::chrono clocks
+// Without it, CLOCK_MONOTONIC_RAW is used on POSIX systems and std::chrono::high_resolution_clock elsewhere
+// Ticks are turned into GameTimePoint with a frequency calibrated against std::chrono::high_resolution_clock, Calibrate() and ToTimePoint() are for the main thread only
+class ProfilerClock
+{
+public:
+	static uint64			GetTicks()
+	{
+#ifdef PROFILER_CLOCK_TSC
+		if( s_bInvariantTSC )
+			return __rdtsc();
+#endif
+
+#ifndef _WIN32
+		timespec oTime;
+		clock_gettime( CLOCK_MONOTONIC_RAW, &oTime );
+		return ( uint64 )oTime.tv_sec * 1000000000ull + ( uint64 )oTime.tv_nsec;
+#else
+		return ( uint64 )std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::high_resolution_clock::now().time_since_epoch() ).count();
+#endif
+	}
+
+	// Refines the frequency from the ticks elapsed since the process started, the longer it runs the more precise it gets, and resets the reference used to convert ticks
+	// Never waits, the first calls give a rougher frequency which each later call replaces
+	static void				Calibrate();
+
+	static GameTimePoint	ToTimePoint( const uint64 uTicks );
+	static double			GetNanoSecondsPerTick();
+	static bool				UsesInvariantTSC();
+
+private:
+	static bool				IsInvariantTSCAvailable();
+
+	static const bool		s_bInvariantTSC;
+
+	static uint64			s_uFirstTicks;
+	static GameTimePoint	s_oFirstTime;
+	static uint64			s_uReferenceTicks;
+	static GameTimePoint	s_oReferenceTime;
+	static double			s_fNanoSecondsPerTick;
+};
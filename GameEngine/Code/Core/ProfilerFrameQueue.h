@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Array.h"
+
+// Frames recorded but waiting for their GPU timings, in the order they were recorded
+// Frames are handed over oldest first and a frame still waiting holds back the newer ones, so that a frame is never ready before the frames preceding it
+template < typename T >
+class ProfilerFrameQueue
+{
+public:
+	void Push( T* pFrame )
+	{
+		m_aFrames.PushBack( pFrame );
+	}
+
+	// oIsReady( T* ) resolves the frame if it can, oOnReady( T* ) is then called for it
+	template < typename IsReadyFunction, typename OnReadyFunction >
+	void PopReady( IsReadyFunction&& oIsReady, OnReadyFunction&& oOnReady )
+	{
+		uint uReadyCount = 0;
+		while( uReadyCount < m_aFrames.Count() && oIsReady( m_aFrames[ uReadyCount ] ) )
+			oOnReady( m_aFrames[ uReadyCount++ ] );
+
+		if( uReadyCount == 0 )
+			return;
+
+		for( uint u = uReadyCount; u < m_aFrames.Count(); ++u )
+			m_aFrames[ u - uReadyCount ] = m_aFrames[ u ];
+
+		m_aFrames.Resize( m_aFrames.Count() - uReadyCount );
+	}
+
+	uint GetPendingCount() const
+	{
+		return m_aFrames.Count();
+	}
+
+private:
+	Array< T* > m_aFrames;
+};
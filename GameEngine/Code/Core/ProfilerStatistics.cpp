@@ -0,0 +1,249 @@
+#include "ProfilerStatistics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+
+static uint GetBucketIndex( const uint64 uDurationNs )
+{
+	if( uDurationNs < 8 )
+		return ( uint )uDurationNs;
+
+	// Exponent gives the power of two, the 3 bits following the leading one give the bucket within it
+	const uint uExponent = ( uint )std::bit_width( uDurationNs ) - 1;
+	const uint uIndex = ( uExponent - 2 ) * 8 + ( uint )( ( uDurationNs >> ( uExponent - 3 ) ) & 7 );
+
+	return std::min( uIndex, PROFILER_HISTOGRAM_BUCKET_COUNT - 1 );
+}
+
+static uint64 GetBucketValue( const uint uIndex )
+{
+	if( uIndex < 8 )
+		return uIndex;
+
+	const uint uExponent = uIndex / 8 + 2;
+	const uint64 uBucketStart = ( uint64 )( 8 + uIndex % 8 ) << ( uExponent - 3 );
+	const uint64 uBucketWidth = 1ull << ( uExponent - 3 );
+
+	return uBucketStart + uBucketWidth / 2;
+}
+
+static double ToMilliSeconds( const uint64 uDurationNs )
+{
+	return uDurationNs / 1000000.0;
+}
+
+ProfilerHistogram::ProfilerHistogram()
+{
+	Clear();
+}
+
+void ProfilerHistogram::Add( const uint64 uDurationNs )
+{
+	++m_uCount;
+	m_uTotalNs += uDurationNs;
+	m_uMaxNs = std::max( m_uMaxNs, uDurationNs );
+	++m_aBuckets[ GetBucketIndex( uDurationNs ) ];
+}
+
+void ProfilerHistogram::Clear()
+{
+	m_uCount = 0;
+	m_uTotalNs = 0;
+	m_uMaxNs = 0;
+	memset( m_aBuckets, 0, sizeof( m_aBuckets ) );
+}
+
+uint64 ProfilerHistogram::GetMean() const
+{
+	return m_uCount != 0 ? m_uTotalNs / m_uCount : 0;
+}
+
+uint64 ProfilerHistogram::GetPercentile( const float fPercentile ) const
+{
+	if( m_uCount == 0 )
+		return 0;
+
+	const uint64 uRank = std::max( ( uint64 )1, ( uint64 )( m_uCount * ( double )fPercentile + 0.5 ) );
+	if( uRank >= m_uCount )
+		return m_uMaxNs;
+
+	uint64 uCumulatedCount = 0;
+	for( uint u = 0; u < PROFILER_HISTOGRAM_BUCKET_COUNT; ++u )
+	{
+		uCumulatedCount += m_aBuckets[ u ];
+		if( uCumulatedCount >= uRank )
+			return std::min( GetBucketValue( u ), m_uMaxNs );
+	}
+
+	return m_uMaxNs;
+}
+
+ProfilerBlockAllocations::ProfilerBlockAllocations()
+	: ProfilerBlockAllocations( 0, 0, 0 )
+{
+}
+
+ProfilerBlockAllocations::ProfilerBlockAllocations( const uint64 uAllocationCount, const uint64 uAllocatedBytes, const uint64 uFreedBytes )
+	: m_uAllocationCount( uAllocationCount )
+	, m_uAllocatedBytes( uAllocatedBytes )
+	, m_uFreedBytes( uFreedBytes )
+{
+}
+
+ProfilerBlockAllocations& ProfilerBlockAllocations::operator+=( const ProfilerBlockAllocations& oOther )
+{
+	m_uAllocationCount += oOther.m_uAllocationCount;
+	m_uAllocatedBytes += oOther.m_uAllocatedBytes;
+	m_uFreedBytes += oOther.m_uFreedBytes;
+
+	return *this;
+}
+
+ProfilerStatistics::ProfilerStatistics()
+	: m_uSessionFrameCount( 0 )
+	, m_uWindowFrameCount( 600 )
+	, m_uWindowFrameIndex( 0 )
+	, m_bWindowCompleted( false )
+{
+}
+
+void ProfilerStatistics::AddBlock( const char* sName, const uint64 uDurationNs, const ProfilerBlockAllocations& oAllocations /*= ProfilerBlockAllocations()*/ )
+{
+	// The same name may come from several string literals, blocks are first looked up by pointer and only then by name
+	auto it = m_mIndicesByPointer.find( sName );
+	if( it == m_mIndicesByPointer.end() )
+	{
+		auto itName = m_mIndicesByName.find( sName );
+		if( itName == m_mIndicesByName.end() )
+		{
+			itName = m_mIndicesByName.emplace( sName, m_aBlockStatistics.Count() ).first;
+
+			m_aBlockStatistics.PushBack( ProfilerBlockStatistics() );
+			m_aBlockStatistics.Back().m_sName = sName;
+		}
+
+		it = m_mIndicesByPointer.emplace( sName, itName->second ).first;
+	}
+
+	ProfilerBlockStatistics& oBlockStatistics = m_aBlockStatistics[ it->second ];
+	oBlockStatistics.m_oSession.Add( uDurationNs );
+	oBlockStatistics.m_oWindow.Add( uDurationNs );
+	oBlockStatistics.m_oSessionAllocations += oAllocations;
+	oBlockStatistics.m_oWindowAllocations += oAllocations;
+}
+
+void ProfilerStatistics::EndFrame()
+{
+	++m_uSessionFrameCount;
+
+	if( m_uWindowFrameCount == 0 || ++m_uWindowFrameIndex < m_uWindowFrameCount )
+		return;
+
+	for( ProfilerBlockStatistics& oBlockStatistics : m_aBlockStatistics )
+	{
+		oBlockStatistics.m_oLastWindow = oBlockStatistics.m_oWindow;
+		oBlockStatistics.m_oWindow.Clear();
+
+		oBlockStatistics.m_oLastWindowAllocations = oBlockStatistics.m_oWindowAllocations;
+		oBlockStatistics.m_oWindowAllocations = ProfilerBlockAllocations();
+	}
+
+	m_uWindowFrameIndex = 0;
+	m_bWindowCompleted = true;
+}
+
+void ProfilerStatistics::SetWindowFrameCount( const uint uFrameCount )
+{
+	if( uFrameCount == m_uWindowFrameCount )
+		return;
+
+	m_uWindowFrameCount = uFrameCount;
+	m_uWindowFrameIndex = 0;
+	m_bWindowCompleted = false;
+
+	for( ProfilerBlockStatistics& oBlockStatistics : m_aBlockStatistics )
+	{
+		oBlockStatistics.m_oWindow.Clear();
+		oBlockStatistics.m_oLastWindow.Clear();
+		oBlockStatistics.m_oWindowAllocations = ProfilerBlockAllocations();
+		oBlockStatistics.m_oLastWindowAllocations = ProfilerBlockAllocations();
+	}
+}
+
+uint ProfilerStatistics::GetWindowFrameCount() const
+{
+	return m_uWindowFrameCount;
+}
+
+const Array< ProfilerBlockStatistics >& ProfilerStatistics::GetBlockStatistics() const
+{
+	return m_aBlockStatistics;
+}
+
+const ProfilerHistogram& ProfilerStatistics::GetWindowHistogram( const ProfilerBlockStatistics& oBlockStatistics ) const
+{
+	if( m_uWindowFrameCount == 0 )
+		return oBlockStatistics.m_oSession;
+
+	return m_bWindowCompleted ? oBlockStatistics.m_oLastWindow : oBlockStatistics.m_oWindow;
+}
+
+const ProfilerBlockAllocations& ProfilerStatistics::GetWindowAllocations( const ProfilerBlockStatistics& oBlockStatistics ) const
+{
+	if( m_uWindowFrameCount == 0 )
+		return oBlockStatistics.m_oSessionAllocations;
+
+	return m_bWindowCompleted ? oBlockStatistics.m_oLastWindowAllocations : oBlockStatistics.m_oWindowAllocations;
+}
+
+uint64 ProfilerStatistics::GetSessionFrameCount() const
+{
+	return m_uSessionFrameCount;
+}
+
+std::string ProfilerStatistics::GetReport( const ReportFormat eFormat ) const
+{
+	Array< const ProfilerBlockStatistics* > aSortedBlockStatistics;
+	aSortedBlockStatistics.Reserve( m_aBlockStatistics.Count() );
+	for( const ProfilerBlockStatistics& oBlockStatistics : m_aBlockStatistics )
+		aSortedBlockStatistics.PushBack( &oBlockStatistics );
+
+	std::sort( aSortedBlockStatistics.begin(), aSortedBlockStatistics.end(), []( const ProfilerBlockStatistics* pA, const ProfilerBlockStatistics* pB ) {
+		return pA->m_oSession.m_uTotalNs > pB->m_oSession.m_uTotalNs;
+	} );
+
+	const double fFrameCount = ( double )std::max( m_uSessionFrameCount, ( uint64 )1 );
+
+	std::string sReport;
+	if( eFormat == ReportFormat::CSV )
+	{
+		sReport += "name,count,calls_per_frame,total_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,allocations,allocated_bytes,freed_bytes\n";
+
+		for( const ProfilerBlockStatistics* pBlockStatistics : aSortedBlockStatistics )
+		{
+			const ProfilerHistogram& oHistogram = pBlockStatistics->m_oSession;
+			const ProfilerBlockAllocations& oAllocations = pBlockStatistics->m_oSessionAllocations;
+			sReport += std::format( "\"{}\",{},{:.2f},{:.3f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{},{},{}\n", pBlockStatistics->m_sName, oHistogram.m_uCount, oHistogram.m_uCount / fFrameCount, ToMilliSeconds( oHistogram.m_uTotalNs ),
+				ToMilliSeconds( oHistogram.GetMean() ), ToMilliSeconds( oHistogram.GetPercentile( 0.5f ) ), ToMilliSeconds( oHistogram.GetPercentile( 0.95f ) ), ToMilliSeconds( oHistogram.GetPercentile( 0.99f ) ), ToMilliSeconds( oHistogram.m_uMaxNs ),
+				oAllocations.m_uAllocationCount, oAllocations.m_uAllocatedBytes, oAllocations.m_uFreedBytes );
+		}
+	}
+	else
+	{
+		sReport += std::format( "Profiler statistics over {} frames (durations in ms)\n\n", m_uSessionFrameCount );
+		sReport += std::format( "{:<40} {:>10} {:>8} {:>12} {:>9} {:>9} {:>9} {:>9} {:>9} {:>12} {:>14} {:>14}\n", "Block", "Count", "Calls", "Total", "Mean", "p50", "p95", "p99", "Max", "Allocations", "Allocated (B)", "Freed (B)" );
+
+		for( const ProfilerBlockStatistics* pBlockStatistics : aSortedBlockStatistics )
+		{
+			const ProfilerHistogram& oHistogram = pBlockStatistics->m_oSession;
+			const ProfilerBlockAllocations& oAllocations = pBlockStatistics->m_oSessionAllocations;
+			sReport += std::format( "{:<40} {:>10} {:>8.2f} {:>12.3f} {:>9.4f} {:>9.4f} {:>9.4f} {:>9.4f} {:>9.4f} {:>12} {:>14} {:>14}\n", pBlockStatistics->m_sName, oHistogram.m_uCount, oHistogram.m_uCount / fFrameCount, ToMilliSeconds( oHistogram.m_uTotalNs ),
+				ToMilliSeconds( oHistogram.GetMean() ), ToMilliSeconds( oHistogram.GetPercentile( 0.5f ) ), ToMilliSeconds( oHistogram.GetPercentile( 0.95f ) ), ToMilliSeconds( oHistogram.GetPercentile( 0.99f ) ), ToMilliSeconds( oHistogram.m_uMaxNs ),
+				oAllocations.m_uAllocationCount, oAllocations.m_uAllocatedBytes, oAllocations.m_uFreedBytes );
+		}
+	}
+
+	return sReport;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "Array.h"
+
+inline constexpr uint PROFILER_HISTOGRAM_BUCKET_COUNT = 312;
+
+// Durations in nanoseconds are counted in log-linear buckets, 8 buckets per power of two
+// Memory does not depend on the number of samples and percentiles are precise to about 6%, durations over 36 minutes share the last bucket
+struct ProfilerHistogram
+{
+	ProfilerHistogram();
+
+	void	Add( const uint64 uDurationNs );
+	void	Clear();
+
+	uint64	GetMean() const;
+	uint64	GetPercentile( const float fPercentile ) const;
+
+	uint64	m_uCount;
+	uint64	m_uTotalNs;
+	uint64	m_uMaxNs;
+	uint	m_aBuckets[ PROFILER_HISTOGRAM_BUCKET_COUNT ];
+};
+
+// Heap traffic of the blocks, only fed when allocations are audited
+struct ProfilerBlockAllocations
+{
+	ProfilerBlockAllocations();
+	ProfilerBlockAllocations( const uint64 uAllocationCount, const uint64 uAllocatedBytes, const uint64 uFreedBytes );
+
+	ProfilerBlockAllocations& operator+=( const ProfilerBlockAllocations& oOther );
+
+	uint64	m_uAllocationCount;
+	uint64	m_uAllocatedBytes;
+	uint64	m_uFreedBytes;
+};
+
+struct ProfilerBlockStatistics
+{
+	std::string					m_sName;
+	ProfilerHistogram			m_oSession;
+	ProfilerHistogram			m_oWindow;
+	ProfilerHistogram			m_oLastWindow;
+	ProfilerBlockAllocations	m_oSessionAllocations;
+	ProfilerBlockAllocations	m_oWindowAllocations;
+	ProfilerBlockAllocations	m_oLastWindowAllocations;
+};
+
+// Aggregates block durations by name, over the whole session and over a window of frames
+class ProfilerStatistics
+{
+public:
+	enum class ReportFormat : uint8
+	{
+		TEXT,
+		CSV
+	};
+
+	ProfilerStatistics();
+
+	// Names are looked up by pointer first, a pointer must always name the same block : string literals and names interned by the profiler
+	void										AddBlock( const char* sName, const uint64 uDurationNs, const ProfilerBlockAllocations& oAllocations = ProfilerBlockAllocations() );
+	void										EndFrame();
+
+	// A window of 0 frames never ends, it then covers the whole session
+	void										SetWindowFrameCount( const uint uFrameCount );
+	uint										GetWindowFrameCount() const;
+
+	const Array< ProfilerBlockStatistics >&		GetBlockStatistics() const;
+	const ProfilerHistogram&					GetWindowHistogram( const ProfilerBlockStatistics& oBlockStatistics ) const;
+	const ProfilerBlockAllocations&				GetWindowAllocations( const ProfilerBlockStatistics& oBlockStatistics ) const;
+	uint64										GetSessionFrameCount() const;
+
+	// Reports the session statistics, blocks sorted by decreasing total time
+	std::string									GetReport( const ReportFormat eFormat ) const;
+
+private:
+	Array< ProfilerBlockStatistics >			m_aBlockStatistics;
+	std::unordered_map< const char*, uint >		m_mIndicesByPointer;
+	std::unordered_map< std::string, uint >		m_mIndicesByName;
+
+	uint64										m_uSessionFrameCount;
+	uint										m_uWindowFrameCount;
+	uint										m_uWindowFrameIndex;
+	bool										m_bWindowCompleted;
+};
@@ -0,0 +1,112 @@
+#include "ProfilerTrace.h"
+
+#include <cmath>
+#include <format>
+
+void AppendJSONString( std::string& sOutput, const std::string_view sValue )
+{
+	sOutput += '"';
+
+	for( const char cCharacter : sValue )
+	{
+		switch( cCharacter )
+		{
+		case '"':
+			sOutput += "\\\"";
+			break;
+		case '\\':
+			sOutput += "\\\\";
+			break;
+		case '\n':
+			sOutput += "\\n";
+			break;
+		case '\r':
+			sOutput += "\\r";
+			break;
+		case '\t':
+			sOutput += "\\t";
+			break;
+		default:
+			if( ( uint8 )cCharacter < 0x20 )
+				sOutput += std::format( "\\u{:04x}", ( uint )( uint8 )cCharacter );
+			else
+				sOutput += cCharacter;
+			break;
+		}
+	}
+
+	sOutput += '"';
+}
+
+void ProfilerTrace::SetProcessName( const uint uProcess, const char* sName )
+{
+	m_sMetadata += std::format( "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":", uProcess );
+	AppendJSONString( m_sMetadata, sName );
+	m_sMetadata += "}},\n";
+}
+
+void ProfilerTrace::SetThreadName( const uint uProcess, const uint uThread, const char* sName )
+{
+	m_sMetadata += std::format( "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":", uProcess, uThread );
+	AppendJSONString( m_sMetadata, sName );
+	m_sMetadata += "}},\n";
+	m_sMetadata += std::format( "{{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"sort_index\":{}}}}},\n", uProcess, uThread, uThread );
+}
+
+void ProfilerTrace::AddBlock( const char* sName, const uint uProcess, const uint uThread, const double fStart, const double fDuration )
+{
+	m_sEvents += "{\"name\":";
+	AppendJSONString( m_sEvents, sName );
+	m_sEvents += std::format( ",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}},\n", uProcess, uThread, fStart, fDuration );
+}
+
+void ProfilerTrace::AddBlock( const char* sName, const uint uProcess, const uint uThread, const double fStart, const double fDuration, const AllocationCounters& oAllocations )
+{
+	m_sEvents += "{\"name\":";
+	AppendJSONString( m_sEvents, sName );
+	m_sEvents += std::format( ",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"allocations\":{},\"allocated_bytes\":{},\"frees\":{},\"freed_bytes\":{},\"intrusives\":{}}}}},\n", uProcess, uThread, fStart, fDuration,
+		oAllocations.m_uAllocationCount, oAllocations.m_uAllocatedBytes, oAllocations.m_uFreeCount, oAllocations.m_uFreedBytes, oAllocations.m_uIntrusiveCount );
+}
+
+void ProfilerTrace::AddCounter( const char* sName, const uint uProcess, const double fTime, const std::initializer_list< std::pair< const char*, double > > oValues )
+{
+	m_sEvents += "{\"name\":";
+	AppendJSONString( m_sEvents, sName );
+	m_sEvents += std::format( ",\"ph\":\"C\",\"pid\":{},\"ts\":{:.3f},\"args\":{{", uProcess, fTime );
+
+	bool bFirst = true;
+	for( const std::pair< const char*, double >& oValue : oValues )
+	{
+		if( bFirst == false )
+			m_sEvents += ',';
+		bFirst = false;
+
+		// JSON has no infinity nor NaN
+		AppendJSONString( m_sEvents, oValue.first );
+		m_sEvents += std::format( ":{}", std::isfinite( oValue.second ) ? oValue.second : 0.0 );
+	}
+
+	m_sEvents += "}},\n";
+}
+
+std::string ProfilerTrace::GetJSON() const
+{
+	std::string sJSON = "{\"traceEvents\":[\n";
+	sJSON += m_sMetadata;
+	sJSON += m_sEvents;
+
+	// The last event is followed by a comma, JSON does not allow it
+	if( sJSON.back() == '\n' && sJSON[ sJSON.size() - 2 ] == ',' )
+		sJSON.erase( sJSON.size() - 2 );
+
+	sJSON += "\n]}\n";
+	return sJSON;
+}
+
+void ProfilerTrace::Clear()
+{
+	m_sMetadata.clear();
+	m_sMetadata.shrink_to_fit();
+	m_sEvents.clear();
+	m_sEvents.shrink_to_fit();
+}
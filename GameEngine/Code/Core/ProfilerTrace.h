@@ -0,0 +1,32 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "AllocationAudit.h"
+#include "Types.h"
+
+// Appends sValue to sOutput as a quoted JSON string, escaping quotes, backslashes and control characters
+void AppendJSONString( std::string& sOutput, const std::string_view sValue );
+
+// Builds a Chrome trace event file, which chrome://tracing and Perfetto can open
+// Times and durations are in microseconds, names are escaped so that any block, counter or thread name gives valid JSON
+class ProfilerTrace
+{
+public:
+	void		SetProcessName( const uint uProcess, const char* sName );
+	void		SetThreadName( const uint uProcess, const uint uThread, const char* sName );
+
+	void		AddBlock( const char* sName, const uint uProcess, const uint uThread, const double fStart, const double fDuration );
+	void		AddBlock( const char* sName, const uint uProcess, const uint uThread, const double fStart, const double fDuration, const AllocationCounters& oAllocations );
+	void		AddCounter( const char* sName, const uint uProcess, const double fTime, const std::initializer_list< std::pair< const char*, double > > oValues );
+
+	std::string	GetJSON() const;
+	void		Clear();
+
+private:
+	std::string	m_sMetadata;
+	std::string	m_sEvents;
+};
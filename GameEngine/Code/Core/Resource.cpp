@@ -0,0 +1,32 @@
+#include "Resource.h"
+
+// Resources are shared between the main thread and the loading thread
+Resource::Resource()
+	: Intrusive( ReferencePolicy::ATOMIC )
+	, m_eStatus( Status::LOADING )
+{
+}
+
+Resource::~Resource()
+{
+}
+
+Resource::Status Resource::GetStatus() const
+{
+	return m_eStatus;
+}
+
+bool Resource::IsLoading() const
+{
+	return m_eStatus == Status::LOADING;
+}
+
+bool Resource::IsLoaded() const
+{
+	return m_eStatus == Status::LOADED;
+}
+
+bool Resource::IsFailed() const
+{
+	return m_eStatus == Status::FAILED;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Intrusive.h"
+
+class Resource : public Intrusive
+{
+public:
+	friend class ResourceLoader;
+
+	enum class Status
+	{
+		LOADING,
+		LOADED,
+		FAILED
+	};
+
+	Resource();
+	virtual ~Resource();
+
+	virtual void	Destroy() = 0; // TODO #eric this could probably be a destructor ?
+
+	Status			GetStatus() const;
+	bool			IsLoading() const;
+	bool			IsLoaded() const;
+	bool			IsFailed() const;
+
+protected:
+	Status m_eStatus;
+};
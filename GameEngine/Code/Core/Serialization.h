@@ -4,24 +4,13 @@
 #include <nlohmann/json_fwd.hpp>
 
 #include "Core/Array.h"
+#include "Core/GLMSerialization.h"
 
 class Entity;
 class EntityHolder;
 class Spline;
 struct Color;
 
-namespace glm
-{
-	void to_json( nlohmann::json& oJsonContent, const glm::bvec3& vVector );
-	void from_json( const nlohmann::json& oJsonContent, glm::bvec3& vVector );
-
-	void to_json( nlohmann::json& oJsonContent, const glm::vec3& vVector );
-	void from_json( const nlohmann::json& oJsonContent, glm::vec3& vVector );
-
-	void to_json( nlohmann::json& oJsonContent, const glm::quat& vVector );
-	void from_json( const nlohmann::json& oJsonContent, glm::quat& qQuaternion );
-}
-
 void to_json( nlohmann::json& oJsonContent, const Entity& oEntity );
 
 void to_json( nlohmann::json& oJsonContent, const EntityHolder& oEntityHolder );
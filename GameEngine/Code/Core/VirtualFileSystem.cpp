@@ -0,0 +1,171 @@
+#include "VirtualFileSystem.h"
+
+#include <utility>
+
+#include "Logger.h"
+
+VirtualFile::VirtualFile()
+	: m_bOpen( false )
+{
+}
+
+VirtualFile::VirtualFile( VirtualFile&& oVirtualFile ) noexcept
+	: VirtualFile()
+{
+	*this = std::move( oVirtualFile );
+}
+
+VirtualFile& VirtualFile::operator=( VirtualFile&& oVirtualFile ) noexcept
+{
+	if( &oVirtualFile == this )
+		return *this;
+
+	// Mappings and buffers keep their address when moved, so does the data
+	m_oMappedFile = std::move( oVirtualFile.m_oMappedFile );
+	m_aBuffer = std::move( oVirtualFile.m_aBuffer );
+	m_aData = oVirtualFile.m_aData;
+	m_bOpen = oVirtualFile.m_bOpen;
+
+	oVirtualFile.m_aData = ArrayView< const uint8 >();
+	oVirtualFile.m_bOpen = false;
+
+	return *this;
+}
+
+bool VirtualFile::IsOpen() const
+{
+	return m_bOpen;
+}
+
+ArrayView< const uint8 > VirtualFile::GetData() const
+{
+	return m_aData;
+}
+
+std::string_view VirtualFile::GetText() const
+{
+	return std::string_view( ( const char* )m_aData.Data(), m_aData.Count() );
+}
+
+uint64 VirtualFile::GetSize() const
+{
+	return m_aData.Count();
+}
+
+VirtualFileLocation::VirtualFileLocation()
+	: m_uOffset( 0 )
+	, m_uStoredSize( 0 )
+	, m_uSize( 0 )
+	, m_eCompression( PackCompression::NONE )
+{
+}
+
+VirtualFileSystem* g_pVirtualFileSystem = nullptr;
+
+VirtualFileSystem::VirtualFileSystem()
+{
+	g_pVirtualFileSystem = this;
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+	for( MountedPack* pMountedPack : m_aMountedPacks )
+		delete pMountedPack;
+
+	g_pVirtualFileSystem = nullptr;
+}
+
+bool VirtualFileSystem::Mount( const std::filesystem::path& oFilePath, const std::string& sMountPoint )
+{
+	MountedPack* pMountedPack = new MountedPack;
+	if( pMountedPack->m_oPackFile.Open( oFilePath ) == false )
+	{
+		delete pMountedPack;
+		return false;
+	}
+
+	pMountedPack->m_sMountPoint = std::filesystem::path( sMountPoint ).lexically_normal().generic_string();
+	if( pMountedPack->m_sMountPoint.empty() == false && pMountedPack->m_sMountPoint.back() != '/' )
+		pMountedPack->m_sMountPoint += '/';
+
+	m_aMountedPacks.PushBack( pMountedPack );
+
+	LOG_INFO( "Mounted {} ({} files) on {}", oFilePath.string(), pMountedPack->m_oPackFile.GetEntries().Count(), sMountPoint );
+	return true;
+}
+
+bool VirtualFileSystem::Exists( const std::filesystem::path& oFilePath ) const
+{
+	const PackFile* pPackFile = nullptr;
+	if( Find( oFilePath.lexically_normal().generic_string(), pPackFile ) != nullptr )
+		return true;
+
+	return std::filesystem::exists( oFilePath );
+}
+
+VirtualFile VirtualFileSystem::Open( const std::filesystem::path& oFilePath ) const
+{
+	VirtualFile oVirtualFile;
+
+	const PackFile* pPackFile = nullptr;
+	const PackEntry* pEntry = Find( oFilePath.lexically_normal().generic_string(), pPackFile );
+	if( pEntry != nullptr )
+	{
+		oVirtualFile.m_bOpen = pPackFile->Read( *pEntry, oVirtualFile.m_aData, oVirtualFile.m_aBuffer );
+		return oVirtualFile;
+	}
+
+	if( oVirtualFile.m_oMappedFile.Open( oFilePath ) )
+	{
+		oVirtualFile.m_aData = oVirtualFile.m_oMappedFile.GetData();
+		oVirtualFile.m_bOpen = true;
+	}
+
+	return oVirtualFile;
+}
+
+bool VirtualFileSystem::Locate( const std::filesystem::path& oFilePath, VirtualFileLocation& oLocation ) const
+{
+	const PackFile* pPackFile = nullptr;
+	const PackEntry* pEntry = Find( oFilePath.lexically_normal().generic_string(), pPackFile );
+	if( pEntry != nullptr )
+	{
+		oLocation.m_oFilePath = pPackFile->GetFilePath();
+		oLocation.m_uOffset = pEntry->m_uOffset;
+		oLocation.m_uStoredSize = pEntry->m_uStoredSize;
+		oLocation.m_uSize = pEntry->m_uSize;
+		oLocation.m_eCompression = pEntry->m_eCompression;
+		return true;
+	}
+
+	std::error_code oError;
+	const uint64 uSize = std::filesystem::file_size( oFilePath, oError );
+	if( oError )
+		return false;
+
+	oLocation.m_oFilePath = oFilePath;
+	oLocation.m_uOffset = 0;
+	oLocation.m_uStoredSize = uSize;
+	oLocation.m_uSize = uSize;
+	oLocation.m_eCompression = PackCompression::NONE;
+	return true;
+}
+
+const PackEntry* VirtualFileSystem::Find( const std::string& sPath, const PackFile*& pPackFile ) const
+{
+	for( uint u = m_aMountedPacks.Count(); u > 0; --u )
+	{
+		const MountedPack* pMountedPack = m_aMountedPacks[ u - 1 ];
+		if( sPath.starts_with( pMountedPack->m_sMountPoint ) == false )
+			continue;
+
+		const PackEntry* pEntry = pMountedPack->m_oPackFile.Find( std::string_view( sPath ).substr( pMountedPack->m_sMountPoint.length() ) );
+		if( pEntry != nullptr )
+		{
+			pPackFile = &pMountedPack->m_oPackFile;
+			return pEntry;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "Array.h"
+#include "MappedFile.h"
+#include "PackFile.h"
+
+// A file read through the virtual file system, either in place in a pack or a mapped loose file, or decompressed from a pack
+class VirtualFile
+{
+public:
+	VirtualFile();
+	VirtualFile( VirtualFile&& oVirtualFile ) noexcept;
+
+	VirtualFile& operator=( VirtualFile&& oVirtualFile ) noexcept;
+
+	bool						IsOpen() const;
+
+	ArrayView< const uint8 >	GetData() const;
+	std::string_view			GetText() const;
+	uint64						GetSize() const;
+
+private:
+	friend class VirtualFileSystem;
+
+	MappedFile					m_oMappedFile;
+	Array< uint8 >				m_aBuffer;
+	ArrayView< const uint8 >	m_aData;
+	bool						m_bOpen;
+};
+
+// Where the bytes of a file are stored, so that they can be read without opening it through the virtual file system
+struct VirtualFileLocation
+{
+	VirtualFileLocation();
+
+	std::filesystem::path	m_oFilePath;
+	uint64					m_uOffset;
+	uint64					m_uStoredSize;
+	uint64					m_uSize;
+	PackCompression			m_eCompression;
+};
+
+// Resolves paths in the mounted packs first, the last mounted pack having priority, then falls back to loose files
+// Packs are mounted at startup, lookups can then be done from any thread
+class VirtualFileSystem
+{
+public:
+	VirtualFileSystem();
+	~VirtualFileSystem();
+
+	// Files of the pack are seen under sMountPoint, as if the packed directory was there
+	bool		Mount( const std::filesystem::path& oFilePath, const std::string& sMountPoint );
+
+	bool		Exists( const std::filesystem::path& oFilePath ) const;
+	VirtualFile	Open( const std::filesystem::path& oFilePath ) const;
+	bool		Locate( const std::filesystem::path& oFilePath, VirtualFileLocation& oLocation ) const;
+
+private:
+	struct MountedPack
+	{
+		PackFile	m_oPackFile;
+		std::string	m_sMountPoint;
+	};
+
+	const PackEntry*	Find( const std::string& sPath, const PackFile*& pPackFile ) const;
+
+	// Packs hold their mapping and cannot be copied, which Array requires
+	Array< MountedPack* >	m_aMountedPacks;
+};
+
+extern VirtualFileSystem* g_pVirtualFileSystem;
@@ -157,7 +157,7 @@ void Editor::OnSceneLoaded()
 
 void Editor::Update( const InputContext& oInputContext, const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "Editor" );
+	PROFILE_SCOPE( "Editor" );
 
 	if( g_pInputHandler->IsInputActionTriggered( InputActionID::ACTION_TOGGLE_EDITOR ) )
 		m_bDisplayEditor = !m_bDisplayEditor;
@@ -502,7 +502,7 @@ void Editor::Update( const InputContext& oInputContext, const RenderContext& oRe
 
 void Editor::Render( const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "Editor" );
+	PROFILE_SCOPE( "Editor" );
 
 	if( m_bDisplayEditor )
 	{
@@ -753,7 +753,7 @@ bool Editor::DisplayHierarchy( Entity* pEntity, int iImGuiID )
 
 void Editor::StoreSnapshot()
 {
-	ProfilerBlock oBlock( "Snapshot" );
+	PROFILE_SCOPE( "Snapshot" );
 
 	m_oSnapshotStore.Push();
 	g_pGameWorld->m_oScene.Save( m_oSnapshotStore.Back() );
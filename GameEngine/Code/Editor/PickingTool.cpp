@@ -10,7 +10,7 @@
 #include "Math/GLMHelpers.h"
 
 PickingTool::PickingTool()
-	: m_xPicking( g_pResourceLoader->LoadTechnique( "Shader/picking.tech" ) )
+	: m_xPicking( g_pResourceLoader->LoadTechnique( "Shader/picking.tech", LoadPriority::BACKGROUND ) )
 {
 	m_oSkinningBuffer.Create( ShaderBufferDesc().Dynamic() );
 }
@@ -13,7 +13,7 @@
 inline constexpr int TRENCH_SIZE = 8192;
 
 TrenchTool::TrenchTool()
-	: m_xTrench( g_pResourceLoader->LoadTechnique( "Shader/trench.tech" ) )
+	: m_xTrench( g_pResourceLoader->LoadTechnique( "Shader/trench.tech", LoadPriority::BACKGROUND ) )
 {
 	m_oTrenchRT.Create( RenderTargetDesc( TRENCH_SIZE, TRENCH_SIZE ).Depth() );
 }
@@ -18,7 +18,7 @@ CameraManager::~CameraManager()
 
 void CameraManager::Update( const GameContext& oGameContext )
 {
-	ProfilerBlock oBlock( "CameraManager" );
+	PROFILE_SCOPE( "CameraManager" );
 
 	if( oGameContext.m_bEditing == false && m_xActiveCamera.IsValid() )
 		m_xActiveCamera->ApplyCamera( g_pRenderer->m_oCamera );
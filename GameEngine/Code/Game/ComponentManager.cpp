@@ -157,12 +157,18 @@ void ComponentManager::NotifyAfterPhysicsOnComponents()
 
 void ComponentManager::UpdateComponents( const GameContext& oGameContext )
 {
+	uint uLiveComponentCount = 0;
+
 	for( ComponentsHolderBase* pHolder : m_aPriorityComponentsHolder )
 	{
 		ProfilerBlock oBlock( pHolder->GetConcreteComponentName().c_str() );
 
 		pHolder->UpdateComponents( oGameContext );
+
+		uLiveComponentCount += pHolder->GetCount() - pHolder->GetDisposedCount();
 	}
+
+	PROFILE_COUNTER( "Live components", uLiveComponentCount );
 }
 
 void ComponentManager::FinalizeComponents()
@@ -8,6 +8,8 @@
 #include "Game/GameWorld.h"
 #include "Math/GLMHelpers.h"
 
+DEFINE_POOL_ALLOCATOR( Entity, 256 )
+
 static bool IsUniformScale( const glm::vec3& vScale )
 {
 	const float fEpsilon = 0.001f;
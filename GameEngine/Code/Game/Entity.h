@@ -6,6 +6,7 @@
 #include <glm/gtc/quaternion.hpp>
 
 #include "Core/Intrusive.h"
+#include "Core/PoolAllocator.h"
 #include "Core/Types.h"
 #include "Game/Component.h"
 
@@ -76,6 +77,8 @@ private:
 
 class Entity : public Intrusive
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class Scene;
 
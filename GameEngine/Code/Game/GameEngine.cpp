@@ -19,6 +19,16 @@ GameEngine::GameEngine( const InputContext& oInputContext, const RenderContext&
 	, m_eGameState( GameState::INITIALIZING )
 {
 	g_pGameEngine = this;
+
+	// Assets are read from the pack when there is one, built with --pack, loose files being used otherwise
+	if( std::filesystem::exists( "Data.pack" ) )
+		m_oVirtualFileSystem.Mount( "Data.pack", "Data" );
+
+	m_oProfiler.SetFrameBudget( 1000.f / 30.f );
+	m_oProfiler.SetBlockBudget( "Update", 8.f );
+	m_oProfiler.SetBlockBudget( "Physics", 4.f );
+	m_oProfiler.SetBlockBudget( "Render", 12.f );
+	m_oProfiler.SetBlockBudget( "HandleLoadedResources", 2.f );
 }
 
 GameEngine::~GameEngine()
@@ -72,7 +82,7 @@ void GameEngine::NewFrame()
 
 void GameEngine::ProcessFrame()
 {
-	ProfilerBlock oBlock( "GameEngine" );
+	PROFILE_SCOPE( "GameEngine" );
 
 	m_oResourceLoader.HandleLoadedResources();
 
@@ -90,13 +100,11 @@ void GameEngine::EndFrame()
 	m_oRenderer.Clear();
 
 	ImGui::Render();
-
-	Logger::Flush();
 }
 
 void GameEngine::Update()
 {
-	ProfilerBlock oBlock( "Update" );
+	PROFILE_SCOPE( "Update" );
 
 	if( m_eGameState == GameState::INITIALIZING )
 	{
@@ -148,7 +156,7 @@ void GameEngine::Update()
 
 void GameEngine::Render()
 {
-	ProfilerBlock oBlock( "Render" );
+	PROFILE_SCOPE( "Render" );
 
 	if( m_eGameState != GameState::INITIALIZING )
 	{
@@ -5,6 +5,7 @@
 #include "Core/MemoryTracker.h"
 #include "Core/Profiler.h"
 #include "Core/Types.h"
+#include "Core/VirtualFileSystem.h"
 #include "Editor/Editor.h"
 #include "GameContext.h"
 #include "GameWorld.h"
@@ -47,6 +48,7 @@ private:
 	MemoryTracker			m_oMemoryTracker;
 	Profiler				m_oProfiler;
 
+	VirtualFileSystem		m_oVirtualFileSystem;
 	ResourceLoader			m_oResourceLoader;
 	InputHandler			m_oInputHandler;
 	Renderer				m_oRenderer;
@@ -1,6 +1,6 @@
 #include "GameWorld.h"
 
-#include "Core/FileUtils.h"
+#include "Core/VirtualFileSystem.h"
 #include "Core/Profiler.h"
 #include "Entity.h"
 #include "GameContext.h"
@@ -12,6 +12,7 @@ GameWorld* g_pGameWorld = nullptr;
 GameWorld::GameWorld()
 	: m_eWorldState( WorldState::EMPTY )
 	, m_eWorldTrigger( WorldTrigger::NONE )
+	, m_uSceneInFlightBytesBudget( 0 )
 {
 	g_pGameWorld = this;
 }
@@ -24,7 +25,10 @@ GameWorld::~GameWorld()
 void GameWorld::SetScene( const std::filesystem::path& oScenePath )
 {
 	m_oScenePath = oScenePath;
-	m_oSceneJson = nlohmann::json::parse( ReadTextFile( m_oScenePath ) );
+
+	// Parsed in place from the mapped scene, its text is never copied
+	const VirtualFile oSceneFile = g_pVirtualFileSystem->Open( m_oScenePath );
+	m_oSceneJson = nlohmann::json::parse( oSceneFile.GetText() );
 }
 
 const std::filesystem::path& GameWorld::GetScene() const
@@ -49,13 +53,17 @@ void GameWorld::Reset()
 
 void GameWorld::Update( const GameContext& oGameContext )
 {
-	ProfilerBlock oBlock( "GameWorld" );
+	PROFILE_SCOPE( "GameWorld" );
 
 	switch( m_eWorldState )
 	{
 	case WorldState::EMPTY:
 		if( m_eWorldTrigger == WorldTrigger::LOAD )
 		{
+			// Nothing of the scene is shown until all of it is loaded, it gets the budget of the most urgent resources meanwhile
+			m_uSceneInFlightBytesBudget = g_pResourceLoader->GetInFlightBytesBudget( LoadPriority::NORMAL );
+			g_pResourceLoader->SetInFlightBytesBudget( LoadPriority::NORMAL, g_pResourceLoader->GetInFlightBytesBudget( LoadPriority::HIGH ) );
+
 			m_oScene.Load( m_oSceneJson );
 			g_pComponentManager->InitializeComponents();
 			m_eWorldState = WorldState::LOADING;
@@ -65,6 +73,7 @@ void GameWorld::Update( const GameContext& oGameContext )
 	case WorldState::LOADING:
 		if( g_pComponentManager->AreComponentsInitialized() )
 		{
+			g_pResourceLoader->SetInFlightBytesBudget( LoadPriority::NORMAL, m_uSceneInFlightBytesBudget );
 			m_eWorldState = WorldState::READY;
 			m_eWorldTrigger = WorldTrigger::NONE;
 		}
@@ -148,7 +157,7 @@ void GameWorld::UpdateWorld( const GameContext& oGameContext )
 
 	for( uint u = 0; u < oGameContext.m_uLastTicks; ++u )
 	{
-		ProfilerBlock oBlock( "Tick" );
+		PROFILE_SCOPE( "Tick" );
 		g_pComponentManager->TickComponents();
 		g_pComponentManager->NotifyBeforePhysicsOnComponents();
 		g_pPhysics->Tick();
@@ -156,12 +165,12 @@ void GameWorld::UpdateWorld( const GameContext& oGameContext )
 	}
 
 	{
-		ProfilerBlock oBlock( "Logic" );
+		PROFILE_SCOPE( "Logic" );
 		g_pComponentManager->UpdateComponents( oGameContext );
 	}
 
 	{
-		ProfilerBlock oBlock( "Finalize" );
+		PROFILE_SCOPE( "Finalize" );
 		g_pComponentManager->FinalizeComponents();
 	}
 }
@@ -57,6 +57,8 @@ private:
 
 	WorldState				m_eWorldState;
 	WorldTrigger			m_eWorldTrigger;
+	// Budget of the resources of the scene once it is loaded
+	uint64					m_uSceneInFlightBytesBudget;
 
 	std::filesystem::path	m_oScenePath;
 	Scene					m_oScene;
@@ -16,7 +16,7 @@ InputContext::KeyStatus::KeyStatus()
 
 void InputContext::Refresh()
 {
-	ProfilerBlock oBlock( "InputContext" );
+	PROFILE_SCOPE( "InputContext" );
 
 	glfwPollEvents();
 	glfwGetGamepadState( GLFW_JOYSTICK_1, &m_oGamepad );
@@ -151,7 +151,7 @@ InputHandler::~InputHandler()
 
 void InputHandler::UpdateInputs( const InputContext& oInputContext )
 {
-	ProfilerBlock oBlock( "Inputs" );
+	PROFILE_SCOPE( "Inputs" );
 
 	for( uint u = 0; u < m_aInputActions.Count(); ++u )
 	{
@@ -0,0 +1,105 @@
+#include "ModelMeshFile.h"
+
+static_assert( sizeof( glm::mat4x3 ) == sizeof( MeshFileMatrix ) );
+
+template < typename T >
+static MeshFileCurve WriteMeshFileCurve( MeshFileData& oData, const AnimationCurve< T >& oCurve )
+{
+	return MeshFileCurve { AppendMeshFileValues( oData.m_aKeyTimes, oCurve.m_aTimes ), AppendMeshFileValues( oData.m_aKeyValues, oCurve.m_aValues ) };
+}
+
+template < typename T >
+static void ReadMeshFileCurve( const MeshFile& oMeshFile, const MeshFileCurve& oCurve, AnimationCurve< T >& oAnimationCurve )
+{
+	CopyMeshFileValues( oMeshFile.GetKeyTimes(), oCurve.m_oTimes, oAnimationCurve.m_aTimes );
+	CopyMeshFileValues( oMeshFile.GetKeyValues(), oCurve.m_oValues, oAnimationCurve.m_aValues );
+}
+
+static void WriteMeshFileSkeleton( MeshFileData& oData, const Skeleton& oSkeleton )
+{
+	oData.m_aNodes.PushBack( MeshFileNode { oSkeleton.m_uMatrixIndex, oSkeleton.m_aChildren.Count() } );
+
+	for( const Skeleton& oChild : oSkeleton.m_aChildren )
+		WriteMeshFileSkeleton( oData, oChild );
+}
+
+// The node counts were checked when the file was opened, a file of any depth is read without recursing
+static void ReadMeshFileSkeleton( const ArrayView< const MeshFileNode > aNodes, Skeleton& oSkeleton )
+{
+	// Children are pushed last to first so that they are popped in file order, their arrays are not resized once pushed
+	Array< Skeleton* > aPendingSkeletons;
+	aPendingSkeletons.PushBack( &oSkeleton );
+
+	for( const MeshFileNode& oNode : aNodes )
+	{
+		Skeleton* pSkeleton = aPendingSkeletons.Back();
+		aPendingSkeletons.PopBack();
+
+		pSkeleton->m_uMatrixIndex = oNode.m_uMatrixIndex;
+		pSkeleton->m_aChildren.Resize( oNode.m_uChildCount );
+
+		for( uint u = oNode.m_uChildCount; u > 0; --u )
+			aPendingSkeletons.PushBack( &pSkeleton->m_aChildren[ u - 1 ] );
+	}
+}
+
+void WriteMeshFileAnimations( MeshFileData& oData, const Skeleton& oSkeleton, const Array< glm::mat4x3 >& aPoseMatrices, const Array< glm::mat4x3 >& aSkinMatrices, const Array< Animation >& aAnimations )
+{
+	WriteMeshFileSkeleton( oData, oSkeleton );
+	AppendMeshFileValues( oData.m_aPoseMatrices, aPoseMatrices );
+	AppendMeshFileValues( oData.m_aSkinMatrices, aSkinMatrices );
+
+	for( const Animation& oAnimation : aAnimations )
+	{
+		MeshFileAnimation oMeshFileAnimation;
+		oMeshFileAnimation.m_oName = oData.AddBlob( oAnimation.m_sName.data(), ( uint )oAnimation.m_sName.length() );
+		oMeshFileAnimation.m_oChannels = MeshFileRange { oData.m_aChannels.Count(), oAnimation.m_aNodeAnimations.Count() };
+		oMeshFileAnimation.m_fDuration = oAnimation.m_fDuration;
+		oData.m_aAnimations.PushBack( oMeshFileAnimation );
+
+		for( const NodeAnimation& oNodeAnimation : oAnimation.m_aNodeAnimations )
+		{
+			MeshFileChannel oChannel;
+			oChannel.m_oPositionCurve = WriteMeshFileCurve( oData, oNodeAnimation.m_oPositionCurve );
+			oChannel.m_oRotationCurve = WriteMeshFileCurve( oData, oNodeAnimation.m_oRotationCurve );
+			oChannel.m_oScaleCurve = WriteMeshFileCurve( oData, oNodeAnimation.m_oScaleCurve );
+			oChannel.m_uMatrixIndex = oNodeAnimation.m_uMatrixIndex;
+			oData.m_aChannels.PushBack( oChannel );
+		}
+	}
+}
+
+void ReadMeshFileAnimations( const MeshFile& oMeshFile, Skeleton& oSkeleton, Array< glm::mat4x3 >& aPoseMatrices, Array< glm::mat4x3 >& aSkinMatrices, Array< Animation >& aAnimations )
+{
+	const ArrayView< const MeshFileAnimation > aMeshFileAnimations = oMeshFile.GetAnimations();
+	aAnimations.Resize( aMeshFileAnimations.Count() );
+
+	for( uint uAnimation = 0; uAnimation < aMeshFileAnimations.Count(); ++uAnimation )
+	{
+		const MeshFileAnimation& oMeshFileAnimation = aMeshFileAnimations[ uAnimation ];
+
+		Animation& oAnimation = aAnimations[ uAnimation ];
+		oAnimation.m_sName = oMeshFile.GetString( oMeshFileAnimation.m_oName );
+		oAnimation.m_fDuration = oMeshFileAnimation.m_fDuration;
+		oAnimation.m_aNodeAnimations.Resize( oMeshFileAnimation.m_oChannels.m_uCount );
+
+		for( uint uChannel = 0; uChannel < oMeshFileAnimation.m_oChannels.m_uCount; ++uChannel )
+		{
+			const MeshFileChannel& oChannel = oMeshFile.GetChannels()[ oMeshFileAnimation.m_oChannels.m_uOffset + uChannel ];
+
+			NodeAnimation& oNodeAnimation = oAnimation.m_aNodeAnimations[ uChannel ];
+			ReadMeshFileCurve( oMeshFile, oChannel.m_oPositionCurve, oNodeAnimation.m_oPositionCurve );
+			ReadMeshFileCurve( oMeshFile, oChannel.m_oRotationCurve, oNodeAnimation.m_oRotationCurve );
+			ReadMeshFileCurve( oMeshFile, oChannel.m_oScaleCurve, oNodeAnimation.m_oScaleCurve );
+			oNodeAnimation.m_uMatrixIndex = oChannel.m_uMatrixIndex;
+		}
+	}
+
+	if( oMeshFile.GetNodes().Empty() == false )
+		ReadMeshFileSkeleton( oMeshFile.GetNodes(), oSkeleton );
+
+	const ArrayView< const MeshFileMatrix > aMeshFilePoseMatrices = oMeshFile.GetPoseMatrices();
+	const ArrayView< const MeshFileMatrix > aMeshFileSkinMatrices = oMeshFile.GetSkinMatrices();
+	CopyMeshFileValues( aMeshFilePoseMatrices, MeshFileRange { 0, aMeshFilePoseMatrices.Count() }, aPoseMatrices );
+	CopyMeshFileValues( aMeshFileSkinMatrices, MeshFileRange { 0, aMeshFileSkinMatrices.Count() }, aSkinMatrices );
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Animation.h"
+#include "Core/Array.h"
+#include "Core/MeshFile.h"
+
+// Appends values made of elements of the section, like vec3 to floats, and returns their range in elements
+template < typename T, typename U >
+MeshFileRange AppendMeshFileValues( Array< T >& aSection, const Array< U >& aValues )
+{
+	static_assert( sizeof( U ) % sizeof( T ) == 0 );
+
+	const uint uCount = aValues.Count() * ( uint )( sizeof( U ) / sizeof( T ) );
+	const MeshFileRange oRange { aSection.Count(), uCount };
+
+	aSection.Resize( aSection.Count() + uCount );
+	if( uCount > 0 )
+		memcpy( aSection.Data() + oRange.m_uOffset, aValues.Data(), uCount * sizeof( T ) );
+
+	return oRange;
+}
+
+template < typename T, typename U >
+void CopyMeshFileValues( const ArrayView< const T > aSection, const MeshFileRange& oRange, Array< U >& aValues )
+{
+	static_assert( sizeof( U ) % sizeof( T ) == 0 );
+
+	aValues.Resize( oRange.m_uCount / ( uint )( sizeof( U ) / sizeof( T ) ) );
+	if( aValues.Empty() == false )
+		memcpy( aValues.Data(), aSection.Data() + oRange.m_uOffset, aValues.Count() * sizeof( U ) );
+}
+
+// The skeleton, its matrices and the animations of a model, what a mesh file holds besides the meshes and materials
+void WriteMeshFileAnimations( MeshFileData& oData, const Skeleton& oSkeleton, const Array< glm::mat4x3 >& aPoseMatrices, const Array< glm::mat4x3 >& aSkinMatrices, const Array< Animation >& aAnimations );
+// The file was checked when it was opened
+void ReadMeshFileAnimations( const MeshFile& oMeshFile, Skeleton& oSkeleton, Array< glm::mat4x3 >& aPoseMatrices, Array< glm::mat4x3 >& aSkinMatrices, Array< Animation >& aAnimations );
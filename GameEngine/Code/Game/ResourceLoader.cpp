@@ -1,9 +1,9 @@
 #include "ResourceLoader.h"
 
-#define NOMINMAX
-#include <Windows.h>
-
 #include <assimp/cimport.h>
+#include <assimp/Importer.hpp>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <nlohmann/json.hpp>
@@ -11,17 +11,19 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_TRUETYPE_IMPLEMENTATION
 
+#include "Core/BinaryStream.h"
 #include "Core/Common.h"
-#include "Core/FileUtils.h"
 #include "Core/Logger.h"
 #include "Core/Profiler.h"
 #include "Core/stb_image.h"
 #include "Core/stb_truetype.h"
 #include "Core/StringUtils.h"
+#include "Core/VirtualFileSystem.h"
 #include "Graphics/BoundingVolume.h"
 #include "Graphics/DebugDisplay.h"
 #include "Graphics/MaterialManager.h"
 #include "InputHandler.h"
+#include "ModelMeshFile.h"
 
 template < typename T >
 auto AssimpToGLM( const T& oAssimp )
@@ -47,104 +49,337 @@ auto AssimpToGLM< aiMatrix4x4 >( const aiMatrix4x4& mAssimp )
 	return glm::transpose( *reinterpret_cast< const glm::mat4* >( &mAssimp ) );
 }
 
+// Lets assimp read models, and the files they reference, through the virtual file system
+class VirtualIOStream : public Assimp::IOStream
+{
+public:
+	explicit VirtualIOStream( VirtualFile&& oVirtualFile )
+		: m_oVirtualFile( std::move( oVirtualFile ) )
+		, m_aData( m_oVirtualFile.GetData() )
+		, m_uPosition( 0 )
+	{
+	}
+
+	explicit VirtualIOStream( const ArrayView< const uint8 > aData )
+		: m_aData( aData )
+		, m_uPosition( 0 )
+	{
+	}
+
+	size_t Read( void* pBuffer, size_t uSize, size_t uCount ) override
+	{
+		if( uSize == 0 )
+			return 0;
+
+		const size_t uReadCount = std::min( uCount, ( FileSize() - m_uPosition ) / uSize );
+		memcpy( pBuffer, m_aData.Data() + m_uPosition, uReadCount * uSize );
+		m_uPosition += uReadCount * uSize;
+
+		return uReadCount;
+	}
+
+	size_t Write( const void* /*pBuffer*/, size_t /*uSize*/, size_t /*uCount*/ ) override
+	{
+		return 0;
+	}
+
+	aiReturn Seek( size_t uOffset, aiOrigin eOrigin ) override
+	{
+		size_t uPosition = uOffset;
+		if( eOrigin == aiOrigin_CUR )
+			uPosition += m_uPosition;
+		else if( eOrigin == aiOrigin_END )
+			uPosition = FileSize() - uOffset;
+
+		if( uPosition > FileSize() )
+			return aiReturn_FAILURE;
+
+		m_uPosition = uPosition;
+		return aiReturn_SUCCESS;
+	}
+
+	size_t Tell() const override
+	{
+		return m_uPosition;
+	}
+
+	size_t FileSize() const override
+	{
+		return ( size_t )m_aData.Count();
+	}
+
+	void Flush() override
+	{
+	}
+
+private:
+	VirtualFile					m_oVirtualFile;
+	ArrayView< const uint8 >	m_aData;
+	size_t						m_uPosition;
+};
+
+class VirtualIOSystem : public Assimp::IOSystem
+{
+public:
+	// The model file itself is already read by the IO thread, only the files it references are opened
+	void SetPrefetchedFile( const std::string& sFilePath, const ArrayView< const uint8 > aData )
+	{
+		m_sPrefetchedFilePath = sFilePath;
+		m_aPrefetchedData = aData;
+	}
+
+	bool Exists( const char* sFilePath ) const override
+	{
+		return m_sPrefetchedFilePath == sFilePath || g_pVirtualFileSystem->Exists( sFilePath );
+	}
+
+	char getOsSeparator() const override
+	{
+		return '/';
+	}
+
+	Assimp::IOStream* Open( const char* sFilePath, const char* sMode ) override
+	{
+		if( strchr( sMode, 'w' ) != nullptr )
+			return nullptr;
+
+		if( m_sPrefetchedFilePath == sFilePath )
+			return new VirtualIOStream( m_aPrefetchedData );
+
+		VirtualFile oVirtualFile = g_pVirtualFileSystem->Open( sFilePath );
+		if( oVirtualFile.IsOpen() == false )
+			return nullptr;
+
+		if( std::find( m_aOpenedFilePaths.begin(), m_aOpenedFilePaths.end(), sFilePath ) == m_aOpenedFilePaths.end() )
+			m_aOpenedFilePaths.PushBack( sFilePath );
+
+		return new VirtualIOStream( std::move( oVirtualFile ) );
+	}
+
+	// The files referenced by the model, like its materials
+	const Array< std::string >& GetOpenedFilePaths() const
+	{
+		return m_aOpenedFilePaths;
+	}
+
+	void Close( Assimp::IOStream* pStream ) override
+	{
+		delete pStream;
+	}
+
+private:
+	std::string					m_sPrefetchedFilePath;
+	ArrayView< const uint8 >	m_aPrefetchedData;
+	Array< std::string >		m_aOpenedFilePaths;
+};
+
 ResourceLoader* g_pResourceLoader = nullptr;
 
-//constexpr uint IO_THREAD_AFFINITY_MASK = 1 << 1;
+// To be increased whenever the derived data is written differently, or derived differently from the same source
+static constexpr uint32 MODEL_DERIVED_DATA_VERSION = 2;
+static constexpr uint32 TEXTURE_DERIVED_DATA_VERSION = 2;
+
+// Decoded pixels take several times the size of their source, larger textures are decoded on every load rather than filling the cache
+static constexpr uint64 TEXTURE_DERIVED_DATA_MAX_SIZE = 16ull << 20;
+
+static constexpr uint MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace;
+
+// Material textures are stored in the derived data by their index in this table
+static TextureResPtr LitMaterialData::* const MATERIAL_TEXTURE_SLOTS[] = {
+	&LitMaterialData::m_xDiffuseTextureResource,
+	&LitMaterialData::m_xNormalTextureResource,
+	&LitMaterialData::m_xSpecularTextureResource,
+	&LitMaterialData::m_xEmissiveTextureResource
+};
+
+static uint GetMaterialTextureSlot( TextureResPtr LitMaterialData::* pTextureResource )
+{
+	return ( uint )( std::find( std::begin( MATERIAL_TEXTURE_SLOTS ), std::end( MATERIAL_TEXTURE_SLOTS ), pTextureResource ) - std::begin( MATERIAL_TEXTURE_SLOTS ) );
+}
+
+// Derived data depends on the kind of resource, the settings it is derived with and the content of its source file
+static uint64 ComputeDerivedDataKey( const char* sCommandName, const uint64 uSettingsHash, const ArrayView< const uint8 > aData )
+{
+	uint64 uKey = HashData( sCommandName, strlen( sCommandName ) );
+	uKey = HashData( &uSettingsHash, sizeof( uSettingsHash ), uKey );
+	return HashData( aData.Data(), aData.Count(), uKey );
+}
+
+static bool HashSourceFile( const std::string& sFilePath, uint64& uHash )
+{
+	const VirtualFile oVirtualFile = g_pVirtualFileSystem->Open( sFilePath );
+	if( oVirtualFile.IsOpen() == false )
+		return false;
+
+	uHash = HashData( oVirtualFile.GetData().Data(), oVirtualFile.GetSize() );
+	return true;
+}
+
+template < typename T >
+static void WriteAnimationCurve( BinaryWriter& oWriter, const AnimationCurve< T >& oCurve )
+{
+	oWriter.WriteArray( oCurve.m_aTimes );
+	oWriter.WriteArray( oCurve.m_aValues );
+}
+
+template < typename T >
+static bool ReadAnimationCurve( BinaryReader& oReader, AnimationCurve< T >& oCurve )
+{
+	return oReader.ReadArray( oCurve.m_aTimes ) && oReader.ReadArray( oCurve.m_aValues ) && oCurve.m_aTimes.Count() == oCurve.m_aValues.Count();
+}
+
+static MeshFileBox ToMeshFileBox( const AxisAlignedBox& oAABB )
+{
+	return MeshFileBox { { oAABB.m_vMin.x, oAABB.m_vMin.y, oAABB.m_vMin.z }, { oAABB.m_vMax.x, oAABB.m_vMax.y, oAABB.m_vMax.z } };
+}
+
+static void WriteSkeleton( BinaryWriter& oWriter, const Skeleton& oSkeleton )
+{
+	oWriter.Write( oSkeleton.m_uMatrixIndex );
+	oWriter.Write( oSkeleton.m_aChildren.Count() );
+
+	for( const Skeleton& oChild : oSkeleton.m_aChildren )
+		WriteSkeleton( oWriter, oChild );
+}
+
+static bool ReadSkeleton( BinaryReader& oReader, Skeleton& oSkeleton )
+{
+	uint uChildCount = 0;
+	if( oReader.Read( oSkeleton.m_uMatrixIndex ) == false || oReader.Read( uChildCount ) == false )
+		return false;
+
+	// Children are added as they are read, a count read from a damaged entry does not allocate more than there is data for
+	for( uint u = 0; u < uChildCount; ++u )
+	{
+		oSkeleton.m_aChildren.PushBack( Skeleton() );
+		if( ReadSkeleton( oReader, oSkeleton.m_aChildren.Back() ) == false )
+			return false;
+	}
+
+	return true;
+}
+
+// The main thread and the IO thread keep a core each
+static uint GetDecodeThreadCount()
+{
+	return std::max( std::thread::hardware_concurrency(), 3u ) - 2;
+}
 
 ResourceLoader::ResourceLoader()
-	: m_bRunning( true )
-	, m_oIOThread( &ResourceLoader::Load, this )
+	: m_oDerivedDataCache( "Cache" )
+	, m_oScheduler( GetDecodeThreadCount() )
 	, m_bDisableUnusedResourcesDestruction( false )
 	, m_bDisplayDebug( false )
 {
-	//SetThreadAffinityMask( m_oIOThread.native_handle(), IO_THREAD_AFFINITY_MASK );
-	SetThreadDescription( m_oIOThread.native_handle(), L"IO thread" );
-
 	g_pResourceLoader = this;
 }
 
 ResourceLoader::~ResourceLoader()
 {
-	m_bRunning = false;
-	m_oProcessingCommandsConditionVariable.notify_one();
-
 	g_pResourceLoader = nullptr;
 }
 
-FontResPtr ResourceLoader::LoadFont( const char* sFilePath )
+FontResPtr ResourceLoader::LoadFont( const char* sFilePath, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	FontResPtr& xFontPtr = m_mFontResources[ sFilePath ];
 	if( xFontPtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xFontPtr.GetPtr(), ePriority );
 		return xFontPtr;
+	}
 
 	xFontPtr = new FontResource();
 
-	LOG_INFO( "Loading {}", sFilePath );
-	m_oPendingLoadCommands.m_aFontLoadCommands.PushBack( FontLoadCommand( sFilePath, xFontPtr ) );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sFilePath );
+	m_oScheduler.PushLoadCommand( new FontLoadCommand( sFilePath, xFontPtr ), ePriority );
 
 	return xFontPtr;
 }
 
-TextureResPtr ResourceLoader::LoadTexture( const char* sFilePath, const bool bSRGB /*= false*/, const bool bUse16Bits /*= false*/ )
+TextureResPtr ResourceLoader::LoadTexture( const char* sFilePath, const bool bSRGB /*= false*/, const bool bUse16Bits /*= false*/, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	TextureResPtr& xTexturePtr = m_mTextureResources[ sFilePath ];
 	if( xTexturePtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xTexturePtr.GetPtr(), ePriority );
 		return xTexturePtr;
+	}
 
 	xTexturePtr = new TextureResource();
 
-	LOG_INFO( "Loading {}", sFilePath );
-	m_oPendingLoadCommands.m_aTextureLoadCommands.PushBack( TextureLoadCommand( sFilePath, xTexturePtr, bSRGB, bUse16Bits ) );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sFilePath );
+	m_oScheduler.PushLoadCommand( new TextureLoadCommand( sFilePath, xTexturePtr, bSRGB, bUse16Bits ), ePriority );
 
 	return xTexturePtr;
 }
 
-TextureResPtr ResourceLoader::LoadTexture( const char* sFilePath, const uint8* pData, const uint uDataSize, const bool bSRGB /*= false */, const bool bUse16Bits /*= false*/ )
+TextureResPtr ResourceLoader::LoadTexture( const char* sFilePath, Array< uint8 >&& aData, const bool bSRGB /*= false */, const bool bUse16Bits /*= false*/, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	TextureResPtr& xTexturePtr = m_mTextureResources[ sFilePath ];
 	if( xTexturePtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xTexturePtr.GetPtr(), ePriority );
 		return xTexturePtr;
+	}
 
 	xTexturePtr = new TextureResource();
 
-	LOG_INFO( "Loading {}", sFilePath );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sFilePath );
 
-	int iWidth;
-	int iHeight;
-	int iDepth;
-	uint8* pImageData = stbi_load_from_memory( pData, uDataSize, &iWidth, &iHeight, &iDepth, 0 );
+	m_oScheduler.PushLoadCommand( new TextureLoadCommand( sFilePath, xTexturePtr, bSRGB, bUse16Bits ), ePriority, std::move( aData ) );
 
-	TextureLoadCommand oLoadCommand( sFilePath, xTexturePtr, bSRGB, bUse16Bits );
-	oLoadCommand.m_eStatus = pImageData != nullptr ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
-	oLoadCommand.m_iWidth = iWidth;
-	oLoadCommand.m_iHeight = iHeight;
-	oLoadCommand.m_iDepth = iDepth;
-	oLoadCommand.m_pData = pImageData;
+	return xTexturePtr;
+}
 
-	m_oPendingLoadCommands.m_aTextureLoadCommands.PushBack( oLoadCommand );
+bool ResourceLoader::ConvertModel( const char* sFilePath, const std::filesystem::path& oMeshFilePath )
+{
+	ModelLoadCommand oLoadCommand( sFilePath, new ModelResource() );
 
-	return xTexturePtr;
+	const VirtualFile oVirtualFile = g_pVirtualFileSystem->Open( oLoadCommand.GetFilePath() );
+	if( oVirtualFile.IsOpen() == false )
+	{
+		SLOG_ERROR( LogCategory::RESOURCES, "File not found {}", sFilePath );
+		return false;
+	}
+
+	if( oLoadCommand.Import( oVirtualFile.GetData() ) == false )
+	{
+		SLOG_ERROR( LogCategory::RESOURCES, "Error reading file {}", sFilePath );
+		return false;
+	}
+
+	if( oLoadCommand.ExportMeshFile( oMeshFilePath ) == false )
+		return false;
+
+	SLOG_INFO( LogCategory::RESOURCES, "Converted {} into {}", sFilePath, oMeshFilePath.string() );
+	return true;
 }
 
-ModelResPtr ResourceLoader::LoadModel( const char* sFilePath )
+ModelResPtr ResourceLoader::LoadModel( const char* sFilePath, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	ModelResPtr& xModelPtr = m_mModelResources[ sFilePath ];
 	if( xModelPtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xModelPtr.GetPtr(), ePriority );
 		return xModelPtr;
+	}
 
 	xModelPtr = new ModelResource();
 
-	LOG_INFO( "Loading {}", sFilePath );
-	m_oPendingLoadCommands.m_aModelLoadCommands.PushBack( ModelLoadCommand( sFilePath, xModelPtr ) );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sFilePath );
+	m_oScheduler.PushLoadCommand( new ModelLoadCommand( sFilePath, xModelPtr ), ePriority );
 
 	return xModelPtr;
 }
 
-ShaderResPtr ResourceLoader::LoadShader( const char* sFilePath )
+ShaderResPtr ResourceLoader::LoadShader( const char* sFilePath, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	ShaderResPtr& xShaderPtr = m_mShaderResources[ sFilePath ];
 	if( xShaderPtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xShaderPtr.GetPtr(), ePriority );
 		return xShaderPtr;
+	}
 
 	xShaderPtr = new ShaderResource();
 
@@ -152,31 +387,66 @@ ShaderResPtr ResourceLoader::LoadShader( const char* sFilePath )
 	const std::string sRealFilePath = aFlags.Front();
 	aFlags.PopFront();
 
-	LOG_INFO( "Loading {}", sRealFilePath );
-	m_oPendingLoadCommands.m_aShaderLoadCommands.PushBack( ShaderLoadCommand( sRealFilePath.c_str(), xShaderPtr, std::move( aFlags ) ) );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sRealFilePath );
+	m_oScheduler.PushLoadCommand( new ShaderLoadCommand( sRealFilePath.c_str(), xShaderPtr, std::move( aFlags ) ), ePriority );
 
 	return xShaderPtr;
 }
 
-TechniqueResPtr ResourceLoader::LoadTechnique( const char* sFilePath )
+TechniqueResPtr ResourceLoader::LoadTechnique( const char* sFilePath, const LoadPriority ePriority /*= LoadPriority::NORMAL*/ )
 {
 	TechniqueResPtr& xTechniquePtr = m_mTechniqueResources[ sFilePath ];
 	if( xTechniquePtr != nullptr )
+	{
+		m_oScheduler.RaiseLoadPriority( xTechniquePtr.GetPtr(), ePriority );
 		return xTechniquePtr;
+	}
 
 	xTechniquePtr = new TechniqueResource();
 
-	LOG_INFO( "Loading {}", sFilePath );
-	m_oPendingLoadCommands.m_aTechniqueLoadCommands.PushBack( TechniqueLoadCommand( sFilePath, xTechniquePtr ) );
+	SLOG_INFO( LogCategory::RESOURCES, "Loading {}", sFilePath );
+	m_oScheduler.PushLoadCommand( new TechniqueLoadCommand( sFilePath, xTechniquePtr ), ePriority );
 
 	return xTechniquePtr;
 }
 
+void ResourceLoader::UpdateLoadPriority( const Resource* pResource, const LoadPriority ePriority, const float fDistance /*= 0.f*/ )
+{
+	m_oScheduler.UpdateLoadPriority( pResource, ePriority, fDistance );
+}
+
+void ResourceLoader::SetInFlightBytesBudget( const LoadPriority ePriority, const uint64 uBytes )
+{
+	m_oScheduler.SetInFlightBytesBudget( ePriority, uBytes );
+}
+
+uint64 ResourceLoader::GetInFlightBytesBudget( const LoadPriority ePriority ) const
+{
+	return m_oScheduler.GetInFlightBytesBudget( ePriority );
+}
+
 void ResourceLoader::HandleLoadedResources()
 {
-	ProfilerBlock oBlock( "HandleLoadedResources" );
+	PROFILE_SCOPE( "HandleLoadedResources" );
+
+	m_oScheduler.FinalizeLoadCommands();
+
+	const uint uPendingLoadCommandCount = m_oScheduler.GetPendingLoadCommandCount();
+	const uint uFinalizingLoadCommandCount = m_oScheduler.GetFinalizingLoadCommandCount();
+	const uint uWaitingDependenciesLoadCommandCount = m_oScheduler.GetWaitingDependenciesLoadCommandCount();
+
+	PROFILE_COUNTER( "Waiting dependencies load commands", uWaitingDependenciesLoadCommandCount );
 
-	CheckFinishedProcessingLoadCommands();
+	if( uPendingLoadCommandCount > 0 )
+		g_pDebugDisplay->DisplayText( std::format( "Pending load commands {}", uPendingLoadCommandCount ), glm::vec4( 1.f, 0.5f, 0.f, 1.f ) );
+
+	if( uFinalizingLoadCommandCount > 0 )
+		g_pDebugDisplay->DisplayText( std::format( "Finalizing load commands {}", uFinalizingLoadCommandCount ), glm::vec4( 0.f, 0.5f, 1.f, 1.f ) );
+
+	if( uWaitingDependenciesLoadCommandCount > 0 )
+		g_pDebugDisplay->DisplayText( std::format( "Waiting dependencies load commands {}", uWaitingDependenciesLoadCommandCount ), glm::vec4( 0.5f, 1.f, 0.f, 1.f ) );
+
+	PROFILE_COUNTER( "Loaded resources", m_mFontResources.size() + m_mTextureResources.size() + m_mModelResources.size() + m_mShaderResources.size() + m_mTechniqueResources.size() );
 
 	if( m_bDisableUnusedResourcesDestruction == false )
 		DestroyUnusedResources();
@@ -184,9 +454,9 @@ void ResourceLoader::HandleLoadedResources()
 
 void ResourceLoader::ProcessLoadCommands()
 {
-	ProfilerBlock oBlock( "ProcessLoadCommands" );
+	PROFILE_SCOPE( "ProcessLoadCommands" );
 
-	ProcessPendingLoadCommands();
+	m_oScheduler.ProcessPendingLoadCommands();
 }
 
 void ResourceLoader::DisplayDebug()
@@ -259,252 +529,52 @@ void ResourceLoader::DisplayDebug()
 	ImGui::End();
 }
 
-template < typename LoadCommand >
-void Load( Array< LoadCommand >& aLoadCommands, std::unique_lock< std::mutex >& oLock, const char* sCommandName )
-{
-	for( LoadCommand& oLoadCommand : aLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus != ResourceLoader::LoadCommandStatus::PENDING )
-			continue;
-
-		ProfilerBlock oResourceBlock( sCommandName, true );
-
-		{
-			ProfilerBlock oResourceBlock( "CheckResource", true );
-
-			if( std::filesystem::exists( oLoadCommand.GetFilePath() ) == false )
-			{
-				oLock.lock();
-				oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::NOT_FOUND;
-				oLock.unlock();
-				continue;
-			}
-		}
-
-		oLoadCommand.Load( oLock );
-	}
-}
-
-void ResourceLoader::Load()
-{
-	while( m_bRunning )
-	{
-		std::unique_lock oLock( m_oProcessingCommandsMutex );
-		// TODO #eric improve load queue handling
-		m_oProcessingCommandsConditionVariable.wait( oLock, [ this ]() { return m_oProcessingLoadCommands.Empty() == false || m_bRunning == false; } );
-		oLock.unlock();
-
-		if( m_bRunning == false )
-			return;
-
-		::Load( m_oProcessingLoadCommands.m_aFontLoadCommands, oLock, "LoadFont" );
-		::Load( m_oProcessingLoadCommands.m_aShaderLoadCommands, oLock, "LoadShader" );
-		::Load( m_oProcessingLoadCommands.m_aTechniqueLoadCommands, oLock, "LoadTechnique" );
-		::Load( m_oProcessingLoadCommands.m_aTextureLoadCommands, oLock, "LoadTexture" );
-		::Load( m_oProcessingLoadCommands.m_aModelLoadCommands, oLock, "LoadModel" );
-	}
-}
-
-void ResourceLoader::ProcessPendingLoadCommands()
-{
-	ProfilerBlock oBlock( "ProcessLoadCommands" );
-
-	std::unique_lock oLock( m_oProcessingCommandsMutex );
-	if( m_oProcessingLoadCommands.Empty() && m_oPendingLoadCommands.Empty() == false )
-	{
-		m_oProcessingLoadCommands.Grab( m_oPendingLoadCommands );
-		oLock.unlock();
-
-		m_oProcessingCommandsConditionVariable.notify_one();
-	}
-}
-
-template < typename LoadCommand >
-uint CheckFinishedProcessingLoadCommands( Array< LoadCommand >& aLoadCommands )
-{
-	uint uFinishedCount = 0;
-
-	for( uint u = 0; u < aLoadCommands.Count(); ++u )
-	{
-		LoadCommand& oLoadCommand = aLoadCommands[ u ];
-		switch( oLoadCommand.m_eStatus )
-		{
-		case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-			LOG_ERROR( "File not found {}", oLoadCommand.m_sFilePath );
-			oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::NOT_FOUND;
-			oLoadCommand.OnFinished();
-			oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::FINISHED;
-			++uFinishedCount;
-			break;
-		case ResourceLoader::LoadCommandStatus::ERROR_READING:
-			LOG_ERROR( "Error reading file {}", oLoadCommand.m_sFilePath );
-			oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::ERROR_READING;
-			oLoadCommand.OnFinished();
-			oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::FINISHED;
-			++uFinishedCount;
-			break;
-		case ResourceLoader::LoadCommandStatus::LOADED:
-			LOG_INFO( "Loaded {}", oLoadCommand.m_sFilePath );
-			oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::FINISHED;
-			oLoadCommand.OnFinished();
-			if( oLoadCommand.HasDependencies() )
-			{
-				LOG_INFO( "Waiting dependencies for {}", oLoadCommand.m_sFilePath );
-				oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::WAITING_DEPENDENCIES;
-			}
-			++uFinishedCount;
-			break;
-		case ResourceLoader::LoadCommandStatus::FINISHED:
-		case ResourceLoader::LoadCommandStatus::WAITING_DEPENDENCIES:
-			++uFinishedCount;
-			break;
-		}
-	}
-
-	return uFinishedCount;
-}
-
-template < typename LoadCommand >
-uint CheckWaitingDependenciesLoadCommands( Array< LoadCommand >& aLoadCommands )
-{
-	uint uFinishedCount = 0;
-
-	for( uint u = 0; u < aLoadCommands.Count(); ++u )
-	{
-		LoadCommand& oLoadCommand = aLoadCommands[ u ];
-		switch( oLoadCommand.m_eStatus )
-		{
-		case ResourceLoader::LoadCommandStatus::WAITING_DEPENDENCIES:
-			if( oLoadCommand.AllDependenciesLoaded() )
-			{
-				LOG_INFO( "Dependencies ready for {}", oLoadCommand.m_sFilePath );
-				oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::FINISHED;
-				oLoadCommand.OnDependenciesReady();
-				++uFinishedCount;
-			}
-			else if( oLoadCommand.AnyDependencyFailed() )
-			{
-				LOG_ERROR( "Failed to load a dependency for {}", oLoadCommand.m_sFilePath );
-				oLoadCommand.m_eStatus = ResourceLoader::LoadCommandStatus::ERROR_READING;
-				oLoadCommand.OnDependenciesReady();
-				++uFinishedCount;
-			}
-			break;
-		case ResourceLoader::LoadCommandStatus::FINISHED:
-			++uFinishedCount;
-			break;
-		default:
-			break;
-		}
-	}
-
-	return uFinishedCount;
-}
-
-void ResourceLoader::CheckFinishedProcessingLoadCommands()
-{
-	ProfilerBlock oBlock( "CheckFinishedLoadCommands" );
-
-	uint uFinishedCount = 0;
-
-	std::unique_lock oLock( m_oProcessingCommandsMutex );
-
-	uFinishedCount += ::CheckFinishedProcessingLoadCommands( m_oProcessingLoadCommands.m_aFontLoadCommands );
-	uFinishedCount += ::CheckFinishedProcessingLoadCommands( m_oProcessingLoadCommands.m_aShaderLoadCommands );
-	uFinishedCount += ::CheckFinishedProcessingLoadCommands( m_oProcessingLoadCommands.m_aTechniqueLoadCommands );
-	uFinishedCount += ::CheckFinishedProcessingLoadCommands( m_oProcessingLoadCommands.m_aTextureLoadCommands );
-	uFinishedCount += ::CheckFinishedProcessingLoadCommands( m_oProcessingLoadCommands.m_aModelLoadCommands );
-
-	if( uFinishedCount == m_oProcessingLoadCommands.Count() )
-	{
-		m_oWaitingDependenciesLoadCommands.CopyWaitingDependencies( m_oProcessingLoadCommands );
-		m_oProcessingLoadCommands.Clear();
-	}
-
-	uFinishedCount = 0;
-
-	uFinishedCount += ::CheckWaitingDependenciesLoadCommands( m_oWaitingDependenciesLoadCommands.m_aFontLoadCommands );
-	uFinishedCount += ::CheckWaitingDependenciesLoadCommands( m_oWaitingDependenciesLoadCommands.m_aShaderLoadCommands );
-	uFinishedCount += ::CheckWaitingDependenciesLoadCommands( m_oWaitingDependenciesLoadCommands.m_aTechniqueLoadCommands );
-	uFinishedCount += ::CheckWaitingDependenciesLoadCommands( m_oWaitingDependenciesLoadCommands.m_aTextureLoadCommands );
-	uFinishedCount += ::CheckWaitingDependenciesLoadCommands( m_oWaitingDependenciesLoadCommands.m_aModelLoadCommands );
-
-	// TODO #eric not ideal, the list will only be cleared when all waiting commands are completed at the same time
-	if( uFinishedCount == m_oWaitingDependenciesLoadCommands.Count() )
-		m_oWaitingDependenciesLoadCommands.Clear();
-
-	if( m_oPendingLoadCommands.Empty() == false )
-		g_pDebugDisplay->DisplayText( std::format( "Pending load commands {}", m_oPendingLoadCommands.Count() ), glm::vec4( 1.f, 0.5f, 0.f, 1.f ) );
-
-	if( m_oProcessingLoadCommands.Empty() == false )
-		g_pDebugDisplay->DisplayText( std::format( "Processing load commands {}", m_oProcessingLoadCommands.Count() ), glm::vec4( 0.f, 0.5f, 1.f, 1.f ) );
-
-	if( m_oWaitingDependenciesLoadCommands.Empty() == false )
-		g_pDebugDisplay->DisplayText( std::format( "Waiting dependencies load commands {}", m_oWaitingDependenciesLoadCommands.Count() ), glm::vec4( 0.5f, 1.f, 0.f, 1.f ) );
-}
-
-template < typename Resource >
-void DestroyUnusedResources( std::unordered_map< std::string, StrongPtr< Resource > >& mResources )
-{
-	for( auto& oPair : mResources )
-	{
-		if( oPair.second->GetReferenceCount() == 1 )
-		{
-			LOG_INFO( "Unloading {}", oPair.first );
-			oPair.second->Destroy();
-			oPair.second = nullptr;
-		}
-	}
-
-	std::erase_if( mResources, []( const std::pair< std::string, StrongPtr< Resource > >& oPair ) { return oPair.second == nullptr; } );
-}
-
 void ResourceLoader::DestroyUnusedResources()
 {
-	ProfilerBlock oBlock( "DestroyUnusedResources" );
+	PROFILE_SCOPE( "DestroyUnusedResources" );
 
-	::DestroyUnusedResources( m_mFontResources );
-	::DestroyUnusedResources( m_mTechniqueResources );
-	::DestroyUnusedResources( m_mShaderResources );
-	::DestroyUnusedResources( m_mTextureResources );
-	::DestroyUnusedResources( m_mModelResources );
+	m_oScheduler.DestroyUnusedResources( m_mFontResources );
+	m_oScheduler.DestroyUnusedResources( m_mTechniqueResources );
+	m_oScheduler.DestroyUnusedResources( m_mShaderResources );
+	m_oScheduler.DestroyUnusedResources( m_mTextureResources );
+	m_oScheduler.DestroyUnusedResources( m_mModelResources );
 }
 
 ResourceLoader::FontLoadCommand::FontLoadCommand( const char* sFilePath, const FontResPtr& xResource )
-	: LoadCommand( sFilePath, xResource )
+	: LoadCommand( sFilePath, xResource, STAGE, PRIORITY, "LoadFont" )
 {
 }
 
-void ResourceLoader::FontLoadCommand::Load( std::unique_lock< std::mutex >& oLock )
+void ResourceLoader::FontLoadCommand::Load( const ArrayView< const uint8 > aData )
 {
 	Array< uint8 > aAtlasData( FontResource::ATLAS_WIDTH * FontResource::ATLAS_HEIGHT );
 	Array< stbtt_packedchar > aPackedCharacters( FontResource::GLYPH_COUNT );
 
-	Array< uint8 > aFontData = ReadBinaryFile( GetFilePath() );
-
-	stbtt_pack_context oAtlasContext;
-	stbtt_PackBegin( &oAtlasContext, aAtlasData.Data(), FontResource::ATLAS_WIDTH, FontResource::ATLAS_HEIGHT, 0, 1, nullptr );
-	stbtt_PackFontRange( &oAtlasContext, aFontData.Data(), 0, ( float )FontResource::FONT_HEIGHT, FontResource::FIRST_GLYPH, FontResource::GLYPH_COUNT, aPackedCharacters.Data() );
-	stbtt_PackEnd( &oAtlasContext );
+	bool bPacked = false;
+	if( aData.Empty() == false )
+	{
+		stbtt_pack_context oAtlasContext;
+		stbtt_PackBegin( &oAtlasContext, aAtlasData.Data(), FontResource::ATLAS_WIDTH, FontResource::ATLAS_HEIGHT, 0, 1, nullptr );
+		bPacked = stbtt_PackFontRange( &oAtlasContext, aData.Data(), 0, ( float )FontResource::FONT_HEIGHT, FontResource::FIRST_GLYPH, FontResource::GLYPH_COUNT, aPackedCharacters.Data() ) != 0;
+		stbtt_PackEnd( &oAtlasContext );
+	}
 
-	oLock.lock();
-	m_eStatus = aAtlasData.Empty() == false ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
+	m_eStatus = bPacked ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
 	m_aAtlasData = std::move( aAtlasData );
 	m_aPackedCharacters = std::move( aPackedCharacters );
-	oLock.unlock();
 }
 
 void ResourceLoader::FontLoadCommand::OnFinished()
 {
 	switch( m_eStatus )
 	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	case LoadCommandStatus::FINISHED:
 		m_xResource->m_oAtlas.Create( TextureDesc( FontResource::ATLAS_WIDTH, FontResource::ATLAS_HEIGHT, TextureFormat::R ).Data( m_aAtlasData.Data() ).GenerateMips() );
 		m_xResource->m_aPackedCharacters = std::move( m_aPackedCharacters );
 		m_xResource->m_eStatus = Resource::Status::LOADED;
 		break;
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -517,7 +587,7 @@ void ResourceLoader::FontLoadCommand::OnDependenciesReady()
 }
 
 ResourceLoader::TextureLoadCommand::TextureLoadCommand( const char* sFilePath, const TextureResPtr& xResource, const bool bSRGB, const bool bUse16Bits )
-	: LoadCommand( sFilePath, xResource )
+	: LoadCommand( sFilePath, xResource, STAGE, PRIORITY, "LoadTexture" )
 	, m_iWidth( 0 )
 	, m_iHeight( 0 )
 	, m_iDepth( 0 )
@@ -527,20 +597,42 @@ ResourceLoader::TextureLoadCommand::TextureLoadCommand( const char* sFilePath, c
 {
 }
 
-void ResourceLoader::TextureLoadCommand::Load( std::unique_lock< std::mutex >& oLock )
+ResourceLoader::TextureLoadCommand::~TextureLoadCommand()
+{
+	// Cancelled commands are not finalized
+	stbi_image_free( m_pData );
+}
+
+void ResourceLoader::TextureLoadCommand::Load( const ArrayView< const uint8 > aData )
 {
-	int iWidth;
-	int iHeight;
-	int iDepth;
-	uint8* pData = m_bUse16Bits ? ( uint8* )stbi_load_16( GetFilePath().c_str(), &iWidth, &iHeight, &iDepth, 0 ) : stbi_load( GetFilePath().c_str(), &iWidth, &iHeight, &iDepth, 0 );
+	const uint64 uKey = ComputeDerivedDataKey( m_sCommandName, m_bUse16Bits, aData );
+	if( aData.Empty() == false && LoadDerivedData( uKey ) )
+	{
+		m_eStatus = LoadCommandStatus::LOADED;
+		return;
+	}
+
+	int iWidth = 0;
+	int iHeight = 0;
+	int iDepth = 0;
+	uint8* pData = nullptr;
+
+	if( aData.Empty() == false )
+	{
+		if( m_bUse16Bits )
+			pData = ( uint8* )stbi_load_16_from_memory( aData.Data(), ( int )aData.Count(), &iWidth, &iHeight, &iDepth, 0 );
+		else
+			pData = stbi_load_from_memory( aData.Data(), ( int )aData.Count(), &iWidth, &iHeight, &iDepth, 0 );
+	}
 
-	oLock.lock();
 	m_eStatus = pData != nullptr ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
 	m_iWidth = iWidth;
 	m_iHeight = iHeight;
 	m_iDepth = iDepth;
 	m_pData = pData;
-	oLock.unlock();
+
+	if( pData != nullptr )
+		StoreDerivedData( uKey );
 }
 
 void ResourceLoader::TextureLoadCommand::OnFinished()
@@ -559,13 +651,14 @@ void ResourceLoader::TextureLoadCommand::OnFinished()
 
 	switch( m_eStatus )
 	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	case LoadCommandStatus::FINISHED:
 		m_xResource->m_oTexture.Create( TextureDesc( m_iWidth, m_iHeight, eFormat ).Data( m_pData ).SRGB( m_bSRGB ).GenerateMips() );
 		stbi_image_free( m_pData );
+		m_pData = nullptr;
 		m_xResource->m_eStatus = Resource::Status::LOADED;
 		break;
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -577,43 +670,147 @@ void ResourceLoader::TextureLoadCommand::OnDependenciesReady()
 {
 }
 
+uint64 ResourceLoader::TextureLoadCommand::GetDataSize() const
+{
+	return ( uint64 )m_iWidth * m_iHeight * m_iDepth * ( m_bUse16Bits ? 2 : 1 );
+}
+
+bool ResourceLoader::TextureLoadCommand::LoadDerivedData( const uint64 uKey )
+{
+	MappedFile oMappedFile;
+	ArrayView< const uint8 > aData;
+	if( g_pResourceLoader->m_oDerivedDataCache.Load( uKey, TEXTURE_DERIVED_DATA_VERSION, oMappedFile, aData ) == false )
+		return false;
+
+	BinaryReader oReader( aData );
+	if( oReader.Read( m_iWidth ) == false || oReader.Read( m_iHeight ) == false || oReader.Read( m_iDepth ) == false )
+		return false;
+
+	const uint64 uSize = GetDataSize();
+	if( uSize == 0 || uSize > TEXTURE_DERIVED_DATA_MAX_SIZE || uSize != aData.Count() - 3 * sizeof( int ) )
+		return false;
+
+	// Allocated as stb does, the pixels are freed the same way whether they were decoded or not
+	m_pData = ( uint8* )STBI_MALLOC( uSize );
+	oReader.ReadBytes( m_pData, uSize );
+	return true;
+}
+
+void ResourceLoader::TextureLoadCommand::StoreDerivedData( const uint64 uKey ) const
+{
+	if( GetDataSize() > TEXTURE_DERIVED_DATA_MAX_SIZE )
+		return;
+
+	BinaryWriter oWriter;
+	oWriter.Write( m_iWidth );
+	oWriter.Write( m_iHeight );
+	oWriter.Write( m_iDepth );
+	oWriter.WriteBytes( m_pData, GetDataSize() );
+
+	const Array< uint8 >& aData = oWriter.GetData();
+	g_pResourceLoader->m_oDerivedDataCache.Store( uKey, TEXTURE_DERIVED_DATA_VERSION, ArrayView< const uint8 >( aData.Data(), aData.Count() ) );
+}
+
 ResourceLoader::ModelLoadCommand::ModelLoadCommand( const char* sFilePath, const ModelResPtr& xResource )
-	: LoadCommand( sFilePath, xResource )
+	: LoadCommand( sFilePath, xResource, std::filesystem::path( sFilePath ).extension() == ".mesh" ? LoadStage::MAP : STAGE, PRIORITY, "LoadModel" )
 	, m_pScene( nullptr )
+	, m_uUploadedMeshCount( 0 )
 {
 }
 
-void ResourceLoader::ModelLoadCommand::Load( std::unique_lock< std::mutex >& oLock )
+void ResourceLoader::ModelLoadCommand::Load( const ArrayView< const uint8 > aData )
 {
-	aiScene* pSceneData = nullptr;
+	if( m_eStage == LoadStage::MAP )
+	{
+		m_eStatus = LoadMeshFile() ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
+		return;
+	}
 
-	const aiScene* pScene = g_pResourceLoader->m_oModelImporter.ReadFile( GetFilePath(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace );
-	if( pScene != nullptr )
-		pSceneData = g_pResourceLoader->m_oModelImporter.GetOrphanedScene();
+	// Embedded textures are named after the model, its path is part of what the data is derived from
+	const uint64 uKey = ComputeDerivedDataKey( m_sCommandName, HashData( m_sFilePath.data(), m_sFilePath.length(), MODEL_IMPORT_FLAGS ), aData );
+	if( aData.Empty() == false && LoadDerivedData( uKey ) )
+	{
+		CreateMeshViews();
+		m_eStatus = LoadCommandStatus::LOADED;
+		return;
+	}
 
-	oLock.lock();
-	m_eStatus = pSceneData != nullptr ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
-	m_pScene = pSceneData;
-	oLock.unlock();
+	const bool bImported = Import( aData );
+	if( bImported )
+	{
+		StoreDerivedData( uKey );
+		CreateMeshViews();
+	}
+
+	m_eStatus = bImported ? LoadCommandStatus::LOADED : LoadCommandStatus::ERROR_READING;
 }
 
-void ResourceLoader::ModelLoadCommand::OnFinished()
+bool ResourceLoader::ModelLoadCommand::Import( const ArrayView< const uint8 > aData )
 {
-	switch( m_eStatus )
-	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	aiScene* pSceneData = nullptr;
+
+	// Importers cannot be shared between threads, models are decoded in parallel
+	VirtualIOSystem* pIOSystem = new VirtualIOSystem;
+	pIOSystem->SetPrefetchedFile( GetFilePath(), aData );
+
+	Assimp::Importer oModelImporter;
+	oModelImporter.SetIOHandler( pIOSystem );
+
+	const aiScene* pScene = oModelImporter.ReadFile( GetFilePath(), MODEL_IMPORT_FLAGS );
+	if( pScene != nullptr )
+		pSceneData = oModelImporter.GetOrphanedScene();
+
+	if( pSceneData != nullptr )
 	{
+		m_pScene = pSceneData;
+
 		LoadAnimations();
 		LoadSkeleton();
 		LoadMaterials();
 		LoadMeshes();
+
 		aiReleaseImport( m_pScene );
-		if( HasDependencies() == false )
-			m_xResource->m_eStatus = Resource::Status::LOADED;
-		break;
+		m_pScene = nullptr;
+
+		for( const std::string& sFilePath : pIOSystem->GetOpenedFilePaths() )
+		{
+			m_aSourceFiles.PushBack();
+			m_aSourceFiles.Back().m_sFilePath = sFilePath;
+			m_aSourceFiles.Back().m_uHash = 0;
+			HashSourceFile( sFilePath, m_aSourceFiles.Back().m_uHash );
+		}
+	}
+
+	return pSceneData != nullptr;
+}
+
+void ResourceLoader::ModelLoadCommand::CreateMeshViews()
+{
+	m_aMeshViews.Resize( m_aPackedMeshes.Count() );
+
+	for( uint u = 0; u < m_aPackedMeshes.Count(); ++u )
+	{
+		m_aMeshViews[ u ].m_oPackedMesh = PackedMeshView( m_aPackedMeshes[ u ].m_oPackedMesh );
+		m_aMeshViews[ u ].m_uMaterialIndex = m_aPackedMeshes[ u ].m_uMaterialIndex;
 	}
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+}
+
+void ResourceLoader::ModelLoadCommand::OnFinished()
+{
+	switch( m_eStatus )
+	{
+	case LoadCommandStatus::FINISHED:
+		m_xResource->m_oAABB = m_oAABB;
+		m_xResource->m_aAnimations = std::move( m_aAnimations );
+		m_xResource->m_oSkeleton = std::move( m_oSkeleton );
+		m_xResource->m_aPoseMatrices = std::move( m_aPoseMatrices );
+		m_xResource->m_aSkinMatrices = std::move( m_aSkinMatrices );
+		m_xResource->m_aMeshes.Reserve( m_aMeshViews.Count() );
+		LoadTextures();
+		// The resource is loaded once its meshes are uploaded, see Upload
+		break;
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -625,10 +822,10 @@ void ResourceLoader::ModelLoadCommand::OnDependenciesReady()
 {
 	switch( m_eStatus )
 	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	case LoadCommandStatus::FINISHED:
 		m_xResource->m_eStatus = Resource::Status::LOADED;
 		break;
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -639,17 +836,50 @@ void ResourceLoader::ModelLoadCommand::OnDependenciesReady()
 	m_aDependencies.Clear();
 }
 
+bool ResourceLoader::ModelLoadCommand::Upload( const GameTimePoint oDeadline )
+{
+	// Meshes are uploaded one at a time until the deadline, so that a large model is spread over several frames
+	while( m_uUploadedMeshCount < m_aMeshViews.Count() )
+	{
+		if( std::chrono::high_resolution_clock::now() >= oDeadline )
+			return false;
+
+		PROFILE_SCOPE_DETAILED( "UploadMesh" );
+
+		const ModelMeshView& oMeshView = m_aMeshViews[ m_uUploadedMeshCount ];
+
+		MaterialReference oMaterial;
+		if( oMeshView.m_uMaterialIndex < m_aMaterials.Count() )
+			oMaterial = g_pMaterialManager->CreateMaterial( m_aMaterials[ oMeshView.m_uMaterialIndex ] );
+
+		m_xResource->m_aMeshes.PushBack();
+		m_xResource->m_aMeshes.Back().Create( oMeshView.m_oPackedMesh, oMaterial );
+		++m_uUploadedMeshCount;
+	}
+
+	// The vertex data is not needed anymore
+	m_aMeshViews.Clear();
+	m_aPackedMeshes.Clear();
+	m_oMeshFile.Close();
+	m_oMeshFileData = VirtualFile();
+
+	if( HasDependencies() == false )
+		m_xResource->m_eStatus = Resource::Status::LOADED;
+
+	return true;
+}
+
 void ResourceLoader::ModelLoadCommand::LoadAnimations()
 {
 	m_mNodeIndices[ "SkeletonRoot" ] = 0;
 
-	m_xResource->m_aAnimations.Resize( m_pScene->mNumAnimations );
+	m_aAnimations.Resize( m_pScene->mNumAnimations );
 
 	for( uint uAnimation = 0; uAnimation < m_pScene->mNumAnimations; ++uAnimation )
 	{
 		const aiAnimation* pAnimation = m_pScene->mAnimations[ uAnimation ];
 
-		Animation& oAnimation = m_xResource->m_aAnimations[ uAnimation ];
+		Animation& oAnimation = m_aAnimations[ uAnimation ];
 		oAnimation.m_sName = pAnimation->mName.C_Str();
 		oAnimation.m_fDuration = ( float )( pAnimation->mDuration / pAnimation->mTicksPerSecond );
 		oAnimation.m_aNodeAnimations.Resize( pAnimation->mNumChannels );
@@ -693,12 +923,12 @@ void ResourceLoader::ModelLoadCommand::LoadAnimations()
 
 void ResourceLoader::ModelLoadCommand::LoadSkeleton()
 {
-	m_xResource->m_oSkeleton.m_uMatrixIndex = 0;
+	m_oSkeleton.m_uMatrixIndex = 0;
 
-	m_xResource->m_aPoseMatrices.Resize( ( uint )m_mNodeIndices.size(), glm::mat4( 1.f ) );
-	LoadSkeleton( m_pScene->mRootNode, m_xResource->m_oSkeleton );
+	m_aPoseMatrices.Resize( ( uint )m_mNodeIndices.size(), glm::mat4( 1.f ) );
+	LoadSkeleton( m_pScene->mRootNode, m_oSkeleton );
 
-	m_xResource->m_aSkinMatrices.Resize( ( uint )m_mNodeIndices.size(), glm::mat4( 1.f ) );
+	m_aSkinMatrices.Resize( ( uint )m_mNodeIndices.size(), glm::mat4( 1.f ) );
 }
 
 void ResourceLoader::ModelLoadCommand::LoadMaterials()
@@ -726,49 +956,10 @@ void ResourceLoader::ModelLoadCommand::LoadMaterials()
 
 		pMaterial->Get( AI_MATKEY_SHININESS, m_aMaterials[ u ].m_fShininess );
 
-		if( pMaterial->GetTextureCount( aiTextureType_DIFFUSE ) != 0 )
-		{
-			aiString sFile;
-			if( pMaterial->GetTexture( aiTextureType_DIFFUSE, 0, &sFile ) == AI_SUCCESS )
-			{
-				TextureResPtr xTextureResource = LoadTexture( sFile.C_Str(), true );
-				m_aMaterials[ u ].m_xDiffuseTextureResource = xTextureResource;
-				m_aDependencies.PushBack( xTextureResource.GetPtr() );
-			}
-		}
-
-		if( pMaterial->GetTextureCount( aiTextureType_NORMALS ) != 0 )
-		{
-			aiString sFile;
-			if( pMaterial->GetTexture( aiTextureType_NORMALS, 0, &sFile ) == AI_SUCCESS )
-			{
-				TextureResPtr xTextureResource = LoadTexture( sFile.C_Str() );
-				m_aMaterials[ u ].m_xNormalTextureResource = xTextureResource;
-				m_aDependencies.PushBack( xTextureResource.GetPtr() );
-			}
-		}
-
-		if( pMaterial->GetTextureCount( aiTextureType_SPECULAR ) != 0 )
-		{
-			aiString sFile;
-			if( pMaterial->GetTexture( aiTextureType_SPECULAR, 0, &sFile ) == AI_SUCCESS )
-			{
-				TextureResPtr xTextureResource = LoadTexture( sFile.C_Str() );
-				m_aMaterials[ u ].m_xSpecularTextureResource = xTextureResource;
-				m_aDependencies.PushBack( xTextureResource.GetPtr() );
-			}
-		}
-
-		if( pMaterial->GetTextureCount( aiTextureType_EMISSIVE ) != 0 )
-		{
-			aiString sFile;
-			if( pMaterial->GetTexture( aiTextureType_EMISSIVE, 0, &sFile ) == AI_SUCCESS )
-			{
-				TextureResPtr xTextureResource = LoadTexture( sFile.C_Str() );
-				m_aMaterials[ u ].m_xEmissiveTextureResource = xTextureResource;
-				m_aDependencies.PushBack( xTextureResource.GetPtr() );
-			}
-		}
+		LoadMaterialTexture( u, pMaterial, aiTextureType_DIFFUSE, &LitMaterialData::m_xDiffuseTextureResource, true );
+		LoadMaterialTexture( u, pMaterial, aiTextureType_NORMALS, &LitMaterialData::m_xNormalTextureResource );
+		LoadMaterialTexture( u, pMaterial, aiTextureType_SPECULAR, &LitMaterialData::m_xSpecularTextureResource );
+		LoadMaterialTexture( u, pMaterial, aiTextureType_EMISSIVE, &LitMaterialData::m_xEmissiveTextureResource );
 	}
 }
 
@@ -777,7 +968,7 @@ void ResourceLoader::ModelLoadCommand::LoadMeshes()
 	aiNode* pRoot = m_pScene->mRootNode;
 
 	const uint uMeshCount = CountMeshes( pRoot );
-	m_xResource->m_aMeshes.Reserve( uMeshCount );
+	m_aPackedMeshes.Reserve( uMeshCount );
 	LoadMeshes( pRoot );
 }
 
@@ -846,7 +1037,7 @@ void ResourceLoader::ModelLoadCommand::LoadMesh( aiMesh* pMesh )
 		if( it != m_mNodeIndices.cend() )
 			uBoneIndex = it->second;
 		
-		m_xResource->m_aSkinMatrices[ uBoneIndex ] = AssimpToGLM( pBone->mOffsetMatrix );
+		m_aSkinMatrices[ uBoneIndex ] = AssimpToGLM( pBone->mOffsetMatrix );
 
 		for( uint uWeight = 0; uWeight < pBone->mNumWeights; ++uWeight )
 		{
@@ -863,21 +1054,19 @@ void ResourceLoader::ModelLoadCommand::LoadMesh( aiMesh* pMesh )
 		}
 	}
 
-	FitAxisAlignedBox( m_xResource->m_oAABB, aVertices );
+	m_aPackedMeshes.PushBack();
+
+	PackedModelMesh& oPackedModelMesh = m_aPackedMeshes.Back();
+	FitAxisAlignedBox( oPackedModelMesh.m_oAABB, aVertices );
+	FitAxisAlignedBox( m_oAABB, aVertices );
 
-	MeshBuilder oMeshBuilder = MeshBuilder( std::move( aVertices ), std::move( aIndices ) )
+	oPackedModelMesh.m_oPackedMesh = MeshBuilder( std::move( aVertices ), std::move( aIndices ) )
 		.WithUVs( std::move( aUVs ) )
 		.WithNormals( std::move( aNormals ) )
 		.WithTangents( std::move( aTangents ) )
-		.WithSkinData( std::move( aSkinData ) );
-
-	if( pMesh->mMaterialIndex >= 0 && pMesh->mMaterialIndex < m_aMaterials.Count() )
-	{
-		const MaterialReference oMaterial = g_pMaterialManager->CreateMaterial( m_aMaterials[ pMesh->mMaterialIndex ] );
-		oMeshBuilder.WithMaterial( oMaterial );
-	}
-
-	m_xResource->m_aMeshes.PushBack( oMeshBuilder.Build() );
+		.WithSkinData( std::move( aSkinData ) )
+		.Pack();
+	oPackedModelMesh.m_uMaterialIndex = pMesh->mMaterialIndex;
 }
 
 void ResourceLoader::ModelLoadCommand::LoadSkeleton( aiNode* pNode, Skeleton& oParent )
@@ -901,40 +1090,390 @@ void ResourceLoader::ModelLoadCommand::LoadSkeleton( aiNode* pNode, Skeleton& oP
 		const uint uNodeIndex = FetchNodeIndex( sNodeName );
 		oSkeleton.m_uMatrixIndex = uNodeIndex;
 
-		if( uNodeIndex >= m_xResource->m_aPoseMatrices.Count() )
-			m_xResource->m_aPoseMatrices.Resize( uNodeIndex + 1 );
+		if( uNodeIndex >= m_aPoseMatrices.Count() )
+			m_aPoseMatrices.Resize( uNodeIndex + 1 );
 
-		m_xResource->m_aPoseMatrices[ uNodeIndex ] = AssimpToGLM( pNode->mTransformation );
+		m_aPoseMatrices[ uNodeIndex ] = AssimpToGLM( pNode->mTransformation );
 	}
 }
 
-TextureResPtr ResourceLoader::ModelLoadCommand::LoadTexture( const std::string& sFileName, const bool bSRGB /*= false*/ )
+void ResourceLoader::ModelLoadCommand::LoadMaterialTexture( const uint uMaterialIndex, const aiMaterial* pMaterial, const int iTextureType, TextureResPtr LitMaterialData::* pTextureResource, const bool bSRGB /*= false*/ )
 {
-	int uTextureIndex = -1;
+	const aiTextureType eTextureType = ( aiTextureType )iTextureType;
+	if( pMaterial->GetTextureCount( eTextureType ) == 0 )
+		return;
+
+	aiString sFile;
+	if( pMaterial->GetTexture( eTextureType, 0, &sFile ) != AI_SUCCESS )
+		return;
+
+	m_aMaterialTextures.PushBack();
+
+	MaterialTexture& oMaterialTexture = m_aMaterialTextures.Back();
+	oMaterialTexture.m_uMaterialIndex = uMaterialIndex;
+	oMaterialTexture.m_pTextureResource = pTextureResource;
+	oMaterialTexture.m_sFilePath = sFile.C_Str();
+	oMaterialTexture.m_bSRGB = bSRGB;
+
+	// Embedded textures are copied, the scene is released before the textures are loaded
 	for( uint u = 0; u < m_pScene->mNumTextures; ++u )
 	{
-		if( sFileName == m_pScene->mTextures[ u ]->mFilename.C_Str() )
+		const aiTexture* pTexture = m_pScene->mTextures[ u ];
+		if( oMaterialTexture.m_sFilePath != pTexture->mFilename.C_Str() )
+			continue;
+
+		const uint64 uOffset = oMaterialTexture.m_sFilePath.find( ".fbm/" );
+		if( uOffset != std::string::npos )
+			Replace( oMaterialTexture.m_sFilePath, oMaterialTexture.m_sFilePath.substr( 0, uOffset + 5 ), GetFilePath() + "@" );
+
+		const uint8* pData = ( const uint8* )pTexture->pcData;
+		oMaterialTexture.m_aEmbeddedData.Resize( pTexture->mWidth );
+		memcpy( oMaterialTexture.m_aEmbeddedData.Data(), pData, pTexture->mWidth );
+		break;
+	}
+}
+
+void ResourceLoader::ModelLoadCommand::LoadTextures()
+{
+	// Embedded textures are decoded on the decode threads like the others, the model waits for all of them through its dependencies
+	for( MaterialTexture& oMaterialTexture : m_aMaterialTextures )
+	{
+		TextureResPtr xTextureResource;
+		if( oMaterialTexture.m_aEmbeddedData.Empty() )
+			xTextureResource = g_pResourceLoader->LoadTexture( oMaterialTexture.m_sFilePath.c_str(), oMaterialTexture.m_bSRGB, false, m_ePriority );
+		else
+			xTextureResource = g_pResourceLoader->LoadTexture( oMaterialTexture.m_sFilePath.c_str(), std::move( oMaterialTexture.m_aEmbeddedData ), oMaterialTexture.m_bSRGB, false, m_ePriority );
+
+		m_aMaterials[ oMaterialTexture.m_uMaterialIndex ].*oMaterialTexture.m_pTextureResource = xTextureResource;
+		m_aDependencies.PushBack( xTextureResource.GetPtr() );
+	}
+
+	m_aMaterialTextures.Clear();
+}
+
+bool ResourceLoader::ModelLoadCommand::LoadDerivedData( const uint64 uKey )
+{
+	MappedFile oMappedFile;
+	ArrayView< const uint8 > aData;
+	if( g_pResourceLoader->m_oDerivedDataCache.Load( uKey, MODEL_DERIVED_DATA_VERSION, oMappedFile, aData ) == false )
+		return false;
+
+	BinaryReader oReader( aData );
+	if( ReadDerivedData( oReader ) && oReader.IsAtEnd() )
+		return true;
+
+	// What was read before the failure is dropped, the model is imported again
+	m_aSourceFiles.Clear();
+	m_aMaterials.Clear();
+	m_aMaterialTextures.Clear();
+	m_aPackedMeshes.Clear();
+	m_oAABB = AxisAlignedBox();
+	m_aAnimations.Clear();
+	m_oSkeleton = Skeleton();
+	m_aPoseMatrices.Clear();
+	m_aSkinMatrices.Clear();
+	return false;
+}
+
+void ResourceLoader::ModelLoadCommand::StoreDerivedData( const uint64 uKey ) const
+{
+	BinaryWriter oWriter;
+	WriteDerivedData( oWriter );
+
+	const Array< uint8 >& aData = oWriter.GetData();
+	g_pResourceLoader->m_oDerivedDataCache.Store( uKey, MODEL_DERIVED_DATA_VERSION, ArrayView< const uint8 >( aData.Data(), aData.Count() ) );
+}
+
+void ResourceLoader::ModelLoadCommand::WriteDerivedData( BinaryWriter& oWriter ) const
+{
+	oWriter.Write( m_aSourceFiles.Count() );
+	for( const SourceFile& oSourceFile : m_aSourceFiles )
+	{
+		oWriter.WriteString( oSourceFile.m_sFilePath );
+		oWriter.Write( oSourceFile.m_uHash );
+	}
+
+	oWriter.Write( m_oAABB );
+
+	oWriter.Write( m_aAnimations.Count() );
+	for( const Animation& oAnimation : m_aAnimations )
+	{
+		oWriter.WriteString( oAnimation.m_sName );
+		oWriter.Write( oAnimation.m_fDuration );
+
+		oWriter.Write( oAnimation.m_aNodeAnimations.Count() );
+		for( const NodeAnimation& oNodeAnimation : oAnimation.m_aNodeAnimations )
 		{
-			uTextureIndex = ( int )u;
-			break;
+			WriteAnimationCurve( oWriter, oNodeAnimation.m_oPositionCurve );
+			WriteAnimationCurve( oWriter, oNodeAnimation.m_oRotationCurve );
+			WriteAnimationCurve( oWriter, oNodeAnimation.m_oScaleCurve );
+			oWriter.Write( oNodeAnimation.m_uMatrixIndex );
 		}
 	}
 
-	if( uTextureIndex != -1 )
+	WriteSkeleton( oWriter, m_oSkeleton );
+	oWriter.WriteArray( m_aPoseMatrices );
+	oWriter.WriteArray( m_aSkinMatrices );
+
+	oWriter.Write( m_aMaterials.Count() );
+	for( const LitMaterialData& oMaterial : m_aMaterials )
 	{
-		aiTexture* pTexture = m_pScene->mTextures[ uTextureIndex ];
+		oWriter.Write( oMaterial.m_oDiffuseColor.m_vColor );
+		oWriter.Write( oMaterial.m_oSpecularColor.m_vColor );
+		oWriter.Write( oMaterial.m_oEmissiveColor.m_vColor );
+		oWriter.Write( oMaterial.m_fShininess );
+	}
 
-		std::string sInternalFileName = sFileName;
-		const uint64 uOffset = sFileName.find( ".fbm/" );
-		if( uOffset != std::string::npos )
-			Replace( sInternalFileName, sInternalFileName.substr( 0, uOffset + 5 ), GetFilePath() + "@" );
+	oWriter.Write( m_aMaterialTextures.Count() );
+	for( const MaterialTexture& oMaterialTexture : m_aMaterialTextures )
+	{
+		oWriter.Write( oMaterialTexture.m_uMaterialIndex );
+		oWriter.Write( GetMaterialTextureSlot( oMaterialTexture.m_pTextureResource ) );
+		oWriter.WriteString( oMaterialTexture.m_sFilePath );
+		oWriter.WriteArray( oMaterialTexture.m_aEmbeddedData );
+		oWriter.Write( oMaterialTexture.m_bSRGB );
+	}
 
-		return g_pResourceLoader->LoadTexture( sInternalFileName.c_str(), ( uint8* )pTexture->pcData, pTexture->mWidth, bSRGB );
+	oWriter.Write( m_aPackedMeshes.Count() );
+	for( const PackedModelMesh& oPackedModelMesh : m_aPackedMeshes )
+	{
+		const PackedMesh& oPackedMesh = oPackedModelMesh.m_oPackedMesh;
+		oWriter.WriteArray( oPackedMesh.m_aVertices );
+		oWriter.WriteArray( oPackedMesh.m_aIndices );
+		oWriter.Write( oPackedMesh.m_uUVsSize );
+		oWriter.Write( oPackedMesh.m_uNormalsSize );
+		oWriter.Write( oPackedMesh.m_uTangentsSize );
+		oWriter.Write( oPackedMesh.m_uBonesSize );
+		oWriter.Write( oPackedMesh.m_uWeightsSize );
+		oWriter.Write( oPackedModelMesh.m_uMaterialIndex );
+		oWriter.Write( oPackedModelMesh.m_oAABB );
 	}
-	else
+}
+
+bool ResourceLoader::ModelLoadCommand::ReadDerivedData( BinaryReader& oReader )
+{
+	// Elements are added as they are read, a count read from a damaged entry does not allocate more than there is data for
+	uint uCount = 0;
+
+	if( oReader.Read( uCount ) == false )
+		return false;
+
+	for( uint u = 0; u < uCount; ++u )
+	{
+		m_aSourceFiles.PushBack();
+		SourceFile& oSourceFile = m_aSourceFiles.Back();
+		if( oReader.ReadString( oSourceFile.m_sFilePath ) == false || oReader.Read( oSourceFile.m_uHash ) == false )
+			return false;
+
+		// The data is outdated as soon as one of the files referenced by the model changes
+		uint64 uHash = 0;
+		if( HashSourceFile( oSourceFile.m_sFilePath, uHash ) == false || uHash != oSourceFile.m_uHash )
+			return false;
+	}
+
+	if( oReader.Read( m_oAABB ) == false || oReader.Read( uCount ) == false )
+		return false;
+
+	for( uint uAnimation = 0; uAnimation < uCount; ++uAnimation )
+	{
+		m_aAnimations.PushBack( Animation() );
+		Animation& oAnimation = m_aAnimations.Back();
+
+		uint uNodeAnimationCount = 0;
+		if( oReader.ReadString( oAnimation.m_sName ) == false || oReader.Read( oAnimation.m_fDuration ) == false || oReader.Read( uNodeAnimationCount ) == false )
+			return false;
+
+		for( uint u = 0; u < uNodeAnimationCount; ++u )
+		{
+			oAnimation.m_aNodeAnimations.PushBack( NodeAnimation() );
+			NodeAnimation& oNodeAnimation = oAnimation.m_aNodeAnimations.Back();
+
+			if( ReadAnimationCurve( oReader, oNodeAnimation.m_oPositionCurve ) == false
+				|| ReadAnimationCurve( oReader, oNodeAnimation.m_oRotationCurve ) == false
+				|| ReadAnimationCurve( oReader, oNodeAnimation.m_oScaleCurve ) == false
+				|| oReader.Read( oNodeAnimation.m_uMatrixIndex ) == false )
+				return false;
+		}
+	}
+
+	if( ReadSkeleton( oReader, m_oSkeleton ) == false || oReader.ReadArray( m_aPoseMatrices ) == false || oReader.ReadArray( m_aSkinMatrices ) == false )
+		return false;
+
+	if( oReader.Read( uCount ) == false )
+		return false;
+
+	for( uint u = 0; u < uCount; ++u )
+	{
+		m_aMaterials.PushBack( LitMaterialData() );
+		LitMaterialData& oMaterial = m_aMaterials.Back();
+
+		if( oReader.Read( oMaterial.m_oDiffuseColor.m_vColor ) == false
+			|| oReader.Read( oMaterial.m_oSpecularColor.m_vColor ) == false
+			|| oReader.Read( oMaterial.m_oEmissiveColor.m_vColor ) == false
+			|| oReader.Read( oMaterial.m_fShininess ) == false )
+			return false;
+	}
+
+	if( oReader.Read( uCount ) == false )
+		return false;
+
+	for( uint u = 0; u < uCount; ++u )
+	{
+		m_aMaterialTextures.PushBack();
+		MaterialTexture& oMaterialTexture = m_aMaterialTextures.Back();
+
+		uint uSlot = 0;
+		if( oReader.Read( oMaterialTexture.m_uMaterialIndex ) == false
+			|| oReader.Read( uSlot ) == false
+			|| oReader.ReadString( oMaterialTexture.m_sFilePath ) == false
+			|| oReader.ReadArray( oMaterialTexture.m_aEmbeddedData ) == false
+			|| oReader.Read( oMaterialTexture.m_bSRGB ) == false )
+			return false;
+
+		if( oMaterialTexture.m_uMaterialIndex >= m_aMaterials.Count() || uSlot >= std::size( MATERIAL_TEXTURE_SLOTS ) )
+			return false;
+
+		oMaterialTexture.m_pTextureResource = MATERIAL_TEXTURE_SLOTS[ uSlot ];
+	}
+
+	if( oReader.Read( uCount ) == false )
+		return false;
+
+	for( uint u = 0; u < uCount; ++u )
+	{
+		m_aPackedMeshes.PushBack();
+		PackedModelMesh& oPackedModelMesh = m_aPackedMeshes.Back();
+		PackedMesh& oPackedMesh = oPackedModelMesh.m_oPackedMesh;
+
+		if( oReader.ReadArray( oPackedMesh.m_aVertices ) == false
+			|| oReader.ReadArray( oPackedMesh.m_aIndices ) == false
+			|| oReader.Read( oPackedMesh.m_uUVsSize ) == false
+			|| oReader.Read( oPackedMesh.m_uNormalsSize ) == false
+			|| oReader.Read( oPackedMesh.m_uTangentsSize ) == false
+			|| oReader.Read( oPackedMesh.m_uBonesSize ) == false
+			|| oReader.Read( oPackedMesh.m_uWeightsSize ) == false
+			|| oReader.Read( oPackedModelMesh.m_uMaterialIndex ) == false
+			|| oReader.Read( oPackedModelMesh.m_oAABB ) == false )
+			return false;
+	}
+
+	return true;
+}
+
+bool ResourceLoader::ModelLoadCommand::LoadMeshFile()
+{
+	static_assert( sizeof( GLuint ) == sizeof( uint32 ) );
+
+	// Loose files are mapped, files of a pack are used in place unless they are compressed
+	m_oMeshFileData = g_pVirtualFileSystem->Open( GetFilePath() );
+	if( m_oMeshFileData.IsOpen() == false || m_oMeshFile.Open( m_oMeshFileData.GetData() ) == false )
+		return false;
+
+	const MeshFileBox& oAABB = m_oMeshFile.GetAABB();
+	m_oAABB.m_vMin = glm::vec3( oAABB.m_aMin[ 0 ], oAABB.m_aMin[ 1 ], oAABB.m_aMin[ 2 ] );
+	m_oAABB.m_vMax = glm::vec3( oAABB.m_aMax[ 0 ], oAABB.m_aMax[ 1 ], oAABB.m_aMax[ 2 ] );
+
+	ReadMeshFileAnimations( m_oMeshFile, m_oSkeleton, m_aPoseMatrices, m_aSkinMatrices, m_aAnimations );
+
+	const ArrayView< const MeshFileMaterial > aMaterials = m_oMeshFile.GetMaterials();
+	m_aMaterials.Resize( aMaterials.Count() );
+
+	for( uint u = 0; u < aMaterials.Count(); ++u )
+	{
+		const MeshFileMaterial& oMeshFileMaterial = aMaterials[ u ];
+		m_aMaterials[ u ].m_oDiffuseColor = Color( oMeshFileMaterial.m_aDiffuseColor[ 0 ], oMeshFileMaterial.m_aDiffuseColor[ 1 ], oMeshFileMaterial.m_aDiffuseColor[ 2 ] );
+		m_aMaterials[ u ].m_oSpecularColor = Color( oMeshFileMaterial.m_aSpecularColor[ 0 ], oMeshFileMaterial.m_aSpecularColor[ 1 ], oMeshFileMaterial.m_aSpecularColor[ 2 ] );
+		m_aMaterials[ u ].m_oEmissiveColor = Color( oMeshFileMaterial.m_aEmissiveColor[ 0 ], oMeshFileMaterial.m_aEmissiveColor[ 1 ], oMeshFileMaterial.m_aEmissiveColor[ 2 ] );
+		m_aMaterials[ u ].m_fShininess = oMeshFileMaterial.m_fShininess;
+	}
+
+	for( const MeshFileMaterialTexture& oMeshFileMaterialTexture : m_oMeshFile.GetMaterialTextures() )
 	{
-		return g_pResourceLoader->LoadTexture( sFileName.c_str(), bSRGB );
+		if( oMeshFileMaterialTexture.m_uSlot >= std::size( MATERIAL_TEXTURE_SLOTS ) )
+			return false;
+
+		m_aMaterialTextures.PushBack();
+
+		MaterialTexture& oMaterialTexture = m_aMaterialTextures.Back();
+		oMaterialTexture.m_uMaterialIndex = oMeshFileMaterialTexture.m_uMaterialIndex;
+		oMaterialTexture.m_pTextureResource = MATERIAL_TEXTURE_SLOTS[ oMeshFileMaterialTexture.m_uSlot ];
+		oMaterialTexture.m_sFilePath = m_oMeshFile.GetString( oMeshFileMaterialTexture.m_oPath );
+		oMaterialTexture.m_bSRGB = oMeshFileMaterialTexture.m_uSRGB != 0;
+		CopyMeshFileValues( m_oMeshFile.GetBlob( oMeshFileMaterialTexture.m_oEmbeddedData ), MeshFileRange { 0, oMeshFileMaterialTexture.m_oEmbeddedData.m_uCount }, oMaterialTexture.m_aEmbeddedData );
 	}
+
+	// The vertices and indices are not copied, they are uploaded from the file
+	const ArrayView< const MeshFileSubmesh > aSubmeshes = m_oMeshFile.GetSubmeshes();
+	m_aMeshViews.Resize( aSubmeshes.Count() );
+
+	for( uint u = 0; u < aSubmeshes.Count(); ++u )
+	{
+		const MeshFileSubmesh& oSubmesh = aSubmeshes[ u ];
+		const ArrayView< const uint32 > aIndices = m_oMeshFile.GetIndices( oSubmesh );
+
+		PackedMeshView& oPackedMesh = m_aMeshViews[ u ].m_oPackedMesh;
+		oPackedMesh.m_aVertices = m_oMeshFile.GetVertices( oSubmesh );
+		oPackedMesh.m_aIndices = ArrayView< const GLuint >( ( const GLuint* )aIndices.Data(), aIndices.Count() );
+		oPackedMesh.m_uUVsSize = oSubmesh.m_uUVsSize;
+		oPackedMesh.m_uNormalsSize = oSubmesh.m_uNormalsSize;
+		oPackedMesh.m_uTangentsSize = oSubmesh.m_uTangentsSize;
+		oPackedMesh.m_uBonesSize = oSubmesh.m_uBonesSize;
+		oPackedMesh.m_uWeightsSize = oSubmesh.m_uWeightsSize;
+		m_aMeshViews[ u ].m_uMaterialIndex = oSubmesh.m_uMaterialIndex;
+	}
+
+	return true;
+}
+
+bool ResourceLoader::ModelLoadCommand::ExportMeshFile( const std::filesystem::path& oFilePath ) const
+{
+	MeshFileData oData;
+	oData.m_oAABB = ToMeshFileBox( m_oAABB );
+
+	for( const PackedModelMesh& oPackedModelMesh : m_aPackedMeshes )
+	{
+		const PackedMesh& oPackedMesh = oPackedModelMesh.m_oPackedMesh;
+
+		MeshFileSubmesh oSubmesh;
+		oSubmesh.m_oVertices = AppendMeshFileValues( oData.m_aVertices, oPackedMesh.m_aVertices );
+		oSubmesh.m_oIndices = AppendMeshFileValues( oData.m_aIndices, oPackedMesh.m_aIndices );
+		oSubmesh.m_uUVsSize = oPackedMesh.m_uUVsSize;
+		oSubmesh.m_uNormalsSize = oPackedMesh.m_uNormalsSize;
+		oSubmesh.m_uTangentsSize = oPackedMesh.m_uTangentsSize;
+		oSubmesh.m_uBonesSize = oPackedMesh.m_uBonesSize;
+		oSubmesh.m_uWeightsSize = oPackedMesh.m_uWeightsSize;
+		oSubmesh.m_uMaterialIndex = oPackedModelMesh.m_uMaterialIndex;
+		oSubmesh.m_oAABB = ToMeshFileBox( oPackedModelMesh.m_oAABB );
+		oData.m_aSubmeshes.PushBack( oSubmesh );
+	}
+
+	WriteMeshFileAnimations( oData, m_oSkeleton, m_aPoseMatrices, m_aSkinMatrices, m_aAnimations );
+
+	for( const LitMaterialData& oMaterial : m_aMaterials )
+	{
+		const glm::vec3& vDiffuseColor = oMaterial.m_oDiffuseColor.m_vColor;
+		const glm::vec3& vSpecularColor = oMaterial.m_oSpecularColor.m_vColor;
+		const glm::vec3& vEmissiveColor = oMaterial.m_oEmissiveColor.m_vColor;
+
+		oData.m_aMaterials.PushBack( MeshFileMaterial {
+			{ vDiffuseColor.r, vDiffuseColor.g, vDiffuseColor.b },
+			{ vSpecularColor.r, vSpecularColor.g, vSpecularColor.b },
+			{ vEmissiveColor.r, vEmissiveColor.g, vEmissiveColor.b },
+			oMaterial.m_fShininess } );
+	}
+
+	for( const MaterialTexture& oMaterialTexture : m_aMaterialTextures )
+	{
+		MeshFileMaterialTexture oMeshFileMaterialTexture;
+		oMeshFileMaterialTexture.m_uMaterialIndex = oMaterialTexture.m_uMaterialIndex;
+		oMeshFileMaterialTexture.m_uSlot = GetMaterialTextureSlot( oMaterialTexture.m_pTextureResource );
+		oMeshFileMaterialTexture.m_oPath = oData.AddBlob( oMaterialTexture.m_sFilePath.data(), ( uint )oMaterialTexture.m_sFilePath.length() );
+		oMeshFileMaterialTexture.m_oEmbeddedData = oData.AddBlob( oMaterialTexture.m_aEmbeddedData.Data(), oMaterialTexture.m_aEmbeddedData.Count() );
+		oMeshFileMaterialTexture.m_uSRGB = oMaterialTexture.m_bSRGB ? 1 : 0;
+		oData.m_aMaterialTextures.PushBack( oMeshFileMaterialTexture );
+	}
+
+	return WriteMeshFile( oFilePath, oData );
 }
 
 uint ResourceLoader::ModelLoadCommand::FetchNodeIndex( const std::string& sName )
@@ -951,7 +1490,7 @@ uint ResourceLoader::ModelLoadCommand::FetchNodeIndex( const std::string& sName
 }
 
 ResourceLoader::ShaderLoadCommand::ShaderLoadCommand( const char* sFilePath, const ShaderResPtr& xResource, Array< std::string >&& aFlags )
-	: LoadCommand( sFilePath, xResource )
+	: LoadCommand( sFilePath, xResource, STAGE, PRIORITY, "LoadShader" )
 	, m_eShaderType( ShaderType::UNDEFINED )
 	, m_aFlags( aFlags )
 {
@@ -964,26 +1503,24 @@ ResourceLoader::ShaderLoadCommand::ShaderLoadCommand( const char* sFilePath, con
 		m_eShaderType = ShaderType::COMPUTE_SHADER;
 }
 
-void ResourceLoader::ShaderLoadCommand::Load( std::unique_lock< std::mutex >& oLock )
+void ResourceLoader::ShaderLoadCommand::Load( const ArrayView< const uint8 > aData )
 {
-	std::string sContent = ReadTextFile( GetFilePath() );
+	std::string sContent( ( const char* )aData.Data(), aData.Count() );
 
-	oLock.lock();
 	m_eStatus = LoadCommandStatus::LOADED;
 	m_sShaderCode = std::move( sContent );
-	oLock.unlock();
 }
 
 void ResourceLoader::ShaderLoadCommand::OnFinished()
 {
 	switch( m_eStatus )
 	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	case LoadCommandStatus::FINISHED:
 		m_xResource->m_oShader.Create( m_sShaderCode, m_eShaderType, m_aFlags );
 		m_xResource->m_eStatus = Resource::Status::LOADED;
 		break;
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -996,13 +1533,12 @@ void ResourceLoader::ShaderLoadCommand::OnDependenciesReady()
 }
 
 ResourceLoader::TechniqueLoadCommand::TechniqueLoadCommand( const char* sFilePath, const TechniqueResPtr& xResource )
-	: LoadCommand( sFilePath, xResource )
+	: LoadCommand( sFilePath, xResource, STAGE, PRIORITY, "LoadTechnique" )
 {
 }
 
-void ResourceLoader::TechniqueLoadCommand::Load( std::unique_lock< std::mutex >& oLock )
+void ResourceLoader::TechniqueLoadCommand::Load( const ArrayView< const uint8 > aData )
 {
-	std::string sContent = ReadTextFile( GetFilePath() );
 
 	std::string sVertexShader;
 	std::string sPixelShader;
@@ -1015,7 +1551,7 @@ void ResourceLoader::TechniqueLoadCommand::Load( std::unique_lock< std::mutex >&
 
 	try
 	{
-		const nlohmann::json oJsonContent = nlohmann::json::parse( sContent );
+		const nlohmann::json oJsonContent = nlohmann::json::parse( std::string_view( ( const char* )aData.Data(), aData.Count() ) );
 
 		if( oJsonContent.contains( "computeShader" ) )
 		{
@@ -1056,11 +1592,10 @@ void ResourceLoader::TechniqueLoadCommand::Load( std::unique_lock< std::mutex >&
 	}
 	catch( const std::exception& oException )
 	{
-		LOG_ERROR( "{} : {}", GetFilePath(), oException.what() );
+		SLOG_ERROR( LogCategory::RESOURCES, "{} : {}", GetFilePath(), oException.what() );
 		bSuccess = false;
 	}
 
-	oLock.lock();
 	if( bSuccess )
 	{
 		m_eStatus = LoadCommandStatus::LOADED;
@@ -1081,19 +1616,18 @@ void ResourceLoader::TechniqueLoadCommand::Load( std::unique_lock< std::mutex >&
 	{
 		m_eStatus = LoadCommandStatus::ERROR_READING;
 	}
-	oLock.unlock();
 }
 
 void ResourceLoader::TechniqueLoadCommand::OnFinished()
 {
 	switch( m_eStatus )
 	{
-	case ResourceLoader::LoadCommandStatus::FINISHED:
+	case LoadCommandStatus::FINISHED:
 		for( const std::string& sShader : m_aShaders )
-			m_aDependencies.PushBack( g_pResourceLoader->LoadShader( sShader.c_str() ).GetPtr() );
+			m_aDependencies.PushBack( g_pResourceLoader->LoadShader( sShader.c_str(), m_ePriority ).GetPtr() );
 		break;
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -1121,8 +1655,8 @@ void ResourceLoader::TechniqueLoadCommand::OnDependenciesReady()
 
 		break;
 	}
-	case ResourceLoader::LoadCommandStatus::NOT_FOUND:
-	case ResourceLoader::LoadCommandStatus::ERROR_READING:
+	case LoadCommandStatus::NOT_FOUND:
+	case LoadCommandStatus::ERROR_READING:
 		m_xResource->m_eStatus = Resource::Status::FAILED;
 		break;
 	default:
@@ -1131,70 +1665,3 @@ void ResourceLoader::TechniqueLoadCommand::OnDependenciesReady()
 
 	m_xResource->m_aShaderResources = std::move( m_aDependencies );
 }
-
-uint ResourceLoader::LoadCommands::Count() const
-{
-	return m_aFontLoadCommands.Count() + m_aTextureLoadCommands.Count() + m_aModelLoadCommands.Count() + m_aShaderLoadCommands.Count() + m_aTechniqueLoadCommands.Count();
-}
-
-bool ResourceLoader::LoadCommands::Empty() const
-{
-	return m_aFontLoadCommands.Empty() && m_aTextureLoadCommands.Empty() && m_aModelLoadCommands.Empty() && m_aShaderLoadCommands.Empty() && m_aTechniqueLoadCommands.Empty();
-}
-
-void ResourceLoader::LoadCommands::Grab( LoadCommands& oLoadCommands )
-{
-	m_aFontLoadCommands.Grab( oLoadCommands.m_aFontLoadCommands );
-	m_aTextureLoadCommands.Grab( oLoadCommands.m_aTextureLoadCommands );
-	m_aModelLoadCommands.Grab( oLoadCommands.m_aModelLoadCommands );
-	m_aShaderLoadCommands.Grab( oLoadCommands.m_aShaderLoadCommands );
-	m_aTechniqueLoadCommands.Grab( oLoadCommands.m_aTechniqueLoadCommands );
-}
-
-void ResourceLoader::LoadCommands::CopyWaitingDependencies( LoadCommands& oLoadCommands )
-{
-	m_aFontLoadCommands.Expand( oLoadCommands.m_aFontLoadCommands.Count() );
-	m_aTextureLoadCommands.Expand( oLoadCommands.m_aTextureLoadCommands.Count() );
-	m_aModelLoadCommands.Expand( oLoadCommands.m_aModelLoadCommands.Count() );
-	m_aShaderLoadCommands.Expand( oLoadCommands.m_aShaderLoadCommands.Count() );
-	m_aTechniqueLoadCommands.Expand( oLoadCommands.m_aTechniqueLoadCommands.Count() );
-
-	for( const FontLoadCommand& oLoadCommand : oLoadCommands.m_aFontLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
-			m_aFontLoadCommands.PushBack( oLoadCommand );
-	}
-
-	for( const TextureLoadCommand& oLoadCommand : oLoadCommands.m_aTextureLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
-			m_aTextureLoadCommands.PushBack( oLoadCommand );
-	}
-
-	for( const ModelLoadCommand& oLoadCommand : oLoadCommands.m_aModelLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
-			m_aModelLoadCommands.PushBack( oLoadCommand );
-	}
-
-	for( const ShaderLoadCommand& oLoadCommand : oLoadCommands.m_aShaderLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
-			m_aShaderLoadCommands.PushBack( oLoadCommand );
-	}
-
-	for( const TechniqueLoadCommand& oLoadCommand : oLoadCommands.m_aTechniqueLoadCommands )
-	{
-		if( oLoadCommand.m_eStatus == LoadCommandStatus::WAITING_DEPENDENCIES )
-			m_aTechniqueLoadCommands.PushBack( oLoadCommand );
-	}
-}
-
-void ResourceLoader::LoadCommands::Clear()
-{
-	m_aFontLoadCommands.Clear();
-	m_aTextureLoadCommands.Clear();
-	m_aModelLoadCommands.Clear();
-	m_aShaderLoadCommands.Clear();
-	m_aTechniqueLoadCommands.Clear();
-}
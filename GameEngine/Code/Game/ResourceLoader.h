@@ -1,21 +1,25 @@
 #pragma once
 
-#include <condition_variable>
 #include <format>
-#include <mutex>
-#include <thread>
 #include <unordered_map>
 
-#include <assimp/Importer.hpp>
-
 #include "Animation.h"
 #include "Core/Array.h"
+#include "Core/DerivedDataCache.h"
 #include "Core/Intrusive.h"
+#include "Core/LoadScheduler.h"
+#include "Core/MeshFile.h"
 #include "Core/stb_truetype.h"
+#include "Core/Time.h"
+#include "Core/VirtualFileSystem.h"
 #include "Graphics/Material.h"
+#include "Graphics/Mesh.h"
 #include "Graphics/Shader.h"
 #include "ResourceTypes.h"
 
+class BinaryReader;
+class BinaryWriter;
+struct aiMaterial;
 struct aiMesh;
 struct aiNode;
 struct aiScene;
@@ -23,26 +27,27 @@ struct aiScene;
 class ResourceLoader
 {
 public:
-	template < typename LoadCommand >
-	friend void Load( Array< LoadCommand >& aLoadCommands, std::unique_lock< std::mutex >& oLock, const char* sCommandName );
-
-	template < typename LoadCommand >
-	friend uint CheckFinishedProcessingLoadCommands( Array< LoadCommand >& aLoadCommands );
-
-	template < typename LoadCommand >
-	friend uint CheckWaitingDependenciesLoadCommands( Array< LoadCommand >& aLoadCommands );
-
 	friend class GameWorld;
 
 	ResourceLoader();
 	~ResourceLoader();
 
-	FontResPtr		LoadFont( const char* sFilePath );
-	TextureResPtr	LoadTexture( const char* sFilePath, const bool bSRGB = false, const bool bUse16Bits = false );
-	TextureResPtr	LoadTexture( const char* sFilePath, const uint8* pData, const uint uDataSize, const bool bSRGB = false, const bool bUse16Bits = false );
-	ModelResPtr		LoadModel( const char* sFilePath );
-	ShaderResPtr	LoadShader( const char* sFilePath );
-	TechniqueResPtr LoadTechnique( const char* sFilePath );
+	FontResPtr		LoadFont( const char* sFilePath, const LoadPriority ePriority = LoadPriority::NORMAL );
+	TextureResPtr	LoadTexture( const char* sFilePath, const bool bSRGB = false, const bool bUse16Bits = false, const LoadPriority ePriority = LoadPriority::NORMAL );
+	// Decodes data already in memory, such as the textures embedded in a model, on the decode threads
+	TextureResPtr	LoadTexture( const char* sFilePath, Array< uint8 >&& aData, const bool bSRGB = false, const bool bUse16Bits = false, const LoadPriority ePriority = LoadPriority::NORMAL );
+	ModelResPtr		LoadModel( const char* sFilePath, const LoadPriority ePriority = LoadPriority::NORMAL );
+	ShaderResPtr	LoadShader( const char* sFilePath, const LoadPriority ePriority = LoadPriority::NORMAL );
+	TechniqueResPtr LoadTechnique( const char* sFilePath, const LoadPriority ePriority = LoadPriority::NORMAL );
+
+	// Imports a model as LoadModel does and writes it as a mesh file, which is then loaded without Assimp
+	static bool		ConvertModel( const char* sFilePath, const std::filesystem::path& oMeshFilePath );
+
+	// Called every frame by what waits for a resource still loading, the closest ones of a class are loaded first
+	void			UpdateLoadPriority( const Resource* pResource, const LoadPriority ePriority, const float fDistance = 0.f );
+	// Reads of a class are only issued while the bytes in flight, from their read to their finalization, fit in its budget
+	void			SetInFlightBytesBudget( const LoadPriority ePriority, const uint64 uBytes );
+	uint64			GetInFlightBytesBudget( const LoadPriority ePriority ) const;
 
 	void			HandleLoadedResources();
 	void			ProcessLoadCommands();
@@ -50,80 +55,15 @@ public:
 	void			DisplayDebug();
 
 private:
-	void			Load();
-	void			ProcessPendingLoadCommands();
-	void			CheckFinishedProcessingLoadCommands();
 	void			DestroyUnusedResources();
-
-	enum class LoadCommandStatus : uint8
-	{
-		PENDING,
-		LOADING,
-		LOADED,
-		FINISHED,
-		WAITING_DEPENDENCIES,
-		NOT_FOUND,
-		ERROR_READING
-	};
-
-	// This class is not polymorphic, it just defines an interface for subclasses to follow
-	template < typename Res >
-	struct LoadCommand
-	{
-		LoadCommand( const char* sFilePath, const StrongPtr< Res >& xResource )
-			: m_sFilePath( sFilePath )
-			, m_xResource( xResource )
-			, m_eStatus( LoadCommandStatus::PENDING )
-		{
-		}
-
-		std::string GetFilePath() const
-		{
-			return std::format( "Data/{}", m_sFilePath );
-		}
-
-		bool HasDependencies() const
-		{
-			return m_aDependencies.Empty() == false;
-		}
-
-		bool AnyDependencyFailed() const
-		{
-			for( const StrongPtr< Resource >& xDependency : m_aDependencies )
-			{
-				if( xDependency->IsFailed() )
-					return true;
-			}
-
-			return false;
-		}
-
-		bool AllDependenciesLoaded() const
-		{
-			for( const StrongPtr< Resource >& xDependency : m_aDependencies )
-			{
-				if( xDependency->IsLoaded() == false )
-					return false;
-			}
-
-			return true;
-		}
-
-		virtual void Load( std::unique_lock< std::mutex >& oLock ) = 0;
-		virtual void OnFinished() = 0;
-		virtual void OnDependenciesReady() = 0;
-
-		std::string						m_sFilePath;
-		StrongPtr< Res >				m_xResource;
-		LoadCommandStatus				m_eStatus;
-		Array< StrongPtr< Resource > >	m_aDependencies;
-	};
-
 	struct FontLoadCommand : LoadCommand< FontResource >
 	{
+		static constexpr LoadStage STAGE = LoadStage::DECODE;
+		static constexpr int PRIORITY = 4;
+
 		FontLoadCommand( const char* sFilePath, const FontResPtr& xResource );
 
-		void Load( std::unique_lock< std::mutex >& oLock ) override;
+		void Load( const ArrayView< const uint8 > aData ) override;
 		void OnFinished() override;
 		void OnDependenciesReady() override;
 
@@ -133,12 +73,20 @@ private:
 
 	struct TextureLoadCommand : LoadCommand< TextureResource >
 	{
+		static constexpr LoadStage STAGE = LoadStage::DECODE;
+		static constexpr int PRIORITY = 1;
+
 		TextureLoadCommand( const char* sFilePath, const TextureResPtr& xResource, const bool bSRGB, const bool bUse16Bits );
+		~TextureLoadCommand() override;
 
-		void Load( std::unique_lock< std::mutex >& oLock ) override;
+		void Load( const ArrayView< const uint8 > aData ) override;
 		void OnFinished() override;
 		void OnDependenciesReady() override;
 
+		uint64	GetDataSize() const;
+		bool	LoadDerivedData( const uint64 uKey );
+		void	StoreDerivedData( const uint64 uKey ) const;
+
 		int		m_iWidth;
 		int		m_iHeight;
 		int		m_iDepth;
@@ -149,12 +97,20 @@ private:
 
 	struct ModelLoadCommand : LoadCommand< ModelResource >
 	{
+		static constexpr LoadStage STAGE = LoadStage::DECODE;
+		static constexpr int PRIORITY = 0;
+
 		ModelLoadCommand( const char* sFilePath, const ModelResPtr& xResource );
 
-		void						Load( std::unique_lock< std::mutex >& oLock ) override;
+		void						Load( const ArrayView< const uint8 > aData ) override;
 		void						OnFinished() override;
 		void						OnDependenciesReady() override;
+		bool						Upload( const GameTimePoint oDeadline ) override;
+
+		bool						Import( const ArrayView< const uint8 > aData );
+		void						CreateMeshViews();
 
+		// Everything is extracted from the scene on the decode threads, only the textures and meshes are created on the main thread
 		void						LoadAnimations();
 		void						LoadSkeleton();
 		void						LoadMaterials();
@@ -163,19 +119,75 @@ private:
 		void						LoadMeshes( aiNode* pNode );
 		void						LoadMesh( aiMesh* pMesh );
 		void						LoadSkeleton( aiNode* pNode, Skeleton& oParent );
-		TextureResPtr				LoadTexture( const std::string& sFileName, const bool bSRGB = false );
+		void						LoadMaterialTexture( const uint uMaterialIndex, const aiMaterial* pMaterial, const int iTextureType, TextureResPtr LitMaterialData::* pTextureResource, const bool bSRGB = false );
+		void						LoadTextures();
 		uint						FetchNodeIndex( const std::string& sName );
 
+		// What is extracted from the scene is kept in the derived data cache, along with the other files the scene was made of
+		bool						LoadDerivedData( const uint64 uKey );
+		void						StoreDerivedData( const uint64 uKey ) const;
+		void						WriteDerivedData( BinaryWriter& oWriter ) const;
+		bool						ReadDerivedData( BinaryReader& oReader );
+
+		// Mesh files hold what is extracted from the scene, their meshes are uploaded straight from the mapping
+		bool						LoadMeshFile();
+		bool						ExportMeshFile( const std::filesystem::path& oFilePath ) const;
+
+		struct SourceFile
+		{
+			std::string	m_sFilePath;
+			uint64		m_uHash;
+		};
+
+		// A texture of a material, its load is only requested on the main thread
+		struct MaterialTexture
+		{
+			uint								m_uMaterialIndex;
+			TextureResPtr LitMaterialData::*	m_pTextureResource;
+			std::string							m_sFilePath;
+			Array< uint8 >						m_aEmbeddedData;
+			bool								m_bSRGB;
+		};
+
+		struct PackedModelMesh
+		{
+			PackedMesh		m_oPackedMesh;
+			uint			m_uMaterialIndex;
+			AxisAlignedBox	m_oAABB;
+		};
+
+		// Points into the packed meshes or into the mesh file
+		struct ModelMeshView
+		{
+			PackedMeshView	m_oPackedMesh;
+			uint			m_uMaterialIndex;
+		};
+
 		aiScene*								m_pScene;
+		Array< SourceFile >						m_aSourceFiles;
 		Array< LitMaterialData >				m_aMaterials;
+		Array< MaterialTexture >				m_aMaterialTextures;
+		Array< PackedModelMesh >				m_aPackedMeshes;
+		Array< ModelMeshView >					m_aMeshViews;
+		VirtualFile								m_oMeshFileData;
+		MeshFile								m_oMeshFile;
+		uint									m_uUploadedMeshCount;
+		AxisAlignedBox							m_oAABB;
+		Array< Animation >						m_aAnimations;
+		Skeleton								m_oSkeleton;
+		Array< glm::mat4x3 >					m_aPoseMatrices;
+		Array< glm::mat4x3 >					m_aSkinMatrices;
 		std::unordered_map< std::string, uint > m_mNodeIndices;
 	};
 
 	struct ShaderLoadCommand : LoadCommand< ShaderResource >
 	{
+		static constexpr LoadStage STAGE = LoadStage::IO;
+		static constexpr int PRIORITY = 3;
+
 		ShaderLoadCommand( const char* sFilePath, const ShaderResPtr& xResource, Array< std::string >&& aFlags );
 
-		void Load( std::unique_lock< std::mutex >& oLock ) override;
+		void Load( const ArrayView< const uint8 > aData ) override;
 		void OnFinished() override;
 		void OnDependenciesReady() override;
 
@@ -186,9 +198,12 @@ private:
 
 	struct TechniqueLoadCommand : LoadCommand< TechniqueResource >
 	{
+		static constexpr LoadStage STAGE = LoadStage::IO;
+		static constexpr int PRIORITY = 2;
+
 		TechniqueLoadCommand( const char* sFilePath, const TechniqueResPtr& xResource );
 
-		void Load( std::unique_lock< std::mutex >& oLock ) override;
+		void Load( const ArrayView< const uint8 > aData ) override;
 		void OnFinished() override;
 		void OnDependenciesReady() override;
 
@@ -197,21 +212,6 @@ private:
 		Array< std::string >					m_aShaders;
 	};
 
-	struct LoadCommands
-	{
-		Array< FontLoadCommand >		m_aFontLoadCommands;
-		Array< TextureLoadCommand >		m_aTextureLoadCommands;
-		Array< ModelLoadCommand >		m_aModelLoadCommands;
-		Array< ShaderLoadCommand >		m_aShaderLoadCommands;
-		Array< TechniqueLoadCommand >	m_aTechniqueLoadCommands;
-
-		uint Count() const;
-		bool Empty() const;
-		void Grab( LoadCommands& oLoadCommands );
-		void CopyWaitingDependencies( LoadCommands& oLoadCommands );
-		void Clear();
-	};
-
 	using FontResourceMap = std::unordered_map< std::string, FontResPtr >;
 	using TextureResourceMap = std::unordered_map< std::string, TextureResPtr >;
 	using ModelResourceMap = std::unordered_map< std::string, ModelResPtr >;
@@ -224,17 +224,11 @@ private:
 	ShaderResourceMap		m_mShaderResources;
 	TechniqueResourceMap	m_mTechniqueResources;
 
-	LoadCommands			m_oPendingLoadCommands;
-	LoadCommands			m_oProcessingLoadCommands;
-	LoadCommands			m_oWaitingDependenciesLoadCommands;
-
-	std::atomic_bool		m_bRunning;
-
-	std::mutex				m_oProcessingCommandsMutex;
-	std::condition_variable m_oProcessingCommandsConditionVariable;
-	std::jthread			m_oIOThread;
+	// Used by the decode threads, it is created before them
+	DerivedDataCache			m_oDerivedDataCache;
 
-	Assimp::Importer		m_oModelImporter;
+	// Runs the commands, it is destroyed first so that its threads are stopped before the cache
+	LoadScheduler			m_oScheduler;
 
 	bool					m_bDisableUnusedResourcesDestruction;
 	bool					m_bDisplayDebug;
@@ -2,34 +2,11 @@
 
 #include "Graphics/Mesh.h"
 
-Resource::Resource()
-	: m_eStatus( Status::LOADING )
-{
-}
-
-Resource::~Resource()
-{
-}
-
-Resource::Status Resource::GetStatus() const
-{
-	return m_eStatus;
-}
-
-bool Resource::IsLoading() const
-{
-	return m_eStatus == Status::LOADING;
-}
-
-bool Resource::IsLoaded() const
-{
-	return m_eStatus == Status::LOADED;
-}
-
-bool Resource::IsFailed() const
-{
-	return m_eStatus == Status::FAILED;
-}
+DEFINE_POOL_ALLOCATOR( FontResource, 16 )
+DEFINE_POOL_ALLOCATOR( ShaderResource, 64 )
+DEFINE_POOL_ALLOCATOR( TechniqueResource, 32 )
+DEFINE_POOL_ALLOCATOR( TextureResource, 64 )
+DEFINE_POOL_ALLOCATOR( ModelResource, 32 )
 
 uint64 FontResource::GetSize() const
 {
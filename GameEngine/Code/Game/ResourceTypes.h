@@ -3,6 +3,8 @@
 #include "Animation.h"
 #include "Core/Array.h"
 #include "Core/Intrusive.h"
+#include "Core/PoolAllocator.h"
+#include "Core/Resource.h"
 #include "Core/stb_truetype.h"
 #include "Graphics/BoundingVolume.h"
 #include "Graphics/Shader.h"
@@ -11,34 +13,10 @@
 
 class Mesh;
 
-class Resource : public Intrusive
-{
-public:
-	friend class ResourceLoader;
-
-	enum class Status
-	{
-		LOADING,
-		LOADED,
-		FAILED
-	};
-
-	Resource();
-	virtual ~Resource();
-
-	virtual void	Destroy() = 0; // TODO #eric this could probably be a destructor ?
-
-	Status			GetStatus() const;
-	bool			IsLoading() const;
-	bool			IsLoaded() const;
-	bool			IsFailed() const;
-
-protected:
-	Status m_eStatus;
-};
-
 class FontResource : public Resource
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class ResourceLoader;
 
@@ -61,6 +39,8 @@ private:
 
 class ShaderResource : public Resource
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class ResourceLoader;
 
@@ -75,6 +55,8 @@ private:
 
 class TechniqueResource : public Resource
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class ResourceLoader;
 
@@ -92,6 +74,8 @@ private:
 
 class TextureResource : public Resource
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class ResourceLoader;
 
@@ -106,6 +90,8 @@ private:
 
 class ModelResource : public Resource
 {
+	DECLARE_POOL_ALLOCATOR()
+
 public:
 	friend class ResourceLoader;
 
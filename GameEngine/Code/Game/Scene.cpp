@@ -92,11 +92,11 @@ Entity* Scene::CreateEntity( const std::string& sName, const uint64 uID )
 
 	if( bIDAlreadyExist )
 	{
-		LOG_WARN( "Cannot create entity {} (id : {}), ID already exists", sName, uID );
+		SLOG_WARN( LogCategory::GAME, "Cannot create entity {} (id : {}), ID already exists", sName, uID );
 		return nullptr;
 	}
 
-	LOG_INFO( "Create entity {} (id : {})", sName, uID );
+	SLOG_INFO( LogCategory::GAME, "Create entity {} (id : {})", sName, uID );
 
 	UpdateID( uID );
 
@@ -120,7 +120,7 @@ void Scene::RemoveEntity( const uint64 uEntityID )
 
 void Scene::RemoveEntity( Entity* pEntity )
 {
-	LOG_INFO( "Remove entity {} (id : {})", pEntity->GetName(), pEntity->GetID() );
+	SLOG_INFO( LogCategory::GAME, "Remove entity {} (id : {})", pEntity->GetName(), pEntity->GetID() );
 
 	for( int i = pEntity->m_aChildren.Count() - 1; i >= 0; --i )
 	{
@@ -1,5 +1,8 @@
 #include "BoundingVolume.h"
 
+#include <cfloat>
+#include <immintrin.h>
+
 #include "Core/Array.h"
 #include "Math/GLMHelpers.h"
 
@@ -30,7 +30,7 @@ void DebugDisplay::NewFrame()
 
 void DebugDisplay::Display( const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "DebugDisplay" );
+	PROFILE_SCOPE( "DebugDisplay" );
 	GPUMarker oGPUMarker( "DebugDisplay" );
 
 	glEnable( GL_DEPTH_TEST );
@@ -56,7 +56,7 @@ void DebugDisplay::Display( const RenderContext& oRenderContext )
 
 void DebugDisplay::DisplayOverlay( const float fDeltaTime, const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "DebugDisplayOverlay" );
+	PROFILE_SCOPE( "DebugDisplayOverlay" );
 	GPUMarker oGPUMarker( "DebugDisplayOverlay" );
 	GPUProfilerBlock oGPUBlock( "DebugDisplayOverlay" );
 
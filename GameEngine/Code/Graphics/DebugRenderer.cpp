@@ -115,10 +115,11 @@ static void PushVertex( Array< GLfloat >& aVertices, const glm::vec3& vVertex )
 	aVertices.PushBack( vVertex.z );
 }
 
+// Debug displays leave the bandwidth to the scene, the unlit technique is raised by the components which share it
 DebugRenderer::DebugRenderer()
-	: m_xLine( g_pResourceLoader->LoadTechnique( "Shader/line.tech" ) )
-	, m_xSphere( g_pResourceLoader->LoadTechnique( "Shader/sphere.tech" ) )
-	, m_xUnlit( g_pResourceLoader->LoadTechnique( "Shader/unlit.tech" ) )
+	: m_xLine( g_pResourceLoader->LoadTechnique( "Shader/line.tech", LoadPriority::BACKGROUND ) )
+	, m_xSphere( g_pResourceLoader->LoadTechnique( "Shader/sphere.tech", LoadPriority::BACKGROUND ) )
+	, m_xUnlit( g_pResourceLoader->LoadTechnique( "Shader/unlit.tech", LoadPriority::BACKGROUND ) )
 {
 	glCreateVertexArrays( 1, &m_uVertexArrayID );
 	glCreateBuffers( 1, &m_uVertexBufferID );
@@ -22,7 +22,36 @@ Mesh::Mesh()
 		m_aBuffers[ u ] = GL_INVALID_VALUE;
 }
 
-void Mesh::Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >& aUVs, const Array< glm::vec3 >& aNormals, const Array< glm::vec3 >& aTangents, const Array< SkinData >& aSkinData, const Array< GLuint >& aIndices, const MaterialReference& oMaterial )
+PackedMesh::PackedMesh()
+	: m_uUVsSize( 0 )
+	, m_uNormalsSize( 0 )
+	, m_uTangentsSize( 0 )
+	, m_uBonesSize( 0 )
+	, m_uWeightsSize( 0 )
+{
+}
+
+PackedMeshView::PackedMeshView()
+	: m_uUVsSize( 0 )
+	, m_uNormalsSize( 0 )
+	, m_uTangentsSize( 0 )
+	, m_uBonesSize( 0 )
+	, m_uWeightsSize( 0 )
+{
+}
+
+PackedMeshView::PackedMeshView( const PackedMesh& oPackedMesh )
+	: m_aVertices( oPackedMesh.m_aVertices.Data(), oPackedMesh.m_aVertices.Count() )
+	, m_aIndices( oPackedMesh.m_aIndices.Data(), oPackedMesh.m_aIndices.Count() )
+	, m_uUVsSize( oPackedMesh.m_uUVsSize )
+	, m_uNormalsSize( oPackedMesh.m_uNormalsSize )
+	, m_uTangentsSize( oPackedMesh.m_uTangentsSize )
+	, m_uBonesSize( oPackedMesh.m_uBonesSize )
+	, m_uWeightsSize( oPackedMesh.m_uWeightsSize )
+{
+}
+
+static PackedMesh PackMesh( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >& aUVs, const Array< glm::vec3 >& aNormals, const Array< glm::vec3 >& aTangents, const Array< SkinData >& aSkinData, const Array< GLuint >& aIndices )
 {
 	ASSERT( aVertices.Empty() == false && aIndices.Empty() == false );
 	ASSERT( aUVs.Empty() || aUVs.Count() == aVertices.Count() );
@@ -30,8 +59,10 @@ void Mesh::Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >
 	ASSERT( aTangents.Empty() || aTangents.Count() == aVertices.Count() );
 	ASSERT( aSkinData.Empty() || aSkinData.Count() == aVertices.Count() );
 
+	PackedMesh oPackedMesh;
+
 	if( aVertices.Empty() || aIndices.Empty() )
-		return;
+		return oPackedMesh;
 
 	const uint uVerticesSize = sizeof( aVertices[ 0 ] ) / sizeof( GLfloat );
 	const uint uUVsSize = aUVs.Empty() ? 0 : sizeof( aUVs[ 0 ] ) / sizeof( GLfloat );
@@ -48,7 +79,7 @@ void Mesh::Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >
 
 	const uint uVertexSize = uWeightsOffset + uWeightsSize;
 
-	Array< GLfloat > aPackedVertices;
+	Array< GLfloat >& aPackedVertices = oPackedMesh.m_aVertices;
 	aPackedVertices.Resize( uVertexSize * aVertices.Count() );
 
 	for( uint u = 0; u < aVertices.Count(); ++u )
@@ -95,6 +126,49 @@ void Mesh::Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >
 		}
 	}
 
+	oPackedMesh.m_aIndices = aIndices;
+	oPackedMesh.m_uUVsSize = uUVsSize;
+	oPackedMesh.m_uNormalsSize = uNormalsSize;
+	oPackedMesh.m_uTangentsSize = uTangentsSize;
+	oPackedMesh.m_uBonesSize = uBonesSize;
+	oPackedMesh.m_uWeightsSize = uWeightsSize;
+
+	return oPackedMesh;
+}
+
+void Mesh::Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >& aUVs, const Array< glm::vec3 >& aNormals, const Array< glm::vec3 >& aTangents, const Array< SkinData >& aSkinData, const Array< GLuint >& aIndices, const MaterialReference& oMaterial )
+{
+	Create( PackMesh( aVertices, aUVs, aNormals, aTangents, aSkinData, aIndices ), oMaterial );
+}
+
+void Mesh::Create( const PackedMesh& oPackedMesh, const MaterialReference& oMaterial )
+{
+	Create( PackedMeshView( oPackedMesh ), oMaterial );
+}
+
+void Mesh::Create( const PackedMeshView& oPackedMesh, const MaterialReference& oMaterial )
+{
+	const ArrayView< const GLfloat > aPackedVertices = oPackedMesh.m_aVertices;
+	const ArrayView< const GLuint > aIndices = oPackedMesh.m_aIndices;
+
+	if( aPackedVertices.Empty() || aIndices.Empty() )
+		return;
+
+	const uint uVerticesSize = sizeof( glm::vec3 ) / sizeof( GLfloat );
+	const uint uUVsSize = oPackedMesh.m_uUVsSize;
+	const uint uNormalsSize = oPackedMesh.m_uNormalsSize;
+	const uint uTangentsSize = oPackedMesh.m_uTangentsSize;
+	const uint uBonesSize = oPackedMesh.m_uBonesSize;
+	const uint uWeightsSize = oPackedMesh.m_uWeightsSize;
+
+	const uint uUVsOffset = uVerticesSize;
+	const uint uNormalsOffset = uUVsOffset + uUVsSize;
+	const uint uTangentsOffset = uNormalsOffset + uNormalsSize;
+	const uint uBonesOffset = uTangentsOffset + uTangentsSize;
+	const uint uWeightsOffset = uBonesOffset + uBonesSize;
+
+	const uint uVertexSize = uWeightsOffset + uWeightsSize;
+
 	m_iIndexCount = ( int )aIndices.Count();
 
 	glCreateVertexArrays( 1, &m_uVertexArrayID );
@@ -180,8 +254,8 @@ const MaterialReference& Mesh::GetMaterial() const
 }
 
 MeshBuilder::MeshBuilder( Array< glm::vec3 >&& aVertices, Array< GLuint >&& aIndices )
-	: m_aVertices( aVertices )
-	, m_aIndices( aIndices )
+	: m_aVertices( std::move( aVertices ) )
+	, m_aIndices( std::move( aIndices ) )
 {
 }
 
@@ -193,7 +267,7 @@ MeshBuilder& MeshBuilder::WithUVs()
 
 MeshBuilder& MeshBuilder::WithUVs( Array< glm::vec2 >&& aUVs )
 {
-	m_aUVs = aUVs;
+	m_aUVs = std::move( aUVs );
 	return *this;
 }
 
@@ -205,7 +279,7 @@ MeshBuilder& MeshBuilder::WithNormals()
 
 MeshBuilder& MeshBuilder::WithNormals( Array< glm::vec3 >&& aNormals )
 {
-	m_aNormals = aNormals;
+	m_aNormals = std::move( aNormals );
 	return *this;
 }
 
@@ -217,7 +291,7 @@ MeshBuilder& MeshBuilder::WithTangents()
 
 MeshBuilder& MeshBuilder::WithTangents( Array< glm::vec3 >&& aTangents )
 {
-	m_aTangents = aTangents;
+	m_aTangents = std::move( aTangents );
 	return *this;
 }
 
@@ -229,7 +303,7 @@ MeshBuilder& MeshBuilder::WithSkinData()
 
 MeshBuilder& MeshBuilder::WithSkinData( Array< SkinData >&& aSkinData )
 {
-	m_aSkinData = aSkinData;
+	m_aSkinData = std::move( aSkinData );
 	return *this;
 }
 
@@ -239,10 +313,15 @@ MeshBuilder& MeshBuilder::WithMaterial( const MaterialReference& oMaterial )
 	return *this;
 }
 
+PackedMesh MeshBuilder::Pack() const
+{
+	return PackMesh( m_aVertices, m_aUVs, m_aNormals, m_aTangents, m_aSkinData, m_aIndices );
+}
+
 Mesh MeshBuilder::Build()
 {
 	Mesh oMesh;
-	oMesh.Create( m_aVertices, m_aUVs, m_aNormals, m_aTangents, m_aSkinData, m_aIndices, m_oMaterial );
+	oMesh.Create( Pack(), m_oMaterial );
 
 	return oMesh;
 }
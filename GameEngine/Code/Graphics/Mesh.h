@@ -19,6 +19,37 @@ struct SkinData
 	float	m_aWeights[ MAX_VERTEX_BONE_COUNT ];
 };
 
+// Interleaved vertex data, it can be packed on any thread and then uploaded on the main thread
+struct PackedMesh
+{
+	PackedMesh();
+
+	Array< GLfloat >	m_aVertices;
+	Array< GLuint >		m_aIndices;
+
+	uint				m_uUVsSize;
+	uint				m_uNormalsSize;
+	uint				m_uTangentsSize;
+	uint				m_uBonesSize;
+	uint				m_uWeightsSize;
+};
+
+// Interleaved vertex data stored elsewhere, like in a PackedMesh or a mapped mesh file
+struct PackedMeshView
+{
+	PackedMeshView();
+	PackedMeshView( const PackedMesh& oPackedMesh );
+
+	ArrayView< const GLfloat >	m_aVertices;
+	ArrayView< const GLuint >	m_aIndices;
+
+	uint						m_uUVsSize;
+	uint						m_uNormalsSize;
+	uint						m_uTangentsSize;
+	uint						m_uBonesSize;
+	uint						m_uWeightsSize;
+};
+
 class Mesh
 {
 public:
@@ -31,6 +62,8 @@ public:
 	Mesh();
 
 	void						Create( const Array< glm::vec3 >& aVertices, const Array< glm::vec2 >& aUVs, const Array< glm::vec3 >& aNormals, const Array< glm::vec3 >& aTangents, const Array< SkinData >& aSkinData, const Array< GLuint >& aIndices, const MaterialReference& oMaterial );
+	void						Create( const PackedMesh& oPackedMesh, const MaterialReference& oMaterial );
+	void						Create( const PackedMeshView& oPackedMesh, const MaterialReference& oMaterial );
 	void						Destroy();
 
 	void						SetMaterial( const MaterialReference& oMaterial );
@@ -66,6 +99,7 @@ public:
 	MeshBuilder&	WithSkinData( Array< SkinData >&& aSkinData );
 	MeshBuilder&	WithMaterial( const MaterialReference& oMaterial );
 
+	PackedMesh		Pack() const;
 	Mesh			Build();
 
 private:
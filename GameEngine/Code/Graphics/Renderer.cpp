@@ -97,7 +97,7 @@ static GPULightingDataBlock SetupLighting( const Array< DirectionalLightNode* >&
 
 static void CullNodes( const Array< VisualNode* >& aVisualNodes, const Frustum& oFrustum )
 {
-	ProfilerBlock oBlock( "Cull" );
+	PROFILE_SCOPE( "Cull" );
 
 	const uint uBatchIterationCount = aVisualNodes.Count() / 4;
 	const uint uSingleIterationCount = aVisualNodes.Count() - 4 * uBatchIterationCount;
@@ -118,7 +118,7 @@ static void CullNodes( const Array< VisualNode* >& aVisualNodes, const Frustum&
 template < bool bApplyMaterials >
 static void DrawNodes( const Array< VisualNode* >& aVisualNodes, Technique& oTechnique, const glm::mat4& mViewProjectionMatrix )
 {
-	ProfilerBlock oBlock( "Draw" );
+	PROFILE_SCOPE( "Draw" );
 
 	TechniqueParameter oParamUseSkinning = oTechnique.GetParameter( PARAM_USE_SKINNING );
 	TechniqueParameter oParamSkinningOffset = oTechnique.GetParameter( PARAM_SKINNING_OFFSET );
@@ -361,15 +361,16 @@ void StorageBufferSlot::ClearSlot()
 
 Renderer* g_pRenderer = nullptr;
 
+// Nothing is drawn without the pipeline and the default maps, the editor overlays can wait
 Renderer::Renderer()
-	: m_xDefaultDiffuseMap( g_pResourceLoader->LoadTexture( "Default_diffuse.png", true ) )
-	, m_xDefaultNormalMap( g_pResourceLoader->LoadTexture( "Default_normal.png" ) )
-	, m_xDeferredMaps( g_pResourceLoader->LoadTechnique( "Shader/deferred_maps.tech" ) )
-	, m_xDeferredCompose( g_pResourceLoader->LoadTechnique( "Shader/deferred_compose.tech" ) )
-	, m_xBlend( g_pResourceLoader->LoadTechnique( "Shader/blend.tech" ) )
-	, m_xOutline( g_pResourceLoader->LoadTechnique( "Shader/outline.tech" ) )
-	, m_xGizmo( g_pResourceLoader->LoadTechnique( "Shader/gizmo.tech" ) )
-	, m_xShadowMap( g_pResourceLoader->LoadTechnique( "Shader/shadow_map.tech" ) )
+	: m_xDefaultDiffuseMap( g_pResourceLoader->LoadTexture( "Default_diffuse.png", true, false, LoadPriority::HIGH ) )
+	, m_xDefaultNormalMap( g_pResourceLoader->LoadTexture( "Default_normal.png", false, false, LoadPriority::HIGH ) )
+	, m_xDeferredMaps( g_pResourceLoader->LoadTechnique( "Shader/deferred_maps.tech", LoadPriority::HIGH ) )
+	, m_xDeferredCompose( g_pResourceLoader->LoadTechnique( "Shader/deferred_compose.tech", LoadPriority::HIGH ) )
+	, m_xBlend( g_pResourceLoader->LoadTechnique( "Shader/blend.tech", LoadPriority::HIGH ) )
+	, m_xOutline( g_pResourceLoader->LoadTechnique( "Shader/outline.tech", LoadPriority::BACKGROUND ) )
+	, m_xGizmo( g_pResourceLoader->LoadTechnique( "Shader/gizmo.tech", LoadPriority::BACKGROUND ) )
+	, m_xShadowMap( g_pResourceLoader->LoadTechnique( "Shader/shadow_map.tech", LoadPriority::HIGH ) )
 	, m_eRenderingMode( RenderingMode::FORWARD )
 	, m_eMSAALevel( MSAALevel::MSAA_8X )
 	, m_bSRGB( true )
@@ -414,7 +415,7 @@ Renderer::~Renderer()
 
 void Renderer::Render( const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "Renderer" );
+	PROFILE_SCOPE( "Renderer" );
 	GPUProfilerBlock oGPUBlock( "Renderer" );
 
 	UpdateRenderPipeline( oRenderContext );
@@ -486,6 +487,17 @@ void Renderer::Render( const RenderContext& oRenderContext )
 
 void Renderer::Clear()
 {
+	uint64 uTriangleCount = 0;
+	uint64 uDrawCallCount = 0;
+	for( uint u = 0; u < RendererStatistics::TOTAL_STEP_COUNT; ++u )
+	{
+		uTriangleCount += m_oStatistics.m_aStepTriangleCount[ u ];
+		uDrawCallCount += m_oStatistics.m_aStepDrawCallCount[ u ];
+	}
+
+	PROFILE_COUNTER( "Triangles", uTriangleCount );
+	PROFILE_COUNTER( "Draw calls", uDrawCallCount );
+
 	m_oStatistics = RendererStatistics();
 
 	m_oVisualStructure.Clear();
@@ -733,7 +745,7 @@ const RendererStatistics& Renderer::GetStatistics() const
 void Renderer::RenderForward( const RenderContext& oRenderContext )
 {
 	GPUMarker oGPUMarker( "Forward" );
-	ProfilerBlock oBlock( "Forward" );
+	PROFILE_SCOPE( "Forward" );
 
 	SetRenderTarget( m_oForwardMSAATarget );
 
@@ -839,7 +851,7 @@ void Renderer::RenderForward( const RenderContext& oRenderContext )
 void Renderer::RenderDeferred( const RenderContext& oRenderContext )
 {
 	GPUMarker oGPUMarker( "Deferred" );
-	ProfilerBlock oBlock( "Deferred" );
+	PROFILE_SCOPE( "Deferred" );
 
 	SetRenderTarget( m_oDeferredMapsTarget );
 
@@ -924,7 +936,7 @@ void Renderer::RenderDeferred( const RenderContext& oRenderContext )
 void Renderer::RenderShadowMap()
 {
 	GPUMarker oGPUMarker( "ShadowMap" );
-	ProfilerBlock oBlock( "ShadowMap" );
+	PROFILE_SCOPE( "ShadowMap" );
 
 	if( m_oVisualStructure.m_aDirectionalLights.Empty() )
 		return;
@@ -8,7 +8,7 @@ Shader::Shader()
 {
 }
 
-void Shader::Create( const std::string& sShaderCode, const ShaderType eShaderType, const Array< std::string >& aFlags )
+void Shader::Create( const std::string_view sShaderCode, const ShaderType eShaderType, const Array< std::string >& aFlags )
 {
 	m_uShaderID = glCreateShader( GetGLShaderType( eShaderType ) );
 
@@ -18,19 +18,22 @@ void Shader::Create( const std::string& sShaderCode, const ShaderType eShaderTyp
 	for( const std::string& sFlag : aFlags )
 		sFlags += "#define " + sFlag + "\n";
 
-	const std::string sContent = ( "#line 1\n" + sShaderCode );
+	const std::string sLine = "#line 1\n";
 
-	const uint uShaderPartCount = 3;
+	// Parts are given with their lengths, the code is passed as is without being copied
+	const uint uShaderPartCount = 4;
 
 	const GLchar* aShaderCode[ uShaderPartCount ];
 	aShaderCode[ 0 ] = sVersion.c_str();
 	aShaderCode[ 1 ] = sFlags.c_str();
-	aShaderCode[ 2 ] = sContent.c_str();
+	aShaderCode[ 2 ] = sLine.c_str();
+	aShaderCode[ 3 ] = sShaderCode.data();
 
 	GLint aShaderCodeLength[ uShaderPartCount ];
 	aShaderCodeLength[ 0 ] = ( GLint )sVersion.length();
 	aShaderCodeLength[ 1 ] = ( GLint )sFlags.length();
-	aShaderCodeLength[ 2 ] = ( GLint )sContent.length();
+	aShaderCodeLength[ 2 ] = ( GLint )sLine.length();
+	aShaderCodeLength[ 3 ] = ( GLint )sShaderCode.length();
 
 	GLint iCompileResult;
 	glShaderSource( m_uShaderID, uShaderPartCount, aShaderCode, aShaderCodeLength );
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include <GL/glew.h>
 
@@ -23,7 +24,7 @@ public:
 
 	Shader();
 
-	void Create( const std::string& sShaderCode, const ShaderType eShaderType, const Array< std::string >& aFlags );
+	void Create( const std::string_view sShaderCode, const ShaderType eShaderType, const Array< std::string >& aFlags );
 	void Destroy();
 
 private:
@@ -21,8 +21,8 @@ glm::vec2 SizeOnScreen( const glm::vec2& vSize, const RenderContext& oRenderCont
 }
 
 TextRenderer::TextRenderer()
-	: m_xFont( g_pResourceLoader->LoadFont( "Roboto-Bold.ttf" ) )
-	, m_xTextTechnique( g_pResourceLoader->LoadTechnique( "Shader/text.tech" ) )
+	: m_xFont( g_pResourceLoader->LoadFont( "Roboto-Bold.ttf", LoadPriority::HIGH ) )
+	, m_xTextTechnique( g_pResourceLoader->LoadTechnique( "Shader/text.tech", LoadPriority::HIGH ) )
 {
 	Array< glm::vec3 > aVertices( 4 );
 	aVertices[ 0 ] = glm::vec3( 0.f, 0.f, 0.f );
@@ -54,7 +54,7 @@ TextRenderer::~TextRenderer()
 
 void TextRenderer::RenderText( const Array< Text >& aTexts, const RenderContext& oRenderContext )
 {
-	ProfilerBlock oBlock( "Text" );
+	PROFILE_SCOPE( "Text" );
 
 	glEnable( GL_BLEND );
 	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
@@ -30,10 +30,15 @@ void VisualComponent::Initialize()
 {
 	m_xModel = g_pResourceLoader->LoadModel( m_sModelFile.c_str() );
 	m_xTechnique = g_pResourceLoader->LoadTechnique( "Shader/forward_opaque.tech" );
+
+	UpdateLoadPriority();
 }
 
 bool VisualComponent::IsInitialized() const
 {
+	// Polled every frame until the model is loaded
+	UpdateLoadPriority();
+
 	return m_xModel->IsLoading() == false && m_xTechnique->IsLoaded();
 }
 
@@ -51,6 +56,8 @@ void VisualComponent::Update( const GameContext& oGameContext )
 {
 	const Entity* pEntity = GetEntity();
 
+	UpdateLoadPriority();
+
 	if( m_bModelDirty && m_xModel->IsLoaded() )
 		UpdateModel();
 
@@ -116,6 +123,16 @@ const Array< Mesh >& VisualComponent::GetMeshes() const
 	return m_xModel->GetMeshes();
 }
 
+// Models close to the camera are loaded first, the request is renewed every frame as the camera moves
+void VisualComponent::UpdateLoadPriority() const
+{
+	if( m_xModel->IsLoading() == false )
+		return;
+
+	const float fDistance = glm::distance( GetEntity()->GetWorldTransform().GetO(), g_pRenderer->m_oCamera.GetPosition() );
+	g_pResourceLoader->UpdateLoadPriority( m_xModel.GetPtr(), LoadPriority::NORMAL, fDistance );
+}
+
 void VisualComponent::UpdateModel()
 {
 	m_pVisualNode->m_aMeshes = m_xModel->GetMeshes();
@@ -27,6 +27,7 @@ public:
 	const Array< Mesh >&	GetMeshes() const;
 
 private:
+	void					UpdateLoadPriority() const;
 	void					UpdateModel();
 
 	PROPERTIES( VisualComponent );
@@ -6,6 +6,14 @@
 #include "Game/Entity.h"
 #include "Math/GLMHelpers.h"
 
+DEFINE_POOL_ALLOCATOR( DirectionalLightNode, 16 )
+DEFINE_POOL_ALLOCATOR( PointLightNode, 64 )
+DEFINE_POOL_ALLOCATOR( SpotLightNode, 64 )
+DEFINE_POOL_ALLOCATOR( SkyNode, 4 )
+DEFINE_POOL_ALLOCATOR( TerrainNode, 4 )
+DEFINE_POOL_ALLOCATOR( RoadNode, 64 )
+DEFINE_POOL_ALLOCATOR( VisualNode, 256 )
+
 RoadNode::RoadNode( const uint64 uEntityID, const glm::mat4x3& mMatrix, const Texture& oDiffuse, const Mesh& oMesh )
 	: m_uEntityID( uEntityID )
 	, m_mMatrix( mMatrix )
@@ -4,6 +4,7 @@
 
 #include "BoundingVolume.h"
 #include "Core/Array.h"
+#include "Core/PoolAllocator.h"
 #include "Mesh.h"
 #include "Technique.h"
 #include "Texture.h"
@@ -13,6 +14,8 @@ struct Transform;
 
 struct DirectionalLightNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	glm::vec3	m_vDirection;
 	Color		m_oColor;
 	float		m_fIntensity;
@@ -22,6 +25,8 @@ struct DirectionalLightNode
 
 struct PointLightNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	glm::vec3	m_vPosition;
 	Color		m_oColor;
 	float		m_fIntensity;
@@ -31,6 +36,8 @@ struct PointLightNode
 
 struct SpotLightNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	glm::vec3	m_vPosition;
 	glm::vec3	m_vDirection;
 	Color		m_oColor;
@@ -43,11 +50,15 @@ struct SpotLightNode
 
 struct SkyNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	CubeMap m_oCubeMap;
 };
 
 struct TerrainNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	Texture			m_oDiffuse;
 	Array< Mesh >	m_aMeshes;
 	glm::mat4x3		m_mMatrix;
@@ -56,6 +67,8 @@ struct TerrainNode
 
 struct RoadNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	RoadNode( const uint64 uEntityID, const glm::mat4x3& mMatrix, const Texture& oDiffuse, const Mesh& oMesh );
 
 	uint64		m_uEntityID;
@@ -66,6 +79,8 @@ struct RoadNode
 
 struct VisualNode
 {
+	DECLARE_POOL_ALLOCATOR()
+
 	explicit VisualNode( const uint64 uEntityID );
 	VisualNode( const uint64 uEntityID, const Transform& oTransform, const Array< Mesh >& aMeshes, const AxisAlignedBox& oAABB = AxisAlignedBox() );
 
@@ -8,9 +8,13 @@
 #include "ImGUI/imgui_impl_glfw.h"
 #include "ImGUI/imgui_impl_opengl3.h"
 
+#include "Core/LogDecoder.h"
 #include "Core/Logger.h"
+#include "Core/PackFile.h"
+#include "Core/VirtualFileSystem.h"
 #include "Game/GameEngine.h"
 #include "Game/InputHandler.h"
+#include "Game/ResourceLoader.h"
 #include "Graphics/Renderer.h"
 
 static InputContext s_oInputContext;
@@ -36,8 +40,44 @@ void OnWindowResizeEvent( GLFWwindow* /*pWindow*/, int iWidth, int iHeight )
 	s_oRenderContext.OnFrameBufferResized( iWidth, iHeight );
 }
 
-int main()
+int main( int iArgumentCount, char** aArguments )
 {
+	for( int i = 1; i < iArgumentCount; ++i )
+	{
+		// Writes a binary log as text on the standard output and exits
+		if( strcmp( aArguments[ i ], "--decode-log" ) == 0 && i + 1 < iArgumentCount )
+		{
+			if( DecodeBinaryLog( aArguments[ i + 1 ], stdout ) )
+				return 0;
+
+			LOG_ERROR( "Failed to decode binary log {}", aArguments[ i + 1 ] );
+			Logger::Flush();
+			return -1;
+		}
+
+		// Packs a directory of assets, --pack Data Data.pack builds the pack the engine mounts, and exits
+		if( strcmp( aArguments[ i ], "--pack" ) == 0 && i + 2 < iArgumentCount )
+		{
+			const bool bCompress = i + 3 < iArgumentCount && strcmp( aArguments[ i + 3 ], "--compress" ) == 0;
+			const bool bPacked = WritePackFile( aArguments[ i + 1 ], aArguments[ i + 2 ], bCompress );
+			Logger::Flush();
+			return bPacked ? 0 : -1;
+		}
+
+		// Converts a model to the native mesh format, --convert-mesh Models/Tree.fbx Data/Models/Tree.mesh, and exits
+		if( strcmp( aArguments[ i ], "--convert-mesh" ) == 0 && i + 2 < iArgumentCount )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			const bool bConverted = ResourceLoader::ConvertModel( aArguments[ i + 1 ], aArguments[ i + 2 ] );
+			Logger::Flush();
+			return bConverted ? 0 : -1;
+		}
+
+		// Structured logs are written unformatted, to be decoded afterwards
+		if( strcmp( aArguments[ i ], "--binary-log" ) == 0 )
+			Logger::SetBinaryLog( "GameEngine.binlog" );
+	}
+
 	LOG_INFO( "Initializing GLFW " );
 	if( glfwInit() == false )
 	{
@@ -104,7 +144,7 @@ int main()
 				oGameEngine.NewFrame();
 
 				{
-					ProfilerBlock oBlock( "Frame" );
+					PROFILE_SCOPE( "Frame" );
 					GPUProfilerBlock oGPUBlock( "Frame" );
 
 					s_oInputContext.Refresh();
@@ -113,7 +153,7 @@ int main()
 					oGameEngine.EndFrame();
 
 					{
-						ProfilerBlock oBlock( "WaitDisplay" );
+						PROFILE_SCOPE( "WaitDisplay" );
 						GPUProfilerBlock oGPUBlock( "WaitDisplay" );
 
 						{
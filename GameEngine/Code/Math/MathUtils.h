@@ -34,4 +34,37 @@ struct PlaneUtil
 
 	glm::vec3 m_vOrigin;
 	glm::vec3 m_vNormal;
-};
\ No newline at end of file
+};
+
+// Bilinear sample of a height map of unsigned values, normalized in [0, 1]
+template < typename T >
+inline float SampleHeightMap( const glm::vec2 vUV, const T* aData, const int iWidth, const int iHeight )
+{
+	static const float fNormalizeFactor = 1.f / ( float )( glm::pow( 2, 8 * sizeof( T ) ) - 1 );
+
+	const float fX = vUV.x * iWidth - 0.5f;
+	const float fY = vUV.y * iHeight - 0.5f;
+
+	int iX0 = ( int )fX;
+	int iY0 = ( int )fY;
+	int iX1 = iX0 + 1;
+	int iY1 = iY0 + 1;
+
+	const float fXRatio = fX - iX0;
+	const float fYRatio = fY - iY0;
+
+	iX0 = glm::clamp( iX0, 0, iWidth - 1 );
+	iX1 = glm::clamp( iX1, 0, iWidth - 1 );
+	iY0 = glm::clamp( iY0, 0, iHeight - 1 );
+	iY1 = glm::clamp( iY1, 0, iHeight - 1 );
+
+	const T uValue00 = aData[ iY0 * iWidth + iX0 ];
+	const T uValue10 = aData[ iY0 * iWidth + iX1 ];
+	const T uValue01 = aData[ iY1 * iWidth + iX0 ];
+	const T uValue11 = aData[ iY1 * iWidth + iX1 ];
+
+	const float uValue0 = uValue00 * ( 1.f - fXRatio ) + uValue10 * fXRatio;
+	const float uValue1 = uValue01 * ( 1.f - fXRatio ) + uValue11 * fXRatio;
+
+	return fNormalizeFactor * ( uValue0 * ( 1 - fYRatio ) + uValue1 * fYRatio );
+}
\ No newline at end of file
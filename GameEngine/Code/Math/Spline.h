@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Core/Array.h"
+
+class Spline;
+
+class SplineIterator
+{
+public:
+	explicit SplineIterator( const Spline& oSpline );
+
+	bool		MoveForward( const float fStepDistance, const float fSubStepDistance = 0.01f );
+
+	glm::vec3	ComputePosition() const;
+	glm::vec3	ComputeTangent() const;
+
+	float		GetRatio() const;
+
+private:
+	const Spline&	m_oSpline;
+
+	float			m_fRatio;
+	float			m_fDistance;
+	uint			m_uCPIndex;
+};
+
+class Spline
+{
+public:
+	Spline() = default;
+	explicit Spline( const Array< glm::vec3 >& aControlPoints );
+	Spline( const Array< glm::vec3 >& aControlPoints, const Array< glm::vec3 >& aTangents );
+
+	glm::vec3					ComputePosition( const float fRatio ) const;
+	glm::vec3					ComputeTangent( const float fRatio ) const;
+	float						ComputeDistance( const float fRatioA, const float fRatioB ) const;
+
+	float						GetLength() const;
+
+	void						RebuildTangents();
+	void						RebuildDistances();
+
+	Array< glm::vec3 >&			GetControlPoints();
+	const Array< glm::vec3 >&	GetControlPoints() const;
+	Array< glm::vec3 >&			GetTangents();
+	const Array< glm::vec3 >&	GetTangents() const;
+	const Array< float >&		GetDistances() const;
+	const Array< float >&		GetCumulatedDistances() const;
+
+private:
+	Array< glm::vec3 >	m_aControlPoints;
+	Array< glm::vec3 >	m_aTangents;
+	Array< float >		m_aDistances;
+	Array< float >		m_aCumulatedDistances;
+};
@@ -6,6 +6,25 @@
 
 using namespace physx;
 
+void* PhysicsProfilerCallback::zoneStart( const char* sEventName, bool bDetached, uint64_t /*uContextID*/ )
+{
+	// Detached zones may end on another thread, they can't be nested in the lane of the thread starting them
+	if( bDetached || g_pProfiler == nullptr )
+		return nullptr;
+
+	// The main thread is already named, this only names the dispatcher threads
+	g_pProfiler->SetThreadName( "PhysX worker" );
+	g_pProfiler->StartBlock( sEventName );
+
+	return this;
+}
+
+void PhysicsProfilerCallback::zoneEnd( void* pProfilerData, const char* /*sEventName*/, bool /*bDetached*/, uint64_t /*uContextID*/ )
+{
+	if( pProfilerData != nullptr && g_pProfiler != nullptr )
+		g_pProfiler->EndBlock();
+}
+
 Physics* g_pPhysics = nullptr;
 
 Physics::Physics()
@@ -19,10 +38,14 @@ Physics::Physics()
 	PxPvdTransport* pTransport = PxDefaultPvdSocketTransportCreate( "127.0.0.1", 5425, 10 );
 	m_pPvd->connect( *pTransport, PxPvdInstrumentationFlag::eALL );
 
+	// Replaces the callback registered by PVD, profiling zones go to our profiler instead
+	PxSetProfilerCallback( &m_oProfilerCallback );
+
 	PxSceneDesc oSceneDesc( m_pPhysics->getTolerancesScale() );
 	oSceneDesc.gravity = PxVec3( 0.f, -9.81f, 0.f );
 	oSceneDesc.cpuDispatcher = m_pCPUDispatcher;
 	oSceneDesc.filterShader = PxDefaultSimulationFilterShader;
+	oSceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
 	m_pScene = m_pPhysics->createScene( oSceneDesc );
 
 	m_pMaterial = m_pPhysics->createMaterial( 0.5f, 0.5f, 0.75f );
@@ -39,6 +62,8 @@ Physics::Physics()
 
 Physics::~Physics()
 {
+	PxSetProfilerCallback( nullptr );
+
 	PX_RELEASE( m_pScene );
 	PX_RELEASE( m_pCPUDispatcher );
 	PX_RELEASE( m_pPhysics );
@@ -52,10 +77,16 @@ Physics::~Physics()
 
 void Physics::Tick()
 {
-	ProfilerBlock oBlock( "Physics" );
+	PROFILE_SCOPE( "Physics" );
 
 	m_pScene->simulate( TICK_STEP );
 	m_pScene->fetchResults( true );
+
+	PxU32 uActiveActorCount = 0;
+	m_pScene->getActiveActors( uActiveActorCount );
+
+	PROFILE_COUNTER( "Physics actors", m_pScene->getNbActors( PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC ) );
+	PROFILE_COUNTER( "Physics active actors", uActiveActorCount );
 }
 
 bool Physics::Raycast(const glm::vec3& vOrigin, const glm::vec3& vDirection, const float fDistance, glm::vec3& vPosition )
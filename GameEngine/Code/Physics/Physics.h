@@ -4,6 +4,14 @@
 
 #include "PxPhysicsAPI.h"
 
+// Forwards PhysX profiling zones to the profiler, which shows the work of the dispatcher threads in their own lanes
+class PhysicsProfilerCallback : public physx::PxProfilerCallback
+{
+public:
+	void*	zoneStart( const char* sEventName, bool bDetached, uint64_t uContextID ) override;
+	void	zoneEnd( void* pProfilerData, const char* sEventName, bool bDetached, uint64_t uContextID ) override;
+};
+
 class Physics
 {
 public:
@@ -26,6 +34,7 @@ public:
 private:
 	physx::PxDefaultAllocator		m_oAllocator;
 	physx::PxDefaultErrorCallback	m_oErrorCallback;
+	PhysicsProfilerCallback			m_oProfilerCallback;
 	physx::PxFoundation*			m_pFoundation;
 	physx::PxPvd*					m_pPvd;
 	physx::PxPhysics*				m_pPhysics;
@@ -0,0 +1,2 @@
+#include "pch.h"
+#include "Game/Animation.cpp"
\ No newline at end of file
@@ -0,0 +1,2 @@
+#include "pch.h"
+#include "Core/AsyncFileReader.cpp"
\ No newline at end of file
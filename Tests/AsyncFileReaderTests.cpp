@@ -0,0 +1,295 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "Core/AsyncFileReader.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( AsyncFileReaderTests )
+	{
+		static std::filesystem::path WriteTestFile( const std::string& sFileName, const std::string& sContent )
+		{
+			const std::filesystem::path oFilePath = std::filesystem::temp_directory_path() / sFileName;
+
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream.write( sContent.data(), sContent.length() );
+
+			return oFilePath;
+		}
+
+		static std::string GetData( const AsyncRead* pRead )
+		{
+			return std::string( ( const char* )pRead->m_aData.Data(), pRead->m_aData.Count() );
+		}
+
+		static void TestReads( const bool bAllowIOUring )
+		{
+			const std::string sContent = "0123456789abcdefghijklmnopqrstuvwxyz";
+			const std::filesystem::path oFilePath = WriteTestFile( "AsyncFileReaderTests.txt", sContent );
+			const std::filesystem::path oEmptyFilePath = WriteTestFile( "AsyncFileReaderTests.empty", "" );
+
+			{
+				AsyncFileReader oReader( 2, bAllowIOUring );
+
+				oReader.Read( oFilePath, 0, 0, 0, ( void* )1 );
+				oReader.Read( oFilePath, 10, 6, 0, ( void* )2 );
+				oReader.Read( oFilePath, 30, 0, 0, ( void* )3 );
+				oReader.Read( oFilePath, 30, 10, 0, ( void* )4 );
+				oReader.Read( std::filesystem::temp_directory_path() / "AsyncFileReaderTests.missing", 0, 0, 0, ( void* )5 );
+				oReader.Read( oEmptyFilePath, 0, 0, 0, ( void* )6 );
+
+				uint uDeliveredCount = 0;
+				while( AsyncRead* pRead = oReader.PopDelivered( true ) )
+				{
+					switch( ( uint64 )pRead->m_pUserData )
+					{
+					case 1:
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+						Assert::IsTrue( GetData( pRead ) == sContent );
+						break;
+					case 2:
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+						Assert::IsTrue( GetData( pRead ) == "abcdef" );
+						break;
+					case 3:
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+						Assert::IsTrue( GetData( pRead ) == "uvwxyz" );
+						break;
+					case 6:
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+						Assert::IsTrue( pRead->m_aData.Empty() );
+						break;
+					default:
+						// Out of the file or missing
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::FAILED );
+						Assert::IsTrue( pRead->m_aData.Empty() );
+						break;
+					}
+
+					delete pRead;
+					++uDeliveredCount;
+				}
+
+				Assert::AreEqual( 6u, uDeliveredCount );
+				Assert::AreEqual( 0u, oReader.GetPendingCount() );
+				Assert::AreEqual( 0u, oReader.GetInFlightCount() );
+			}
+
+			std::filesystem::remove( oFilePath );
+			std::filesystem::remove( oEmptyFilePath );
+		}
+
+		static void TestManyReads( const bool bAllowIOUring )
+		{
+			// More reads than the queue depth, so that some wait for others to complete
+			const uint uFileCount = 8;
+			const uint uReadCount = 4 * ASYNC_READ_QUEUE_DEPTH;
+
+			std::filesystem::path aFilePaths[ uFileCount ];
+			std::string aContents[ uFileCount ];
+			for( uint u = 0; u < uFileCount; ++u )
+			{
+				aContents[ u ] = std::string( 1000 * ( u + 1 ), ( char )( 'a' + u ) );
+				aFilePaths[ u ] = WriteTestFile( "AsyncFileReaderTests" + std::to_string( u ) + ".bin", aContents[ u ] );
+			}
+
+			{
+				AsyncFileReader oReader( ASYNC_READ_DEFAULT_THREAD_COUNT, bAllowIOUring );
+
+				for( uint u = 0; u < uReadCount; ++u )
+					oReader.Read( aFilePaths[ u % uFileCount ], 0, 0, u % 3, ( void* )( uint64 )( u % uFileCount ) );
+
+				uint uDeliveredCount = 0;
+				while( AsyncRead* pRead = oReader.PopDelivered( true ) )
+				{
+					Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+					Assert::IsTrue( GetData( pRead ) == aContents[ ( uint64 )pRead->m_pUserData ] );
+
+					delete pRead;
+					++uDeliveredCount;
+				}
+
+				Assert::AreEqual( uReadCount, uDeliveredCount );
+			}
+
+			for( const std::filesystem::path& oFilePath : aFilePaths )
+				std::filesystem::remove( oFilePath );
+		}
+
+		TEST_METHOD( ReadTest )
+		{
+			TestReads( false );
+		}
+
+		TEST_METHOD( IOUringReadTest )
+		{
+			// Falls back to the thread pool when io_uring is not available
+			TestReads( true );
+		}
+
+		TEST_METHOD( ManyReadsTest )
+		{
+			TestManyReads( false );
+			TestManyReads( true );
+		}
+
+		TEST_METHOD( LargeReadTest )
+		{
+			// Sparse on most file systems, nothing is written
+			const std::filesystem::path oFilePath = WriteTestFile( "AsyncFileReaderTests.large", "" );
+			std::filesystem::resize_file( oFilePath, ( 4ull << 30 ) + 16 );
+
+			for( const bool bAllowIOUring : { false, true } )
+			{
+				AsyncFileReader oReader( 2, bAllowIOUring );
+
+				// Too large for the data of a read, which is not truncated but fails
+				oReader.Read( oFilePath, 0, 0, 0, ( void* )1 );
+				oReader.Read( oFilePath, 4ull << 30, 16, 0, ( void* )2 );
+
+				uint uDeliveredCount = 0;
+				while( AsyncRead* pRead = oReader.PopDelivered( true ) )
+				{
+					if( ( uint64 )pRead->m_pUserData == 1 )
+					{
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::FAILED );
+						Assert::IsTrue( pRead->m_aData.Empty() );
+					}
+					else
+					{
+						Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::COMPLETED );
+						Assert::IsTrue( GetData( pRead ) == std::string( 16, '\0' ) );
+					}
+
+					delete pRead;
+					++uDeliveredCount;
+				}
+
+				Assert::AreEqual( 2u, uDeliveredCount );
+			}
+
+			std::filesystem::remove( oFilePath );
+		}
+
+		TEST_METHOD( CancelTest )
+		{
+			const std::filesystem::path oFilePath = WriteTestFile( "AsyncFileReaderTests.txt", "content" );
+
+			{
+				// Without threads, reads stay pending
+				AsyncFileReader oReader( 0, false );
+
+				AsyncRead* pFirstRead = oReader.Read( oFilePath, 0, 0, 0 );
+				AsyncRead* pSecondRead = oReader.Read( oFilePath, 0, 0, 0 );
+				oReader.Read( oFilePath, 0, 0, 0 );
+
+				Assert::IsTrue( oReader.PopDelivered( false ) == nullptr );
+				Assert::AreEqual( 3u, oReader.GetPendingCount() );
+
+				oReader.SetPriority( pFirstRead, 10 );
+				Assert::AreEqual( 10, pFirstRead->m_iPriority );
+
+				oReader.Cancel( pSecondRead );
+				Assert::AreEqual( 2u, oReader.GetPendingCount() );
+
+				AsyncRead* pRead = oReader.PopDelivered( false );
+				Assert::IsTrue( pRead == pSecondRead );
+				Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::CANCELLED );
+				delete pRead;
+
+				// Pending reads are deleted with the reader
+			}
+
+			{
+				AsyncFileReader oReader( 0, false );
+
+				oReader.Read( oFilePath, 0, 0, 0 );
+				oReader.Read( oFilePath, 0, 0, 0 );
+
+				oReader.CancelAll();
+				Assert::AreEqual( 0u, oReader.GetPendingCount() );
+
+				uint uCancelledCount = 0;
+				while( AsyncRead* pRead = oReader.PopDelivered( true ) )
+				{
+					Assert::IsTrue( pRead->m_eStatus == AsyncReadStatus::CANCELLED );
+					delete pRead;
+					++uCancelledCount;
+				}
+
+				Assert::AreEqual( 2u, uCancelledCount );
+			}
+
+			std::filesystem::remove( oFilePath );
+		}
+
+		TEST_METHOD( InterruptTest )
+		{
+			const std::filesystem::path oFilePath = WriteTestFile( "AsyncFileReaderTests.txt", "content" );
+
+			{
+				// Without threads, the read stays pending and PopDelivered would wait forever
+				AsyncFileReader oReader( 0, false );
+				AsyncRead* pRead = oReader.Read( oFilePath, 0, 0, 0 );
+
+				// Before waiting
+				oReader.Interrupt();
+				Assert::IsTrue( oReader.PopDelivered( true ) == nullptr );
+
+				// While waiting
+				std::thread oThread( [ &oReader ]() {
+					std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+					oReader.Interrupt();
+				} );
+				Assert::IsTrue( oReader.PopDelivered( true ) == nullptr );
+				oThread.join();
+
+				oReader.Cancel( pRead );
+				pRead = oReader.PopDelivered( true );
+				Assert::IsTrue( pRead != nullptr && pRead->m_eStatus == AsyncReadStatus::CANCELLED );
+				delete pRead;
+			}
+
+			std::filesystem::remove( oFilePath );
+		}
+
+		TEST_METHOD( PriorityTest )
+		{
+			// A large first read keeps the only thread busy while the others are queued
+			const std::filesystem::path oLargeFilePath = WriteTestFile( "AsyncFileReaderTests.large", std::string( 64 * 1024 * 1024, 'x' ) );
+			const std::filesystem::path oFilePath = WriteTestFile( "AsyncFileReaderTests.txt", "content" );
+
+			{
+				AsyncFileReader oReader( 1, false );
+
+				oReader.Read( oLargeFilePath, 0, 0, 0, ( void* )0 );
+				while( oReader.GetInFlightCount() == 0 )
+					std::this_thread::yield();
+
+				const int aPriorities[] = { 1, 5, 3, 5, 2 };
+				for( uint u = 0; u < std::size( aPriorities ); ++u )
+					oReader.Read( oFilePath, 0, 0, aPriorities[ u ], ( void* )( uint64 )( u + 1 ) );
+
+				// Highest priority first, then in request order
+				const uint64 aExpectedOrder[] = { 0, 2, 4, 3, 5, 1 };
+				for( const uint64 uExpected : aExpectedOrder )
+				{
+					AsyncRead* pRead = oReader.PopDelivered( true );
+					Assert::IsTrue( pRead != nullptr );
+					Assert::AreEqual( uExpected, ( uint64 )pRead->m_pUserData );
+					delete pRead;
+				}
+			}
+
+			std::filesystem::remove( oLargeFilePath );
+			std::filesystem::remove( oFilePath );
+		}
+	};
+}
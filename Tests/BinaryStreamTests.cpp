@@ -0,0 +1,72 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "Core/BinaryStream.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( BinaryStreamTests )
+	{
+		TEST_METHOD( RoundTripTest )
+		{
+			Array< float > aValues;
+			aValues.PushBack( 1.f );
+			aValues.PushBack( -2.5f );
+
+			BinaryWriter oWriter;
+			oWriter.Write( 42u );
+			oWriter.WriteArray( aValues );
+			oWriter.WriteString( "Data/sphere.obj" );
+			oWriter.WriteArray( Array< uint8 >() );
+			oWriter.WriteString( "" );
+
+			const Array< uint8 >& aData = oWriter.GetData();
+			BinaryReader oReader( ArrayView< const uint8 >( aData.Data(), aData.Count() ) );
+
+			uint uValue = 0;
+			Assert::IsTrue( oReader.Read( uValue ) );
+			Assert::AreEqual( 42u, uValue );
+
+			Array< float > aReadValues;
+			Assert::IsTrue( oReader.ReadArray( aReadValues ) );
+			Assert::AreEqual( 2u, aReadValues.Count() );
+			Assert::AreEqual( -2.5f, aReadValues[ 1 ] );
+
+			std::string sValue;
+			Assert::IsTrue( oReader.ReadString( sValue ) );
+			Assert::IsTrue( sValue == "Data/sphere.obj" );
+
+			Array< uint8 > aEmpty;
+			Assert::IsTrue( oReader.ReadArray( aEmpty ) );
+			Assert::IsTrue( aEmpty.Empty() );
+			Assert::IsTrue( oReader.ReadString( sValue ) );
+			Assert::IsTrue( sValue.empty() );
+
+			Assert::IsTrue( oReader.IsAtEnd() );
+			Assert::IsTrue( oReader.IsValid() );
+		}
+
+		TEST_METHOD( TruncatedTest )
+		{
+			Array< uint64 > aValues( 4, 7 );
+
+			BinaryWriter oWriter;
+			oWriter.WriteArray( aValues );
+			oWriter.Write( 1.f );
+
+			// The array claims more elements than there are bytes left
+			const Array< uint8 >& aData = oWriter.GetData();
+			BinaryReader oReader( ArrayView< const uint8 >( aData.Data(), aData.Count() - 12 ) );
+
+			Array< uint64 > aReadValues;
+			Assert::IsFalse( oReader.ReadArray( aReadValues ) );
+			Assert::IsFalse( oReader.IsValid() );
+
+			// Reads after a failed one fail too, even when they would fit
+			uint8 uValue = 0;
+			Assert::IsFalse( oReader.Read( uValue ) );
+		}
+	};
+}
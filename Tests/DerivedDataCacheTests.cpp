@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Core/DerivedDataCache.h"
+#include "Core/Logger.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( DerivedDataCacheTests )
+	{
+		class TestLogger : public ::Logger
+		{
+		public:
+			std::string m_sLogs;
+
+		private:
+			void FlushLogs() override
+			{
+				m_sLogs += s_pLogBuffer;
+			}
+		};
+
+		static std::filesystem::path GetCacheDirectory()
+		{
+			const std::filesystem::path oDirectory = std::filesystem::temp_directory_path() / "DerivedDataCacheTests";
+			std::filesystem::remove_all( oDirectory );
+			return oDirectory;
+		}
+
+		TEST_METHOD( HashTest )
+		{
+			const std::string sContent = "Triangulate, GenSmoothNormals, JoinIdenticalVertices, CalcTangentSpace";
+			const uint64 uHash = HashData( sContent.data(), sContent.length() );
+
+			Assert::AreEqual( uHash, HashData( sContent.data(), sContent.length() ) );
+			Assert::AreNotEqual( uHash, HashData( sContent.data(), sContent.length() - 1 ) );
+			Assert::AreNotEqual( uHash, HashData( sContent.data(), sContent.length(), 1 ) );
+
+			// A change in any byte of a word changes the hash
+			std::string sChanged = sContent;
+			sChanged[ 7 ] = 'x';
+			Assert::AreNotEqual( uHash, HashData( sChanged.data(), sChanged.length() ) );
+		}
+
+		TEST_METHOD( StoreLoadTest )
+		{
+			const DerivedDataCache oCache( GetCacheDirectory() );
+
+			const std::string sContent = "processed";
+			Assert::IsTrue( oCache.Store( 0x1234, 1, ArrayView< const uint8 >( ( const uint8* )sContent.data(), ( uint )sContent.length() ) ) );
+
+			{
+				MappedFile oMappedFile;
+				ArrayView< const uint8 > aData;
+				Assert::IsTrue( oCache.Load( 0x1234, 1, oMappedFile, aData ) );
+				Assert::IsTrue( std::string( ( const char* )aData.Data(), aData.Count() ) == sContent );
+			}
+
+			MappedFile oMappedFile;
+			ArrayView< const uint8 > aData;
+
+			// Entries of another version or key are misses
+			Assert::IsFalse( oCache.Load( 0x1234, 2, oMappedFile, aData ) );
+			Assert::IsFalse( oCache.Load( 0x4321, 1, oMappedFile, aData ) );
+
+			// So are truncated entries
+			std::filesystem::resize_file( oCache.GetEntryPath( 0x1234 ), sizeof( DerivedDataHeader ) + 2 );
+			Assert::IsFalse( oCache.Load( 0x1234, 1, oMappedFile, aData ) );
+
+			// And entries too large for a view, even when their size truncated to a view matches the header, sparse on most file systems
+			Assert::IsTrue( oCache.Store( 0x1234, 1, ArrayView< const uint8 >( ( const uint8* )sContent.data(), ( uint )sContent.length() ) ) );
+			std::filesystem::resize_file( oCache.GetEntryPath( 0x1234 ), ( 4ull << 30 ) + sizeof( DerivedDataHeader ) + sContent.length() );
+			Assert::IsFalse( oCache.Load( 0x1234, 1, oMappedFile, aData ) );
+
+			// Storing again replaces the entry
+			Assert::IsTrue( oCache.Store( 0x1234, 2, ArrayView< const uint8 >() ) );
+			Assert::IsTrue( oCache.Load( 0x1234, 2, oMappedFile, aData ) );
+			Assert::IsTrue( aData.Empty() );
+		}
+
+		TEST_METHOD( MissTest )
+		{
+			TestLogger oLogger;
+			const DerivedDataCache oCache( GetCacheDirectory() );
+
+			// Entries missing from the cache are silent misses
+			MappedFile oMappedFile;
+			ArrayView< const uint8 > aData;
+			Assert::IsFalse( oCache.Load( 0x1234, 1, oMappedFile, aData ) );
+			Assert::IsFalse( oMappedFile.IsOpen() );
+
+			::Logger::Flush();
+			Assert::IsTrue( oLogger.m_sLogs.find( "[ERROR]" ) == std::string::npos );
+		}
+	};
+}
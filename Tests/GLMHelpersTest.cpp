@@ -0,0 +1,2 @@
+#include "pch.h"
+#include "Math/GLMHelpers.cpp"
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "pch.h"
 #include "CppUnitTest.h"
 
+#include <chrono>
+#include <format>
+#include <thread>
+#include <vector>
+
 #include "Core/Intrusive.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -29,6 +34,27 @@ namespace Tests
 			}
 		};
 
+		struct TestSharedIntrusive : public Intrusive
+		{
+			static std::atomic< uint > s_uAliveCount;
+
+			TestSharedIntrusive()
+				: Intrusive( ReferencePolicy::ATOMIC )
+			{
+				++s_uAliveCount;
+			}
+
+			~TestSharedIntrusive()
+			{
+				--s_uAliveCount;
+			}
+
+			uint64 GetSize() const override
+			{
+				return sizeof( TestSharedIntrusive );
+			}
+		};
+
 	public:
 		TEST_METHOD( StrongPtrTest )
 		{
@@ -286,7 +312,269 @@ namespace Tests
 
 			Assert::AreEqual( 0u, TestIntrusive::s_uAliveCount );
 		}
+
+		TEST_METHOD( WeakPtrHandleReuseTest )
+		{
+			Assert::AreEqual( 0u, TestIntrusive::s_uAliveCount );
+
+			WeakPtr< TestIntrusive > xWeakPtr;
+			{
+				StrongPtr< TestIntrusive > xStrongPtr( new TestIntrusive );
+				xWeakPtr = xStrongPtr.GetPtr();
+				Assert::IsTrue( xStrongPtr.GetPtr() == xWeakPtr.GetPtr() );
+			}
+			Assert::AreEqual( 0u, TestIntrusive::s_uAliveCount );
+			Assert::IsTrue( nullptr == xWeakPtr.GetPtr() );
+
+			// Test that a new object reusing the handle of a destroyed one is not reachable from stale WeakPtr
+			{
+				StrongPtr< TestIntrusive > xStrongPtr( new TestIntrusive );
+				WeakPtr< TestIntrusive > xNewWeakPtr( xStrongPtr.GetPtr() );
+				Assert::AreEqual( 1u, xStrongPtr->CountWeakReferences() );
+				Assert::IsTrue( xStrongPtr.GetPtr() == xNewWeakPtr.GetPtr() );
+				Assert::IsTrue( nullptr == xWeakPtr.GetPtr() );
+
+				// Test moving WeakPtr
+				WeakPtr< TestIntrusive > xMovedWeakPtr( std::move( xNewWeakPtr ) );
+				Assert::AreEqual( 1u, xStrongPtr->CountWeakReferences() );
+				Assert::IsTrue( xStrongPtr.GetPtr() == xMovedWeakPtr.GetPtr() );
+				Assert::IsTrue( nullptr == xNewWeakPtr.GetPtr() );
+
+				xWeakPtr = std::move( xMovedWeakPtr );
+				Assert::AreEqual( 1u, xStrongPtr->CountWeakReferences() );
+				Assert::IsTrue( xStrongPtr.GetPtr() == xWeakPtr.GetPtr() );
+			}
+			Assert::AreEqual( 0u, TestIntrusive::s_uAliveCount );
+			Assert::IsTrue( nullptr == xWeakPtr.GetPtr() );
+		}
+
+		TEST_METHOD( WeakPtrChurnSpeedTest )
+		{
+			const uint uWeakCount = 100000;
+
+			StrongPtr< TestIntrusive > xStrongPtr( new TestIntrusive );
+
+			// Many weak references to a single popular object, like an entity referenced by holders and editor tools
+			std::vector< WeakPtr< TestIntrusive > > aWeakPtrs;
+			aWeakPtrs.reserve( uWeakCount );
+
+			auto t1 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uWeakCount; ++u )
+				aWeakPtrs.emplace_back( xStrongPtr.GetPtr() );
+			for( uint u = 0; u < uWeakCount; ++u )
+				aWeakPtrs[ u ] = nullptr;
+			auto t2 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uWeakCount; ++u )
+				aWeakPtrs[ u ] = xStrongPtr.GetPtr();
+			for( uint u = uWeakCount; u > 0; --u )
+				aWeakPtrs[ u - 1 ] = nullptr;
+			auto t3 = std::chrono::high_resolution_clock::now();
+
+			const auto oOldestFirstTime = std::chrono::duration_cast< std::chrono::microseconds >( t2 - t1 ).count();
+			const auto oNewestFirstTime = std::chrono::duration_cast< std::chrono::microseconds >( t3 - t2 ).count();
+
+			Logger::WriteMessage( std::format( "Churn of {} WeakPtr : oldest released first {} us, newest released first {} us\n", uWeakCount, oOldestFirstTime, oNewestFirstTime ).c_str() );
+
+			// Suspicious if not, but not a hard truth : the release order should not matter
+			Assert::IsTrue( oOldestFirstTime < 10 * ( oNewestFirstTime + 1 ) );
+			Assert::AreEqual( 0u, xStrongPtr->CountWeakReferences() );
+		}
+
+		TEST_METHOD( SharedStrongPtrTest )
+		{
+			Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+
+			const uint uThreadCount = 4;
+			const uint uIterations = 100000;
+
+			TestSharedIntrusive* pTestIntrusive = new TestSharedIntrusive;
+
+			// Test copying and releasing StrongPtr from several threads at the same time
+			{
+				StrongPtr< TestSharedIntrusive > xStrongPtr( pTestIntrusive );
+
+				std::vector< std::thread > aThreads;
+				for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+				{
+					aThreads.emplace_back( [ &xStrongPtr ]() {
+						for( uint u = 0; u < uIterations; ++u )
+						{
+							StrongPtr< TestSharedIntrusive > xCopy( xStrongPtr );
+							StrongPtr< TestSharedIntrusive > xOtherCopy = xCopy;
+						}
+					} );
+				}
+
+				for( std::thread& oThread : aThreads )
+					oThread.join();
+
+				Assert::AreEqual( 1u, TestSharedIntrusive::s_uAliveCount.load() );
+				Assert::AreEqual( 1u, pTestIntrusive->GetReferenceCount() );
+			}
+			Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+
+			// Test pointers to the base class, they count references with the policy of the object
+			{
+				StrongPtr< Intrusive > xStrongPtr( new TestSharedIntrusive );
+				Assert::IsTrue( xStrongPtr->GetReferencePolicy() == ReferencePolicy::ATOMIC );
+
+				std::vector< std::thread > aThreads;
+				for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+				{
+					aThreads.emplace_back( [ &xStrongPtr ]() {
+						for( uint u = 0; u < uIterations; ++u )
+						{
+							StrongPtr< Intrusive > xCopy( xStrongPtr );
+							StrongPtr< Intrusive > xOtherCopy = xCopy;
+						}
+					} );
+				}
+
+				for( std::thread& oThread : aThreads )
+					oThread.join();
+
+				Assert::AreEqual( 1u, xStrongPtr->GetReferenceCount() );
+			}
+			Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+
+			// Test releasing the last references from several threads, the object must be destroyed exactly once
+			{
+				std::vector< StrongPtr< TestSharedIntrusive > > aStrongPtrs( uThreadCount, StrongPtr< TestSharedIntrusive >( new TestSharedIntrusive ) );
+				Assert::AreEqual( 1u, TestSharedIntrusive::s_uAliveCount.load() );
+
+				std::vector< std::thread > aThreads;
+				for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+					aThreads.emplace_back( [ &aStrongPtrs, uThread ]() { aStrongPtrs[ uThread ] = nullptr; } );
+
+				for( std::thread& oThread : aThreads )
+					oThread.join();
+
+				Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+			}
+		}
+
+		TEST_METHOD( SharedWeakPtrTest )
+		{
+			Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+
+			const uint uThreadCount = 4;
+			const uint uIterations = 10000;
+
+			// Test objects referenced weakly being destroyed on several threads while weak references come and go on another one
+			StrongPtr< TestSharedIntrusive > xStrongPtr( new TestSharedIntrusive );
+			std::atomic< bool > bRunning = true;
+
+			std::thread oWeakThread( [ &xStrongPtr, &bRunning ]() {
+				while( bRunning )
+				{
+					WeakPtr< TestSharedIntrusive > xWeakPtr( xStrongPtr.GetPtr() );
+					Assert::IsTrue( xStrongPtr.GetPtr() == xWeakPtr.GetPtr() );
+				}
+			} );
+
+			std::vector< std::thread > aThreads;
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				aThreads.emplace_back( []() {
+					for( uint u = 0; u < uIterations; ++u )
+					{
+						StrongPtr< TestSharedIntrusive > xLocalPtr( new TestSharedIntrusive );
+						WeakPtr< TestSharedIntrusive > xWeakPtr( xLocalPtr.GetPtr() );
+						xLocalPtr = nullptr;
+						Assert::IsTrue( nullptr == xWeakPtr.GetPtr() );
+					}
+				} );
+			}
+
+			for( std::thread& oThread : aThreads )
+				oThread.join();
+
+			bRunning = false;
+			oWeakThread.join();
+
+			Assert::AreEqual( 1u, TestSharedIntrusive::s_uAliveCount.load() );
+			Assert::AreEqual( 0u, xStrongPtr->CountWeakReferences() );
+		}
+
+		TEST_METHOD( SharedWeakPtrResolveTest )
+		{
+			Assert::AreEqual( 0u, TestSharedIntrusive::s_uAliveCount.load() );
+
+			const uint uThreadCount = 4;
+			const uint uObjectCount = 5000;
+
+			// Test resolving weak references without the lock while other threads grow the table of handles
+			StrongPtr< TestSharedIntrusive > xStrongPtr( new TestSharedIntrusive );
+			const WeakPtr< TestSharedIntrusive > xWeakPtr( xStrongPtr.GetPtr() );
+			std::atomic< bool > bRunning = true;
+
+			std::thread oResolveThread( [ &xStrongPtr, &xWeakPtr, &bRunning ]() {
+				while( bRunning )
+					Assert::IsTrue( xStrongPtr.GetPtr() == xWeakPtr.GetPtr() );
+			} );
+
+			std::vector< std::thread > aThreads;
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				aThreads.emplace_back( []() {
+					std::vector< StrongPtr< TestSharedIntrusive > > aStrongPtrs;
+					std::vector< WeakPtr< TestSharedIntrusive > > aWeakPtrs;
+					for( uint u = 0; u < uObjectCount; ++u )
+					{
+						aStrongPtrs.emplace_back( new TestSharedIntrusive );
+						aWeakPtrs.emplace_back( aStrongPtrs.back().GetPtr() );
+					}
+
+					for( uint u = 0; u < uObjectCount; ++u )
+						Assert::IsTrue( aStrongPtrs[ u ].GetPtr() == aWeakPtrs[ u ].GetPtr() );
+
+					aStrongPtrs.clear();
+					for( uint u = 0; u < uObjectCount; ++u )
+						Assert::IsTrue( nullptr == aWeakPtrs[ u ].GetPtr() );
+				} );
+			}
+
+			for( std::thread& oThread : aThreads )
+				oThread.join();
+
+			bRunning = false;
+			oResolveThread.join();
+
+			Assert::AreEqual( 1u, TestSharedIntrusive::s_uAliveCount.load() );
+			Assert::AreEqual( 1u, xStrongPtr->CountWeakReferences() );
+		}
+
+		TEST_METHOD( ReferenceCountingSpeedTest )
+		{
+			const uint uIterations = 10000000;
+
+			StrongPtr< TestIntrusive > xLocalPtr( new TestIntrusive );
+			StrongPtr< TestSharedIntrusive > xSharedPtr( new TestSharedIntrusive );
+
+			auto t1 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uIterations; ++u )
+			{
+				StrongPtr< TestIntrusive > xCopy( xLocalPtr );
+			}
+			auto t2 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uIterations; ++u )
+			{
+				StrongPtr< TestSharedIntrusive > xCopy( xSharedPtr );
+			}
+			auto t3 = std::chrono::high_resolution_clock::now();
+
+			const auto oLocalTime = std::chrono::duration_cast< std::chrono::microseconds >( t2 - t1 ).count();
+			const auto oSharedTime = std::chrono::duration_cast< std::chrono::microseconds >( t3 - t2 ).count();
+
+			Logger::WriteMessage( std::format( "{} StrongPtr copies : local {} us, atomic {} us\n", uIterations, oLocalTime, oSharedTime ).c_str() );
+
+			// Suspicious if not, but not a hard truth
+			Assert::IsTrue( oLocalTime < oSharedTime );
+			Assert::AreEqual( 1u, xLocalPtr->GetReferenceCount() );
+			Assert::AreEqual( 1u, xSharedPtr->GetReferenceCount() );
+		}
 	};
 
 	uint IntrusiveTests::TestIntrusive::s_uAliveCount = 0;
+	std::atomic< uint > IntrusiveTests::TestSharedIntrusive::s_uAliveCount = 0;
 }
@@ -0,0 +1,2 @@
+#include "pch.h"
+#include "Core/LoadScheduler.cpp"
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "Core/LoadScheduler.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	class TestResource : public Resource
+	{
+	public:
+		uint64 GetSize() const override
+		{
+			return sizeof( TestResource );
+		}
+
+		void Destroy() override
+		{
+			++s_uDestroyCount;
+		}
+
+		void SetStatus( const Status eStatus )
+		{
+			m_eStatus = eStatus;
+		}
+
+		static uint s_uDestroyCount;
+	};
+
+	uint TestResource::s_uDestroyCount = 0;
+
+	using TestResPtr = StrongPtr< TestResource >;
+
+	// Reads a file outside of the Data directory, and records on the main thread when it is finished
+	struct TestLoadCommand : LoadCommand< TestResource >
+	{
+		TestLoadCommand( const std::filesystem::path& oFilePath, const TestResPtr& xResource, const LoadStage eStage, Array< std::string >& aEvents )
+			: LoadCommand( oFilePath.string().c_str(), xResource, eStage, 0, "TestLoad" )
+			, m_aEvents( aEvents )
+			, m_pLoadGate( nullptr )
+			, m_pUploadGate( nullptr )
+			, m_pLoadCount( nullptr )
+			, m_bFailLoad( false )
+		{
+		}
+
+		std::string GetFilePath() const override
+		{
+			return m_sFilePath;
+		}
+
+		void Load( const ArrayView< const uint8 > /*aData*/ ) override
+		{
+			// Holds the loader thread until the test lets the command through
+			while( m_pLoadGate != nullptr && *m_pLoadGate == false )
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+
+			if( m_pLoadCount != nullptr )
+				++*m_pLoadCount;
+
+			m_eStatus = m_bFailLoad ? LoadCommandStatus::ERROR_READING : LoadCommandStatus::LOADED;
+		}
+
+		void OnFinished() override
+		{
+			m_aEvents.PushBack( "Finished " + GetName() );
+
+			if( m_eStatus == LoadCommandStatus::NOT_FOUND || m_eStatus == LoadCommandStatus::ERROR_READING )
+				m_xResource->SetStatus( Resource::Status::FAILED );
+		}
+
+		void OnDependenciesReady() override
+		{
+			m_aEvents.PushBack( "Ready " + GetName() );
+
+			m_xResource->SetStatus( m_eStatus == LoadCommandStatus::FINISHED ? Resource::Status::LOADED : Resource::Status::FAILED );
+		}
+
+		bool Upload( const GameTimePoint /*oDeadline*/ ) override
+		{
+			if( m_pUploadGate != nullptr && *m_pUploadGate == false )
+				return false;
+
+			if( HasDependencies() == false )
+				m_xResource->SetStatus( Resource::Status::LOADED );
+
+			return true;
+		}
+
+		std::string GetName() const
+		{
+			return std::filesystem::path( m_sFilePath ).extension().string().substr( 1 );
+		}
+
+		Array< std::string >&	m_aEvents;
+		const std::atomic_bool*	m_pLoadGate;
+		const bool*				m_pUploadGate;
+		std::atomic_uint*		m_pLoadCount;
+		bool					m_bFailLoad;
+	};
+
+	TEST_CLASS( LoadSchedulerTests )
+	{
+		static std::filesystem::path WriteTestFile( const std::string& sExtension, const uint uSize )
+		{
+			const std::filesystem::path oFilePath = std::filesystem::temp_directory_path() / ( "LoadSchedulerTests." + sExtension );
+
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream << std::string( uSize, 'x' );
+
+			return oFilePath;
+		}
+
+		// Runs frames as the resource loader does until the condition is met
+		template < typename Condition >
+		static bool RunFrames( LoadScheduler& oScheduler, Condition&& oCondition )
+		{
+			for( uint u = 0; u < 2000; ++u )
+			{
+				oScheduler.ProcessPendingLoadCommands();
+				oScheduler.FinalizeLoadCommands();
+
+				if( oCondition() )
+					return true;
+
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+
+			return false;
+		}
+
+		static int FindEvent( const Array< std::string >& aEvents, const std::string& sEvent )
+		{
+			for( uint u = 0; u < aEvents.Count(); ++u )
+			{
+				if( aEvents[ u ] == sEvent )
+					return ( int )u;
+			}
+
+			return -1;
+		}
+
+	public:
+		TEST_METHOD( DependencyOrderTest )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			Array< std::string > aEvents;
+			std::atomic_bool bLoadC( false );
+
+			LoadScheduler oScheduler( 2 );
+
+			// a depends on b, which depends on c, held on a decode thread
+			TestResPtr xA = new TestResource();
+			TestResPtr xB = new TestResource();
+			TestResPtr xC = new TestResource();
+
+			TestLoadCommand* pA = new TestLoadCommand( WriteTestFile( "a", 16 ), xA, LoadStage::IO, aEvents );
+			pA->m_aDependencies.PushBack( xB.GetPtr() );
+			TestLoadCommand* pB = new TestLoadCommand( WriteTestFile( "b", 16 ), xB, LoadStage::IO, aEvents );
+			pB->m_aDependencies.PushBack( xC.GetPtr() );
+			TestLoadCommand* pC = new TestLoadCommand( WriteTestFile( "c", 16 ), xC, LoadStage::DECODE, aEvents );
+			pC->m_pLoadGate = &bLoadC;
+
+			oScheduler.PushLoadCommand( pA, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pB, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pC, LoadPriority::NORMAL );
+
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return oScheduler.GetWaitingDependenciesLoadCommandCount() == 2; } ) );
+			Assert::IsTrue( xA->IsLoading() && xB->IsLoading() && xC->IsLoading() );
+			Assert::AreEqual( 2u, aEvents.Count() );
+
+			bLoadC = true;
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xA->IsLoading() == false; } ) );
+
+			// Completing c completes its dependents in turn, within the same frame
+			Assert::AreEqual( 5u, aEvents.Count() );
+			Assert::IsTrue( aEvents[ 2 ] == "Finished c" );
+			Assert::IsTrue( aEvents[ 3 ] == "Ready b" );
+			Assert::IsTrue( aEvents[ 4 ] == "Ready a" );
+
+			Assert::IsTrue( xA->IsLoaded() && xB->IsLoaded() && xC->IsLoaded() );
+			Assert::AreEqual( 0u, oScheduler.GetWaitingDependenciesLoadCommandCount() );
+			Assert::AreEqual( ( uint64 )0, oScheduler.GetInFlightBytes() );
+		}
+
+		TEST_METHOD( FailurePropagationTest )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			Array< std::string > aEvents;
+			std::atomic_bool bLoadB( false );
+
+			LoadScheduler oScheduler( 2 );
+
+			// b fails while a and c wait for it, c through a
+			TestResPtr xA = new TestResource();
+			TestResPtr xB = new TestResource();
+			TestResPtr xC = new TestResource();
+
+			TestLoadCommand* pA = new TestLoadCommand( WriteTestFile( "a", 16 ), xA, LoadStage::IO, aEvents );
+			pA->m_aDependencies.PushBack( xB.GetPtr() );
+			TestLoadCommand* pB = new TestLoadCommand( WriteTestFile( "b", 16 ), xB, LoadStage::DECODE, aEvents );
+			pB->m_pLoadGate = &bLoadB;
+			pB->m_bFailLoad = true;
+			TestLoadCommand* pC = new TestLoadCommand( WriteTestFile( "c", 16 ), xC, LoadStage::IO, aEvents );
+			pC->m_aDependencies.PushBack( xA.GetPtr() );
+
+			oScheduler.PushLoadCommand( pA, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pB, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pC, LoadPriority::NORMAL );
+
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return oScheduler.GetWaitingDependenciesLoadCommandCount() == 2; } ) );
+
+			bLoadB = true;
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xC->IsLoading() == false; } ) );
+
+			Assert::IsTrue( xA->IsFailed() && xB->IsFailed() && xC->IsFailed() );
+			Assert::IsTrue( FindEvent( aEvents, "Finished b" ) < FindEvent( aEvents, "Ready a" ) );
+			Assert::IsTrue( FindEvent( aEvents, "Ready a" ) < FindEvent( aEvents, "Ready c" ) );
+
+			// A dependency which already failed is resolved as soon as the command is finished
+			TestResPtr xD = new TestResource();
+			TestResPtr xE = new TestResource();
+
+			oScheduler.PushLoadCommand( new TestLoadCommand( std::filesystem::temp_directory_path() / "LoadSchedulerTests.d", xD, LoadStage::IO, aEvents ), LoadPriority::NORMAL );
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xD->IsLoading() == false; } ) );
+			Assert::IsTrue( xD->IsFailed() );
+
+			TestLoadCommand* pE = new TestLoadCommand( WriteTestFile( "e", 16 ), xE, LoadStage::IO, aEvents );
+			pE->m_aDependencies.PushBack( xD.GetPtr() );
+			oScheduler.PushLoadCommand( pE, LoadPriority::NORMAL );
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xE->IsLoading() == false; } ) );
+
+			Assert::IsTrue( xE->IsFailed() );
+			Assert::AreEqual( 0u, oScheduler.GetWaitingDependenciesLoadCommandCount() );
+		}
+
+		TEST_METHOD( FinalizeBudgetTest )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			Array< std::string > aEvents;
+			std::atomic_uint uLoadCount( 0 );
+			bool bUpload = false;
+
+			LoadScheduler oScheduler( 1 );
+
+			// Only one of the files fits in the budget at a time
+			oScheduler.SetInFlightBytesBudget( LoadPriority::NORMAL, 1000 );
+
+			TestResPtr xA = new TestResource();
+			TestResPtr xB = new TestResource();
+
+			TestLoadCommand* pA = new TestLoadCommand( WriteTestFile( "a", 1000 ), xA, LoadStage::IO, aEvents );
+			pA->m_pUploadGate = &bUpload;
+			pA->m_pLoadCount = &uLoadCount;
+			TestLoadCommand* pB = new TestLoadCommand( WriteTestFile( "b", 1000 ), xB, LoadStage::IO, aEvents );
+			pB->m_pUploadGate = &bUpload;
+			pB->m_pLoadCount = &uLoadCount;
+
+			oScheduler.PushLoadCommand( pA, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pB, LoadPriority::NORMAL );
+
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return aEvents.Empty() == false; } ) );
+			Assert::IsTrue( aEvents[ 0 ] == "Finished a" );
+
+			// The bytes of a are held until it is uploaded, over several frames
+			for( uint u = 0; u < 20; ++u )
+			{
+				oScheduler.ProcessPendingLoadCommands();
+				oScheduler.FinalizeLoadCommands();
+				std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			}
+
+			Assert::AreEqual( 1u, uLoadCount.load() );
+			Assert::AreEqual( ( uint64 )1000, oScheduler.GetInFlightBytes() );
+			Assert::AreEqual( 1u, oScheduler.GetFinalizingLoadCommandCount() );
+			Assert::IsTrue( xA->IsLoading() && xB->IsLoading() );
+
+			// Releasing them lets b be read
+			bUpload = true;
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xB->IsLoading() == false; } ) );
+
+			Assert::AreEqual( 2u, uLoadCount.load() );
+			Assert::IsTrue( xA->IsLoaded() && xB->IsLoaded() );
+			Assert::AreEqual( ( uint64 )0, oScheduler.GetInFlightBytes() );
+			Assert::AreEqual( 0u, oScheduler.GetFinalizingLoadCommandCount() );
+		}
+
+		TEST_METHOD( PriorityOrderTest )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			Array< std::string > aEvents;
+
+			LoadScheduler oScheduler( 1 );
+
+			// Files are read one at a time, in the order of their priorities
+			oScheduler.SetInFlightBytesBudget( LoadPriority::NORMAL, 1 );
+			oScheduler.SetInFlightBytesBudget( LoadPriority::HIGH, 1 );
+
+			Array< TestResPtr > aResources;
+			Array< TestLoadCommand* > aLoadCommands;
+			for( const char* sName : { "a", "b", "c", "h", "x", "y" } )
+			{
+				aResources.PushBack( new TestResource() );
+				aLoadCommands.PushBack( new TestLoadCommand( WriteTestFile( sName, 16 ), aResources.Back(), LoadStage::IO, aEvents ) );
+			}
+
+			// x waits for y, which is only requested through it
+			aLoadCommands[ 4 ]->m_aDependencies.PushBack( aResources[ 5 ].GetPtr() );
+
+			for( TestLoadCommand* pLoadCommand : aLoadCommands )
+				oScheduler.PushLoadCommand( pLoadCommand, LoadPriority::NORMAL );
+
+			// b is requested twice in the frame and takes the closest distance, h takes a higher class
+			oScheduler.UpdateLoadPriority( aResources[ 0 ].GetPtr(), LoadPriority::NORMAL, 200.f );
+			oScheduler.UpdateLoadPriority( aResources[ 1 ].GetPtr(), LoadPriority::NORMAL, 100.f );
+			oScheduler.UpdateLoadPriority( aResources[ 1 ].GetPtr(), LoadPriority::NORMAL, 10.f );
+			oScheduler.UpdateLoadPriority( aResources[ 2 ].GetPtr(), LoadPriority::NORMAL, 50.f );
+			oScheduler.UpdateLoadPriority( aResources[ 3 ].GetPtr(), LoadPriority::HIGH, 500.f );
+			oScheduler.UpdateLoadPriority( aResources[ 4 ].GetPtr(), LoadPriority::NORMAL, 20.f );
+
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return aResources[ 0 ]->IsLoading() == false; } ) );
+
+			const char* aExpectedEvents[] = { "Finished h", "Finished b", "Finished x", "Finished y", "Ready x", "Finished c", "Finished a" };
+			Assert::AreEqual( ( uint )std::size( aExpectedEvents ), aEvents.Count() );
+			for( uint u = 0; u < aEvents.Count(); ++u )
+				Assert::IsTrue( aEvents[ u ] == aExpectedEvents[ u ] );
+		}
+
+		TEST_METHOD( CancelUnusedResourcesTest )
+		{
+			VirtualFileSystem oVirtualFileSystem;
+			Array< std::string > aEvents;
+			std::atomic_bool bLoadBlocker( false );
+			std::atomic_uint uLoadCount( 0 );
+			TestResource::s_uDestroyCount = 0;
+
+			LoadScheduler oScheduler( 1 );
+
+			// The blocker holds the budget on a decode thread, the other files stay queued behind it
+			oScheduler.SetInFlightBytesBudget( LoadPriority::NORMAL, 1 );
+
+			std::unordered_map< std::string, TestResPtr > mResources;
+			TestResPtr xBlocker = mResources[ "blocker" ] = new TestResource();
+			mResources[ "a" ] = new TestResource();
+			TestResPtr xB = mResources[ "b" ] = new TestResource();
+			mResources[ "c" ] = new TestResource();
+			mResources[ "c" ]->SetStatus( Resource::Status::LOADED );
+
+			TestLoadCommand* pBlocker = new TestLoadCommand( WriteTestFile( "blocker", 16 ), xBlocker, LoadStage::DECODE, aEvents );
+			pBlocker->m_pLoadGate = &bLoadBlocker;
+			pBlocker->m_pLoadCount = &uLoadCount;
+			TestLoadCommand* pA = new TestLoadCommand( WriteTestFile( "a", 16 ), mResources[ "a" ], LoadStage::IO, aEvents );
+			pA->m_pLoadCount = &uLoadCount;
+			TestLoadCommand* pB = new TestLoadCommand( WriteTestFile( "b", 16 ), xB, LoadStage::IO, aEvents );
+			pB->m_pLoadCount = &uLoadCount;
+
+			oScheduler.PushLoadCommand( pBlocker, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pA, LoadPriority::NORMAL );
+			oScheduler.PushLoadCommand( pB, LoadPriority::NORMAL );
+
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return oScheduler.GetInFlightBytes() > 0; } ) );
+
+			// a is only referenced by the map and its command, c only by the map
+			oScheduler.DestroyUnusedResources( mResources );
+
+			Assert::AreEqual( ( size_t )2, mResources.size() );
+			Assert::IsTrue( mResources.contains( "blocker" ) && mResources.contains( "b" ) );
+			Assert::AreEqual( 1u, TestResource::s_uDestroyCount );
+
+			// a is dropped before being read
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return TestResource::s_uDestroyCount == 2; } ) );
+			Assert::AreEqual( 0u, uLoadCount.load() );
+			Assert::IsTrue( aEvents.Empty() );
+
+			bLoadBlocker = true;
+			Assert::IsTrue( RunFrames( oScheduler, [ & ]() { return xB->IsLoading() == false; } ) );
+
+			Assert::AreEqual( 2u, uLoadCount.load() );
+			Assert::IsTrue( xBlocker->IsLoaded() && xB->IsLoaded() );
+			Assert::AreEqual( 2u, TestResource::s_uDestroyCount );
+			Assert::AreEqual( ( uint64 )0, oScheduler.GetInFlightBytes() );
+		}
+	};
+}
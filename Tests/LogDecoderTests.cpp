@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "Core/LogDecoder.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( LogDecoderTests )
+	{
+		template < typename... Args >
+		static std::string Format( const char* sFormat, const Args&... oArgs )
+		{
+			uint8 aArguments[ 1024 ];
+			uint8* pEnd = aArguments;
+			( ( pEnd = WriteLogArgument( pEnd, oArgs ) ), ... );
+
+			std::string sOutput;
+			FormatStructuredLog( sOutput, sFormat, LogArgumentTypes< Args... >::s_aTypes, sizeof...( Args ), aArguments, ( uint )( pEnd - aArguments ) );
+			return sOutput;
+		}
+
+		TEST_METHOD( FormatTest )
+		{
+			Assert::AreEqual( std::string( "No argument" ), Format( "No argument" ) );
+			Assert::AreEqual( std::string( "1 -2 3 true c" ), Format( "{} {} {} {} {}", 1u, ( int8 )-2, ( uint64 )3, true, 'c' ) );
+			Assert::AreEqual( std::string( "0.50 2.25" ), Format( "{:.2f} {}", 0.5f, 2.25 ) );
+			Assert::AreEqual( std::string( "Entity player (id : 12)" ), Format( "Entity {} (id : {})", std::string( "player" ), 12 ) );
+			Assert::AreEqual( std::string( "literal and view" ), Format( "{} and {}", "literal", std::string_view( "view" ) ) );
+			Assert::AreEqual( std::string( "b a b" ), Format( "{1} {0} {1}", "a", "b" ) );
+			Assert::AreEqual( std::string( "{ff}" ), Format( "{{{:x}}}", 255 ) );
+			Assert::AreEqual( std::string( "0x10" ), Format( "{}", ( const void* )0x10 ) );
+
+			// Bad specs and missing arguments don't lose the rest of the message
+			Assert::AreEqual( std::string( "{?} 2 {?}" ), Format( "{:s} {} {}", 1, 2 ) );
+		}
+
+		TEST_METHOD( BinaryLogTest )
+		{
+			const std::filesystem::path oFilePath = std::filesystem::temp_directory_path() / "LogDecoderTests.binlog";
+
+			::Logger::SetBinaryLog( oFilePath );
+
+			static constexpr LogDescriptor s_oDescriptor( "Loaded {} in {:.1f} ms", __FILE__, __LINE__, ::Logger::LEVEL_WARN, LogCategory::RESOURCES );
+			for( uint u = 0; u < 3; ++u )
+				::Logger::LogStructured( s_oDescriptor, "Loaded {} in {:.1f} ms", std::format( "File{}", u ), u * 0.5f );
+
+			::Logger::Flush();
+			::Logger::SetBinaryLog( std::filesystem::path() );
+
+			FILE* pOutput = tmpfile();
+			Assert::IsTrue( pOutput != nullptr );
+			Assert::IsTrue( DecodeBinaryLog( oFilePath, pOutput ) );
+
+			std::string sDecoded( ( size_t )ftell( pOutput ), '\0' );
+			rewind( pOutput );
+			Assert::AreEqual( sDecoded.length(), fread( sDecoded.data(), 1, sDecoded.length(), pOutput ) );
+			fclose( pOutput );
+
+			std::filesystem::remove( oFilePath );
+
+			Assert::IsTrue( sDecoded.find( "[WARN] [RESOURCES] " ) != std::string::npos );
+			Assert::IsTrue( sDecoded.find( "LogDecoderTests.cpp(" ) != std::string::npos );
+			Assert::IsTrue( sDecoded.find( " : Loaded File0 in 0.0 ms\n" ) < sDecoded.find( " : Loaded File1 in 0.5 ms\n" ) );
+			Assert::IsTrue( sDecoded.find( " : Loaded File1 in 0.5 ms\n" ) < sDecoded.find( " : Loaded File2 in 1.0 ms\n" ) );
+			Assert::IsTrue( sDecoded.find( "Loaded File2 in 1.0 ms\n" ) != std::string::npos );
+
+			Assert::IsFalse( DecodeBinaryLog( oFilePath, stdout ) );
+		}
+
+		TEST_METHOD( CorruptBinaryLogTest )
+		{
+			// String lengths going past the arguments, including ones wrapping around once their prefix is added
+			for( const uint uLength : { 2u, 0xFFFFFFFDu, 0xFFFFFFFFu } )
+			{
+				uint8 aArguments[ sizeof( uint ) + 1 ];
+				memcpy( aArguments, &uLength, sizeof( uint ) );
+				aArguments[ sizeof( uint ) ] = 'a';
+
+				const LogArgumentType eType = LogArgumentType::STRING;
+				std::string sOutput;
+				FormatStructuredLog( sOutput, "Name {}", &eType, 1, aArguments, sizeof( aArguments ) );
+				Assert::AreEqual( std::string( "Name {?}" ), sOutput );
+			}
+
+			const std::filesystem::path oFilePath = std::filesystem::temp_directory_path() / "LogDecoderTests.binlog";
+
+			::Logger::SetBinaryLog( oFilePath );
+
+			static constexpr LogDescriptor s_oDescriptor( "Loaded {}", __FILE__, __LINE__, ::Logger::LEVEL_WARN, LogCategory::RESOURCES );
+			::Logger::LogStructured( s_oDescriptor, "Loaded {}", std::string( "File" ) );
+
+			::Logger::Flush();
+			::Logger::SetBinaryLog( std::filesystem::path() );
+
+			std::ifstream oInputStream( oFilePath, std::ios::binary );
+			const std::string sContent( ( std::istreambuf_iterator< char >( oInputStream ) ), std::istreambuf_iterator< char >() );
+			oInputStream.close();
+
+			auto TestContent = [ & ]( const std::string& sChanged ) {
+				std::ofstream( oFilePath, std::ios::binary ).write( sChanged.data(), sChanged.length() );
+				Assert::IsFalse( DecodeBinaryLog( oFilePath, stdout ) );
+			};
+
+			TestContent( sContent.substr( 0, sContent.length() - 1 ) );
+
+			// Argument size of the entry, written right before its argument bytes
+			std::string sChanged = sContent;
+			const uint32 uLargeSize = 0xFFFFFFFF;
+			memcpy( sChanged.data() + sContent.length() - sizeof( uint ) - 4 - sizeof( uint32 ), &uLargeSize, sizeof( uLargeSize ) );
+			TestContent( sChanged );
+
+			std::filesystem::remove( oFilePath );
+		}
+	};
+}
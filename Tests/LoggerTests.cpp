@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <mutex>
+#include <thread>
+
+#include "Core/Logger.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( LoggerTests )
+	{
+		class TestLogger : public ::Logger
+		{
+		public:
+			std::string m_sLogs;
+
+		private:
+			void FlushLogs() override
+			{
+				m_sLogs += s_pLogBuffer;
+			}
+		};
+
+		TEST_METHOD( DeliveryTest )
+		{
+			TestLogger oLogger;
+
+			const uint64 uDroppedCount = ::Logger::GetDroppedCount();
+			const uint uThreadCount = 4;
+			const uint uEntryCount = 500;
+
+			std::thread aThreads[ uThreadCount ];
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				aThreads[ uThread ] = std::thread( [ uThread ]() {
+					for( uint u = 0; u < uEntryCount; ++u )
+						::Logger::Log( ::Logger::LEVEL_INFO, __FILE__, __LINE__, "Entry {} of thread {}", u, uThread );
+				} );
+			}
+
+			for( std::thread& oThread : aThreads )
+				oThread.join();
+
+			::Logger::Flush();
+
+			Assert::AreEqual( uDroppedCount, ::Logger::GetDroppedCount() );
+
+			uint uEntries = 0;
+			for( size_t uPosition = oLogger.m_sLogs.find( "Entry " ); uPosition != std::string::npos; uPosition = oLogger.m_sLogs.find( "Entry ", uPosition + 1 ) )
+				++uEntries;
+			Assert::AreEqual( uThreadCount * uEntryCount, uEntries );
+
+			// Entries of a thread keep their order
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				const size_t uFirstPosition = oLogger.m_sLogs.find( std::format( "Entry 0 of thread {}\n", uThread ) );
+				const size_t uLastPosition = oLogger.m_sLogs.find( std::format( "Entry {} of thread {}\n", uEntryCount - 1, uThread ) );
+				Assert::IsTrue( uFirstPosition != std::string::npos );
+				Assert::IsTrue( uLastPosition != std::string::npos );
+				Assert::IsTrue( uFirstPosition < uLastPosition );
+			}
+
+			Assert::IsTrue( oLogger.m_sLogs.find( "[INFO] " ) != std::string::npos );
+			Assert::IsTrue( oLogger.m_sLogs.find( "LoggerTests.cpp(" ) != std::string::npos );
+		}
+
+		TEST_METHOD( TruncationTest )
+		{
+			TestLogger oLogger;
+
+			const std::string sLongMessage( 2 * LOG_MESSAGE_SIZE, 'x' );
+			::Logger::Log( ::Logger::LEVEL_WARN, __FILE__, __LINE__, "{}", sLongMessage );
+			::Logger::Flush();
+
+			// The cut is marked rather than silent
+			Assert::IsTrue( oLogger.m_sLogs.find( std::string( LOG_MESSAGE_SIZE - 3, 'x' ) + "...\n" ) != std::string::npos );
+			Assert::IsTrue( oLogger.m_sLogs.find( std::string( LOG_MESSAGE_SIZE - 2, 'x' ) ) == std::string::npos );
+
+			static constexpr LogDescriptor s_oDescriptor( "Name {}", __FILE__, __LINE__, ::Logger::LEVEL_WARN, LogCategory::GAME );
+			::Logger::LogStructured( s_oDescriptor, "Name {}", std::string( 2 * LOG_MESSAGE_SIZE, 'y' ) );
+			::Logger::Flush();
+
+			Assert::IsTrue( oLogger.m_sLogs.find( " : Name " + std::string( LOG_MESSAGE_SIZE - 5 - 3, 'y' ) + "...\n" ) != std::string::npos );
+		}
+
+		TEST_METHOD( StructuredTest )
+		{
+			TestLogger oLogger;
+
+			static constexpr LogDescriptor s_oDescriptor( "Entity {} moved to ({:.1f}, {:.1f})", __FILE__, __LINE__, ::Logger::LEVEL_DEBUG, LogCategory::GAME );
+
+			::Logger::LogStructured( s_oDescriptor, "Entity {} moved to ({:.1f}, {:.1f})", std::string( "player" ), 1.f, -2.5f );
+
+			// Categories filter their levels independently
+			::Logger::SetCategoryLevel( LogCategory::GAME, ::Logger::LEVEL_INFO );
+			Assert::IsFalse( ::Logger::IsEnabled( LogCategory::GAME, ::Logger::LEVEL_DEBUG ) );
+			Assert::IsTrue( ::Logger::IsEnabled( LogCategory::GAME, ::Logger::LEVEL_WARN ) );
+			Assert::IsTrue( ::Logger::IsEnabled( LogCategory::PHYSICS, ::Logger::LEVEL_DEBUG ) );
+			::Logger::SetCategoryLevel( LogCategory::GAME, ::Logger::LEVEL_TRACE );
+
+			::Logger::Flush();
+
+			Assert::IsTrue( oLogger.m_sLogs.find( "[DEBUG] [GAME] " ) != std::string::npos );
+			Assert::IsTrue( oLogger.m_sLogs.find( " : Entity player moved to (1.0, -2.5)\n" ) != std::string::npos );
+		}
+
+		TEST_METHOD( StructuredSpeedTest )
+		{
+			// Batches fit in the ring of the thread so that no entry is dropped
+			const uint uBatchCount = 100;
+			const uint uEntryCount = 500;
+
+			static constexpr LogDescriptor s_oDescriptor( "Entity {} created at ({}, {}, {})", __FILE__, __LINE__, ::Logger::LEVEL_INFO, LogCategory::GAME );
+
+			std::chrono::nanoseconds oFormattedDuration( 0 );
+			std::chrono::nanoseconds oStructuredDuration( 0 );
+			for( uint uBatch = 0; uBatch < uBatchCount; ++uBatch )
+			{
+				auto t1 = std::chrono::high_resolution_clock::now();
+				for( uint u = 0; u < uEntryCount; ++u )
+					::Logger::Log( ::Logger::LEVEL_INFO, __FILE__, __LINE__, "Entity {} created at ({}, {}, {})", u, u * 0.5f, 1.f, -2.f );
+				auto t2 = std::chrono::high_resolution_clock::now();
+				::Logger::Flush();
+
+				auto t3 = std::chrono::high_resolution_clock::now();
+				for( uint u = 0; u < uEntryCount; ++u )
+					::Logger::LogStructured( s_oDescriptor, "Entity {} created at ({}, {}, {})", u, u * 0.5f, 1.f, -2.f );
+				auto t4 = std::chrono::high_resolution_clock::now();
+				::Logger::Flush();
+
+				oFormattedDuration += t2 - t1;
+				oStructuredDuration += t4 - t3;
+			}
+
+			const uint uTotalCount = uBatchCount * uEntryCount;
+			Microsoft::VisualStudio::CppUnitTestFramework::Logger::WriteMessage( std::format( "{} entries : formatted {:.1f} ns/entry, structured {:.1f} ns/entry\n", uTotalCount, ( double )oFormattedDuration.count() / uTotalCount,
+				( double )oStructuredDuration.count() / uTotalCount ).c_str() );
+
+			// Suspicious if not, but not a hard truth
+			Assert::IsTrue( oStructuredDuration < oFormattedDuration );
+		}
+
+		TEST_METHOD( ThroughputSpeedTest )
+		{
+			const uint uThreadCount = 8;
+			const uint uEntryCount = 50000;
+
+			// Batches fit in the ring of each thread and are flushed, so that only delivered entries are measured
+			const uint uBatchSize = 250;
+
+			// Time spent logging, summed over the threads
+			auto RunThreads = [ & ]( auto&& oLog ) {
+				std::atomic< int64 > iDuration = 0;
+
+				std::thread aThreads[ uThreadCount ];
+				for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+				{
+					aThreads[ uThread ] = std::thread( [ &oLog, &iDuration, uThread ]() {
+						std::chrono::nanoseconds oDuration( 0 );
+						for( uint uBatch = 0; uBatch < uEntryCount; uBatch += uBatchSize )
+						{
+							auto t1 = std::chrono::high_resolution_clock::now();
+							for( uint u = uBatch; u < uBatch + uBatchSize; ++u )
+								oLog( uThread, u );
+							auto t2 = std::chrono::high_resolution_clock::now();
+							::Logger::Flush();
+
+							oDuration += t2 - t1;
+						}
+
+						iDuration += oDuration.count();
+					} );
+				}
+
+				for( std::thread& oThread : aThreads )
+					oThread.join();
+
+				return std::chrono::nanoseconds( iDuration.load() );
+			};
+
+			// Formatting the whole entry under a lock, like a synchronous logger made thread safe
+			std::mutex oMutex;
+			std::string sBuffer;
+			sBuffer.reserve( 10 * 1024 );
+
+			const uint64 uDroppedCount = ::Logger::GetDroppedCount();
+
+			const std::chrono::nanoseconds oAsyncDuration = RunThreads( []( const uint uThread, const uint u ) {
+				::Logger::Log( ::Logger::LEVEL_INFO, __FILE__, __LINE__, "Entity {} created by thread {} at ({}, {}, {})", u, uThread, u * 0.5f, 1.f, -2.f );
+			} );
+			const std::chrono::nanoseconds oLockedDuration = RunThreads( [ & ]( const uint uThread, const uint u ) {
+				const std::string sLog = std::format( "{} [{}] {}({}) : {}\n", std::chrono::system_clock::now(), "INFO", __FILE__, __LINE__, std::format( "Entity {} created by thread {} at ({}, {}, {})", u, uThread, u * 0.5f, 1.f, -2.f ) );
+
+				std::unique_lock oLock( oMutex );
+				if( sBuffer.length() + sLog.length() > sBuffer.capacity() )
+					sBuffer.clear();
+				sBuffer += sLog;
+			} );
+
+			const uint uTotalCount = uThreadCount * uEntryCount;
+			Assert::AreEqual( uDroppedCount, ::Logger::GetDroppedCount() );
+
+			Microsoft::VisualStudio::CppUnitTestFramework::Logger::WriteMessage( std::format( "{} entries from {} threads : async {:.1f} ns/entry, locked {:.1f} ns/entry\n", uTotalCount, uThreadCount, ( double )oAsyncDuration.count() / uTotalCount,
+				( double )oLockedDuration.count() / uTotalCount ).c_str() );
+
+			// Suspicious if not, but not a hard truth
+			Assert::IsTrue( oAsyncDuration < oLockedDuration );
+		}
+	};
+}
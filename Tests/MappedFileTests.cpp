@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Core/MappedFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( MappedFileTests )
+	{
+		static std::filesystem::path WriteTestFile( const char* sFileName, const std::string& sContent )
+		{
+			const std::filesystem::path oFilePath = std::filesystem::temp_directory_path() / sFileName;
+
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream.write( sContent.data(), sContent.length() );
+
+			return oFilePath;
+		}
+
+		TEST_METHOD( ReadTest )
+		{
+			const std::string sContent = "{\r\n\t\"scene\": []\r\n}";
+			const std::filesystem::path oFilePath = WriteTestFile( "MappedFileTests.txt", sContent );
+
+			{
+				const MappedFile oMappedFile( oFilePath );
+
+				Assert::IsTrue( oMappedFile.IsOpen() );
+				Assert::AreEqual( ( uint64 )sContent.length(), oMappedFile.GetSize() );
+				Assert::IsTrue( oMappedFile.GetText() == sContent );
+
+				const ArrayView< const uint8 > aData = oMappedFile.GetData();
+				Assert::AreEqual( ( uint )sContent.length(), aData.Count() );
+				Assert::AreEqual( ( uint8 )'{', aData.Front() );
+				Assert::AreEqual( ( uint8 )'}', aData.Back() );
+			}
+
+			std::filesystem::remove( oFilePath );
+		}
+
+		TEST_METHOD( EmptyTest )
+		{
+			const std::filesystem::path oFilePath = WriteTestFile( "MappedFileTests.empty", "" );
+
+			{
+				const MappedFile oMappedFile( oFilePath );
+
+				Assert::IsTrue( oMappedFile.IsOpen() );
+				Assert::AreEqual( ( uint64 )0, oMappedFile.GetSize() );
+				Assert::IsTrue( oMappedFile.GetData().Empty() );
+				Assert::IsTrue( oMappedFile.GetText().empty() );
+			}
+
+			std::filesystem::remove( oFilePath );
+
+			const MappedFile oMissingFile( oFilePath );
+			Assert::IsFalse( oMissingFile.IsOpen() );
+			Assert::IsTrue( oMissingFile.GetData().Empty() );
+		}
+
+		TEST_METHOD( MoveTest )
+		{
+			const std::filesystem::path oFilePath = WriteTestFile( "MappedFileTests.bin", "mapped" );
+
+			{
+				MappedFile oMappedFile( oFilePath );
+				MappedFile oMovedFile( std::move( oMappedFile ) );
+
+				Assert::IsFalse( oMappedFile.IsOpen() );
+				Assert::IsTrue( oMovedFile.GetText() == "mapped" );
+
+				oMappedFile = std::move( oMovedFile );
+				Assert::IsFalse( oMovedFile.IsOpen() );
+				Assert::IsTrue( oMappedFile.GetText() == "mapped" );
+
+				oMappedFile.Close();
+				Assert::IsFalse( oMappedFile.IsOpen() );
+			}
+
+			// The file is not locked once unmapped
+			Assert::IsTrue( std::filesystem::remove( oFilePath ) );
+		}
+	};
+}
@@ -0,0 +1,235 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Core/MeshFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( MeshFileTests )
+	{
+		static std::filesystem::path GetMeshFilePath()
+		{
+			const std::filesystem::path oDirectory = std::filesystem::temp_directory_path() / "MeshFileTests";
+			std::filesystem::create_directories( oDirectory );
+			return oDirectory / "Test.mesh";
+		}
+
+		// Two submeshes, the second one skinned, a skeleton of three nodes and an animation of the root
+		static MeshFileData CreateMeshFileData()
+		{
+			MeshFileData oData;
+			oData.m_oAABB = { { -1.f, 0.f, -1.f }, { 1.f, 2.f, 1.f } };
+
+			MeshFileSubmesh oSubmesh {};
+			oSubmesh.m_oVertices = { 0, 3 * 5 };
+			oSubmesh.m_oIndices = { 0, 3 };
+			oSubmesh.m_uUVsSize = 2;
+			oSubmesh.m_uMaterialIndex = 0;
+			oSubmesh.m_oAABB = { { 0.f, 0.f, 0.f }, { 1.f, 1.f, 0.f } };
+			oData.m_aSubmeshes.PushBack( oSubmesh );
+
+			oSubmesh.m_oVertices = { 3 * 5, 4 * 11 };
+			oSubmesh.m_oIndices = { 3, 6 };
+			oSubmesh.m_uUVsSize = 0;
+			oSubmesh.m_uBonesSize = 4;
+			oSubmesh.m_uWeightsSize = 4;
+			oSubmesh.m_uMaterialIndex = 1;
+			oData.m_aSubmeshes.PushBack( oSubmesh );
+
+			for( uint u = 0; u < 3 * 5 + 4 * 11; ++u )
+				oData.m_aVertices.PushBack( ( float )u * 0.5f );
+
+			for( const uint32 uIndex : { 0u, 1u, 2u, 0u, 1u, 2u, 2u, 3u, 0u } )
+				oData.m_aIndices.PushBack( uIndex );
+
+			oData.m_aNodes.PushBack( { 0, 2 } );
+			oData.m_aNodes.PushBack( { 1, 0 } );
+			oData.m_aNodes.PushBack( { 2, 0 } );
+
+			for( uint u = 0; u < 3; ++u )
+			{
+				MeshFileMatrix oMatrix {};
+				oMatrix.m_aValues[ 0 ] = oMatrix.m_aValues[ 4 ] = oMatrix.m_aValues[ 8 ] = 1.f;
+				oMatrix.m_aValues[ 9 ] = ( float )u;
+				oData.m_aPoseMatrices.PushBack( oMatrix );
+				oData.m_aSkinMatrices.PushBack( oMatrix );
+			}
+
+			const std::string sName = "Walk";
+
+			MeshFileAnimation oAnimation {};
+			oAnimation.m_oName = oData.AddBlob( sName.data(), ( uint )sName.length() );
+			oAnimation.m_oChannels = { 0, 1 };
+			oAnimation.m_fDuration = 1.5f;
+			oData.m_aAnimations.PushBack( oAnimation );
+
+			MeshFileChannel oChannel {};
+			oChannel.m_oPositionCurve = { { 0, 2 }, { 0, 6 } };
+			oChannel.m_oRotationCurve = { { 0, 2 }, { 6, 8 } };
+			oChannel.m_oScaleCurve = { { 0, 1 }, { 14, 3 } };
+			oChannel.m_uMatrixIndex = 0;
+			oData.m_aChannels.PushBack( oChannel );
+
+			oData.m_aKeyTimes.PushBack( 0.f );
+			oData.m_aKeyTimes.PushBack( 1.5f );
+			for( uint u = 0; u < 17; ++u )
+				oData.m_aKeyValues.PushBack( ( float )u );
+
+			oData.m_aMaterials.PushBack( { { 1.f, 0.f, 0.f }, { 0.5f, 0.5f, 0.5f }, { 0.f, 0.f, 0.f }, 32.f } );
+			oData.m_aMaterials.PushBack( { { 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, 8.f } );
+
+			const std::string sPath = "Textures/diffuse.png";
+			const uint8 aEmbeddedData[] = { 0x89, 'P', 'N', 'G' };
+
+			MeshFileMaterialTexture oMaterialTexture {};
+			oMaterialTexture.m_uMaterialIndex = 1;
+			oMaterialTexture.m_uSlot = 0;
+			oMaterialTexture.m_oPath = oData.AddBlob( sPath.data(), ( uint )sPath.length() );
+			oMaterialTexture.m_oEmbeddedData = oData.AddBlob( aEmbeddedData, sizeof( aEmbeddedData ) );
+			oMaterialTexture.m_uSRGB = 1;
+			oData.m_aMaterialTextures.PushBack( oMaterialTexture );
+
+			return oData;
+		}
+
+		template < typename T >
+		static void AssertEqual( const Array< T >& aExpected, const ArrayView< const T > aActual )
+		{
+			Assert::AreEqual( aExpected.Count(), aActual.Count() );
+			Assert::IsTrue( aExpected.Empty() || memcmp( aExpected.Data(), aActual.Data(), aExpected.Count() * sizeof( T ) ) == 0 );
+		}
+
+		static void WriteTestFile( const std::filesystem::path& oFilePath, const std::string& sContent )
+		{
+			std::ofstream oFileStream( oFilePath, std::ios::binary | std::ios::trunc );
+			oFileStream.write( sContent.data(), sContent.length() );
+		}
+
+		static std::string ReadTestFile( const std::filesystem::path& oFilePath )
+		{
+			std::ifstream oFileStream( oFilePath, std::ios::binary );
+			return std::string( std::istreambuf_iterator< char >( oFileStream ), std::istreambuf_iterator< char >() );
+		}
+
+		TEST_METHOD( RoundTripTest )
+		{
+			const std::filesystem::path oFilePath = GetMeshFilePath();
+			const MeshFileData oData = CreateMeshFileData();
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+
+			MeshFile oMeshFile;
+			Assert::IsTrue( oMeshFile.Open( oFilePath ) );
+
+			Assert::IsTrue( memcmp( &oData.m_oAABB, &oMeshFile.GetAABB(), sizeof( MeshFileBox ) ) == 0 );
+			AssertEqual( oData.m_aVertices, oMeshFile.GetVertices() );
+			AssertEqual( oData.m_aIndices, oMeshFile.GetIndices() );
+			AssertEqual( oData.m_aSubmeshes, oMeshFile.GetSubmeshes() );
+			AssertEqual( oData.m_aNodes, oMeshFile.GetNodes() );
+			AssertEqual( oData.m_aPoseMatrices, oMeshFile.GetPoseMatrices() );
+			AssertEqual( oData.m_aSkinMatrices, oMeshFile.GetSkinMatrices() );
+			AssertEqual( oData.m_aAnimations, oMeshFile.GetAnimations() );
+			AssertEqual( oData.m_aChannels, oMeshFile.GetChannels() );
+			AssertEqual( oData.m_aKeyTimes, oMeshFile.GetKeyTimes() );
+			AssertEqual( oData.m_aKeyValues, oMeshFile.GetKeyValues() );
+			AssertEqual( oData.m_aMaterials, oMeshFile.GetMaterials() );
+			AssertEqual( oData.m_aMaterialTextures, oMeshFile.GetMaterialTextures() );
+
+			// Submeshes are used in place, their vertices and indices point into the mapping
+			const MeshFileSubmesh& oSkinnedSubmesh = oMeshFile.GetSubmeshes()[ 1 ];
+			Assert::AreEqual( 4u * 11u, oMeshFile.GetVertices( oSkinnedSubmesh ).Count() );
+			Assert::IsTrue( oMeshFile.GetVertices( oSkinnedSubmesh ).Data() == oMeshFile.GetVertices().Data() + 3 * 5 );
+			Assert::AreEqual( 6u, oMeshFile.GetIndices( oSkinnedSubmesh ).Count() );
+			Assert::AreEqual( ( uint32 )3, oMeshFile.GetIndices( oSkinnedSubmesh )[ 4 ] );
+
+			Assert::IsTrue( oMeshFile.GetString( oMeshFile.GetAnimations()[ 0 ].m_oName ) == "Walk" );
+			Assert::IsTrue( oMeshFile.GetString( oMeshFile.GetMaterialTextures()[ 0 ].m_oPath ) == "Textures/diffuse.png" );
+			Assert::AreEqual( 4u, oMeshFile.GetBlob( oMeshFile.GetMaterialTextures()[ 0 ].m_oEmbeddedData ).Count() );
+			Assert::AreEqual( ( uint8 )'P', oMeshFile.GetBlob( oMeshFile.GetMaterialTextures()[ 0 ].m_oEmbeddedData )[ 1 ] );
+
+			Assert::AreEqual( ( uintptr_t )0, ( uintptr_t )oMeshFile.GetVertices().Data() % MESH_FILE_ALIGNMENT );
+			Assert::AreEqual( ( uintptr_t )0, ( uintptr_t )oMeshFile.GetSubmeshes().Data() % MESH_FILE_ALIGNMENT );
+			Assert::AreEqual( ( uintptr_t )0, ( uintptr_t )oMeshFile.GetPoseMatrices().Data() % MESH_FILE_ALIGNMENT );
+		}
+
+		TEST_METHOD( EmptyTest )
+		{
+			const std::filesystem::path oFilePath = GetMeshFilePath();
+			Assert::IsTrue( WriteMeshFile( oFilePath, MeshFileData() ) );
+
+			MeshFile oMeshFile;
+			Assert::IsTrue( oMeshFile.Open( oFilePath ) );
+			Assert::IsTrue( oMeshFile.GetSubmeshes().Empty() );
+			Assert::IsTrue( oMeshFile.GetNodes().Empty() );
+			Assert::IsTrue( oMeshFile.GetAnimations().Empty() );
+		}
+
+		TEST_METHOD( InvalidTest )
+		{
+			const std::filesystem::path oFilePath = GetMeshFilePath();
+			Assert::IsTrue( WriteMeshFile( oFilePath, CreateMeshFileData() ) );
+			const std::string sContent = ReadTestFile( oFilePath );
+
+			MeshFile oMeshFile;
+
+			WriteTestFile( oFilePath, sContent.substr( 0, sContent.length() - 1 ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			WriteTestFile( oFilePath, sContent.substr( 0, sizeof( MeshFileHeader ) - 1 ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			std::string sChanged = sContent;
+			sChanged[ offsetof( MeshFileHeader, m_uVersion ) ] += 1;
+			WriteTestFile( oFilePath, sChanged );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			// A submesh going past the vertices
+			MeshFileData oData = CreateMeshFileData();
+			oData.m_aSubmeshes[ 1 ].m_oVertices.m_uCount += 11;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			// An index past the vertices of its submesh
+			oData = CreateMeshFileData();
+			oData.m_aIndices[ 8 ] = 4;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			// A skeleton node missing a child
+			oData = CreateMeshFileData();
+			oData.m_aNodes[ 0 ].m_uChildCount = 3;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			// A node and a channel animating a matrix past the pose and skin matrices
+			oData = CreateMeshFileData();
+			oData.m_aNodes[ 2 ].m_uMatrixIndex = 3;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			oData = CreateMeshFileData();
+			oData.m_aChannels[ 0 ].m_uMatrixIndex = 3;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			oData = CreateMeshFileData();
+			oData.m_aSkinMatrices.PopBack();
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			// A rotation curve with 3 values per key
+			oData = CreateMeshFileData();
+			oData.m_aChannels[ 0 ].m_oRotationCurve.m_oValues.m_uCount = 6;
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+			Assert::IsFalse( oMeshFile.Open( oFilePath ) );
+
+			WriteTestFile( oFilePath, sContent );
+			Assert::IsTrue( oMeshFile.Open( oFilePath ) );
+		}
+	};
+}
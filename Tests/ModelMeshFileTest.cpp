@@ -0,0 +1,2 @@
+#include "pch.h"
+#include "Game/ModelMeshFile.cpp"
\ No newline at end of file
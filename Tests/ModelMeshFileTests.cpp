@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+
+#include "Game/ModelMeshFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( ModelMeshFileTests )
+	{
+		static std::filesystem::path GetMeshFilePath()
+		{
+			const std::filesystem::path oDirectory = std::filesystem::temp_directory_path() / "ModelMeshFileTests";
+			std::filesystem::create_directories( oDirectory );
+			return oDirectory / "Test.mesh";
+		}
+
+		// A root with two children, the first one with a child of its own, so that the nodes are not written in matrix order
+		static Skeleton CreateSkeleton()
+		{
+			Skeleton oSkeleton;
+			oSkeleton.m_uMatrixIndex = 0;
+			oSkeleton.m_aChildren.Resize( 2 );
+			oSkeleton.m_aChildren[ 0 ].m_uMatrixIndex = 2;
+			oSkeleton.m_aChildren[ 0 ].m_aChildren.Resize( 1 );
+			oSkeleton.m_aChildren[ 0 ].m_aChildren[ 0 ].m_uMatrixIndex = 3;
+			oSkeleton.m_aChildren[ 1 ].m_uMatrixIndex = 1;
+			return oSkeleton;
+		}
+
+		static Array< glm::mat4x3 > CreateMatrices( const float fOffset )
+		{
+			Array< glm::mat4x3 > aMatrices;
+			for( uint u = 0; u < 4; ++u )
+			{
+				glm::mat4x3 mMatrix( 1.f );
+				mMatrix[ 3 ] = glm::vec3( fOffset + ( float )u, 2.f * ( float )u, -( float )u );
+				aMatrices.PushBack( mMatrix );
+			}
+
+			return aMatrices;
+		}
+
+		// Channels of different key counts, and an animation without any
+		static Array< Animation > CreateAnimations()
+		{
+			Array< Animation > aAnimations( 2 );
+			aAnimations[ 0 ].m_sName = "Walk";
+			aAnimations[ 0 ].m_fDuration = 1.5f;
+			aAnimations[ 0 ].m_aNodeAnimations.Resize( 2 );
+
+			NodeAnimation& oRootAnimation = aAnimations[ 0 ].m_aNodeAnimations[ 0 ];
+			oRootAnimation.m_uMatrixIndex = 0;
+			for( uint u = 0; u < 3; ++u )
+			{
+				oRootAnimation.m_oPositionCurve.m_aTimes.PushBack( 0.5f * ( float )u );
+				oRootAnimation.m_oPositionCurve.m_aValues.PushBack( glm::vec3( ( float )u, 0.f, 1.f ) );
+			}
+			oRootAnimation.m_oRotationCurve.m_aTimes.PushBack( 0.f );
+			oRootAnimation.m_oRotationCurve.m_aValues.PushBack( glm::quat( 1.f, 0.f, 0.f, 0.f ) );
+			oRootAnimation.m_oScaleCurve.m_aTimes.PushBack( 0.f );
+			oRootAnimation.m_oScaleCurve.m_aValues.PushBack( glm::vec3( 1.f ) );
+
+			NodeAnimation& oLeafAnimation = aAnimations[ 0 ].m_aNodeAnimations[ 1 ];
+			oLeafAnimation.m_uMatrixIndex = 3;
+			oLeafAnimation.m_oRotationCurve.m_aTimes.PushBack( 0.f );
+			oLeafAnimation.m_oRotationCurve.m_aTimes.PushBack( 1.5f );
+			oLeafAnimation.m_oRotationCurve.m_aValues.PushBack( glm::quat( 1.f, 0.f, 0.f, 0.f ) );
+			oLeafAnimation.m_oRotationCurve.m_aValues.PushBack( glm::quat( 0.f, 0.f, 1.f, 0.f ) );
+
+			aAnimations[ 1 ].m_sName = "Idle";
+			aAnimations[ 1 ].m_fDuration = 0.f;
+
+			return aAnimations;
+		}
+
+		template < typename T >
+		static void AssertEqual( const Array< T >& aExpected, const Array< T >& aActual )
+		{
+			Assert::AreEqual( aExpected.Count(), aActual.Count() );
+			Assert::IsTrue( aExpected.Empty() || memcmp( aExpected.Data(), aActual.Data(), aExpected.Count() * sizeof( T ) ) == 0 );
+		}
+
+		template < typename T >
+		static void AssertEqual( const AnimationCurve< T >& oExpected, const AnimationCurve< T >& oActual )
+		{
+			AssertEqual( oExpected.m_aTimes, oActual.m_aTimes );
+			AssertEqual( oExpected.m_aValues, oActual.m_aValues );
+		}
+
+		static void AssertEqual( const Skeleton& oExpected, const Skeleton& oActual )
+		{
+			Assert::AreEqual( oExpected.m_uMatrixIndex, oActual.m_uMatrixIndex );
+			Assert::AreEqual( oExpected.m_aChildren.Count(), oActual.m_aChildren.Count() );
+
+			for( uint u = 0; u < oExpected.m_aChildren.Count(); ++u )
+				AssertEqual( oExpected.m_aChildren[ u ], oActual.m_aChildren[ u ] );
+		}
+
+		TEST_METHOD( RoundTripTest )
+		{
+			const Skeleton oSkeleton = CreateSkeleton();
+			const Array< glm::mat4x3 > aPoseMatrices = CreateMatrices( 0.f );
+			const Array< glm::mat4x3 > aSkinMatrices = CreateMatrices( 10.f );
+			const Array< Animation > aAnimations = CreateAnimations();
+
+			// Written and read the way a model is exported and loaded
+			MeshFileData oData;
+			WriteMeshFileAnimations( oData, oSkeleton, aPoseMatrices, aSkinMatrices, aAnimations );
+
+			const std::filesystem::path oFilePath = GetMeshFilePath();
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+
+			MeshFile oMeshFile;
+			Assert::IsTrue( oMeshFile.Open( oFilePath ) );
+
+			Skeleton oReadSkeleton;
+			Array< glm::mat4x3 > aReadPoseMatrices;
+			Array< glm::mat4x3 > aReadSkinMatrices;
+			Array< Animation > aReadAnimations;
+			ReadMeshFileAnimations( oMeshFile, oReadSkeleton, aReadPoseMatrices, aReadSkinMatrices, aReadAnimations );
+
+			AssertEqual( oSkeleton, oReadSkeleton );
+			AssertEqual( aPoseMatrices, aReadPoseMatrices );
+			AssertEqual( aSkinMatrices, aReadSkinMatrices );
+
+			Assert::AreEqual( aAnimations.Count(), aReadAnimations.Count() );
+			for( uint uAnimation = 0; uAnimation < aAnimations.Count(); ++uAnimation )
+			{
+				const Animation& oAnimation = aAnimations[ uAnimation ];
+				const Animation& oReadAnimation = aReadAnimations[ uAnimation ];
+				Assert::IsTrue( oAnimation.m_sName == oReadAnimation.m_sName );
+				Assert::AreEqual( oAnimation.m_fDuration, oReadAnimation.m_fDuration );
+				Assert::AreEqual( oAnimation.m_aNodeAnimations.Count(), oReadAnimation.m_aNodeAnimations.Count() );
+
+				for( uint uChannel = 0; uChannel < oAnimation.m_aNodeAnimations.Count(); ++uChannel )
+				{
+					const NodeAnimation& oNodeAnimation = oAnimation.m_aNodeAnimations[ uChannel ];
+					const NodeAnimation& oReadNodeAnimation = oReadAnimation.m_aNodeAnimations[ uChannel ];
+					Assert::AreEqual( oNodeAnimation.m_uMatrixIndex, oReadNodeAnimation.m_uMatrixIndex );
+					AssertEqual( oNodeAnimation.m_oPositionCurve, oReadNodeAnimation.m_oPositionCurve );
+					AssertEqual( oNodeAnimation.m_oRotationCurve, oReadNodeAnimation.m_oRotationCurve );
+					AssertEqual( oNodeAnimation.m_oScaleCurve, oReadNodeAnimation.m_oScaleCurve );
+				}
+			}
+		}
+
+		// A model without skeleton nor animations, the matrices are still read
+		TEST_METHOD( StaticModelTest )
+		{
+			MeshFileData oData;
+			WriteMeshFileAnimations( oData, Skeleton(), CreateMatrices( 0.f ), CreateMatrices( 0.f ), Array< Animation >() );
+			Assert::AreEqual( 1u, oData.m_aNodes.Count() );
+
+			const std::filesystem::path oFilePath = GetMeshFilePath();
+			Assert::IsTrue( WriteMeshFile( oFilePath, oData ) );
+
+			MeshFile oMeshFile;
+			Assert::IsTrue( oMeshFile.Open( oFilePath ) );
+
+			Skeleton oReadSkeleton;
+			Array< glm::mat4x3 > aReadPoseMatrices;
+			Array< glm::mat4x3 > aReadSkinMatrices;
+			Array< Animation > aReadAnimations;
+			ReadMeshFileAnimations( oMeshFile, oReadSkeleton, aReadPoseMatrices, aReadSkinMatrices, aReadAnimations );
+
+			AssertEqual( Skeleton(), oReadSkeleton );
+			Assert::AreEqual( 4u, aReadPoseMatrices.Count() );
+			Assert::AreEqual( 4u, aReadSkinMatrices.Count() );
+			Assert::IsTrue( aReadAnimations.Empty() );
+		}
+	};
+}
@@ -0,0 +1,6 @@
+#include "pch.h"
+#include "Core/PackFile.cpp"
+
+// Implemented by ResourceLoader.cpp in the engine, packs only need its zlib decoder
+#define STB_IMAGE_IMPLEMENTATION
+#include "Core/stb_image.h"
\ No newline at end of file
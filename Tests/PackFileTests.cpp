@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Core/PackFile.h"
+#include "Core/VirtualFileSystem.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( PackFileTests )
+	{
+		static void WriteTestFile( const std::filesystem::path& oFilePath, const std::string& sContent )
+		{
+			std::filesystem::create_directories( oFilePath.parent_path() );
+
+			std::ofstream oFileStream( oFilePath, std::ios::binary );
+			oFileStream.write( sContent.data(), sContent.length() );
+		}
+
+		static void TestPack( const bool bCompress )
+		{
+			const std::filesystem::path oRootPath = std::filesystem::temp_directory_path() / "PackFileTests";
+			const std::filesystem::path oDirectory = oRootPath / "Data";
+			const std::filesystem::path oPackPath = oRootPath / "Data.pack";
+
+			const std::string sCompressible( 4096, 'a' );
+			WriteTestFile( oDirectory / "Scene" / "test.scene", "{ \"scene\": [] }" );
+			WriteTestFile( oDirectory / "Textures" / "grass.png", sCompressible );
+			WriteTestFile( oDirectory / "empty.txt", "" );
+
+			Assert::IsTrue( WritePackFile( oDirectory, oPackPath, bCompress ) );
+
+			{
+				PackFile oPackFile;
+				Assert::IsTrue( oPackFile.Open( oPackPath ) );
+				Assert::AreEqual( 3u, oPackFile.GetEntries().Count() );
+
+				const PackEntry* pEntry = oPackFile.Find( "Textures/grass.png" );
+				Assert::IsTrue( pEntry != nullptr );
+				Assert::AreEqual( ( uint64 )sCompressible.length(), pEntry->m_uSize );
+				Assert::IsTrue( pEntry->m_eCompression == ( bCompress ? PackCompression::ZLIB : PackCompression::NONE ) );
+				Assert::IsTrue( oPackFile.GetPath( *pEntry ) == "Textures/grass.png" );
+				Assert::IsTrue( oPackFile.Find( "Textures/dirt.png" ) == nullptr );
+
+				// Small entries are not worth compressing
+				Assert::IsTrue( oPackFile.Find( "Scene/test.scene" )->m_eCompression == PackCompression::NONE );
+
+				for( const PackEntry& oEntry : oPackFile.GetEntries() )
+					Assert::AreEqual( ( uint64 )0, oEntry.m_uOffset % PACK_DATA_ALIGNMENT );
+			}
+
+			// Files are replaced on disk so that reads coming from the pack can be told apart
+			WriteTestFile( oDirectory / "Scene" / "test.scene", "loose" );
+			WriteTestFile( oDirectory / "loose.txt", "loose only" );
+
+			{
+				VirtualFileSystem oVirtualFileSystem;
+				Assert::IsTrue( oVirtualFileSystem.Mount( oPackPath, oDirectory.generic_string() ) );
+
+				const VirtualFile oScene = oVirtualFileSystem.Open( oDirectory / "Textures" / ".." / "Scene" / "test.scene" );
+				Assert::IsTrue( oScene.IsOpen() );
+				Assert::IsTrue( oScene.GetText() == "{ \"scene\": [] }" );
+
+				const VirtualFile oTexture = oVirtualFileSystem.Open( oDirectory / "Textures" / "grass.png" );
+				Assert::IsTrue( oTexture.GetText() == sCompressible );
+
+				const VirtualFile oEmpty = oVirtualFileSystem.Open( oDirectory / "empty.txt" );
+				Assert::IsTrue( oEmpty.IsOpen() );
+				Assert::AreEqual( ( uint64 )0, oEmpty.GetSize() );
+
+				// Files missing from the pack fall back to loose files
+				Assert::IsTrue( oVirtualFileSystem.Exists( oDirectory / "loose.txt" ) );
+				Assert::IsTrue( oVirtualFileSystem.Open( oDirectory / "loose.txt" ).GetText() == "loose only" );
+
+				Assert::IsFalse( oVirtualFileSystem.Exists( oDirectory / "missing.txt" ) );
+				Assert::IsFalse( oVirtualFileSystem.Open( oDirectory / "missing.txt" ).IsOpen() );
+
+				// Located entries are read straight from the pack file and decompressed after
+				VirtualFileLocation oLocation;
+				Assert::IsTrue( oVirtualFileSystem.Locate( oDirectory / "Textures" / "grass.png", oLocation ) );
+				Assert::IsTrue( oLocation.m_oFilePath == oPackPath );
+				Assert::AreEqual( ( uint64 )sCompressible.length(), oLocation.m_uSize );
+
+				Array< uint8 > aStoredData( ( uint )oLocation.m_uStoredSize );
+				std::ifstream oPackStream( oPackPath, std::ios::binary );
+				oPackStream.seekg( oLocation.m_uOffset );
+				oPackStream.read( ( char* )aStoredData.Data(), aStoredData.Count() );
+
+				Array< uint8 > aData;
+				Assert::IsTrue( DecompressPackData( ArrayView< const uint8 >( aStoredData.Data(), aStoredData.Count() ), oLocation.m_uSize, oLocation.m_eCompression, aData ) );
+				Assert::IsTrue( std::string( ( const char* )aData.Data(), aData.Count() ) == sCompressible );
+
+				Assert::IsTrue( oVirtualFileSystem.Locate( oDirectory / "loose.txt", oLocation ) );
+				Assert::IsTrue( oLocation.m_oFilePath == oDirectory / "loose.txt" );
+				Assert::AreEqual( ( uint64 )10, oLocation.m_uStoredSize );
+				Assert::IsFalse( oVirtualFileSystem.Locate( oDirectory / "missing.txt", oLocation ) );
+			}
+
+			std::filesystem::remove_all( oRootPath );
+		}
+
+		TEST_METHOD( PackTest )
+		{
+			TestPack( false );
+		}
+
+		TEST_METHOD( CompressedPackTest )
+		{
+			TestPack( true );
+		}
+
+		TEST_METHOD( InvalidPackTest )
+		{
+			const std::filesystem::path oRootPath = std::filesystem::temp_directory_path() / "PackFileTests";
+			const std::filesystem::path oDirectory = oRootPath / "Data";
+			const std::filesystem::path oPackPath = oRootPath / "Data.pack";
+
+			WriteTestFile( oDirectory / "Scene" / "test.scene", "{ \"scene\": [] }" );
+			WriteTestFile( oDirectory / "Textures" / "grass.png", std::string( 4096, 'a' ) );
+			Assert::IsTrue( WritePackFile( oDirectory, oPackPath, true ) );
+
+			std::ifstream oPackStream( oPackPath, std::ios::binary );
+			const std::string sContent( ( std::istreambuf_iterator< char >( oPackStream ) ), std::istreambuf_iterator< char >() );
+			oPackStream.close();
+
+			const PackHeader& oHeader = *( const PackHeader* )sContent.data();
+			const size_t uEntryOffset = ( size_t )oHeader.m_uEntriesOffset;
+
+			// Each entry field is changed in turn, the pack must be refused rather than read out of its bounds
+			auto TestChangedEntry = [ & ]( const size_t uFieldOffset, const void* pValue, const size_t uValueSize ) {
+				std::string sChanged = sContent;
+				memcpy( sChanged.data() + uEntryOffset + uFieldOffset, pValue, uValueSize );
+				WriteTestFile( oPackPath, sChanged );
+
+				PackFile oPackFile;
+				Assert::IsFalse( oPackFile.Open( oPackPath ) );
+			};
+
+			const uint64 uLargeOffset = sContent.length() - 4;
+			TestChangedEntry( offsetof( PackEntry, m_uOffset ), &uLargeOffset, sizeof( uLargeOffset ) );
+
+			const uint64 uLargeSize = ~0ull;
+			TestChangedEntry( offsetof( PackEntry, m_uStoredSize ), &uLargeSize, sizeof( uLargeSize ) );
+			TestChangedEntry( offsetof( PackEntry, m_uSize ), &uLargeSize, sizeof( uLargeSize ) );
+
+			const uint32 uLargePathOffset = oHeader.m_uPathsSize;
+			TestChangedEntry( offsetof( PackEntry, m_uPathOffset ), &uLargePathOffset, sizeof( uLargePathOffset ) );
+
+			const uint8 uUnknownCompression = 7;
+			TestChangedEntry( offsetof( PackEntry, m_eCompression ), &uUnknownCompression, sizeof( uUnknownCompression ) );
+
+			// Truncated before its paths
+			WriteTestFile( oPackPath, sContent.substr( 0, sContent.length() - 1 ) );
+			{
+				PackFile oPackFile;
+				Assert::IsFalse( oPackFile.Open( oPackPath ) );
+			}
+
+			WriteTestFile( oPackPath, sContent );
+			{
+				PackFile oPackFile;
+				Assert::IsTrue( oPackFile.Open( oPackPath ) );
+			}
+
+			std::filesystem::remove_all( oRootPath );
+		}
+	};
+}
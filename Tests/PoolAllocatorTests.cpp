@@ -0,0 +1,257 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <thread>
+
+#include "Core/PoolAllocator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( PoolAllocatorTests )
+	{
+		struct PooledStruct
+		{
+			DECLARE_POOL_ALLOCATOR()
+
+			PooledStruct()
+				: m_uValue( 0 )
+			{
+				++s_uAliveCount;
+			}
+
+			virtual ~PooledStruct()
+			{
+				--s_uAliveCount;
+			}
+
+			static uint s_uAliveCount;
+
+			uint64	m_uValue;
+			float	m_aPayload[ 12 ];
+		};
+
+		struct DerivedPooledStruct : PooledStruct
+		{
+			float m_aAdditionalPayload[ 4 ];
+		};
+
+		struct SmallPooledStruct
+		{
+			DECLARE_POOL_ALLOCATOR()
+
+			uint64	m_aPayload[ 2 ];
+		};
+
+		struct LargePooledStruct
+		{
+			DECLARE_POOL_ALLOCATOR()
+
+			float	m_aPayload[ 64 ];
+		};
+
+		// Elements of three sizes are created and destroyed in a random order, like entities, components and visual nodes spawning during gameplay
+		// The timing against the global heap is measured by the PoolAllocatorChurn and HeapChurn benchmarks
+		static bool Churn( const uint uSlotCount, const uint uOperationCount )
+		{
+			Array< SmallPooledStruct* > aSmallElements( uSlotCount, nullptr );
+			Array< PooledStruct* > aMediumElements( uSlotCount, nullptr );
+			Array< LargePooledStruct* > aLargeElements( uSlotCount, nullptr );
+
+			// Each element holds its slot at the start of its payload, an element handed out twice would overwrite it
+			auto Slot = []< typename T >( T* pElement ) -> uint& { return *reinterpret_cast< uint* >( pElement->m_aPayload ); };
+
+			bool bValid = true;
+			auto Churn = [ &bValid, &Slot ]< typename T >( Array< T* >& aElements, const uint uSlot ) {
+				if( aElements[ uSlot ] != nullptr )
+				{
+					bValid &= Slot( aElements[ uSlot ] ) == uSlot;
+					delete aElements[ uSlot ];
+					aElements[ uSlot ] = nullptr;
+				}
+				else
+				{
+					aElements[ uSlot ] = new T;
+					Slot( aElements[ uSlot ] ) = uSlot;
+				}
+			};
+
+			uint uRandom = 12345;
+			for( uint u = 0; u < uOperationCount; ++u )
+			{
+				uRandom = uRandom * 1664525u + 1013904223u;
+				const uint uSlot = ( uRandom >> 8 ) % uSlotCount;
+
+				// Half of the operations are on the medium size
+				switch( uRandom >> 30 )
+				{
+				case 0:
+					Churn( aSmallElements, uSlot );
+					break;
+				case 3:
+					Churn( aLargeElements, uSlot );
+					break;
+				default:
+					Churn( aMediumElements, uSlot );
+					break;
+				}
+			}
+
+			for( uint u = 0; u < uSlotCount; ++u )
+			{
+				bValid &= aSmallElements[ u ] == nullptr || Slot( aSmallElements[ u ] ) == u;
+				bValid &= aMediumElements[ u ] == nullptr || Slot( aMediumElements[ u ] ) == u;
+				bValid &= aLargeElements[ u ] == nullptr || Slot( aLargeElements[ u ] ) == u;
+
+				delete aSmallElements[ u ];
+				delete aMediumElements[ u ];
+				delete aLargeElements[ u ];
+			}
+
+			return bValid;
+		}
+
+	public:
+		TEST_METHOD( AllocationTest )
+		{
+			PoolAllocator& oPoolAllocator = PooledStruct::GetPoolAllocator();
+			const PoolAllocatorStatistics oInitialStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( ( uint64 )sizeof( PooledStruct ), oInitialStatistics.m_uElementSize );
+			Assert::AreEqual( 0u, oInitialStatistics.m_uLiveCount );
+
+			// Fill more than one slab
+			Array< PooledStruct* > aElements;
+			for( uint u = 0; u < 100; ++u )
+			{
+				aElements.PushBack( new PooledStruct );
+				aElements.Back()->m_uValue = u;
+			}
+
+			PoolAllocatorStatistics oStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( 100u, PooledStruct::s_uAliveCount );
+			Assert::AreEqual( 100u, oStatistics.m_uLiveCount );
+			Assert::IsTrue( oStatistics.m_uSlabCount >= 2u );
+			Assert::AreEqual( oStatistics.m_uSlabCount * 64u, oStatistics.m_uCapacity );
+
+			const uint uSlabCount = oStatistics.m_uSlabCount;
+
+			for( uint u = 0; u < aElements.Count(); ++u )
+			{
+				Assert::AreEqual( ( uint64 )u, aElements[ u ]->m_uValue );
+				Assert::AreEqual( 0ull, ( uint64 )aElements[ u ] % alignof( PooledStruct ) );
+			}
+
+			// Freed elements are reused before growing
+			PooledStruct* pFreed = aElements[ 50 ];
+			delete pFreed;
+			aElements[ 50 ] = new PooledStruct;
+			Assert::IsTrue( pFreed == aElements[ 50 ] );
+
+			oStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( uSlabCount, oStatistics.m_uSlabCount );
+
+			for( PooledStruct* pElement : aElements )
+				delete pElement;
+
+			oStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( 0u, PooledStruct::s_uAliveCount );
+			Assert::AreEqual( 0u, oStatistics.m_uLiveCount );
+			Assert::AreEqual( uSlabCount, oStatistics.m_uSlabCount );
+			Assert::AreEqual( oStatistics.m_uAllocationCount, oStatistics.m_uFreeCount );
+		}
+
+		TEST_METHOD( FallbackTest )
+		{
+			PoolAllocator& oPoolAllocator = PooledStruct::GetPoolAllocator();
+			const PoolAllocatorStatistics oInitialStatistics = oPoolAllocator.GetStatistics();
+
+			// Derived types without their own pool go through the global heap
+			PooledStruct* pDerived = new DerivedPooledStruct;
+			PoolAllocatorStatistics oStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( oInitialStatistics.m_uLiveCount, oStatistics.m_uLiveCount );
+			Assert::AreEqual( oInitialStatistics.m_uFallbackCount + 1, oStatistics.m_uFallbackCount );
+
+			delete pDerived;
+			oStatistics = oPoolAllocator.GetStatistics();
+			Assert::AreEqual( oInitialStatistics.m_uLiveCount, oStatistics.m_uLiveCount );
+			Assert::AreEqual( 0u, PooledStruct::s_uAliveCount );
+		}
+
+		TEST_METHOD( ChurnTest )
+		{
+			const PoolAllocatorStatistics oInitialStatistics = PooledStruct::GetPoolAllocator().GetStatistics();
+
+			Assert::IsTrue( Churn( 1000, 200000 ) );
+
+			const PoolAllocatorStatistics oStatistics = PooledStruct::GetPoolAllocator().GetStatistics();
+			Assert::AreEqual( 0u, PooledStruct::s_uAliveCount );
+			Assert::AreEqual( 0u, oStatistics.m_uLiveCount );
+			Assert::AreEqual( oStatistics.m_uAllocationCount - oInitialStatistics.m_uAllocationCount, oStatistics.m_uFreeCount - oInitialStatistics.m_uFreeCount );
+			Assert::AreEqual( 0u, SmallPooledStruct::GetPoolAllocator().GetStatistics().m_uLiveCount );
+			Assert::AreEqual( 0u, LargePooledStruct::GetPoolAllocator().GetStatistics().m_uLiveCount );
+		}
+
+		TEST_METHOD( ThreadTest )
+		{
+			const uint uThreadCount = 4;
+			const uint uElementCount = 1000;
+
+			// Elements are freed by another thread than the one which created them, as when an entity is destroyed by a job
+			Array< Array< SmallPooledStruct* > > aElements( uThreadCount );
+			Array< std::thread* > aThreads;
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				aThreads.PushBack( new std::thread( [ &aElements, uThread ]() {
+					for( uint u = 0; u < uElementCount; ++u )
+					{
+						aElements[ uThread ].PushBack( new SmallPooledStruct );
+						aElements[ uThread ].Back()->m_aPayload[ 0 ] = uThread * uElementCount + u;
+						aElements[ uThread ].Back()->m_aPayload[ 1 ] = uThread;
+					}
+				} ) );
+			}
+
+			for( std::thread* pThread : aThreads )
+			{
+				pThread->join();
+				delete pThread;
+			}
+			aThreads.Clear();
+
+			Assert::AreEqual( uThreadCount * uElementCount, SmallPooledStruct::GetPoolAllocator().GetStatistics().m_uLiveCount );
+
+			// Every element was handed out once, with the values written by its own thread
+			bool bValid = true;
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				for( uint u = 0; u < uElementCount; ++u )
+					bValid &= aElements[ uThread ][ u ]->m_aPayload[ 0 ] == uThread * uElementCount + u && aElements[ uThread ][ u ]->m_aPayload[ 1 ] == uThread;
+			}
+			Assert::IsTrue( bValid );
+
+			for( uint uThread = 0; uThread < uThreadCount; ++uThread )
+			{
+				aThreads.PushBack( new std::thread( [ &aElements, uThread ]() {
+					const uint uOtherThread = ( uThread + 1 ) % uThreadCount;
+					for( SmallPooledStruct* pElement : aElements[ uOtherThread ] )
+						delete pElement;
+				} ) );
+			}
+
+			for( std::thread* pThread : aThreads )
+			{
+				pThread->join();
+				delete pThread;
+			}
+
+			Assert::AreEqual( 0u, SmallPooledStruct::GetPoolAllocator().GetStatistics().m_uLiveCount );
+		}
+	};
+
+	uint PoolAllocatorTests::PooledStruct::s_uAliveCount = 0;
+
+	DEFINE_POOL_ALLOCATOR( PoolAllocatorTests::PooledStruct, 64 )
+	DEFINE_POOL_ALLOCATOR( PoolAllocatorTests::SmallPooledStruct, 256 )
+	DEFINE_POOL_ALLOCATOR( PoolAllocatorTests::LargePooledStruct, 32 )
+}
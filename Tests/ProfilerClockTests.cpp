@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <chrono>
+#include <format>
+#include <thread>
+
+#include "Core/ProfilerClock.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( ProfilerClockTests )
+	{
+	public:
+		TEST_METHOD( CalibrationTest )
+		{
+			// Calibrating runs every frame, it must not wait for the clocks to drift apart
+			const GameTimePoint oCalibrationStart = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < 100; ++u )
+				ProfilerClock::Calibrate();
+			Assert::IsTrue( std::chrono::high_resolution_clock::now() - oCalibrationStart < std::chrono::milliseconds( 10 ) );
+			Assert::IsTrue( ProfilerClock::GetNanoSecondsPerTick() > 0.0 );
+
+			const uint64 uStartTicks = ProfilerClock::GetTicks();
+			const GameTimePoint oStart = std::chrono::high_resolution_clock::now();
+
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+			const uint64 uEndTicks = ProfilerClock::GetTicks();
+			const GameTimePoint oEnd = std::chrono::high_resolution_clock::now();
+
+			ProfilerClock::Calibrate();
+
+			const double fExpectedMs = std::chrono::duration< double, std::milli >( oEnd - oStart ).count();
+			const double fMeasuredMs = std::chrono::duration< double, std::milli >( ProfilerClock::ToTimePoint( uEndTicks ) - ProfilerClock::ToTimePoint( uStartTicks ) ).count();
+			Assert::IsTrue( fMeasuredMs > fExpectedMs * 0.98 && fMeasuredMs < fExpectedMs * 1.02 );
+
+			// Converted ticks land in the std::chrono::high_resolution_clock timeline
+			const double fOffsetMs = std::chrono::duration< double, std::milli >( ProfilerClock::ToTimePoint( uEndTicks ) - oEnd ).count();
+			Assert::IsTrue( fOffsetMs > -1.0 && fOffsetMs < 1.0 );
+		}
+
+		TEST_METHOD( GetTicksSpeedTest )
+		{
+			const uint uIterations = 10000000;
+
+			uint64 uLastTicks = 0;
+			GameTimePoint oLastTime;
+
+			auto t1 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uIterations; ++u )
+				uLastTicks = std::max( uLastTicks, ProfilerClock::GetTicks() );
+			auto t2 = std::chrono::high_resolution_clock::now();
+			for( uint u = 0; u < uIterations; ++u )
+				oLastTime = std::max( oLastTime, std::chrono::high_resolution_clock::now() );
+			auto t3 = std::chrono::high_resolution_clock::now();
+
+			const auto oTicksTime = std::chrono::duration_cast< std::chrono::microseconds >( t2 - t1 ).count();
+			const auto oChronoTime = std::chrono::duration_cast< std::chrono::microseconds >( t3 - t2 ).count();
+
+			Logger::WriteMessage( std::format( "{} timestamps : ProfilerClock ({}) {} us, high_resolution_clock {} us\n", uIterations, ProfilerClock::UsesInvariantTSC() ? "invariant TSC" : "fallback", oTicksTime, oChronoTime ).c_str() );
+
+			// Suspicious if not, but not a hard truth
+			if( ProfilerClock::UsesInvariantTSC() )
+				Assert::IsTrue( oTicksTime < oChronoTime );
+		}
+	};
+}
@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "Core/ProfilerFrameQueue.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	struct TestFrame
+	{
+		uint m_uIndex = 0;
+		bool m_bResolved = false;
+		bool m_bReady = false;
+	};
+
+	TEST_CLASS( ProfilerFrameQueueTests )
+	{
+	public:
+		TEST_METHOD( OrderTest )
+		{
+			TestFrame aFrames[ 5 ];
+			ProfilerFrameQueue< TestFrame > oQueue;
+			for( uint u = 0; u < 5; ++u )
+			{
+				aFrames[ u ].m_uIndex = u;
+				oQueue.Push( &aFrames[ u ] );
+			}
+
+			Array< uint > aReadyFrames;
+			auto IsResolved = []( TestFrame* pFrame ) { return pFrame->m_bResolved; };
+			auto OnReady = [ &aReadyFrames ]( TestFrame* pFrame ) { aReadyFrames.PushBack( pFrame->m_uIndex ); };
+
+			// A newer frame waits for the older ones
+			aFrames[ 1 ].m_bResolved = true;
+			aFrames[ 3 ].m_bResolved = true;
+			oQueue.PopReady( IsResolved, OnReady );
+			Assert::IsTrue( aReadyFrames.Empty() );
+			Assert::AreEqual( 5u, oQueue.GetPendingCount() );
+
+			aFrames[ 0 ].m_bResolved = true;
+			oQueue.PopReady( IsResolved, OnReady );
+			Assert::AreEqual( 2u, aReadyFrames.Count() );
+			Assert::AreEqual( 0u, aReadyFrames[ 0 ] );
+			Assert::AreEqual( 1u, aReadyFrames[ 1 ] );
+			Assert::AreEqual( 3u, oQueue.GetPendingCount() );
+
+			aFrames[ 4 ].m_bResolved = true;
+			aFrames[ 2 ].m_bResolved = true;
+			oQueue.PopReady( IsResolved, OnReady );
+			Assert::AreEqual( 5u, aReadyFrames.Count() );
+			for( uint u = 0; u < 5; ++u )
+				Assert::AreEqual( u, aReadyFrames[ u ] );
+			Assert::AreEqual( 0u, oQueue.GetPendingCount() );
+		}
+
+		TEST_METHOD( SpikeContextTest )
+		{
+			// Frames resolved together, as when the GPU timings of several frames arrive in the same NewFrame
+			const uint uFramesBefore = 3;
+			const uint uSpikeFrame = 4;
+
+			TestFrame aFrames[ 6 ];
+			ProfilerFrameQueue< TestFrame > oQueue;
+			for( uint u = 0; u < 6; ++u )
+			{
+				aFrames[ u ].m_uIndex = u;
+				aFrames[ u ].m_bResolved = true;
+				oQueue.Push( &aFrames[ u ] );
+			}
+
+			// Same lookup as Profiler::CheckBudgets, the frames preceding the spike are only part of it once ready
+			Array< uint > aSpikeFrames;
+			auto IsResolved = []( TestFrame* pFrame ) { return pFrame->m_bResolved; };
+			auto OnReady = [ & ]( TestFrame* pFrame ) {
+				pFrame->m_bReady = true;
+				if( pFrame->m_uIndex != uSpikeFrame )
+					return;
+
+				for( uint u = uFramesBefore; u > 0; --u )
+				{
+					if( aFrames[ uSpikeFrame - u ].m_bReady )
+						aSpikeFrames.PushBack( uSpikeFrame - u );
+				}
+				aSpikeFrames.PushBack( uSpikeFrame );
+			};
+
+			oQueue.PopReady( IsResolved, OnReady );
+
+			Assert::AreEqual( uFramesBefore + 1, aSpikeFrames.Count() );
+			for( uint u = 0; u < aSpikeFrames.Count(); ++u )
+				Assert::AreEqual( uSpikeFrame - uFramesBefore + u, aSpikeFrames[ u ] );
+			Assert::AreEqual( 0u, oQueue.GetPendingCount() );
+		}
+	};
+}
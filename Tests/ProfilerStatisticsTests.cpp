@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "Core/ProfilerStatistics.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( ProfilerStatisticsTests )
+	{
+	public:
+		TEST_METHOD( HistogramTest )
+		{
+			ProfilerHistogram oHistogram;
+			Assert::AreEqual( ( uint64 )0, oHistogram.GetPercentile( 0.5f ) );
+
+			// 1 to 1000 microseconds
+			for( uint u = 1; u <= 1000; ++u )
+				oHistogram.Add( u * 1000ull );
+
+			Assert::AreEqual( ( uint64 )1000, oHistogram.m_uCount );
+			Assert::AreEqual( ( uint64 )1000000, oHistogram.m_uMaxNs );
+			Assert::AreEqual( ( uint64 )500500, oHistogram.GetMean() );
+
+			auto IsClose = []( const uint64 uValue, const uint64 uExpected ) {
+				return uValue >= uExpected * 0.93 && uValue <= uExpected * 1.07;
+			};
+
+			Assert::IsTrue( IsClose( oHistogram.GetPercentile( 0.5f ), 500000 ) );
+			Assert::IsTrue( IsClose( oHistogram.GetPercentile( 0.95f ), 950000 ) );
+			Assert::IsTrue( IsClose( oHistogram.GetPercentile( 0.99f ), 990000 ) );
+			Assert::AreEqual( ( uint64 )1000000, oHistogram.GetPercentile( 1.f ) );
+
+			// A single hitch only shows in the highest percentiles
+			ProfilerHistogram oHitchHistogram;
+			for( uint u = 0; u < 499; ++u )
+				oHitchHistogram.Add( 100000 );
+			oHitchHistogram.Add( 50000000 );
+
+			Assert::IsTrue( IsClose( oHitchHistogram.GetPercentile( 0.99f ), 100000 ) );
+			Assert::AreEqual( ( uint64 )50000000, oHitchHistogram.GetPercentile( 1.f ) );
+			Assert::AreEqual( ( uint64 )50000000, oHitchHistogram.m_uMaxNs );
+
+			oHistogram.Clear();
+			Assert::AreEqual( ( uint64 )0, oHistogram.m_uCount );
+			Assert::AreEqual( ( uint64 )0, oHistogram.GetPercentile( 0.99f ) );
+		}
+
+		TEST_METHOD( AggregationTest )
+		{
+			ProfilerStatistics oStatistics;
+			oStatistics.SetWindowFrameCount( 2 );
+
+			// Same name from another literal
+			const char sUpdate[] = "Update";
+
+			oStatistics.AddBlock( "Update", 1000 );
+			oStatistics.AddBlock( sUpdate, 3000 );
+			oStatistics.AddBlock( "Render", 5000 );
+			oStatistics.EndFrame();
+
+			const Array< ProfilerBlockStatistics >& aBlockStatistics = oStatistics.GetBlockStatistics();
+			Assert::AreEqual( 2u, aBlockStatistics.Count() );
+			Assert::IsTrue( aBlockStatistics[ 0 ].m_sName == "Update" );
+			Assert::AreEqual( ( uint64 )2, aBlockStatistics[ 0 ].m_oSession.m_uCount );
+			Assert::AreEqual( ( uint64 )4000, aBlockStatistics[ 0 ].m_oSession.m_uTotalNs );
+
+			// Window still running
+			Assert::AreEqual( ( uint64 )2, oStatistics.GetWindowHistogram( aBlockStatistics[ 0 ] ).m_uCount );
+
+			oStatistics.AddBlock( "Update", 2000 );
+			oStatistics.EndFrame();
+
+			// Window completed, the next one starts empty
+			Assert::AreEqual( ( uint64 )3, oStatistics.GetWindowHistogram( aBlockStatistics[ 0 ] ).m_uCount );
+			Assert::AreEqual( ( uint64 )0, aBlockStatistics[ 0 ].m_oWindow.m_uCount );
+
+			oStatistics.AddBlock( "Update", 2000 );
+			oStatistics.EndFrame();
+			oStatistics.EndFrame();
+
+			Assert::AreEqual( ( uint64 )1, oStatistics.GetWindowHistogram( aBlockStatistics[ 0 ] ).m_uCount );
+			Assert::AreEqual( ( uint64 )0, oStatistics.GetWindowHistogram( aBlockStatistics[ 1 ] ).m_uCount );
+			Assert::AreEqual( ( uint64 )4, aBlockStatistics[ 0 ].m_oSession.m_uCount );
+			Assert::AreEqual( ( uint64 )4, oStatistics.GetSessionFrameCount() );
+
+			// Session window
+			oStatistics.SetWindowFrameCount( 0 );
+			Assert::AreEqual( ( uint64 )4, oStatistics.GetWindowHistogram( aBlockStatistics[ 0 ] ).m_uCount );
+		}
+
+		TEST_METHOD( AllocationsTest )
+		{
+			ProfilerStatistics oStatistics;
+			oStatistics.SetWindowFrameCount( 2 );
+
+			oStatistics.AddBlock( "LoadScene", 1000, ProfilerBlockAllocations( 3, 300, 100 ) );
+			oStatistics.AddBlock( "LoadScene", 1000, ProfilerBlockAllocations( 1, 50, 0 ) );
+			oStatistics.AddBlock( "Render", 1000 );
+			oStatistics.EndFrame();
+
+			const Array< ProfilerBlockStatistics >& aBlockStatistics = oStatistics.GetBlockStatistics();
+			Assert::AreEqual( ( uint64 )4, oStatistics.GetWindowAllocations( aBlockStatistics[ 0 ] ).m_uAllocationCount );
+			Assert::AreEqual( ( uint64 )350, oStatistics.GetWindowAllocations( aBlockStatistics[ 0 ] ).m_uAllocatedBytes );
+			Assert::AreEqual( ( uint64 )100, oStatistics.GetWindowAllocations( aBlockStatistics[ 0 ] ).m_uFreedBytes );
+			Assert::AreEqual( ( uint64 )0, oStatistics.GetWindowAllocations( aBlockStatistics[ 1 ] ).m_uAllocationCount );
+
+			oStatistics.AddBlock( "LoadScene", 1000, ProfilerBlockAllocations( 2, 20, 20 ) );
+			oStatistics.EndFrame();
+			oStatistics.EndFrame();
+
+			// Window completed, then a frame without allocations in the next one
+			Assert::AreEqual( ( uint64 )6, oStatistics.GetWindowAllocations( aBlockStatistics[ 0 ] ).m_uAllocationCount );
+			Assert::AreEqual( ( uint64 )0, aBlockStatistics[ 0 ].m_oWindowAllocations.m_uAllocationCount );
+			Assert::AreEqual( ( uint64 )370, aBlockStatistics[ 0 ].m_oSessionAllocations.m_uAllocatedBytes );
+
+			const std::string sCSV = oStatistics.GetReport( ProfilerStatistics::ReportFormat::CSV );
+			Assert::IsTrue( sCSV.find( ",6,370,120\n" ) != std::string::npos );
+		}
+
+		TEST_METHOD( ReportTest )
+		{
+			ProfilerStatistics oStatistics;
+			oStatistics.AddBlock( "CullNodes", 1000000 );
+			oStatistics.AddBlock( "UpdateComponents", 3000000 );
+			oStatistics.EndFrame();
+
+			const std::string sCSV = oStatistics.GetReport( ProfilerStatistics::ReportFormat::CSV );
+			Assert::IsTrue( sCSV.starts_with( "name,count,calls_per_frame,total_ms,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,allocations,allocated_bytes,freed_bytes\n" ) );
+
+			// Sorted by decreasing total time
+			const size_t uUpdatePosition = sCSV.find( "\"UpdateComponents\",1,1.00,3.000," );
+			const size_t uCullPosition = sCSV.find( "\"CullNodes\",1,1.00,1.000," );
+			Assert::IsTrue( uUpdatePosition != std::string::npos );
+			Assert::IsTrue( uCullPosition != std::string::npos );
+			Assert::IsTrue( uUpdatePosition < uCullPosition );
+
+			const std::string sText = oStatistics.GetReport( ProfilerStatistics::ReportFormat::TEXT );
+			Assert::IsTrue( sText.find( "CullNodes" ) != std::string::npos );
+			Assert::IsTrue( sText.find( "UpdateComponents" ) < sText.find( "CullNodes" ) );
+		}
+	};
+}
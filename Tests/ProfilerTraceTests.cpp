@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <nlohmann/json.hpp>
+
+#include "Core/ProfilerTrace.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace Tests
+{
+	TEST_CLASS( ProfilerTraceTests )
+	{
+	public:
+		TEST_METHOD( EscapeTest )
+		{
+			std::string sOutput;
+			AppendJSONString( sOutput, "Plain" );
+			Assert::AreEqual( std::string( "\"Plain\"" ), sOutput );
+
+			sOutput.clear();
+			AppendJSONString( sOutput, "Quote \" backslash \\ line\nbell\a" );
+			Assert::AreEqual( std::string( "\"Quote \\\" backslash \\\\ line\\nbell\\u0007\"" ), sOutput );
+		}
+
+		TEST_METHOD( TraceTest )
+		{
+			// Names a JSON string could not hold as is
+			const char* sBlockName = "Load \"level\" C:\\Data";
+			const char* sCounterName = "Entities\tvisible";
+			const char* sThreadName = "Worker\n2";
+
+			ProfilerTrace oTrace;
+			oTrace.SetProcessName( 1, "CPU" );
+			oTrace.SetThreadName( 1, 0, sThreadName );
+			oTrace.AddBlock( sBlockName, 1, 0, 10.5, 2.25 );
+			oTrace.AddBlock( "Render", 2, 0, 11.0, 1.0 );
+			oTrace.AddCounter( sCounterName, 1, 10.0, { { "value", 42.0 } } );
+			oTrace.AddCounter( "Memory", 1, 10.0, { { "count", 3.0 }, { "bytes", 1024.0 } } );
+
+			const nlohmann::json oJSON = nlohmann::json::parse( oTrace.GetJSON() );
+			const nlohmann::json& oEvents = oJSON[ "traceEvents" ];
+			Assert::IsTrue( oEvents.is_array() );
+			Assert::AreEqual( ( size_t )7, oEvents.size() );
+
+			auto FindEvent = [ & ]( const char* sName, const char* sPhase ) {
+				for( const nlohmann::json& oEvent : oEvents )
+				{
+					if( oEvent[ "name" ] == sName && oEvent[ "ph" ] == sPhase )
+						return oEvent;
+				}
+
+				return nlohmann::json();
+			};
+
+			const nlohmann::json oThreadName = FindEvent( "thread_name", "M" );
+			Assert::IsTrue( oThreadName[ "args" ][ "name" ] == sThreadName );
+
+			const nlohmann::json oBlock = FindEvent( sBlockName, "X" );
+			Assert::IsFalse( oBlock.is_null() );
+			Assert::AreEqual( 1, oBlock[ "pid" ].get< int >() );
+			Assert::AreEqual( 10.5, oBlock[ "ts" ].get< double >() );
+			Assert::AreEqual( 2.25, oBlock[ "dur" ].get< double >() );
+
+			const nlohmann::json oCounter = FindEvent( sCounterName, "C" );
+			Assert::AreEqual( 42.0, oCounter[ "args" ][ "value" ].get< double >() );
+
+			const nlohmann::json oMemory = FindEvent( "Memory", "C" );
+			Assert::AreEqual( 1024.0, oMemory[ "args" ][ "bytes" ].get< double >() );
+
+			// Nothing recorded still gives a valid file
+			oTrace.Clear();
+			Assert::IsTrue( nlohmann::json::parse( oTrace.GetJSON() )[ "traceEvents" ].empty() );
+		}
+	};
+}